@@ -142,7 +142,39 @@ typedef enum {
 
   ENCODER_OPTION_IS_LOSSLESS_LINK,            ///< advanced algorithmetic settings
 
-  ENCODER_OPTION_BITS_VARY_PERCENTAGE        ///< bit vary percentage
+  ENCODER_OPTION_BITS_VARY_PERCENTAGE,       ///< bit vary percentage
+
+  ENCODER_OPTION_THREAD_SCHEDULING,          ///< structure of SThreadSchedulingParam, share of the process-wide thread pool used by this instance
+
+  ENCODER_OPTION_ZERO_COPY_INPUT,            ///< structure of SZeroCopyInputParam, read the planes of the source picture in place instead of copying them
+
+  ENCODER_OPTION_SLICE_OUTPUT_CALLBACK,      ///< structure of SSliceOutputCallbackParam, hands each slice out as soon as it is written
+
+  ENCODER_OPTION_PROFILING,                  ///< structure of SEncoderProfiling, per-stage timing and counters of the encoding
+
+  ENCODER_OPTION_MOTION_HINT,                ///< structure of SMotionHintParam, motion of the next source picture known by the application
+
+  ENCODER_OPTION_MOTION_ANALYSIS,            ///< structure of SMotionAnalysis, motion decided for the last picture, to be shared with other encoders
+
+  ENCODER_OPTION_HIERARCHICAL_ME,            ///< bool, seed the motion search with a coarse-to-fine search on down-scaled pictures, camera content only
+  ENCODER_OPTION_HALFPEL_CACHE,              ///< bool, filter the half-pel planes of each reference once per frame for the sub-pel refinement, camera content only; output unchanged
+  ENCODER_OPTION_SCREEN_BLOCK_HASH,          ///< bool, look 16x16 and 8x8 blocks up in an exact hash index of the reference, screen content only
+  ENCODER_OPTION_STATIC_SKIP_PREFILTER,      ///< bool, classify the macroblocks left unchanged against the reference ahead of the mode decision and code them as skip directly
+  ENCODER_OPTION_EFFORT_MAP,                 ///< structure of SEffortMapParam, effort to spend on each macroblock of the next source picture
+  ENCODER_OPTION_FRAME_TIME_BUDGET,          ///< int, encoding time of a frame in microseconds the complexity is adapted to frame by frame, refer to ECOMPLEXITY_LEVEL; 0: off
+  ENCODER_OPTION_OVERLAPPED_DEBLOCKING,      ///< bool, deblock the picture by macroblock rows while the slice threads are still coding, with the same output as deblocking afterwards
+  ENCODER_OPTION_PREALLOCATE_BUFFERS,        ///< int, slices per picture of each size-limited layer to size the slice, NAL and bitstream buffers for up front, so they do not grow while encoding; -1: the worst case of the level; 0: off, grown on demand
+  ENCODER_OPTION_MEMORY_ARENA,               ///< structure of SMemoryArenaParam, carve the memory of the encoder from one reservation; can be set before Initialize
+  ENCODER_OPTION_GET_MEMORY_USAGE,           ///< structure of SMemoryUsage, memory in use by the encoder, by allocation tag in the arena mode
+  ENCODER_OPTION_LOW_FOOTPRINT,              ///< bool, allocate for the active temporal layers rather than the worst case and leave the bitstream buffer unbacked until written, camera content only; output unchanged; can be set before Initialize
+  ENCODER_OPTION_RECONFIG_POOL,              ///< structure of SReconfigPoolParam, keep the memory and the threads of the encoder over the resets of a resolution or slice layout change; can be set before Initialize; Initialize then sets up a dry-run encoder of the largest picture once to size the arena, which doubles the cost of the first Initialize
+  ENCODER_OPTION_INTRA_REFRESH,              ///< int, frames a band of intra macroblock rows takes to sweep down the picture in place of the periodic IDR, each sweep announced by a recovery point SEI; single spatial layer or simulcast AVC only; 0: off
+  ENCODER_OPTION_QUALITY_METRICS,            ///< bool, measure the PSNR and the SSIM of each coded layer against its source while deblocking, refer to ENCODER_OPTION_GET_QUALITY_METRICS; non-reference pictures are deblocked as well
+  ENCODER_OPTION_GET_QUALITY_METRICS,        ///< structure of SFrameQualityMetrics, PSNR and SSIM of each spatial layer of the last encoded frame, get only
+  ENCODER_OPTION_GET_COMPLEXITY_LEVEL,       ///< int, ECOMPLEXITY_LEVEL the last frame was encoded at, refer to ENCODER_OPTION_FRAME_TIME_BUDGET, get only
+  ENCODER_OPTION_GET_BUFFER_STATISTICS,      ///< structure of SEncoderBufferStatistics, allocations and buffer grows while encoding frames, get only
+  ENCODER_OPTION_GET_RECONFIG_STATISTICS,    ///< structure of SEncoderReconfigStatistics, resets of the encoder for a parameter change, get only
+  ENCODER_OPTION_GET_INTRA_REFRESH_NUM       ///< unsigned int, intra refresh sweeps started in place of an IDR, refer to ENCODER_OPTION_INTRA_REFRESH, get only
 } ENCODER_OPTION;
 
 /**
@@ -633,6 +665,7 @@ typedef struct {
   int   iNalCount;              ///< count number of NAL coded already
   int*  pNalLengthInByte;       ///< length of NAL size in byte from 0 to iNalCount-1
   unsigned char*  pBsBuf;       ///< buffer of bitstream contained
+
 } SLayerBSInfo, *PLayerBSInfo;
 
 /**
@@ -658,6 +691,226 @@ typedef struct Source_Picture_s {
   int       iPicHeight;            ///< luma picture height in y coordinate
   long long uiTimeStamp;           ///< timestamp of the source picture, unit: millisecond
 } SSourcePicture;
+
+/**
+* @brief Enumerate the scheduling class of an encoder instance in the process-wide thread pool
+*/
+typedef enum {
+  THREAD_PRIORITY_INTERACTIVE = 0,     ///< real-time instance, its slice tasks are dispatched before those of other classes
+  THREAD_PRIORITY_NORMAL,              ///< default class
+  THREAD_PRIORITY_ARCHIVAL             ///< offline instance, served when no instance of a higher class is waiting or after it was passed over a few times
+} EThreadPriorityClass;
+
+/**
+* @brief Structure for thread scheduling of an encoder instance
+*/
+typedef struct TagThreadSchedulingParam {
+  int iThreadPoolSize;                  ///< number of threads in the pool shared by all encoders of the process, 0: not changed; a pool in use can only grow
+  int iMaxThreadsInUse;                 ///< maximal number of pool threads running tasks of this instance at the same time, 0: no limit
+  EThreadPriorityClass ePriorityClass;  ///< scheduling class of this instance
+} SThreadSchedulingParam;
+
+/**
+* @brief Structure for reading the source picture in place
+*        the planes are only read during EncodeFrame(), the caller keeps them valid until it returns;
+*        as the source is not kept, the analysis of the next picture (scene change, background, adaptive
+*        quantization, complexity for the rate control, static skip) compares it with the reconstruction of
+*        this one, so the bitstream may differ from the one coded from copied pictures when these are enabled
+*/
+typedef struct TagZeroCopyInputParam {
+  bool bEnable;          ///< read the planes of I420 source pictures in place whenever the settings and the picture allow it
+  int  iStride[3];       ///< [get only] strides a source picture needs to be read in place, all planes also 16 bytes aligned
+  bool bLastInPlace;     ///< [get only] whether the last source picture was read in place
+} SZeroCopyInputParam;
+
+/**
+* @brief Structure of a coded slice given to the slice output callback
+*/
+typedef struct TagSliceOutputInfo {
+  int             iSpatialId;                  ///< dependency id of the layer
+  int             iTemporalId;                 ///< temporal id of the layer
+  int             iSliceIdx;                   ///< index of the slice in the layer, -1 for the parameter sets written before it
+  EVideoFrameType eFrameType;                  ///< frame type of the layer
+  long long       uiTimeStamp;                 ///< timestamp of the frame, as in SFrameBSInfo
+  int             iNalCount;                   ///< count of NAL units, the prefix NAL of the slice (if any) included
+  const int*      pNalLengthInByte;            ///< length of each NAL unit, start code included
+  const unsigned char* pBsBuf;                 ///< NAL units, only valid during the call
+} SSliceOutputInfo;
+
+typedef void (*WelsSliceOutputCallback) (void* pContext, const SSliceOutputInfo* pInfo);
+
+/**
+* @brief Structure for the slice output callback
+*        the slices of a layer are given in slice order, before EncodeFrame() returns with the whole frame as usual;
+*        with slice threading the callback is called from the encoding threads, one call at a time;
+*        the slices of a frame dropped afterwards by the rate control (EncodeFrame() reports videoFrameTypeSkip) have to be discarded
+*/
+typedef struct TagSliceOutputCallbackParam {
+  WelsSliceOutputCallback pCallback;           ///< NULL: no slice output
+  void*                   pContext;            ///< first argument of the callback
+} SSliceOutputCallbackParam;
+
+/**
+* @brief Encoding stages timed by the profiling, refer to SEncoderProfiling
+*/
+typedef enum {
+  PROFILING_STAGE_PREPROCESS = 0,     ///< source picture preparation and video analysis, refer to EProfilingVpMethod
+  PROFILING_STAGE_ME_INTEGER,         ///< integer-pel motion estimation
+  PROFILING_STAGE_ME_SUBPEL,          ///< fractional-pel motion refinement
+  PROFILING_STAGE_MODE_DECISION,      ///< mode decision, motion estimation and inter residual coding excluded
+  PROFILING_STAGE_TRANSFORM_QUANT,    ///< transform and quantization of the decided inter and skip macroblocks
+  PROFILING_STAGE_RECONSTRUCTION,     ///< reconstruction of inter macroblocks, intra ones are reconstructed during their mode decision
+  PROFILING_STAGE_ENTROPY_CODING,     ///< CAVLC or CABAC writing of the macroblocks
+  PROFILING_STAGE_DEBLOCKING,         ///< loop filter
+  PROFILING_STAGE_PADDING,            ///< border expansion of the reference pictures
+  PROFILING_STAGE_RATE_CONTROL,       ///< frame and macroblock level rate control
+  PROFILING_STAGE_NUM
+} EProfilingStage;
+
+/**
+* @brief Video analysis methods timed by the profiling, part of PROFILING_STAGE_PREPROCESS
+*/
+typedef enum {
+  PROFILING_VP_COLORSPACE_CONVERT = 0,
+  PROFILING_VP_DENOISE,
+  PROFILING_VP_SCENE_CHANGE_DETECTION,
+  PROFILING_VP_DOWNSAMPLE,
+  PROFILING_VP_VAA_STATISTICS,
+  PROFILING_VP_BACKGROUND_DETECTION,
+  PROFILING_VP_ADAPTIVE_QUANT,
+  PROFILING_VP_COMPLEXITY_ANALYSIS,
+  PROFILING_VP_SCROLL_DETECTION,
+  PROFILING_VP_NUM
+} EProfilingVpMethod;
+
+/**
+* @brief Macroblock types counted by the profiling
+*/
+typedef enum {
+  PROFILING_MB_INTRA4x4 = 0,
+  PROFILING_MB_INTRA16x16,
+  PROFILING_MB_INTER16x16,
+  PROFILING_MB_INTER16x8,
+  PROFILING_MB_INTER8x16,
+  PROFILING_MB_INTER8x8,              ///< sub-8x8 partitions included
+  PROFILING_MB_SKIP,
+  PROFILING_MB_TYPE_NUM
+} EProfilingMbType;
+
+/**
+* @brief Counters of the profiling, refer to SEncoderProfiling
+*/
+typedef struct TagProfilingCounters {
+  long long    iStageTimeUs[PROFILING_STAGE_NUM];      ///< time spent in each stage, summed over the slice threads
+  long long    iVpTimeUs[PROFILING_VP_NUM];            ///< time spent in each video analysis method
+  long long    iSadCount;                              ///< SAD evaluations of the integer-pel motion estimation
+  long long    iSatdCount;                             ///< SATD evaluations of the integer-pel motion estimation results
+  long long    iSubpelRefineCount;                     ///< fractional-pel refinements, each evaluates up to 9 positions
+  long long    iPrefilteredSkipCount;                  ///< skip macroblocks decided ahead of the mode decision, refer to ENCODER_OPTION_STATIC_SKIP_PREFILTER
+  unsigned int uiMbTypeCount[PROFILING_MB_TYPE_NUM];   ///< coded macroblocks of each type
+} SProfilingCounters;
+
+/**
+* @brief Structure for the encoder profiling
+*        the counters are only updated while enabled; the cost is a branch per stage change when disabled
+*/
+typedef struct TagEncoderProfiling {
+  bool               bEnable;         ///< [set] start or stop the profiling
+  bool               bReset;          ///< [set] clear the counters
+  unsigned int       uiFrameCount;    ///< [get only] frames encoded with the profiling enabled since the last reset
+  SProfilingCounters sTotal;          ///< [get only] sum over these frames
+  SProfilingCounters sLastFrame;      ///< [get only] the last of these frames
+} SEncoderProfiling;
+
+/**
+* @brief Partition suggested by a motion hint, refer to SMbMotionHint
+*/
+typedef enum {
+  MOTION_HINT_NONE = 0,            ///< no partition suggested, the vectors only seed the motion search
+  MOTION_HINT_SKIP,
+  MOTION_HINT_16x16,
+  MOTION_HINT_16x8,
+  MOTION_HINT_8x16,
+  MOTION_HINT_8x8,                 ///< sub-8x8 partitions of the source folded to 8x8
+  MOTION_HINT_INTRA                ///< no motion known for the macroblock
+} EMotionHintPartition;
+
+/**
+* @brief Motion hint of a macroblock, e.g. taken from the bitstream being transcoded
+*/
+typedef struct TagMbMotionHint {
+  short         iMv16x16[2];       ///< x and y of the 16x16 vector, quarter pel
+  short         iMv8x8[4][2];      ///< x and y of the vector of each 8x8 block in raster order, quarter pel
+  signed char   iRefIdx;           ///< reference index of the vectors, they are divided by (iRefIdx + 1) to point to the previous picture
+  unsigned char uiPartition;       ///< EMotionHintPartition
+  unsigned char uiQp;              ///< QP the partition was decided at, 0: unknown; otherwise the partition is only trusted close to this QP
+} SMbMotionHint;
+
+/**
+* @brief Structure for ENCODER_OPTION_MOTION_HINT
+*        the hints are copied and apply to the next EncodeFrame() only; a map of another resolution
+*        is scaled to each spatial layer
+*/
+typedef struct TagMotionHintParam {
+  const SMbMotionHint* pHints;     ///< iMbWidth * iMbHeight hints in raster order, NULL: no hint for the next picture
+  int                  iMbWidth;   ///< width of the hint map in macroblocks
+  int                  iMbHeight;  ///< height of the hint map in macroblocks
+  bool                 bEarlyTermination; ///< true: the suggested partition replaces the partition search; false: the vectors only seed the search
+  const void*          pPreprocess;     ///< pPreprocess of the SMotionAnalysis of an encoder of the same source at the same resolution, NULL: own analysis
+  int                  iPreprocessSize; ///< bytes at pPreprocess
+} SMotionHintParam;
+
+/**
+* @brief Effort of a macroblock, refer to SEffortMapParam
+*/
+typedef enum {
+  EFFORT_FULL = 0,                 ///< the usual mode decision
+  EFFORT_LOW,                      ///< 16x16 partitions only with a small search range, no intra 4x4
+  EFFORT_SKIP                      ///< coded as skip whenever the predicted vector allows, otherwise as EFFORT_LOW
+} EMbEffort;
+
+/**
+* @brief Complexity levels stepped through to meet ENCODER_OPTION_FRAME_TIME_BUDGET, each level keeps the savings of the lower ones
+*/
+typedef enum {
+  COMPLEXITY_LEVEL_FULL = 0,       ///< as set by iComplexityMode
+  COMPLEXITY_LEVEL_NO_INTRA4x4,    ///< intra 4x4 not evaluated in P slices
+  COMPLEXITY_LEVEL_16x16_ONLY,     ///< no inter partition below 16x16
+  COMPLEXITY_LEVEL_HALF_PEL,       ///< sub-pel refinement stops at half pel
+  COMPLEXITY_LEVEL_SMALL_SEARCH,   ///< integer motion search range limited to 16 pels
+  COMPLEXITY_LEVEL_NUM
+} ECOMPLEXITY_LEVEL;
+
+/**
+* @brief Structure for ENCODER_OPTION_EFFORT_MAP
+*        the map is copied and applies to the next EncodeFrame() only; a map of another resolution
+*        is scaled to each spatial layer
+*/
+typedef struct TagEffortMapParam {
+  const unsigned char* pEffort;    ///< iMbWidth * iMbHeight EMbEffort in raster order, NULL: full effort everywhere
+  int                  iMbWidth;   ///< width of the map in macroblocks
+  int                  iMbHeight;  ///< height of the map in macroblocks
+} SEffortMapParam;
+
+/**
+* @brief Structure for ENCODER_OPTION_MOTION_ANALYSIS
+*        the motion decided by one encoder can be handed to the encoders of other bitrates of the same
+*        source through ENCODER_OPTION_MOTION_HINT, so that they skip most of their motion search;
+*        with the preprocessing results they also skip the scene change detection, the background detection,
+*        the adaptive quantization and the statistics of the video analysis wherever they compare the same
+*        source pictures, matched by their timestamps and their order of input
+*/
+typedef struct TagMotionAnalysis {
+  bool                 bEnable;    ///< [set] keep the motion of each encoded picture
+  const SMbMotionHint* pHints;     ///< [get only] motion of the highest spatial layer of the last picture, NULL if none; valid until the next EncodeFrame()
+  int                  iMbWidth;   ///< [get only] width of the map in macroblocks
+  int                  iMbHeight;  ///< [get only] height of the map in macroblocks
+  EVideoFrameType      eFrameType; ///< [get only] type of the picture, to align the key frames of the other encoders
+  long long            uiTimeStamp;///< [get only] timestamp of the picture
+  const void*          pPreprocess;     ///< [get only] preprocessing results of the highest spatial layer of the last picture, NULL if none; valid until the next EncodeFrame()
+  int                  iPreprocessSize; ///< [get only] bytes at pPreprocess
+} SMotionAnalysis;
+
 /**
 * @brief Structure for bit rate info
 */
@@ -691,6 +944,48 @@ typedef struct TagLevelInfo {
   int iLayer;
   ELevelIdc uiLevelIdc;            ///< the level info
 } SLevelInfo;
+
+/**
+* @brief Structure for the memory arena of the encoder, refer to ENCODER_OPTION_MEMORY_ARENA
+*/
+typedef struct TagMemoryArenaParam {
+  unsigned int uiArenaSize;     ///< bytes reserved up front, the blocks beyond are taken from the heap; 0: off, every block from the heap
+  bool         bHugePages;      ///< back the arena with huge pages where the system offers them
+  bool         bPrefault;       ///< touch the arena when reserved, so the pages are on the memory node of the initializing thread
+} SMemoryArenaParam;
+
+/**
+* @brief Structure for the resources kept over the resets of the encoder, refer to ENCODER_OPTION_RECONFIG_POOL
+*/
+typedef struct TagReconfigPoolParam {
+  int iMaxPicWidth;             ///< widest picture the encoder is reconfigured to; 0: off
+  int iMaxPicHeight;            ///< tallest picture the encoder is reconfigured to
+} SReconfigPoolParam;
+
+#define MAX_MEMORY_TAG_NUM      256
+
+/**
+* @brief Structure for the memory in use by the blocks allocated with one tag
+*/
+typedef struct TagMemoryTagUsage {
+  const char*  pTag;            ///< allocation tag; NULL for the tags beyond MAX_MEMORY_TAG_NUM - 1, summed in the last entry
+  unsigned int uiUsedBytes;     ///< bytes requested by the blocks in use
+  unsigned int uiPeakBytes;     ///< most bytes in use at once
+  unsigned int uiAllocCount;    ///< blocks allocated
+} SMemoryTagUsage;
+
+/**
+* @brief Structure for the memory in use by the encoder, refer to ENCODER_OPTION_GET_MEMORY_USAGE
+*/
+typedef struct TagMemoryUsage {
+  unsigned int    uiUsedBytes;                    ///< bytes taken by the blocks in use, with their alignment
+  unsigned int    uiArenaSize;                    ///< bytes of the arena; 0: not in the arena mode
+  unsigned int    uiArenaUsedBytes;               ///< bytes of the arena carved into blocks so far
+  unsigned int    uiArenaOverflowCount;           ///< blocks taken from the heap as the arena had no room
+  unsigned int    uiSharedBytes;                  ///< bytes of the read-only tables the encoder shares with the other encoders, not in uiUsedBytes
+  int             iTagNum;                        ///< entries of sTagUsage, 0: not in the arena mode
+  SMemoryTagUsage sTagUsage[MAX_MEMORY_TAG_NUM];
+} SMemoryUsage;
 /**
 * @brief Structure for dilivery status
 *
@@ -759,6 +1054,45 @@ typedef struct TagVideoEncoderStatistics {
   unsigned long iLastStatisticsFrameCount;
 } SEncoderStatistics;
 
+/**
+* @brief  Structure for the buffer statistics of the encoder, refer to ENCODER_OPTION_GET_BUFFER_STATISTICS
+*/
+typedef struct TagEncoderBufferStatistics {
+  unsigned int uiEncodingAllocCount;           ///< memory blocks allocated while encoding frames, refer to ENCODER_OPTION_PREALLOCATE_BUFFERS
+  unsigned int uiBufferReallocCount;           ///< times the slice, NAL or bitstream buffers were grown while encoding frames
+} SEncoderBufferStatistics;
+
+/**
+* @brief  Structure for the reset statistics of the encoder, refer to ENCODER_OPTION_GET_RECONFIG_STATISTICS
+*/
+typedef struct TagEncoderReconfigStatistics {
+  unsigned int uiReconfigCount;                ///< resets of the encoder for a parameter change, refer to ENCODER_OPTION_RECONFIG_POOL
+  unsigned int uiLastReconfigUs;               ///< time the last reset took in microseconds
+  unsigned int uiMaxReconfigUs;                ///< longest reset in microseconds
+} SEncoderReconfigStatistics;
+
+/**
+* @brief  Structure for the quality of one spatial layer, refer to ENCODER_OPTION_QUALITY_METRICS
+*/
+typedef struct TagLayerQualityMetrics {
+  bool  bMeasured;              ///< the layer was coded and measured in the last encoded frame; the values below are 0 otherwise
+  float fPsnrY;                 ///< PSNR of the reconstructed luma in dB
+  float fPsnrU;                 ///< PSNR of the reconstructed Cb in dB
+  float fPsnrV;                 ///< PSNR of the reconstructed Cr in dB
+  float fSsim;                  ///< SSIM of the reconstructed luma over the 8x8 blocks of the macroblock grid
+} SLayerQualityMetrics;
+
+/**
+* @brief  Structure for the quality of the last encoded frame, refer to ENCODER_OPTION_GET_QUALITY_METRICS
+*/
+typedef struct TagFrameQualityMetrics {
+  long long            uiTimeStamp;                             ///< time stamp of the frame
+  int                  iSpatialLayerNum;                        ///< entries of sLayerMetrics, indexed by the spatial id
+  SLayerQualityMetrics sLayerMetrics[MAX_SPATIAL_LAYER_NUM];
+  unsigned int         uiMeasuredFrameCount[MAX_SPATIAL_LAYER_NUM]; ///< frames of each layer measured since the encoder was initialized
+  SLayerQualityMetrics sLayerAverage[MAX_SPATIAL_LAYER_NUM];        ///< average of the values over those frames
+} SFrameQualityMetrics;
+
 /**
 * @brief  Structure for decoder statistics
 */
@@ -58,6 +58,7 @@ typedef enum {
   videoFormatInternal   = 25,            ///< only used in SVC decoder testbed
 
   videoFormatNV12       = 26,            ///< new format for output by DXVA decoding
+  videoFormatNV21       = 29,            ///< y planar + vu packed, as NV12 with the chroma order swapped
 
   videoFormatVFlip      = 0x80000000
 } EVideoFormatType;
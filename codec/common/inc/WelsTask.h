@@ -41,10 +41,30 @@
 #ifndef _WELS_TASK_H_
 #define _WELS_TASK_H_
 
+#include "typedefs.h"
 #include "codec_def.h"
 
 namespace WelsCommon {
 
+/*
+ *  scheduling class of a task group, tasks of a lower value are dispatched first
+ */
+enum EWelsTaskPriority {
+  WELS_TASK_PRIORITY_HIGH = 0,
+  WELS_TASK_PRIORITY_NORMAL,
+  WELS_TASK_PRIORITY_LOW,
+  WELS_TASK_PRIORITY_NUM
+};
+
+/*
+ *  scheduling attributes shared by all tasks of one thread pool client (e.g. one encoder instance)
+ */
+typedef struct TagWelsTaskGroup {
+  int iPriority;        // EWelsTaskPriority
+  int iMaxRunningNum;   // maximal number of tasks of the group running at the same time, 0: no limit
+  int iRunningNum;      // number of tasks of the group running currently, maintained by the thread pool
+} SWelsTaskGroup;
+
 class IWelsTaskSink {
  public:
   virtual int OnTaskExecuted() = 0;
@@ -55,6 +75,7 @@ class IWelsTask {
  public:
   IWelsTask (IWelsTaskSink* pSink) {
     m_pSink = pSink;
+    m_pGroup = NULL;
   };
   virtual ~IWelsTask() { }
 
@@ -64,8 +85,17 @@ class IWelsTask {
     return m_pSink;
   };
 
+  void SetGroup (SWelsTaskGroup* pGroup) {
+    m_pGroup = pGroup;
+  };
+
+  SWelsTaskGroup* GetGroup() {
+    return m_pGroup;
+  };
+
  protected:
   IWelsTaskSink*   m_pSink;
+  SWelsTaskGroup*  m_pGroup;
 };
 
 }
@@ -54,9 +54,12 @@ class  CWelsThreadPool : public CWelsThread, public IWelsTaskThreadSink {
  public:
   enum {
     DEFAULT_THREAD_NUM = 4,
+    PRIORITY_AGING_NUM = 8,   // dispatches a class with waiting tasks can be passed over before it is served first
   };
 
   static WELS_THREAD_ERROR_CODE SetThreadNum (int32_t iMaxThreadNum);
+  static WELS_THREAD_ERROR_CODE SetFixedThreadNum (int32_t iThreadNum);
+  static bool IsThreadNumFixed();
 
   static CWelsThreadPool* AddReference();
   void RemoveInstance();
@@ -79,6 +82,7 @@ class  CWelsThreadPool : public CWelsThread, public IWelsTaskThreadSink {
  protected:
   WELS_THREAD_ERROR_CODE Init();
   WELS_THREAD_ERROR_CODE Uninit();
+  WELS_THREAD_ERROR_CODE IncreaseThreadNum (int32_t iThreadNum);
 
   WELS_THREAD_ERROR_CODE CreateIdleThread();
   void           DestroyThread (CWelsTaskThread* pThread);
@@ -88,22 +92,27 @@ class  CWelsThreadPool : public CWelsThread, public IWelsTaskThreadSink {
   bool           AddTaskToWaitedList (IWelsTask* pTask);
   CWelsTaskThread*   GetIdleThread();
   IWelsTask*         GetWaitedTask();
+  IWelsTask*         PopWaitedTask (int32_t iPriority);
   int32_t            GetIdleThreadNum();
   int32_t            GetBusyThreadNum();
   int32_t            GetWaitedTaskNum();
   void               ClearWaitedTasks();
+  bool               AcquireGroupSlot (IWelsTask* pTask);
+  void               ReleaseGroupSlot (IWelsTask* pTask);
 
  private:
   CWelsThreadPool();
   virtual ~CWelsThreadPool();
-  
+
   WELS_THREAD_ERROR_CODE StopAllRunning();
 
   static int32_t   m_iRefCount;
   static int32_t   m_iMaxThreadNum;
   static CWelsThreadPool* m_pThreadPoolSelf;
+  static bool      m_bThreadNumFixed;
 
-  CWelsNonDuplicatedList<IWelsTask>* m_cWaitedTasks;
+  CWelsNonDuplicatedList<IWelsTask>* m_cWaitedTasks[WELS_TASK_PRIORITY_NUM];
+  int32_t     m_iPassedOverNum[WELS_TASK_PRIORITY_NUM];
   CWelsNonDuplicatedList<CWelsTaskThread>* m_cIdleThreads;
   CWelsList<CWelsTaskThread>* m_cBusyThreads;
 
@@ -111,6 +120,7 @@ class  CWelsThreadPool : public CWelsThread, public IWelsTaskThreadSink {
   CWelsLock   m_cLockWaitedTasks;
   CWelsLock   m_cLockIdleTasks;
   CWelsLock   m_cLockBusyTasks;
+  CWelsLock   m_cLockTaskGroups;
 
   DISALLOW_COPY_AND_ASSIGN (CWelsThreadPool);
 };
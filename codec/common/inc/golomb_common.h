@@ -50,6 +50,10 @@ namespace WelsCommon {
         (ptr)[2] = (val) >>  8; \
         (ptr)[3] = (val) >>  0; \
     } while (0)
+#define WRITE_BE_64(ptr, val) do { \
+        WRITE_BE_32 ((ptr), (uint32_t) ((val) >> 32)); \
+        WRITE_BE_32 ((ptr) + 4, (uint32_t) (val)); \
+    } while (0)
 /************************************************************************/
 /* GOLOMB CODIMG FOR WELS COMMON                                        */
 /************************************************************************/
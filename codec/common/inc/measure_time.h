@@ -81,6 +81,35 @@ static inline int64_t WelsTime (void) {
 #endif//_WIN32
 }
 
+/*!
+ * \brief   fine grained time measure for profiling
+ * \param   void
+ * \return  time elapsed since an unspecified point (unit: nanosecond)
+ */
+
+static inline int64_t WelsTimeNs (void) {
+#ifndef _WIN32
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts_date;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts_date);
+  return ((int64_t) ts_date.tv_sec * 1000000000 + (int64_t) ts_date.tv_nsec);
+#else
+  return WelsTime() * 1000;
+#endif//CLOCK_MONOTONIC
+#else
+  static int64_t iMtimeFreq = 0;
+  int64_t iMtimeCur = 0;
+  if (!iMtimeFreq) {
+    QueryPerformanceFrequency ((LARGE_INTEGER*)&iMtimeFreq);
+    if (!iMtimeFreq)
+      iMtimeFreq = 1;
+  }
+  QueryPerformanceCounter ((LARGE_INTEGER*)&iMtimeCur);
+  return (int64_t) ((double)iMtimeCur * 1e9 / (double)iMtimeFreq);
+#endif//_WIN32
+}
+
 #ifdef __cplusplus
 }
 #endif
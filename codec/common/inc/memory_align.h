@@ -51,9 +51,35 @@
 
 namespace WelsCommon {
 
+#define MEMORY_TAG_NUM_MAX              256     // tags accounted in the arena mode, the later ones are summed in the last
+#define MEMORY_ARENA_SIZE_CLASS_NUM     32      // free lists of the arena, by log2 of the block size
+
+enum {
+  MEMORY_ARENA_HUGE_PAGES = 0x01,   // back the arena with huge pages where the system offers them
+  MEMORY_ARENA_PREFAULT   = 0x02    // touch the arena when reserved, so it is placed on the node of the creating thread
+};
+
+/*
+ *  memory in use by the blocks allocated with one tag, arena mode only
+ */
+typedef struct TagMemoryTagStat {
+  const char*   pTag;               // NULL for the tags beyond MEMORY_TAG_NUM_MAX - 1
+  uint32_t      uiUsedBytes;        // sizes requested by the blocks in use
+  uint32_t      uiPeakBytes;
+  uint32_t      uiAllocCount;
+} SMemoryTagStat;
+
+typedef struct TagArenaFreeBlock {
+  struct TagArenaFreeBlock* pNext;
+  uint32_t      uiBlockSize;
+} SArenaFreeBlock;
+
 class CMemoryAlign {
  public:
 CMemoryAlign (const uint32_t kuiCacheLineSize);
+// arena mode: the blocks are carved from one reservation of kuiArenaSize bytes, freed blocks are kept in
+// size-class lists for the next requests, and the memory is accounted per tag; the heap is used once it is full
+CMemoryAlign (const uint32_t kuiCacheLineSize, const uint32_t kuiArenaSize, const uint32_t kuiArenaFlags);
 virtual ~CMemoryAlign();
 
 void* WelsMallocz (const uint32_t kuiSize, const char* kpTag);
@@ -61,18 +87,45 @@ void* WelsMalloc (const uint32_t kuiSize, const char* kpTag);
 void WelsFree (void* pPointer, const char* kpTag);
 const uint32_t WelsGetCacheLineSize() const;
 const uint32_t WelsGetMemoryUsage() const;
+const uint32_t WelsGetMemoryAllocCount() const;
+const uint32_t WelsGetArenaSize() const;
+const uint32_t WelsGetArenaUsedBytes() const;
+const uint32_t WelsGetArenaOverflowCount() const;
+const int32_t WelsGetMemoryTagNum() const;
+const SMemoryTagStat* WelsGetMemoryTagStat (const int32_t kiIndex) const;
+// gives the whole arena back at once for the next blocks; only when no block of the arena mode is in use
+bool WelsArenaRewind();
 
  private:
 // private copy & assign constructors adding to fix klocwork scan issues
 CMemoryAlign (const CMemoryAlign& kcMa);
 CMemoryAlign& operator= (const CMemoryAlign& kcMa);
 
+void InitArena (const uint32_t kuiArenaSize, const uint32_t kuiArenaFlags);
+void* ArenaMalloc (const uint32_t kuiSize, const char* kpTag);
+void ArenaFree (void* pPointer);
+uint8_t* ArenaTakeBlock (const uint32_t kuiBlockSize, uint32_t& uiTakenSize);
+void ArenaPutBlock (uint8_t* pBlock, const uint32_t kuiBlockSize);
+int32_t GetMemoryTagIndex (const char* kpTag);
+
  protected:
 uint32_t        m_nCacheLineSize;
 
 #ifdef MEMORY_MONITOR
 uint32_t        m_nMemoryUsageInBytes;
+uint32_t        m_nMemoryAllocCount;
 #endif//MEMORY_MONITOR
+
+SMemoryTagStat* m_pMemoryTagStat;   // NULL: not in the arena mode
+int32_t         m_iMemoryTagNum;
+uint8_t*        m_pArena;           // NULL: blocks taken from the heap one by one
+void*           m_pArenaMapping;    // reservation the arena is aligned in
+uint32_t        m_uiArenaMappingSize;
+bool            m_bArenaMapped;
+uint32_t        m_uiArenaSize;
+uint32_t        m_uiArenaPos;       // bytes of the arena carved so far
+uint32_t        m_uiArenaOverflowCount;
+SArenaFreeBlock* m_pArenaFreeList[MEMORY_ARENA_SIZE_CLASS_NUM];
 };
 
 /*!
@@ -55,6 +55,27 @@ void WelsSampleSadFour4x4_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSamp
 void WelsSampleSadFour8x4_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSample2, int32_t iStride2, int32_t* pSad);
 void WelsSampleSadFour4x8_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSample2, int32_t iStride2, int32_t* pSad);
 
+// SADs of iNum (> 0) 8x8 blocks side by side, pSad[i] for the block at the column 8 * i
+void WelsSampleSad8x8Row_c (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2, int32_t iNum,
+                            int32_t* pSad);
+
+// SAD of one block against iNum (up to SAD_MULTI_MAX_CANDIDATE) reference positions, pCost[i] = SAD + pBaseCost[i]
+#define SAD_MULTI_MAX_CANDIDATE 16
+void WelsSampleSadMulti16x16_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                                const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+void WelsSampleSadMulti16x8_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                               const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+void WelsSampleSadMulti8x16_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                               const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+void WelsSampleSadMulti8x8_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                              const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+void WelsSampleSadMulti4x4_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                              const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+void WelsSampleSadMulti8x4_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                              const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+void WelsSampleSadMulti4x8_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                              const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+
 #if defined(__cplusplus)
 extern "C" {
 #endif//__cplusplus
@@ -72,6 +93,17 @@ void WelsSampleSadFour16x8_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*)
 void WelsSampleSadFour8x16_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
 void WelsSampleSadFour8x8_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
 void WelsSampleSadFour4x4_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
+void WelsSampleSad8x8Row_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t, int32_t*);
+
+void WelsSampleSadMulti16x16_sse2 (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+void WelsSampleSadMulti16x8_sse2 (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+void WelsSampleSadMulti8x16_sse2 (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+void WelsSampleSadMulti8x8_sse2 (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+void WelsSampleSadMulti4x4_sse2 (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+#ifdef HAVE_AVX2
+void WelsSampleSadMulti16x16_avx2 (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+void WelsSampleSadMulti16x8_avx2 (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+#endif
 
 #endif//X86_ASM
 
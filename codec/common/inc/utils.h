@@ -91,5 +91,10 @@ float WelsCalcPsnr (const void* kpTarPic,
                     const int32_t kiWidth,
                     const int32_t kiHeight);
 
+/*!
+ * \brief   PSNR of a picture from its squared error, 99.99 for a lossless picture
+ */
+float WelsCalcPsnrFromSse (const int64_t kiSqe, const int32_t kiWidth, const int32_t kiHeight);
+
 
 #endif//WELS_UTILS_H__
@@ -55,9 +55,14 @@ CWelsLock& GetInitLock() {
 int32_t CWelsThreadPool::m_iRefCount = 0;
 int32_t CWelsThreadPool::m_iMaxThreadNum = DEFAULT_THREAD_NUM;
 CWelsThreadPool* CWelsThreadPool::m_pThreadPoolSelf = NULL;
+bool CWelsThreadPool::m_bThreadNumFixed = false;
 
 CWelsThreadPool::CWelsThreadPool() :
-  m_cWaitedTasks (NULL), m_cIdleThreads (NULL), m_cBusyThreads (NULL) {
+  m_cIdleThreads (NULL), m_cBusyThreads (NULL) {
+  for (int32_t i = 0; i < WELS_TASK_PRIORITY_NUM; i++) {
+    m_cWaitedTasks[i] = NULL;
+    m_iPassedOverNum[i] = 0;
+  }
 }
 
 
@@ -72,7 +77,7 @@ CWelsThreadPool::~CWelsThreadPool() {
 WELS_THREAD_ERROR_CODE CWelsThreadPool::SetThreadNum (int32_t iMaxThreadNum) {
   CWelsAutoLock  cLock (GetInitLock());
 
-  if (m_iRefCount != 0) {
+  if (m_iRefCount != 0 || m_bThreadNumFixed) {
     return WELS_THREAD_ERROR_GENERAL;
   }
 
@@ -83,6 +88,35 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::SetThreadNum (int32_t iMaxThreadNum) {
   return WELS_THREAD_ERROR_OK;
 }
 
+// the pool size is owned by the application from now on, SetThreadNum() from clients will not change it;
+// a pool in use can only grow, the threads are created at once. iThreadNum <= 0 gives the size back to the clients
+WELS_THREAD_ERROR_CODE CWelsThreadPool::SetFixedThreadNum (int32_t iThreadNum) {
+  CWelsAutoLock  cLock (GetInitLock());
+
+  if (iThreadNum <= 0) {
+    m_bThreadNumFixed = false;
+    return WELS_THREAD_ERROR_OK;
+  }
+
+  if (m_iRefCount != 0 && m_pThreadPoolSelf) {
+    if (iThreadNum < m_iMaxThreadNum) {
+      return WELS_THREAD_ERROR_GENERAL;
+    }
+    if (WELS_THREAD_ERROR_OK != m_pThreadPoolSelf->IncreaseThreadNum (iThreadNum)) {
+      return WELS_THREAD_ERROR_GENERAL;
+    }
+  }
+
+  m_iMaxThreadNum = iThreadNum;
+  m_bThreadNumFixed = true;
+  return WELS_THREAD_ERROR_OK;
+}
+
+bool CWelsThreadPool::IsThreadNumFixed() {
+  CWelsAutoLock  cLock (GetInitLock());
+  return m_bThreadNumFixed;
+}
+
 
 CWelsThreadPool* CWelsThreadPool::AddReference() {
   CWelsAutoLock  cLock (GetInitLock());
@@ -141,6 +175,7 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::OnTaskStop (CWelsTaskThread* pThread, IW
   //fprintf(stdout, "CWelsThreadPool::OnTaskStop 0: Task %x at Thread %x Finished\n", pTask, pThread);
 
   RemoveThreadFromBusyList (pThread);
+  ReleaseGroupSlot (pTask);
   AddThreadToIdleQueue (pThread);
 
   if (pTask && pTask->GetSink()) {
@@ -164,10 +199,15 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::Init() {
 
   CWelsAutoLock  cLock (m_cLockPool);
 
-  m_cWaitedTasks = new CWelsNonDuplicatedList<IWelsTask>();
+  for (int32_t i = 0; i < WELS_TASK_PRIORITY_NUM; i++) {
+    m_cWaitedTasks[i] = new CWelsNonDuplicatedList<IWelsTask>();
+    if (NULL == m_cWaitedTasks[i]) {
+      return WELS_THREAD_ERROR_GENERAL;
+    }
+  }
   m_cIdleThreads = new CWelsNonDuplicatedList<CWelsTaskThread>();
   m_cBusyThreads = new CWelsList<CWelsTaskThread>();
-  if (NULL == m_cWaitedTasks || NULL == m_cIdleThreads || NULL == m_cBusyThreads) {
+  if (NULL == m_cIdleThreads || NULL == m_cBusyThreads) {
     return WELS_THREAD_ERROR_GENERAL;
   }
 
@@ -184,6 +224,21 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::Init() {
   return WELS_THREAD_ERROR_OK;
 }
 
+WELS_THREAD_ERROR_CODE CWelsThreadPool::IncreaseThreadNum (int32_t iThreadNum) {
+  CWelsAutoLock  cLock (m_cLockPool);
+
+  for (int32_t i = m_iMaxThreadNum; i < iThreadNum; i++) {
+    if (WELS_THREAD_ERROR_OK != CreateIdleThread()) {
+      return WELS_THREAD_ERROR_GENERAL;
+    }
+    // keep the count in line with the threads created, StopAllRunning() relies on it
+    m_iMaxThreadNum = i + 1;
+  }
+
+  SignalThread();
+  return WELS_THREAD_ERROR_OK;
+}
+
 WELS_THREAD_ERROR_CODE CWelsThreadPool::StopAllRunning() {
   WELS_THREAD_ERROR_CODE iReturn = WELS_THREAD_ERROR_OK;
 
@@ -219,7 +274,9 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::Uninit() {
 
   Kill();
 
-  WELS_DELETE_OP (m_cWaitedTasks);
+  for (int32_t i = 0; i < WELS_TASK_PRIORITY_NUM; i++) {
+    WELS_DELETE_OP (m_cWaitedTasks[i]);
+  }
   WELS_DELETE_OP (m_cIdleThreads);
   WELS_DELETE_OP (m_cBusyThreads);
 
@@ -243,7 +300,9 @@ void CWelsThreadPool::ExecuteTask() {
     if (pTask) {
       pThread->SetTask (pTask);
     } else {
+      // all waiting tasks belong to groups running at their limit, wait for OnTaskStop()
       AddThreadToIdleQueue (pThread);
+      break;
     }
   }
 }
@@ -256,10 +315,13 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::QueueTask (IWelsTask* pTask) {
     CWelsTaskThread* pThread = GetIdleThread();
 
     if (pThread != NULL) {
-      //fprintf(stdout, "ThreadPool:  ExecuteTask = %x at thread %x\n", pTask, pThread);
-      pThread->SetTask (pTask);
+      if (AcquireGroupSlot (pTask)) {
+        //fprintf(stdout, "ThreadPool:  ExecuteTask = %x at thread %x\n", pTask, pThread);
+        pThread->SetTask (pTask);
 
-      return WELS_THREAD_ERROR_OK;
+        return WELS_THREAD_ERROR_OK;
+      }
+      AddThreadToIdleQueue (pThread);
     }
   }
   //fprintf(stdout, "ThreadPool:  AddTaskToWaitedList: %x\n", pTask);
@@ -319,7 +381,32 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::RemoveThreadFromBusyList (CWelsTaskThrea
 bool  CWelsThreadPool::AddTaskToWaitedList (IWelsTask* pTask) {
   CWelsAutoLock  cLock (m_cLockWaitedTasks);
 
-  return m_cWaitedTasks->push_back (pTask);
+  const int32_t kiPriority = pTask->GetGroup() ? WELS_CLIP3 (pTask->GetGroup()->iPriority, WELS_TASK_PRIORITY_HIGH,
+                             WELS_TASK_PRIORITY_LOW) : WELS_TASK_PRIORITY_NORMAL;
+  return m_cWaitedTasks[kiPriority]->push_back (pTask);
+}
+
+// counts one more running task in the group of pTask, fails if the group reached its limit
+bool  CWelsThreadPool::AcquireGroupSlot (IWelsTask* pTask) {
+  CWelsAutoLock  cLock (m_cLockTaskGroups);
+  SWelsTaskGroup* pGroup = pTask->GetGroup();
+
+  if (NULL == pGroup) {
+    return true;
+  }
+  if (pGroup->iMaxRunningNum > 0 && pGroup->iRunningNum >= pGroup->iMaxRunningNum) {
+    return false;
+  }
+  pGroup->iRunningNum ++;
+  return true;
+}
+
+void  CWelsThreadPool::ReleaseGroupSlot (IWelsTask* pTask) {
+  CWelsAutoLock  cLock (m_cLockTaskGroups);
+
+  if (pTask && pTask->GetGroup() && pTask->GetGroup()->iRunningNum > 0) {
+    pTask->GetGroup()->iRunningNum --;
+  }
 }
 
 CWelsTaskThread*   CWelsThreadPool::GetIdleThread() {
@@ -345,35 +432,82 @@ int32_t  CWelsThreadPool::GetIdleThreadNum() {
 }
 
 int32_t  CWelsThreadPool::GetWaitedTaskNum() {
-  return (m_cWaitedTasks?m_cWaitedTasks->size():0);
+  int32_t iNum = 0;
+  for (int32_t i = 0; i < WELS_TASK_PRIORITY_NUM; i++) {
+    iNum += (m_cWaitedTasks[i] ? m_cWaitedTasks[i]->size() : 0);
+  }
+  return iNum;
 }
 
+// the first task of the highest priority whose group is still below its running limit; a class passed over
+// PRIORITY_AGING_NUM times while it had waiting tasks is served first, so a sustained load of higher classes
+// can not starve it
 IWelsTask* CWelsThreadPool::GetWaitedTask() {
   CWelsAutoLock lock (m_cLockWaitedTasks);
 
-  if (NULL==m_cWaitedTasks || m_cWaitedTasks->size() == 0) {
+  IWelsTask* pTask = NULL;
+  int32_t iPriority;
+  for (iPriority = WELS_TASK_PRIORITY_NUM - 1; iPriority > 0; iPriority--) {
+    if (m_iPassedOverNum[iPriority] >= PRIORITY_AGING_NUM) {
+      pTask = PopWaitedTask (iPriority);
+      if (pTask) {
+        break;
+      }
+    }
+  }
+  if (NULL == pTask) {
+    for (iPriority = 0; iPriority < WELS_TASK_PRIORITY_NUM; iPriority++) {
+      pTask = PopWaitedTask (iPriority);
+      if (pTask) {
+        break;
+      }
+    }
+  }
+  if (NULL == pTask) {
     return NULL;
   }
 
-  IWelsTask* pTask = m_cWaitedTasks->begin();
-
-  m_cWaitedTasks->pop_front();
-
+  m_iPassedOverNum[iPriority] = 0;
+  for (int32_t i = iPriority + 1; i < WELS_TASK_PRIORITY_NUM; i++) {
+    if (m_cWaitedTasks[i] && m_cWaitedTasks[i]->size() > 0) {
+      m_iPassedOverNum[i] ++;
+    }
+  }
   return pTask;
 }
 
+// removes and returns the first task of the class whose group is still below its running limit
+IWelsTask* CWelsThreadPool::PopWaitedTask (int32_t iPriority) {
+  CWelsNonDuplicatedList<IWelsTask>* pWaitedTasks = m_cWaitedTasks[iPriority];
+  if (NULL == pWaitedTasks) {
+    return NULL;
+  }
+  const int32_t kiTaskNum = pWaitedTasks->size();
+  for (int32_t iIdx = 0; iIdx < kiTaskNum; iIdx++) {
+    IWelsTask* pTask = pWaitedTasks->getNode (iIdx);
+    if (pTask && AcquireGroupSlot (pTask)) {
+      pWaitedTasks->erase (pTask);
+      return pTask;
+    }
+  }
+  return NULL;
+}
+
 void  CWelsThreadPool::ClearWaitedTasks() {
   CWelsAutoLock cLock (m_cLockWaitedTasks);
-  if (NULL == m_cWaitedTasks) {
-    return;
-  }
   IWelsTask* pTask = NULL;
-  while (0 != m_cWaitedTasks->size()) {
-    pTask = m_cWaitedTasks->begin();
-    if (pTask->GetSink()) {
-      pTask->GetSink()->OnTaskCancelled();
+  for (int32_t i = 0; i < WELS_TASK_PRIORITY_NUM; i++) {
+    m_iPassedOverNum[i] = 0;
+    if (NULL == m_cWaitedTasks[i]) {
+      continue;
+    }
+    while (0 != m_cWaitedTasks[i]->size()) {
+      pTask = m_cWaitedTasks[i]->begin();
+      if (pTask->GetSink()) {
+        pTask->GetSink()->OnTaskCancelled();
+      }
+      m_cWaitedTasks[i]->pop_front();
     }
-    m_cWaitedTasks->pop_front();
   }
 }
 
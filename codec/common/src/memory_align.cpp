@@ -32,9 +32,14 @@
 
 #include <stdlib.h>
 #include <string.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif//__linux__
 #include "memory_align.h"
 #include "macros.h"
 
+#define MEMORY_ARENA_HUGE_PAGE_SIZE     (2 * 1024 * 1024)
+
 namespace WelsCommon {
 
 #ifdef MEMORY_CHECK
@@ -46,19 +51,228 @@ static int32_t  g_iMemoryLength;
 
 CMemoryAlign::CMemoryAlign (const uint32_t kuiCacheLineSize)
 #ifdef MEMORY_MONITOR
-  : m_nMemoryUsageInBytes (0)
+  : m_nMemoryUsageInBytes (0),
+    m_nMemoryAllocCount (0)
 #endif//MEMORY_MONITOR
 {
   if ((kuiCacheLineSize == 0) || (kuiCacheLineSize & 0x0f))
     m_nCacheLineSize = 0x10;
   else
     m_nCacheLineSize = kuiCacheLineSize;
+  InitArena (0, 0);
+}
+
+CMemoryAlign::CMemoryAlign (const uint32_t kuiCacheLineSize, const uint32_t kuiArenaSize,
+                            const uint32_t kuiArenaFlags)
+#ifdef MEMORY_MONITOR
+  : m_nMemoryUsageInBytes (0),
+    m_nMemoryAllocCount (0)
+#endif//MEMORY_MONITOR
+{
+  if ((kuiCacheLineSize == 0) || (kuiCacheLineSize & 0x0f))
+    m_nCacheLineSize = 0x10;
+  else
+    m_nCacheLineSize = kuiCacheLineSize;
+  InitArena (kuiArenaSize, kuiArenaFlags);
 }
 
 CMemoryAlign::~CMemoryAlign() {
 #ifdef MEMORY_MONITOR
   assert (m_nMemoryUsageInBytes == 0);
 #endif//MEMORY_MONITOR
+#if defined(__linux__)
+  if (m_bArenaMapped)
+    munmap (m_pArenaMapping, m_uiArenaMappingSize);
+  else
+#endif
+    free (m_pArenaMapping);
+  free (m_pMemoryTagStat);
+}
+
+void CMemoryAlign::InitArena (const uint32_t kuiArenaSize, const uint32_t kuiArenaFlags) {
+  m_pMemoryTagStat        = NULL;
+  m_iMemoryTagNum         = 0;
+  m_pArena                = NULL;
+  m_pArenaMapping         = NULL;
+  m_uiArenaMappingSize    = 0;
+  m_bArenaMapped          = false;
+  m_uiArenaSize           = 0;
+  m_uiArenaPos            = 0;
+  m_uiArenaOverflowCount  = 0;
+  memset (m_pArenaFreeList, 0, sizeof (m_pArenaFreeList));
+  if (0 == kuiArenaSize)
+    return;
+
+  m_pMemoryTagStat = (SMemoryTagStat*) calloc (MEMORY_TAG_NUM_MAX, sizeof (SMemoryTagStat));
+  if (NULL == m_pMemoryTagStat)
+    return;
+
+  const uint32_t kuiSize = WELS_ALIGN (kuiArenaSize, m_nCacheLineSize);
+  uint32_t uiAlign = m_nCacheLineSize;
+#if defined(__linux__)
+  // transparent huge pages only back the 2MB aligned parts of the mapping
+  if (kuiArenaFlags & MEMORY_ARENA_HUGE_PAGES)
+    uiAlign = WELS_MAX (uiAlign, MEMORY_ARENA_HUGE_PAGE_SIZE);
+  m_uiArenaMappingSize = kuiSize + uiAlign;
+  m_pArenaMapping = mmap (NULL, m_uiArenaMappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == m_pArenaMapping) {
+    m_pArenaMapping = NULL;
+  } else {
+    m_bArenaMapped = true;
+#if defined(MADV_HUGEPAGE)
+    if (kuiArenaFlags & MEMORY_ARENA_HUGE_PAGES)
+      madvise (m_pArenaMapping, m_uiArenaMappingSize, MADV_HUGEPAGE);
+#endif//MADV_HUGEPAGE
+  }
+#endif//__linux__
+  if (NULL == m_pArenaMapping) {
+    uiAlign = m_nCacheLineSize;
+    m_uiArenaMappingSize = kuiSize + uiAlign;
+    m_pArenaMapping = malloc (m_uiArenaMappingSize);
+    if (NULL == m_pArenaMapping)
+      return; // accounted, with the blocks from the heap
+  }
+  m_pArena = (uint8_t*) m_pArenaMapping + uiAlign - 1;
+  m_pArena -= ((uintptr_t) m_pArena & (uiAlign - 1));
+  m_uiArenaSize = kuiSize;
+  // the pages are placed on the memory node of the thread touching them first
+  if (kuiArenaFlags & MEMORY_ARENA_PREFAULT)
+    memset (m_pArena, 0, m_uiArenaSize);
+}
+
+// blocks of the arena mode, from the arena or from the heap once it is full, have a header of one cache line:
+// [tag index][requested size][block size of the arena, or pointer given by malloc] followed by the aligned data
+static inline int32_t* ArenaHeaderTag (void* pPointer) {
+  return (int32_t*) ((uint8_t*)pPointer - sizeof (void*) - 2 * sizeof (int32_t));
+}
+static inline int32_t* ArenaHeaderSize (void* pPointer) {
+  return (int32_t*) ((uint8_t*)pPointer - sizeof (void*) - sizeof (int32_t));
+}
+static inline void** ArenaHeaderBlock (void* pPointer) {
+  return (void**) ((uint8_t*)pPointer - sizeof (void*));
+}
+
+static inline int32_t ArenaSizeClass (uint32_t uiBlockSize) {
+  int32_t iClass = 0;
+  while (uiBlockSize >>= 1)
+    ++ iClass;
+  return iClass;
+}
+
+int32_t CMemoryAlign::GetMemoryTagIndex (const char* kpTag) {
+  for (int32_t i = 0; i < m_iMemoryTagNum; i++) {
+    const char* kpCurTag = m_pMemoryTagStat[i].pTag;
+    if (kpCurTag == kpTag || (kpCurTag != NULL && kpTag != NULL && 0 == strcmp (kpCurTag, kpTag)))
+      return i;
+  }
+  if (m_iMemoryTagNum == MEMORY_TAG_NUM_MAX - 1) {
+    m_pMemoryTagStat[m_iMemoryTagNum ++].pTag = NULL;
+    return m_iMemoryTagNum - 1;
+  } else if (m_iMemoryTagNum == MEMORY_TAG_NUM_MAX) {
+    return MEMORY_TAG_NUM_MAX - 1;
+  }
+  m_pMemoryTagStat[m_iMemoryTagNum].pTag = kpTag;
+  return m_iMemoryTagNum ++;
+}
+
+void CMemoryAlign::ArenaPutBlock (uint8_t* pBlock, const uint32_t kuiBlockSize) {
+  // given back to the end of the carved part, otherwise kept for the requests of its size class
+  if (pBlock + kuiBlockSize == m_pArena + m_uiArenaPos) {
+    m_uiArenaPos -= kuiBlockSize;
+    return;
+  }
+  SArenaFreeBlock* pFreeBlock = (SArenaFreeBlock*)pBlock;
+  const int32_t kiClass = ArenaSizeClass (kuiBlockSize);
+  pFreeBlock->uiBlockSize = kuiBlockSize;
+  pFreeBlock->pNext = m_pArenaFreeList[kiClass];
+  m_pArenaFreeList[kiClass] = pFreeBlock;
+}
+
+uint8_t* CMemoryAlign::ArenaTakeBlock (const uint32_t kuiBlockSize, uint32_t& uiTakenSize) {
+  const int32_t kiClass = ArenaSizeClass (kuiBlockSize);
+  // first fit in the size class
+  for (SArenaFreeBlock** ppFreeBlock = &m_pArenaFreeList[kiClass]; *ppFreeBlock != NULL;
+       ppFreeBlock = & (*ppFreeBlock)->pNext) {
+    if ((*ppFreeBlock)->uiBlockSize >= kuiBlockSize) {
+      SArenaFreeBlock* pFreeBlock = *ppFreeBlock;
+      *ppFreeBlock = pFreeBlock->pNext;
+      uiTakenSize = pFreeBlock->uiBlockSize;
+      return (uint8_t*)pFreeBlock;
+    }
+  }
+  if (m_uiArenaSize - m_uiArenaPos >= kuiBlockSize) {
+    uint8_t* pBlock = m_pArena + m_uiArenaPos;
+    m_uiArenaPos += kuiBlockSize;
+    uiTakenSize = kuiBlockSize;
+    return pBlock;
+  }
+  // split a block of a larger class
+  for (int32_t iClass = kiClass + 1; iClass < MEMORY_ARENA_SIZE_CLASS_NUM; iClass++) {
+    SArenaFreeBlock* pFreeBlock = m_pArenaFreeList[iClass];
+    if (pFreeBlock != NULL) {
+      m_pArenaFreeList[iClass] = pFreeBlock->pNext;
+      uiTakenSize = pFreeBlock->uiBlockSize;
+      if (uiTakenSize - kuiBlockSize >= (m_nCacheLineSize << 2)) {
+        ArenaPutBlock ((uint8_t*)pFreeBlock + kuiBlockSize, uiTakenSize - kuiBlockSize);
+        uiTakenSize = kuiBlockSize;
+      }
+      return (uint8_t*)pFreeBlock;
+    }
+  }
+  return NULL;
+}
+
+void* CMemoryAlign::ArenaMalloc (const uint32_t kuiSize, const char* kpTag) {
+  const uint32_t kuiHeaderSize = m_nCacheLineSize;
+  const uint32_t kuiBlockSize = kuiHeaderSize + WELS_ALIGN (kuiSize, m_nCacheLineSize);
+  if (kuiSize > kuiBlockSize) // wrapped around
+    return NULL;
+
+  uint32_t uiTakenSize = 0;
+  uint8_t* pBlock = (NULL != m_pArena) ? ArenaTakeBlock (kuiBlockSize, uiTakenSize) : NULL;
+  uint8_t* pPointer = NULL;
+  if (NULL != pBlock) {
+    pPointer = pBlock + kuiHeaderSize;
+    *ArenaHeaderBlock (pPointer) = (void*) (uintptr_t)uiTakenSize;
+  } else {
+    uiTakenSize = kuiBlockSize + m_nCacheLineSize - 1;
+    uint8_t* pBuf = (uint8_t*)malloc (uiTakenSize);
+    if (NULL == pBuf)
+      return NULL;
+    pPointer = pBuf + kuiHeaderSize + m_nCacheLineSize - 1;
+    pPointer -= ((uintptr_t)pPointer & (m_nCacheLineSize - 1));
+    *ArenaHeaderBlock (pPointer) = pBuf;
+    ++ m_uiArenaOverflowCount;
+  }
+  const int32_t kiTagIdx = GetMemoryTagIndex (kpTag);
+  SMemoryTagStat* pTagStat = &m_pMemoryTagStat[kiTagIdx];
+  pTagStat->uiUsedBytes += kuiSize;
+  pTagStat->uiPeakBytes = WELS_MAX (pTagStat->uiPeakBytes, pTagStat->uiUsedBytes);
+  ++ pTagStat->uiAllocCount;
+  *ArenaHeaderTag (pPointer) = kiTagIdx;
+  *ArenaHeaderSize (pPointer) = kuiSize;
+#ifdef MEMORY_MONITOR
+  m_nMemoryUsageInBytes += uiTakenSize;
+  ++ m_nMemoryAllocCount;
+#endif//MEMORY_MONITOR
+  return pPointer;
+}
+
+void CMemoryAlign::ArenaFree (void* pPointer) {
+  const uint32_t kuiSize = *ArenaHeaderSize (pPointer);
+  m_pMemoryTagStat[*ArenaHeaderTag (pPointer)].uiUsedBytes -= kuiSize;
+  uint8_t* pBlock = (uint8_t*)pPointer - m_nCacheLineSize;
+  uint32_t uiTakenSize = 0;
+  if (pBlock >= m_pArena && pBlock < m_pArena + m_uiArenaSize) {
+    uiTakenSize = (uint32_t) (uintptr_t) * ArenaHeaderBlock (pPointer);
+    ArenaPutBlock (pBlock, uiTakenSize);
+  } else {
+    uiTakenSize = m_nCacheLineSize + WELS_ALIGN (kuiSize, m_nCacheLineSize) + m_nCacheLineSize - 1;
+    free (*ArenaHeaderBlock (pPointer));
+  }
+#ifdef MEMORY_MONITOR
+  m_nMemoryUsageInBytes -= uiTakenSize;
+#endif//MEMORY_MONITOR
 }
 
 void* WelsMalloc (const uint32_t kuiSize, const char* kpTag, const uint32_t kiAlign) {
@@ -126,12 +340,15 @@ void* CMemoryAlign::WelsMallocz (const uint32_t kuiSize, const char* kpTag) {
 }
 
 void* CMemoryAlign::WelsMalloc (const uint32_t kuiSize, const char* kpTag) {
+  if (NULL != m_pMemoryTagStat)
+    return ArenaMalloc (kuiSize, kpTag);
   void* pPointer = WelsCommon::WelsMalloc (kuiSize, kpTag, m_nCacheLineSize);
 #ifdef MEMORY_MONITOR
   if (pPointer != NULL) {
     const int32_t kiMemoryLength = * ((int32_t*) ((uint8_t*)pPointer - sizeof (void**) - sizeof (
                                         int32_t))) + m_nCacheLineSize - 1 + sizeof (void**) + sizeof (int32_t);
     m_nMemoryUsageInBytes += kiMemoryLength;
+    ++ m_nMemoryAllocCount;
 #ifdef MEMORY_CHECK
     g_iMemoryLength = kiMemoryLength;
 #endif
@@ -141,6 +358,11 @@ void* CMemoryAlign::WelsMalloc (const uint32_t kuiSize, const char* kpTag) {
 }
 
 void CMemoryAlign::WelsFree (void* pPointer, const char* kpTag) {
+  if (NULL != m_pMemoryTagStat) {
+    if (pPointer)
+      ArenaFree (pPointer);
+    return;
+  }
 #ifdef MEMORY_MONITOR
   if (pPointer) {
     const int32_t kiMemoryLength = * ((int32_t*) ((uint8_t*)pPointer - sizeof (void**) - sizeof (
@@ -171,4 +393,42 @@ const uint32_t CMemoryAlign::WelsGetMemoryUsage() const {
   return m_nMemoryUsageInBytes;
 }
 
+const uint32_t CMemoryAlign::WelsGetMemoryAllocCount() const {
+  return m_nMemoryAllocCount;
+}
+
+const uint32_t CMemoryAlign::WelsGetArenaSize() const {
+  return m_uiArenaSize;
+}
+
+const uint32_t CMemoryAlign::WelsGetArenaUsedBytes() const {
+  return m_uiArenaPos;
+}
+
+const uint32_t CMemoryAlign::WelsGetArenaOverflowCount() const {
+  return m_uiArenaOverflowCount;
+}
+
+const int32_t CMemoryAlign::WelsGetMemoryTagNum() const {
+  return m_iMemoryTagNum;
+}
+
+const SMemoryTagStat* CMemoryAlign::WelsGetMemoryTagStat (const int32_t kiIndex) const {
+  if (NULL == m_pMemoryTagStat || kiIndex < 0 || kiIndex >= m_iMemoryTagNum)
+    return NULL;
+  return &m_pMemoryTagStat[kiIndex];
+}
+
+bool CMemoryAlign::WelsArenaRewind() {
+  if (NULL == m_pMemoryTagStat)
+    return false;
+  for (int32_t i = 0; i < m_iMemoryTagNum; i++) {
+    if (m_pMemoryTagStat[i].uiUsedBytes != 0)
+      return false;
+  }
+  m_uiArenaPos = 0;
+  memset (m_pArenaFreeList, 0, sizeof (m_pArenaFreeList));
+  return true;
+}
+
 } // end of namespace WelsCommon
@@ -145,6 +145,11 @@ void WelsSampleSadFour8x8_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSamp
   * (pSad + 2) = WelsSampleSad8x8_c (iSample1, iStride1, (iSample2 - 1), iStride2);
   * (pSad + 3) = WelsSampleSad8x8_c (iSample1, iStride1, (iSample2 + 1), iStride2);
 }
+void WelsSampleSad8x8Row_c (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2, int32_t iNum,
+                            int32_t* pSad) {
+  for (int32_t i = 0; i < iNum; i++)
+    pSad[i] = WelsSampleSad8x8_c (pSample1 + (i << 3), iStride1, pSample2 + (i << 3), iStride2);
+}
 void WelsSampleSadFour4x4_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSample2, int32_t iStride2, int32_t* pSad) {
   * (pSad)     = WelsSampleSad4x4_c (iSample1, iStride1, (iSample2 - iStride2), iStride2);
   * (pSad + 1) = WelsSampleSad4x4_c (iSample1, iStride1, (iSample2 + iStride2), iStride2);
@@ -163,3 +168,41 @@ void WelsSampleSadFour4x8_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSamp
   * (pSad + 2) = WelsSampleSad4x8_c (iSample1, iStride1, (iSample2 - 1), iStride2);
   * (pSad + 3) = WelsSampleSad4x8_c (iSample1, iStride1, (iSample2 + 1), iStride2);
 }
+
+/*
+ * the source row is loaded once and compared against every candidate before moving to the next row
+ */
+static inline void SampleSadMulti_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+                                     const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost,
+                                     const int32_t kiWidth, const int32_t kiHeight) {
+  uint8_t uiSrcRow[16];
+  int32_t i, j, n;
+  for (n = 0; n < iNum; n++)
+    pCost[n] = pBaseCost[n];
+  for (i = 0; i < kiHeight; i++) {
+    for (j = 0; j < kiWidth; j++)
+      uiSrcRow[j] = pSample1[j];
+    for (n = 0; n < iNum; n++) {
+      const uint8_t* kpRef = ppSample2[n] + i * iStride2;
+      int32_t iSadSum = 0;
+      for (j = 0; j < kiWidth; j++)
+        iSadSum += WELS_ABS ((uiSrcRow[j] - kpRef[j]));
+      pCost[n] += iSadSum;
+    }
+    pSample1 += iStride1;
+  }
+}
+
+#define WELS_SAMPLE_SAD_MULTI_C(iWidth, iHeight) \
+void WelsSampleSadMulti##iWidth##x##iHeight##_c (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, \
+    int32_t iStride2, const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost) { \
+  SampleSadMulti_c (pSample1, iStride1, ppSample2, iStride2, pBaseCost, iNum, pCost, iWidth, iHeight); \
+}
+
+WELS_SAMPLE_SAD_MULTI_C (16, 16)
+WELS_SAMPLE_SAD_MULTI_C (16, 8)
+WELS_SAMPLE_SAD_MULTI_C (8, 16)
+WELS_SAMPLE_SAD_MULTI_C (8, 8)
+WELS_SAMPLE_SAD_MULTI_C (4, 4)
+WELS_SAMPLE_SAD_MULTI_C (8, 4)
+WELS_SAMPLE_SAD_MULTI_C (4, 8)
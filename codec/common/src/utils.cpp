@@ -118,9 +118,13 @@ float WelsCalcPsnr (const void* kpTarPic,
       iSqe += kiT * kiT;
     }
   }
-  if (0 == iSqe) {
+  return WelsCalcPsnrFromSse (iSqe, kiWidth, kiHeight);
+}
+
+float WelsCalcPsnrFromSse (const int64_t kiSqe, const int32_t kiWidth, const int32_t kiHeight) {
+  if (0 == kiSqe) {
     return (99.99f);
   }
-  return CALC_PSNR (kiWidth, kiHeight, iSqe);
+  return CALC_PSNR (kiWidth, kiHeight, kiSqe);
 }
 
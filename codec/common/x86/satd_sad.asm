@@ -1246,6 +1246,11 @@ return_sad_intra_16x16_x3:
     pmaddubsw        xmm5, xmm7
     psubsw           xmm2, xmm4
     psubsw           xmm3, xmm5
+    SSE41_SumSatd8x4
+%endmacro
+
+; in: xmm0..xmm3 the differences of the rows 0..3 after pmaddubsw with HSumSubDB1, out: xmm6 += SATD words
+%macro SSE41_SumSatd8x4 0
     SSE2_HDMTwo4x4   xmm0, xmm1, xmm2, xmm3, xmm4
     pabsw            xmm0, xmm0
     pabsw            xmm2, xmm2
@@ -1512,6 +1517,123 @@ loop_get_satd_16x16_right:
 %endif
     ret
 
+;***********************************************************************
+;
+;Pixel_satd_quar_four_wxh_sse41
+;
+;***********************************************************************
+
+%ifdef X86_32
+    %define SATD_QUAR_PTR_SIZE 4
+%else
+    %define SATD_QUAR_PTR_SIZE 8
+%endif
+
+; a row of the block at r0 (stride r1) after pmaddubsw with xmm7, r0 moves down a row
+%macro SSE41_LoadSatdEncRow 1
+    movq             %1, [r0]
+    punpcklqdq       %1, %1
+    pmaddubsw        %1, xmm7
+    add              r0, r1
+%endmacro
+
+; a row of the average of the blocks at r2 (stride r3) and r4 (stride r5) after pmaddubsw with xmm7, %2 clobbered
+%macro SSE41_LoadSatdAvgRow 2
+    movq             %1, [r2]
+    movq             %2, [r4]
+    pavgb            %1, %2
+    punpcklqdq       %1, %1
+    pmaddubsw        %1, xmm7
+    add              r2, r3
+    add              r4, r5
+%endmacro
+
+; SSE41_GetSatd8x4 against the average of the blocks at r2 and r4, the pointers move down 4 rows
+%macro SSE41_GetSatdAvg8x4 0
+    SSE41_LoadSatdEncRow xmm0
+    SSE41_LoadSatdEncRow xmm1
+    SSE41_LoadSatdAvgRow xmm2, xmm4
+    SSE41_LoadSatdAvgRow xmm3, xmm4
+    psubsw           xmm0, xmm2
+    psubsw           xmm1, xmm3
+    SSE41_LoadSatdEncRow xmm2
+    SSE41_LoadSatdEncRow xmm3
+    SSE41_LoadSatdAvgRow xmm4, xmm5
+    psubsw           xmm2, xmm4
+    SSE41_LoadSatdAvgRow xmm4, xmm5
+    psubsw           xmm3, xmm4
+    SSE41_SumSatd8x4
+%endmacro
+
+;***********************************************************************
+;
+;void WelsSampleSatdQuarFour16x16_sse41 (uint8_t* pEnc, int32_t iStrideEnc, uint8_t** ppSrcA, int32_t iStrideA,
+;                                        uint8_t** ppSrcB, const int32_t* pStrideB, int32_t* pSatd);
+;
+;the SATDs of the 4 averages of ppSrcA[i] and ppSrcB[i] against pEnc, the averages are not stored
+;
+;***********************************************************************
+; width=%1 height=%2
+%macro SSE41_SATD_QUAR_FOUR 2
+WELS_EXTERN WelsSampleSatdQuarFour%1x%2_sse41
+    %assign push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 8
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    sub         r7, 6 * SATD_QUAR_PTR_SIZE
+    mov         [r7], r0
+    mov         [r7 + SATD_QUAR_PTR_SIZE], r2
+    mov         [r7 + 2 * SATD_QUAR_PTR_SIZE], r4
+    mov         [r7 + 3 * SATD_QUAR_PTR_SIZE], r5
+    mov         [r7 + 4 * SATD_QUAR_PTR_SIZE], r6
+    xor         r5, r5
+    mov         [r7 + 5 * SATD_QUAR_PTR_SIZE], r5       ; candidate index
+    INIT_X86_32_PIC_NOPRESERVE r6
+    movdqa      xmm7, [pic(HSumSubDB1)]
+    DEINIT_X86_32_PIC
+.cand_loop:
+    pxor        xmm6, xmm6
+    %assign x 0
+    %rep %1 / 8
+    mov         r5, [r7 + 5 * SATD_QUAR_PTR_SIZE]
+    mov         r0, [r7]
+    mov         r6, [r7 + SATD_QUAR_PTR_SIZE]
+    mov         r2, [r6 + r5 * SATD_QUAR_PTR_SIZE]
+    mov         r6, [r7 + 2 * SATD_QUAR_PTR_SIZE]
+    mov         r4, [r6 + r5 * SATD_QUAR_PTR_SIZE]
+    mov         r6, [r7 + 3 * SATD_QUAR_PTR_SIZE]
+    mov         r5d, [r6 + r5 * 4]
+    SIGN_EXTENSION r5, r5d
+%if x > 0
+    add         r0, x * 8
+    add         r2, x * 8
+    add         r4, x * 8
+%endif
+    %rep %2 / 4
+    SSE41_GetSatdAvg8x4
+    %endrep
+    %assign x x+1
+    %endrep
+    SSSE3_SumWHorizon r2d, xmm6, xmm5, xmm4
+    mov         r5, [r7 + 5 * SATD_QUAR_PTR_SIZE]
+    mov         r6, [r7 + 4 * SATD_QUAR_PTR_SIZE]
+    mov         [r6 + r5 * 4], r2d
+    inc         r5
+    mov         [r7 + 5 * SATD_QUAR_PTR_SIZE], r5
+    cmp         r5, 4
+    jl          .cand_loop
+    add         r7, 6 * SATD_QUAR_PTR_SIZE
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+%endmacro
+
+SSE41_SATD_QUAR_FOUR 16, 16
+SSE41_SATD_QUAR_FOUR 16, 8
+SSE41_SATD_QUAR_FOUR 8, 16
+SSE41_SATD_QUAR_FOUR 8, 8
+
 ;***********************************************************************
 ;
 ;Pixel_satd_wxh_sse41 END
@@ -2697,6 +2819,60 @@ WELS_EXTERN WelsSampleSadFour4x4_sse2
 ;
 ;***********************************************************************
 
+; xmm2 += SADs of the 8 lines from r0/r2, walked downwards with positive strides and upwards with negated ones,
+; the pointers end on the last line walked and the strides are negated for the next pass
+; %1=movdqu for two blocks side by side, movq for one
+%macro SSE2_SadRow8x8Lines 1
+    pxor       xmm2, xmm2
+%rep 4
+    %1         xmm0, [r0]
+    %1         xmm1, [r2]
+    psadbw     xmm0, xmm1
+    paddd      xmm2, xmm0
+    %1         xmm0, [r0+r1]
+    %1         xmm1, [r2+r3]
+    psadbw     xmm0, xmm1
+    paddd      xmm2, xmm0
+    lea        r0, [r0+2*r1]
+    lea        r2, [r2+2*r3]
+%endrep
+    sub        r0, r1
+    sub        r2, r3
+    neg        r1
+    neg        r3
+%endmacro
+
+;***********************************************************************
+;   void WelsSampleSad8x8Row_sse2 (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2,
+;                                  int32_t iNum, int32_t* pSad);
+;   SADs of the iNum (> 0) 8x8 blocks side by side, two blocks per pass
+;***********************************************************************
+WELS_EXTERN WelsSampleSad8x8Row_sse2
+    %assign  push_num 0
+    LOAD_6_PARA
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r4, r4d
+    sub        r4, 2
+    jl         .last_block
+.pair_loop:
+    SSE2_SadRow8x8Lines movdqu
+    pshufd     xmm2, xmm2, 08h
+    movq       [r5], xmm2
+    add        r0, 16
+    add        r2, 16
+    add        r5, 8
+    sub        r4, 2
+    jge        .pair_loop
+.last_block:
+    cmp        r4, -1
+    jne        .done
+    SSE2_SadRow8x8Lines movq
+    movd       [r5], xmm2
+.done:
+    LOAD_6_PARA_POP
+    ret
+
 ;***********************************************************************
 ;   int32_t WelsSampleSad4x4_mmx (uint8_t *, int32_t, uint8_t *, int32_t )
 ;***********************************************************************
@@ -2732,3 +2908,217 @@ WELS_EXTERN WelsSampleSad4x4_mmx
     WELSEMMS
     LOAD_4_PARA_POP
     ret
+
+;***********************************************************************
+;
+;Pixel_sad_multi_wxh BEGIN
+;
+;***********************************************************************
+
+%ifdef X86_32
+    %define SAD_MULTI_PTR_SIZE 4
+%else
+    %define SAD_MULTI_PTR_SIZE 8
+%endif
+
+; copy the source block to the stack, a row per 16 bytes for the width 16, two rows per 16 bytes for the width 8
+; pSample1=r0 iStride1=r1 width=%1 height=%2
+%macro SSE2_SadMultiKeepSrc 2
+    %assign k 0
+%if %1 == 16
+    %rep %2
+    movdqu      xmm0, [r0]
+    movdqu      [r7 + k * 16], xmm0
+    add         r0, r1
+    %assign k k+1
+    %endrep
+%else
+    %rep %2 / 2
+    movq        xmm0, [r0]
+    movhps      xmm0, [r0 + r1]
+    movdqu      [r7 + k * 16], xmm0
+    lea         r0, [r0 + 2 * r1]
+    %assign k k+1
+    %endrep
+%endif
+%endmacro
+
+; SADs of the candidates at r0 and r1 against the source kept by SSE2_SadMultiKeepSrc, out: dwords 0 and 1 of xmm6
+; width=%1 height=%2
+%macro SSE2_SadMultiPair 2
+    pxor        xmm6, xmm6
+    pxor        xmm7, xmm7
+    %assign k 0
+%if %1 == 16
+    %rep %2
+    movdqu      xmm0, [r7 + k * 16]
+    movdqu      xmm1, [r0]
+    movdqu      xmm2, [r1]
+    psadbw      xmm1, xmm0
+    psadbw      xmm2, xmm0
+    paddd       xmm6, xmm1
+    paddd       xmm7, xmm2
+    add         r0, r3
+    add         r1, r3
+    %assign k k+1
+    %endrep
+%else
+    %rep %2 / 2
+    movdqu      xmm0, [r7 + k * 16]
+    movq        xmm1, [r0]
+    movhps      xmm1, [r0 + r3]
+    movq        xmm2, [r1]
+    movhps      xmm2, [r1 + r3]
+    psadbw      xmm1, xmm0
+    psadbw      xmm2, xmm0
+    paddd       xmm6, xmm1
+    paddd       xmm7, xmm2
+    lea         r0, [r0 + 2 * r3]
+    lea         r1, [r1 + 2 * r3]
+    %assign k k+1
+    %endrep
+%endif
+    movdqa      xmm0, xmm6
+    punpcklqdq  xmm6, xmm7
+    punpckhqdq  xmm0, xmm7
+    paddd       xmm6, xmm0              ; dword 0: r0, dword 2: r1
+    pshufd      xmm6, xmm6, 08h
+%endmacro
+
+; the 4x4 source stays in xmm4 (rows 0 and 1) and xmm5 (rows 2 and 3), twice each
+%macro SSE2_SadMultiKeepSrc4x4 2
+    movd        xmm4, [r0]
+    movd        xmm0, [r0 + r1]
+    punpckldq   xmm4, xmm0
+    lea         r0, [r0 + 2 * r1]
+    movd        xmm5, [r0]
+    movd        xmm0, [r0 + r1]
+    punpckldq   xmm5, xmm0
+    punpcklqdq  xmm4, xmm4
+    punpcklqdq  xmm5, xmm5
+%endmacro
+
+; out=%1: two rows of the candidate at r0 in the low half and of the one at r1 in the high half, clobber=%2
+%macro SSE2_LoadSadMulti4x2 2
+    movd        %1, [r0]
+    movd        %2, [r0 + r3]
+    punpckldq   %1, %2
+    movd        xmm7, [r1]
+    movd        %2, [r1 + r3]
+    punpckldq   xmm7, %2
+    punpcklqdq  %1, xmm7
+%endmacro
+
+%macro SSE2_SadMultiPair4x4 2
+    SSE2_LoadSadMulti4x2 xmm1, xmm0
+    lea         r0, [r0 + 2 * r3]
+    lea         r1, [r1 + 2 * r3]
+    SSE2_LoadSadMulti4x2 xmm2, xmm0
+    psadbw      xmm1, xmm4
+    psadbw      xmm2, xmm5
+    paddd       xmm1, xmm2
+    pshufd      xmm6, xmm1, 08h
+%endmacro
+
+%ifdef HAVE_AVX2
+; the rows of the source twice each, 32 bytes per row, for the width 16
+%macro AVX2_SadMultiKeepSrc 2
+    %assign k 0
+    %rep %2
+    vbroadcasti128 ymm0, [r0]
+    vmovdqu     [r7 + k * 32], ymm0
+    add         r0, r1
+    %assign k k+1
+    %endrep
+    vzeroupper
+%endmacro
+
+; the candidate at r0 in the low lane and the one at r1 in the high lane of each vpsadbw, out: dwords 0 and 1 of xmm6
+%macro AVX2_SadMultiPair 2
+    vpxor       ymm6, ymm6, ymm6
+    %assign k 0
+    %rep %2
+    vmovdqu     xmm1, [r0]
+    vinserti128 ymm1, ymm1, [r1], 1
+    vpsadbw     ymm1, ymm1, [r7 + k * 32]
+    vpaddd      ymm6, ymm6, ymm1
+    add         r0, r3
+    add         r1, r3
+    %assign k k+1
+    %endrep
+    vextracti128 xmm7, ymm6, 1
+    vpunpcklqdq xmm0, xmm6, xmm7
+    vpunpckhqdq xmm1, xmm6, xmm7
+    vpaddd      xmm6, xmm0, xmm1
+    vpshufd     xmm6, xmm6, 08h
+    vzeroupper                          ; the tail of WELS_SAD_MULTI is SSE2
+%endmacro
+%endif
+
+;***********************************************************************
+;void WelsSampleSadMulti16x16_sse2 (uint8_t* pSample1, int32_t iStride1, uint8_t** ppSample2, int32_t iStride2,
+;                                   const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost);
+; the candidates go by pairs, each row of the source is compared with both; pCost[n] = SAD + pBaseCost[n]
+; name=%1 width=%2 height=%3 bytes of the source on the stack=%4 keep source=%5 pair=%6
+;***********************************************************************
+%macro WELS_SAD_MULTI 6
+WELS_EXTERN %1
+    %assign push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 8
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r5, r5d
+%if %4 > 0
+    sub         r7, %4
+%endif
+    %5          %2, %3
+.pair_loop:
+    cmp         r5, 1
+    jl          .done
+    mov         r0, [r2]
+    mov         r1, r0
+    je          .pair                   ; the last one of an odd number goes with itself
+    mov         r1, [r2 + SAD_MULTI_PTR_SIZE]
+.pair:
+    %6          %2, %3
+    pxor        xmm1, xmm1
+    pinsrw      xmm1, word [r4], 0
+    cmp         r5, 1
+    je          .last
+    pinsrw      xmm1, word [r4 + 2], 2
+    paddd       xmm6, xmm1
+    movq        [r6], xmm6
+    add         r2, 2 * SAD_MULTI_PTR_SIZE
+    add         r4, 4
+    add         r6, 8
+    sub         r5, 2
+    jmp         .pair_loop
+.last:
+    paddd       xmm6, xmm1
+    movd        [r6], xmm6
+.done:
+%if %4 > 0
+    add         r7, %4
+%endif
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+%endmacro
+
+WELS_SAD_MULTI WelsSampleSadMulti16x16_sse2, 16, 16, 256, SSE2_SadMultiKeepSrc, SSE2_SadMultiPair
+WELS_SAD_MULTI WelsSampleSadMulti16x8_sse2, 16, 8, 128, SSE2_SadMultiKeepSrc, SSE2_SadMultiPair
+WELS_SAD_MULTI WelsSampleSadMulti8x16_sse2, 8, 16, 128, SSE2_SadMultiKeepSrc, SSE2_SadMultiPair
+WELS_SAD_MULTI WelsSampleSadMulti8x8_sse2, 8, 8, 64, SSE2_SadMultiKeepSrc, SSE2_SadMultiPair
+WELS_SAD_MULTI WelsSampleSadMulti4x4_sse2, 4, 4, 0, SSE2_SadMultiKeepSrc4x4, SSE2_SadMultiPair4x4
+
+%ifdef HAVE_AVX2
+WELS_SAD_MULTI WelsSampleSadMulti16x16_avx2, 16, 16, 512, AVX2_SadMultiKeepSrc, AVX2_SadMultiPair
+WELS_SAD_MULTI WelsSampleSadMulti16x8_avx2, 16, 8, 256, AVX2_SadMultiKeepSrc, AVX2_SadMultiPair
+%endif
+
+;***********************************************************************
+;
+;Pixel_sad_multi_wxh END
+;
+;***********************************************************************
@@ -95,6 +95,20 @@ int32_t WelsWriteSubsetSpsSyntax (SSubsetSps* pSubsetSps, SBitStringAux* pBitStr
  */
 int32_t WelsWritePpsSyntax (SWelsPPS* pPps, SBitStringAux* pBitStringAux, IWelsParametersetStrategy* pParametersetStrategy);
 
+/*!
+ *************************************************************************************
+ * \brief   to write a recovery point SEI
+ *
+ * \param   pBitStringAux          bitstream writer auxiliary
+ * \param   kiRecoveryFrameCnt     frames in output order until the pictures decoded are exact
+ *
+ * \return  0 - successed
+ *
+ * \note    Call it in case EWelsNalUnitType is SEI, ahead of the first slice of an intra refresh.
+ *************************************************************************************
+ */
+int32_t WelsWriteRecoveryPointSei (SBitStringAux* pBitStringAux, const int32_t kiRecoveryFrameCnt);
+
 /*!
  * \brief   initialize pSps based on configurable parameters in svc
  * \param   pSps                SWelsSPS*
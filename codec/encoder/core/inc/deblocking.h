@@ -82,6 +82,15 @@ void WelsBlockFuncInit (PSetNoneZeroCountZeroFunc* pfSetNZCZero,  int32_t iCpu);
 void PerformDeblockingFilter (sWelsEncCtx* pEnc);
 
 void DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc);
+void DeblockingFilterRowsAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, const int32_t kiFirstRow,
+                                  const int32_t kiRowNum);
+
+void WelsOverlappedDeblockingInit (sWelsEncCtx* pEnc);
+void WelsOverlappedDeblockingMbDone (sWelsEncCtx* pEnc, SSlice* pSlice, SMB* pCurMb);
+void WelsOverlappedDeblockingFinish (sWelsEncCtx* pEnc);
+
+void WelsQualityMetricsInit (sWelsEncCtx* pEnc);
+void WelsQualityMetricsFinish (sWelsEncCtx* pEnc);
 
 void DeblockingFilterSliceAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, SSlice* pSlice);
 void DeblockingFilterSliceAvcbaseNull (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, SSlice* pSlice);
@@ -87,6 +87,20 @@ void LoadBackFrameNum (sWelsEncCtx* pEncCtx, const int32_t kiDidx);
 
 EVideoFrameType DecideFrameType (sWelsEncCtx* pEncCtx, const int8_t kiSpatialNum, const int32_t kiDidx,
                                  bool bSkipFrameFlag);
+
+/*!
+ * \brief   whether intra refresh sweeps replace the periodic IDR, refer to ENCODER_OPTION_INTRA_REFRESH
+ */
+bool WelsIntraRefreshEnabled (const SWelsSvcCodingParam* kpSvcParam);
+/*!
+ * \brief   move the intra refresh sweep of a dependency layer on to the frame decided
+ * \return  true when a sweep starts with the frame, to be announced by a recovery point SEI
+ */
+bool WelsIntraRefreshFrameInit (sWelsEncCtx* pEncCtx, const EVideoFrameType keFrameType, const int32_t kiDidx);
+/*!
+ * \brief   set the intra band of the current layer and the refreshed rows of its reference
+ */
+void WelsIntraRefreshLayerInit (sWelsEncCtx* pEncCtx, const int32_t kiDidx);
 void InitBitStream (sWelsEncCtx* pEncCtx);
 int32_t GetTemporalLevel (SSpatialLayerInternal* fDlp, const int32_t kiFrameNum, const int32_t kiGopSize);
 /*!
@@ -223,18 +223,70 @@ typedef struct TagWelsEncCtx {
   //related to Statistics
   int64_t            uiStartTimestamp;
   SEncoderStatistics sEncoderStatistics[MAX_DEPENDENCY_LAYER];
+  SLayerQualityMetrics sLayerQualityMetrics[MAX_DEPENDENCY_LAYER]; // of the last encoded frame, refer to ENCODER_OPTION_GET_QUALITY_METRICS
+  SLayerQualityMetrics sLayerQualityAverage[MAX_DEPENDENCY_LAYER]; // of the uiQualityFrameCount frames measured
+  uint32_t           uiQualityFrameCount[MAX_DEPENDENCY_LAYER];
   int32_t            iStatisticsLogInterval;
   int64_t            iLastStatisticsLogTs;
 
   int32_t iEncoderError;
   WELS_MUTEX mutexEncoderError;
   bool bDeliveryFlag;
-  SStateCtx sWelsCabacContexts[4][WELS_QP_MAX + 1][WELS_CONTEXT_COUNT];
 #ifdef ENABLE_FRAME_DUMP
   bool bDependencyRecFlag[MAX_DEPENDENCY_LAYER];
 #endif
   int64_t            uiLastTimestamp;
-  uint8_t*           pDynamicBsBuffer[MAX_THREADS_NUM];
+
+  // slice output callback of the current frame, refer to SSliceOutputCallbackParam
+  int32_t            iSliceOutputNext;       // next slice of the current layer to be given
+  int32_t            iSliceOutputLayerNum;   // count of layers of SFrameBSInfo already given
+  EVideoFrameType    eSliceOutputFrameType;
+  int64_t            uiSliceOutputTimeStamp;
+
+  // profiling, refer to ENCODER_OPTION_PROFILING
+  SStageProfiler     sProfiler;              // stages out of the slices, then the sum of the frame
+  SStageProfiler     sProfilerTotal;         // sum of the frames profiled since the last reset
+  uint32_t           uiProfiledFrameCount;
+
+  // motion hint of the next frame, refer to ENCODER_OPTION_MOTION_HINT
+  SMbMotionHint*     pMotionHint;            // NULL or iMotionHintMbWidth * iMotionHintMbHeight hints
+  int32_t            iMotionHintMbWidth;
+  int32_t            iMotionHintMbHeight;
+  int32_t            iMotionHintCapacity;    // count of hints allocated
+  bool               bMotionHintEarlyTermination;
+
+  // effort of each MB of the next frame, refer to ENCODER_OPTION_EFFORT_MAP
+  uint8_t*           pEffortMap;             // NULL or iEffortMapMbWidth * iEffortMapMbHeight EMbEffort
+  int32_t            iEffortMapMbWidth;      // 0: full effort everywhere
+  int32_t            iEffortMapMbHeight;
+  int32_t            iEffortMapCapacity;
+
+  // complexity adapted to the frame time budget, refer to ENCODER_OPTION_FRAME_TIME_BUDGET
+  int32_t            iComplexityLevel;       // ECOMPLEXITY_LEVEL of the next frame
+  int32_t            iLastComplexityLevel;   // ECOMPLEXITY_LEVEL of the last frame, refer to ENCODER_OPTION_GET_COMPLEXITY_LEVEL
+  int64_t            iFrameTimeAvgUs;        // smoothed encoding time at this level, 0: none measured yet
+
+  // motion of the last picture, refer to ENCODER_OPTION_MOTION_ANALYSIS
+  SMbMotionHint*     pMotionAnalysis;        // NULL until the first picture analysed
+  int32_t            iMotionAnalysisMbWidth; // 0: no motion kept for the last picture
+  int32_t            iMotionAnalysisMbHeight;
+  EVideoFrameType    eMotionAnalysisFrameType;
+  int64_t            uiMotionAnalysisTimeStamp;
+
+  // buffers sized up front, refer to ENCODER_OPTION_PREALLOCATE_BUFFERS
+  int32_t            iPreallocSliceNumRequested;                 // iPreallocSliceNum the buffers were sized with
+  int32_t            iPreallocSliceNum[MAX_DEPENDENCY_LAYER];    // slices of each layer sized for, 0: grown on demand
+  uint32_t           uiBufferReallocCount;   // grows of the slice, NAL or bitstream buffers in the current frame
+  uint32_t           uiFrameAllocCount;      // memory blocks allocated in the last frame
+  SEncoderBufferStatistics sBufferStatistics; // of all the frames, refer to ENCODER_OPTION_GET_BUFFER_STATISTICS
+
+  SMemoryArenaParam  sMemoryArena;           // arena pMemAlign was created with, refer to ENCODER_OPTION_MEMORY_ARENA
+  bool               bLowFootprint;          // the buffers were sized with, refer to ENCODER_OPTION_LOW_FOOTPRINT
+  SReconfigPoolParam sReconfigPool;          // pMemAlign was sized for, refer to ENCODER_OPTION_RECONFIG_POOL
+  bool               bKeepMemAlign;          // pMemAlign is taken over by the context of the next reset, not deleted
+  CWelsThreadPool*   pIdleThreadPool;        // reference kept for the next reset while no pTaskManage takes the pool
+  SEncoderReconfigStatistics sReconfigStatistics; // refer to ENCODER_OPTION_GET_RECONFIG_STATISTICS
+  uint32_t           uiIntraRefreshNum;      // sweeps of the highest layer, refer to ENCODER_OPTION_GET_INTRA_REFRESH_NUM
 } sWelsEncCtx/*, *PWelsEncCtx*/;
 }
 #endif//sWelsEncCtx_H__
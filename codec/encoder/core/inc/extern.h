@@ -73,10 +73,11 @@ void GomValidCheck (const int32_t kiMbWidth, const int32_t kiMbHeight, int32_t*
  * \brief   initialize Wels avc encoder core library
  * \param   ppCtx       sWelsEncCtx**
  * \param   para        SWelsSvcCodingParam*
+ * \param   pMemAlign   memory kept over a reset to take over, deleted if the initialization fails; NULL for a new one
  * \return  successful - 0; otherwise none 0 for failed
  */
 int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pPara, SLogContext* pLogCtx,
-                            SExistingParasetList* pExistingParasetList);
+                            SExistingParasetList* pExistingParasetList, CMemoryAlign* pMemAlign);
 
 /*!
  * \brief   uninitialize Wels encoder core library
@@ -95,6 +96,40 @@ void WelsUninitEncoderExt (sWelsEncCtx** ppCtx);
  */
 int32_t WelsEncoderEncodeExt (sWelsEncCtx*, SFrameBSInfo* pFbi, const SSourcePicture* kpSrcPic);
 
+/*!
+ * \brief   per-stage profiling around WelsEncoderEncodeExt(), refer to ENCODER_OPTION_PROFILING
+ */
+void WelsProfilingFrameBegin (sWelsEncCtx* pCtx);
+void WelsProfilingFrameEnd (sWelsEncCtx* pCtx);
+void WelsProfilingReset (sWelsEncCtx* pCtx);
+void WelsProfilingGet (sWelsEncCtx* pCtx, SEncoderProfiling* pProfiling);
+
+/*!
+ * \brief  keep a copy of the motion hints of the next frame, refer to ENCODER_OPTION_MOTION_HINT
+ * \return 0 - successful; otherwise failed
+ */
+int32_t WelsMotionHintSet (sWelsEncCtx* pCtx, const SMotionHintParam* kpHint);
+void WelsMotionHintClear (sWelsEncCtx* pCtx);
+
+/*!
+ * \brief  keep a copy of the effort map of the next frame, refer to ENCODER_OPTION_EFFORT_MAP
+ * \return 0 - successful; otherwise failed
+ */
+int32_t WelsEffortMapSet (sWelsEncCtx* pCtx, const SEffortMapParam* kpMap);
+void WelsEffortMapClear (sWelsEncCtx* pCtx);
+
+/*!
+ * \brief  step the complexity level after each frame to meet the frame time budget, refer to ENCODER_OPTION_FRAME_TIME_BUDGET
+ */
+void WelsComplexityUpdate (sWelsEncCtx* pCtx, const int64_t kiFrameTimeUs);
+void WelsComplexityReset (sWelsEncCtx* pCtx);
+
+/*!
+ * \brief  keep the motion decided for the picture just encoded, refer to ENCODER_OPTION_MOTION_ANALYSIS
+ */
+void WelsMotionAnalysisOutput (sWelsEncCtx* pCtx, const SFrameBSInfo* kpFbi);
+void WelsMotionAnalysisGet (sWelsEncCtx* pCtx, SMotionAnalysis* pAnalysis);
+
 int32_t WelsEncoderEncodeParameterSets (sWelsEncCtx* pCtx, void* pDst);
 
 /*
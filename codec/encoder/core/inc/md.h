@@ -66,6 +66,11 @@ namespace WelsEnc {
 
 #define NO_BEST_FRAC_PIX   1 // REFINE_ME_NO_BEST_HALF_PIXEL + ME_NO_BEST_QUAR_PIXEL
 
+#define MOTION_HINT_QP_GAP_MAX  6 // beyond it the partition of a motion hint decided at another QP is not trusted
+#define EFFORT_LOW_MV_RANGE     8 // integer pel search range of the macroblocks of EFFORT_LOW
+#define COMPLEXITY_MV_RANGE     16 // integer pel search range from COMPLEXITY_LEVEL_SMALL_SEARCH on
+#define COMPLEXITY_RELAX_PERCENT 70 // below this share of the frame time budget the complexity level is stepped back
+
 //for vaa constants
 #define MBVAASIGN_FLAT       15
 #define MBVAASIGN_HOR1      3
@@ -115,6 +120,14 @@ struct {
 //  SMVUnitXY     i_mvbs[MB_BLOCK8x8_NUM];        //scaled MVB
 } sMe;
 
+//motion hint of the application, refer to ENCODER_OPTION_MOTION_HINT
+bool            bMotionHint;            // sHintMv16x16 and sHintMv8x8 are valid for the current MB
+uint8_t         uiHintPartition;        // EMotionHintPartition, MOTION_HINT_NONE unless early termination is asked
+SMVUnitXY       sHintMv16x16;           // scaled to the current layer and to the previous picture
+SMVUnitXY       sHintMv8x8[4];
+
+//effort map of the application, refer to ENCODER_OPTION_EFFORT_MAP
+uint8_t         uiEffort;               // EMbEffort of the current MB
 } SWelsMD;
 
 typedef struct TagMeRefinePointer {
@@ -135,6 +148,9 @@ void FillNeighborCacheInterWithBGD (SMbCache* pMbCache, SMB* pCurMb, int32_t iMb
 void InitFillNeighborCacheInterFunc (SWelsFuncPtrList* pFuncList, const int32_t kiFlag);
 
 void MvdCostInit (uint16_t* pMvdCostInter, const int32_t kiMvdSz);
+// tables filled by MvdCostInit, shared by the encoders with the same kiMvdSz and counted by reference
+uint16_t* MvdCostTableAcquire (const int32_t kiMvdSz);
+void MvdCostTableRelease (uint16_t* pMvdCostTable);
 
 void PredictSad (int8_t* pRefIndexCache, int32_t* pSadCostCache, int32_t uiRef, int32_t* pSadPred);
 
@@ -155,6 +171,9 @@ void MeRefineFracPixel (sWelsEncCtx* pEncCtx, uint8_t* pMemPredInterMb, SWelsME*
 
 void InitBlkStrideWithRef (int32_t* pBlkStride, const int32_t kiStrideRef);
 
+#define HALFPEL_PLANE_MARGIN 16 // the half-pel planes cover the luma extended by this margin
+int32_t WelsHalfPelPlanesFill (CMemoryAlign* pMa, SMcFunc* pMcFuncs, SPicture* pPic);
+
 void UpdateMbMv_c (SMVUnitXY* pMvBuffer, const SMVUnitXY ksMv);
 
 #if defined(__cplusplus)
@@ -86,6 +86,13 @@ bool                            bThreadBsBufferUsage[MAX_THREADS_NUM];
 WELS_MUTEX                      mutexThreadBsBufferUsage;
 WELS_MUTEX                      mutexEvent;
 WELS_MUTEX                      mutexThreadSlcBuffReallocate;
+WELS_MUTEX                      mutexSliceOutput;       // slice output callback, refer to OutputSlicesInOrder()
+
+// overlapped deblocking of the current layer, refer to WelsOverlappedDeblockingMbDone()
+int32_t*                        pDbkRowMbCount;         // reconstructed MBs of each MB row
+int32_t                         iDbkRowsDone;           // MB rows filtered so far
+bool                            bDbkBusy;               // a thread is filtering
+WELS_MUTEX                      mutexDeblocking;
 } SSliceThreading;
 
 #endif//MULTIPLE_THREADING_DEFINES_H__
@@ -95,6 +95,7 @@ SWelsNalRaw     sNalList[2];            // nal list, PREFIX NAL(if applicable) +
 // int32_t         iCountNals;             // count number of NAL in list
 int32_t         iNalLen[2];
 int32_t         iNalIndex;              // coding NAL currently, 0 based
+bool            bOutputPending;         // written, waits for the slices before it to be given to the slice output callback
 
 // bool            bAnnexBFlag;            // annexeb flag, to figure it pOut the packetization mode whether need 4 bytes (0 0 0 1) of start code prefix
 #if MT_DEBUG_BS_WR
@@ -95,6 +95,9 @@ typedef struct TagDLayerParam {
   bool              bEncCurFrmAsIdrFlag;
   int32_t           iFrameNum;              // current frame number coding
   int32_t           iPOC;                   // frame iPOC
+  int32_t           iRefreshFrameIdx;       // frame of the intra refresh sweep being coded, refer to WelsIntraRefreshFrameInit()
+  int32_t           iRefreshFrameNum;       // frames of that sweep, 0: none runs
+  int32_t           iRefreshId;             // sweeps started, the pictures of an older sweep count as not refreshed
 #ifdef ENABLE_FRAME_DUMP
   char          sRecFileName[MAX_FNAME_LEN];    // file to be constructed
 #endif//ENABLE_FRAME_DUMP
@@ -118,11 +121,35 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
   char*       pCurPath; // record current lib path such as:/pData/pData/com.wels.enc/lib/
 
   bool      bDeblockingParallelFlag;        // deblocking filter parallelization control flag
+  bool      bLoopFilterIdcForced;           // iLoopFilterDisableIdc 0 was lowered to 2 for the slice threads
   int32_t   iBitsVaryPercentage;
 
   int8_t   iDecompStages;          // GOP size dependency
   int32_t  iMaxNumRefFrame;
 
+  /* thread pool scheduling, refer to SThreadSchedulingParam */
+  int32_t  iThreadPriorityClass;   // EThreadPriorityClass
+  int32_t  iMaxThreadsInUse;       // 0: no limit on pool threads running slice tasks of this instance
+
+  bool     bZeroCopyInput;         // read the source planes in place when possible, refer to SZeroCopyInputParam
+
+  SSliceOutputCallbackParam sSliceOutput; // called for each slice once written, refer to SSliceOutputCallbackParam
+
+  bool     bProfiling;             // per-stage timing and counters, refer to SEncoderProfiling
+  bool     bMotionAnalysis;        // keep the motion of each picture, refer to SMotionAnalysis
+  bool     bHierarchicalMe;        // pyramid search ahead of the 16x16 ME, refer to PerformMePyramidSearch()
+  bool     bHalfPelCache;          // half-pel planes per reference for the sub-pel refinement, refer to WelsHalfPelPlanesFill()
+  bool     bScreenBlockHash;       // exact block hash index per reference for screen content, refer to PerformBlockHashIndex()
+  bool     bStaticSkipPrefilter;   // frame level skip map ahead of the mode decision, refer to PerformStaticSkipPrefilter()
+  int32_t  iFrameTimeBudgetUs;     // 0: complexity fixed by iComplexityMode, refer to WelsComplexityUpdate()
+  bool     bOverlappedDeblocking;  // frame deblocking by rows during the slice coding, refer to WelsOverlappedDeblockingMbDone()
+  int32_t  iPreallocSliceNum;      // slices of each size-limited layer the buffers are sized for, -1: level worst case, 0: grown on demand
+  SMemoryArenaParam sMemoryArena;  // arena the memory of the encoder is carved from, refer to CMemoryAlign
+  bool     bLowFootprint;          // source pictures for the active temporal layers only, refer to AllocSpatialPictures()
+  SReconfigPoolParam sReconfigPool; // largest picture the arena kept over the resets is sized for, refer to WelsEncoderParamAdjust()
+  int32_t  iIntraRefreshFrames;    // 0: periodic IDR, refer to WelsIntraRefreshFrameInit()
+  bool     bQualityMetrics;        // PSNR and SSIM of each coded layer, refer to WelsQualityMetricsInit()
+
  public:
   TagWelsSvcCodingParam() {
     FillDefault();
@@ -223,9 +250,33 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
     pCurPath                    = NULL; // record current lib path such as:/pData/pData/com.wels.enc/lib/
 
     bDeblockingParallelFlag     = false;// deblocking filter parallelization control flag
+    bLoopFilterIdcForced        = false;
 
     iDecompStages               = 0;    // GOP size dependency, unknown here and be revised later
     iBitsVaryPercentage = 10;
+
+    iThreadPriorityClass        = THREAD_PRIORITY_NORMAL;
+    iMaxThreadsInUse            = 0;
+
+    bZeroCopyInput              = false;
+
+    sSliceOutput.pCallback      = NULL;
+    sSliceOutput.pContext       = NULL;
+
+    bProfiling                  = false;
+    bMotionAnalysis             = false;
+    bHierarchicalMe             = false;
+    bHalfPelCache               = false;
+    bScreenBlockHash            = false;
+    bStaticSkipPrefilter        = false;
+    iFrameTimeBudgetUs          = 0;
+    bOverlappedDeblocking       = false;
+    iPreallocSliceNum           = 0;
+    memset (&sMemoryArena, 0, sizeof (sMemoryArena));
+    bLowFootprint               = false;
+    memset (&sReconfigPool, 0, sizeof (sReconfigPool));
+    iIntraRefreshFrames         = 0;
+    bQualityMetrics             = false;
   }
 
   int32_t ParamBaseTranscode (const SEncParamBase& pCodingParam) {
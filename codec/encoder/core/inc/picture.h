@@ -40,6 +40,27 @@
 
 namespace WelsEnc {
 #define LIST_SIZE      0x10000    //(256*256)
+
+/*
+ *  Exact block hash index, refer to PerformBlockHashIndex()
+ *  The 8x8 block at every position of a reference is hashed with CRC32C, positions sharing a hash are chained in a bucket
+ */
+#define BLOCK_HASH_SIZE       8
+#define BLOCK_HASH_MAX_BUCKET_BITS  20
+typedef struct TagScreenBlockHashIndex {
+int32_t    iWidth;          // positions per row, picture width - BLOCK_HASH_SIZE + 1
+int32_t    iHeight;         // rows of positions, picture height - BLOCK_HASH_SIZE + 1
+int32_t    iBucketBits;
+uint32_t   uiIndexSeq;      // order in which the indexes are built, 0 if never built
+uint64_t*  pHash;           // hash of the block at each position, kept to update the next index incrementally
+uint8_t*   pCellChanged;    // working buffer, flag of each 8x8 cell of whether it differs from the previous index
+uint8_t*   pDirty;          // working buffer of iWidth, flag of each position of a row of whether to hash it again
+int32_t*   pBucketHead;     // latest position of each bucket, -1 if empty
+int32_t*   pNextPosition;   // next position in the same bucket, -1 at the end
+uint32_t   uiSadCostThreshold[BLOCK_SIZE_ALL]; // no look-up below these costs
+bool       bIndexed;        // flag of whether the index of the reference is built
+} SScreenBlockHashIndex;
+
 typedef struct TagScreenBlockFeatureStorage {
 //Input
 uint16_t*  pFeatureOfBlockPointer;    // Pointer to pFeatureOfBlock
@@ -55,6 +76,7 @@ int32_t    iActualListSize;      // actual list size
 uint32_t uiSadCostThreshold[BLOCK_SIZE_ALL];
 bool      bRefBlockFeatureCalculated; // flag of whether pre-process is done
 uint16_t **pFeatureValuePointerList;//uint16_t* pFeatureValuePointerList[WELS_MAX (LIST_SIZE_SUM_16x16, LIST_SIZE_MSE_16x16)]
+SScreenBlockHashIndex* pHashIndex; // allocated on first use, refer to RequestScreenBlockHashIndex()
 } SScreenBlockFeatureStorage; //should be stored with RefPic, one for each frame
 
 /*
@@ -100,6 +122,19 @@ int32_t   iFrameAverageQp;
 /*******************************for screen reference frames****************************/
 SScreenBlockFeatureStorage* pScreenBlockFeatureStorage;
 
+/*******************************half-pel planes of the luma, refer to WelsHalfPelPlanesFill()****************************/
+uint8_t*    pHalfPelBuffer;
+uint8_t*    pHalfPel[3];  // horizontal, vertical and center half-pel of each luma position, with stride iLineSize[0]
+bool        bHalfPelReady;
+
+/*******************************refreshed area since the start of an intra refresh sweep, refer to WelsIntraRefreshLayerInit()****************************/
+int32_t     iRefreshId;       // sweep the rows are counted for
+int32_t     iRefreshedMbRows; // MB rows from the top decodable without the pictures ahead of the sweep
+
+/*******************************source picture held by an orig frame, refer to CWelsPreProcess::SetSharedAnalysis()****************************/
+int64_t     iSrcTimeStamp;    // timestamp of the source picture
+uint32_t    uiSrcSeq;         // order of input of the source picture, 0: none
+
   /*
    *    set picture as unreferenced
    */
@@ -114,8 +149,12 @@ SScreenBlockFeatureStorage* pScreenBlockFeatureStorage;
       iMarkFrameNum      = -1;
       bUsedAsRef         = false;
 
-      if (NULL != pScreenBlockFeatureStorage)
+      if (NULL != pScreenBlockFeatureStorage) {
         pScreenBlockFeatureStorage->bRefBlockFeatureCalculated = false;
+        if (NULL != pScreenBlockFeatureStorage->pHashIndex)
+          pScreenBlockFeatureStorage->pHashIndex->bIndexed = false;
+      }
+      bHalfPelReady      = false;
   }
 
 } SPicture;
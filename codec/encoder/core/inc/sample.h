@@ -56,6 +56,19 @@ int32_t WelsSampleSatdIntra8x8Combined3_c (uint8_t*, int32_t, uint8_t*, int32_t,
 int32_t WelsSampleSadIntra8x8Combined3_c (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*, int32_t, uint8_t*,
     uint8_t*, uint8_t*);
 
+int32_t WelsSampleSatdIntra4x4AllModes_c (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const uint8_t*, int32_t, const int32_t*, uint8_t*, int32_t*);
+int32_t WelsSampleSatdIntra16x16AllModes_c (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const int8_t*, int32_t, const int32_t*, uint8_t*, int32_t*);
+int32_t WelsSampleSadIntra16x16AllModes_c (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const int8_t*, int32_t, const int32_t*, uint8_t*, int32_t*);
+int32_t WelsSampleSatdIntra8x8AllModes_c (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const int8_t*, int32_t, const int32_t*, uint8_t*, int32_t*, uint8_t*, uint8_t*);
+int32_t WelsSampleSadIntra8x8AllModes_c (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const int8_t*, int32_t, const int32_t*, uint8_t*, int32_t*, uint8_t*, uint8_t*);
+
+void WelsSampleSsimStats8x8_c (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
+
 #if defined(__cplusplus)
 extern "C" {
 #endif//__cplusplus
@@ -77,6 +90,11 @@ int32_t WelsSampleSatd16x8_sse41 (uint8_t*, int32_t, uint8_t*, int32_t);
 int32_t WelsSampleSatd16x16_sse41 (uint8_t*, int32_t, uint8_t*, int32_t);
 int32_t WelsSampleSatd4x4_sse41 (uint8_t*, int32_t, uint8_t*, int32_t);
 
+void WelsSampleSatdQuarFour16x16_sse41 (uint8_t*, int32_t, uint8_t**, int32_t, uint8_t**, const int32_t*, int32_t*);
+void WelsSampleSatdQuarFour16x8_sse41 (uint8_t*, int32_t, uint8_t**, int32_t, uint8_t**, const int32_t*, int32_t*);
+void WelsSampleSatdQuarFour8x16_sse41 (uint8_t*, int32_t, uint8_t**, int32_t, uint8_t**, const int32_t*, int32_t*);
+void WelsSampleSatdQuarFour8x8_sse41 (uint8_t*, int32_t, uint8_t**, int32_t, uint8_t**, const int32_t*, int32_t*);
+
 int32_t WelsIntra16x16Combined3Satd_sse41 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*, int32_t, uint8_t*);
 int32_t WelsIntra16x16Combined3Sad_ssse3 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*, int32_t, uint8_t*);
 int32_t WelsIntraChroma8x8Combined3Satd_sse41 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*, int32_t, uint8_t*,
@@ -87,6 +105,8 @@ int32_t WelsSampleSatd8x16_avx2 (uint8_t*, int32_t, uint8_t*, int32_t);
 int32_t WelsSampleSatd16x8_avx2 (uint8_t*, int32_t, uint8_t*, int32_t);
 int32_t WelsSampleSatd16x16_avx2 (uint8_t*, int32_t, uint8_t*, int32_t);
 
+void WelsSampleSsimStats8x8_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
+
 #endif//X86_ASM
 
 #if defined (HAVE_NEON)
@@ -107,6 +127,8 @@ int32_t WelsIntra8x8Combined3Sad_neon (uint8_t*, int32_t, uint8_t*, int32_t, int
 int32_t WelsIntra4x4Combined3Satd_neon (uint8_t*, int32_t, uint8_t*, int32_t, uint8_t*, int32_t*, int32_t, int32_t,
                                         int32_t);
 
+void WelsSampleSsimStats8x8_neon (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
+
 #endif
 
 #if defined (HAVE_NEON_AARCH64)
@@ -123,6 +145,7 @@ int32_t WelsIntra8x8Combined3Sad_AArch64_neon (uint8_t*, int32_t, uint8_t*, int3
                                            uint8_t*);
 int32_t WelsIntra4x4Combined3Satd_AArch64_neon (uint8_t*, int32_t, uint8_t*, int32_t, uint8_t*, int32_t*, int32_t, int32_t,
                                             int32_t);
+void WelsSampleSsimStats8x8_AArch64_neon (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
 #endif
 
 #if defined (HAVE_MMI)
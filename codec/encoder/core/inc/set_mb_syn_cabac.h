@@ -70,6 +70,10 @@ typedef struct TagCabacCtx {
   uint8_t*   m_pBufStart;
   uint8_t*   m_pBufEnd;
   uint8_t*   m_pBufCur;
+  // bytes a carry can still reach are held back: the last byte below 0xff and the 0xff bytes after it,
+  // so the bytes before m_pBufCur are final
+  uint8_t   m_uiBufferedByte;
+  int32_t   m_iBufferedByteNum;   // m_uiBufferedByte and the 0xff bytes following it, 0 when none
 } SCabacCtx;
 
 
@@ -78,7 +82,9 @@ void WelsCabacEncodeInit (SCabacCtx* pCbCtx, uint8_t* pBuf,  uint8_t* pEnd);
 inline void WelsCabacEncodeDecision (SCabacCtx* pCbCtx, int32_t iCtx, uint32_t uiBin);
 inline void WelsCabacEncodeBypassOne (SCabacCtx* pCbCtx, int32_t uiBin);
 void WelsCabacEncodeTerminate (SCabacCtx* pCbCtx, uint32_t uiBin);
+inline void WelsCabacEncodeBypassBins (SCabacCtx* pCbCtx, int32_t iBinNum, uint32_t uiBins);
 void WelsCabacEncodeUeBypass (SCabacCtx* pCbCtx, int32_t iExpBits, uint32_t uiVal);
+void WelsCabacEncodeUeBypassSign (SCabacCtx* pCbCtx, int32_t iExpBits, uint32_t uiVal, uint32_t uiSign);
 void WelsCabacEncodeFlush (SCabacCtx* pCbCtx);
 uint8_t* WelsCabacEncodeGetPtr (SCabacCtx* pCbCtx);
 int32_t  WriteBlockResidualCabac (void* pEncCtx,  int16_t* pCoffLevel, int32_t iEndIdx,
@@ -123,5 +129,53 @@ void WelsCabacEncodeBypassOne (SCabacCtx* pCbCtx, int32_t uiBin) {
   pCbCtx->m_uiLow += kuiBinBitmask & pCbCtx->m_uiRange;
 }
 
+/*
+ *  up to 16 bypass bins in one step, the first bin in the most significant of the iBinNum low bits of uiBins:
+ *  n bypass bins double low n times, adding the range for each bin set, i.e. low = (low << n) + uiBins * range
+ */
+void WelsCabacEncodeBypassBins (SCabacCtx* pCbCtx, int32_t iBinNum, uint32_t uiBins) {
+  const int32_t kiRoom = CABAC_LOW_WIDTH - 1 - pCbCtx->m_iLowBitCnt - pCbCtx->m_iRenormCnt;
+  if (iBinNum > kiRoom && kiRoom > 0) {
+    // the bytes written out on the way keep only the low 15 bits, too few for the product of the remaining bins,
+    // so fill low up to its top bit first and write out before the other bins are shifted in
+    const int32_t kiTail = iBinNum - kiRoom;
+    pCbCtx->m_iRenormCnt += kiRoom;
+    WelsCabacEncodeUpdateLow_ (pCbCtx);
+    pCbCtx->m_uiLow += (cabac_low_t) (uiBins >> kiTail) * pCbCtx->m_uiRange;
+    iBinNum = kiTail;
+    uiBins &= (1u << kiTail) - 1;
+  }
+  pCbCtx->m_iRenormCnt += iBinNum;
+  WelsCabacEncodeUpdateLow_ (pCbCtx);
+  pCbCtx->m_uiLow += (cabac_low_t) uiBins * pCbCtx->m_uiRange;
+}
+
+/*
+ *  RD bit estimation from the context states alone, in 1/256 bit; the engine and the contexts are left untouched
+ *  unless the states are updated explicitly, so mode decision can price alternatives on a scratch copy
+ */
+extern const uint16_t g_kuiCabacBinCost[64][2];
+
+inline uint32_t WelsCabacEstimateDecision (const SStateCtx* kpStateCtx, uint32_t uiBin) {
+  return g_kuiCabacBinCost[kpStateCtx->State()][uiBin != kpStateCtx->Mps()];
+}
+
+inline uint32_t WelsCabacEstimateDecisionUpdate (SStateCtx* pStateCtx, uint32_t uiBin) {
+  const int32_t kiState = pStateCtx->State();
+  const uint32_t kuiMps = pStateCtx->Mps();
+  if (uiBin == kuiMps) {
+    pStateCtx->Set (g_kuiStateTransTable[kiState][1], kuiMps);
+    return g_kuiCabacBinCost[kiState][0];
+  }
+  pStateCtx->Set (g_kuiStateTransTable[kiState][0], kuiMps ^ (kiState == 0));
+  return g_kuiCabacBinCost[kiState][1];
+}
+
+inline uint32_t WelsCabacEstimateBypass (int32_t iBinNum) {
+  return iBinNum << 8;
+}
+
+uint32_t WelsCabacEstimateUeBypass (int32_t iExpBits, uint32_t uiVal);
+
 }
 #endif
@@ -43,6 +43,7 @@
 #include "svc_enc_slice_segment.h"
 #include "set_mb_syn_cabac.h"
 #include "nal_encap.h"
+#include "stat.h"
 
 namespace WelsEnc {
 
@@ -180,7 +181,7 @@ SSliceHeaderExt sSliceHeaderExt;
 
 SMVUnitXY       sMvStartMin;
 SMVUnitXY       sMvStartMax;
-SMVUnitXY       sMvc[5];
+SMVUnitXY       sMvc[7];
 uint8_t         uiMvcNum;
 uint8_t         sScaleShift;
 
@@ -205,6 +206,8 @@ uint32_t        uiSliceConsumeTime;
 int32_t         iSliceComplexRatio;
 
 SRCSlicing      sSlicingOverRc;   //slice level rc statistic info
+
+SStageProfiler  sProfiler;        // stages of the slice thread, refer to ENCODER_OPTION_PROFILING
 } SSlice, *PSlice;
 
 }
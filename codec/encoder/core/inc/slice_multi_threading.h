@@ -70,6 +70,18 @@ void ReleaseMtResource (sWelsEncCtx** ppCtx);
 
 int32_t AppendSliceToFrameBs (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32_t kiSliceCount);
 
+/*!
+ * \brief   slice output callback: start of a layer, gives the parameter sets written before it
+ */
+void InitSliceOutput (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const int32_t kiLayerNum,
+                      const EVideoFrameType keFrameType);
+
+/*!
+ * \brief   slice output callback: gives one written slice (its prefix NAL included) of the current layer
+ */
+void OutputSlice (sWelsEncCtx* pCtx, const int32_t kiSliceIdx, const uint8_t* kpBs, const int32_t* kpNalLen,
+                  const int32_t kiNalCount);
+
 #if !defined(_WIN32)
 WELS_THREAD_ROUTINE_TYPE UpdateMbListThreadProc (void* arg);
 #endif//!_WIN32
@@ -40,6 +40,11 @@
 #if !defined(WELS_ENCODER_STATISTICAL_DATA_H__)
 #define WELS_ENCODER_STATISTICAL_DATA_H__
 
+#include <string.h>
+#include "typedefs.h"
+#include "measure_time.h"
+#include "codec_app_def.h"
+
 namespace WelsEnc {
 
 /*
@@ -97,6 +102,80 @@ SStatSliceInfo  sSliceData;
 
 } SStatData;
 
+/*
+ *  Stage profiling of one slice or of the frame level, refer to SEncoderProfiling
+ */
+typedef struct TagStageProfiler {
+
+bool            bEnabled;
+int32_t         iCurStage;                              // stage charged since iStamp, -1 if none
+int64_t         iStamp;                                 // in ns
+
+int64_t         iStageTime[PROFILING_STAGE_NUM];        // in ns
+int64_t         iVpTime[PROFILING_VP_NUM];              // in ns
+int64_t         iSadCount;
+int64_t         iSatdCount;
+int64_t         iSubpelRefineCount;
+int64_t         iPrefilteredSkipCount;
+int32_t         iMbCount[5][18];                        // refer to WelsCountMbType()
+
+} SStageProfiler;
+
+/*!
+ * \brief  clear the counters, the enabled state is kept
+ */
+static inline void ProfilerClear (SStageProfiler* pProfiler) {
+  const bool kbEnabled = pProfiler->bEnabled;
+  memset (pProfiler, 0, sizeof (SStageProfiler));
+  pProfiler->bEnabled  = kbEnabled;
+  pProfiler->iCurStage = -1;
+}
+
+/*!
+ * \brief  enable or disable the profiler for the next slice or frame, clearing the counters when it gets enabled
+ */
+static inline void ProfilerStart (SStageProfiler* pProfiler, const bool kbEnabled) {
+  if (kbEnabled && !pProfiler->bEnabled)
+    ProfilerClear (pProfiler);
+  pProfiler->bEnabled  = kbEnabled;
+  pProfiler->iCurStage = -1;
+}
+
+/*!
+ * \brief  charge the time elapsed to the current stage and move to another one
+ * \return the stage left, to be switched back to when a nested stage ends
+ */
+static inline int32_t ProfilerSwitchStage (SStageProfiler* pProfiler, const int32_t kiStage) {
+  const int32_t kiLastStage = pProfiler->iCurStage;
+  if (pProfiler->bEnabled) {
+    const int64_t kiNow = WelsTimeNs();
+    if (kiLastStage >= 0)
+      pProfiler->iStageTime[kiLastStage] += kiNow - pProfiler->iStamp;
+    pProfiler->iStamp    = kiNow;
+    pProfiler->iCurStage = kiStage;
+  }
+  return kiLastStage;
+}
+
+/*!
+ * \brief  add the counters of pSrc to pDst
+ */
+static inline void ProfilerAccumulate (SStageProfiler* pDst, const SStageProfiler* pSrc) {
+  int32_t i, j;
+  for (i = 0; i < PROFILING_STAGE_NUM; i++)
+    pDst->iStageTime[i] += pSrc->iStageTime[i];
+  for (i = 0; i < PROFILING_VP_NUM; i++)
+    pDst->iVpTime[i] += pSrc->iVpTime[i];
+  pDst->iSadCount          += pSrc->iSadCount;
+  pDst->iSatdCount         += pSrc->iSatdCount;
+  pDst->iSubpelRefineCount += pSrc->iSubpelRefineCount;
+  pDst->iPrefilteredSkipCount += pSrc->iPrefilteredSkipCount;
+  for (i = 0; i < 5; i++) {
+    for (j = 0; j < 18; j++)
+      pDst->iMbCount[i][j] += pSrc->iMbCount[i][j];
+  }
+}
+
 }
 
 #endif//WELS_ENCODER_STATISTICAL_DATA_H__
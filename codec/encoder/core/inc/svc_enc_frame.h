@@ -68,6 +68,37 @@ uint8_t uiFMEGoodFrameCount;
 int32_t iHighFreMbCount;
 } SFeatureSearchPreparation; //maintain only one
 
+/*
+ *  Pyramid of the luma for hierarchical ME, refer to ENCODER_OPTION_HIERARCHICAL_ME
+ */
+typedef struct TagMePyramid {
+uint8_t*        pCur[2];        // source picture down-scaled by 2 and by 4 in each direction, stride is iWidth
+uint8_t*        pRef[2];        // reference picture down-scaled alike
+int32_t         iWidth[2];
+int32_t         iHeight[2];
+
+SMVUnitXY*      pCoarseMv;      // MV of every MB on the coarsest level, in its pixel unit
+SMVUnitXY*      pMbMv;          // MV of every MB after refinement, in quarter pel of the layer
+bool            bMbMvValid;     // whether pMbMv is searched for the current picture
+} SMePyramid;
+
+/*
+ *  MBs left unchanged against the reference at zero motion, refer to ENCODER_OPTION_STATIC_SKIP_PREFILTER
+ */
+typedef struct TagStaticSkipMb {
+uint16_t        uiSadLuma;              // 16x16 luma SAD
+uint16_t        uiSadChroma;            // sum of the Cb and Cr 8x8 SADs
+bool            bStatic;                // whether the residual quantizes to nothing at the QP of the map
+} SStaticSkipMb;
+
+typedef struct TagStaticSkipMap {
+SStaticSkipMb*  pMb;                    // one for each MB of the layer
+int32_t*        pRowSad;                // 8x8 SADs of an MB row, top and bottom luma then Cb and Cr
+uint8_t         uiQp;                   // QP the MBs are classified at, that of the picture
+uint8_t         uiChromaQp;
+bool            bMapValid;              // whether pMb is built for the current picture
+} SStaticSkipMap;
+
 typedef struct TagSliceBufferInfo {
 SSlice*                 pSliceBuffer;  // slice buffer for multi thread,
 int32_t                 iMaxSliceNum;
@@ -80,6 +111,16 @@ SSubsetSps*             pSubsetSpsP;    // current pSubsetSps used, memory alloc
 SWelsSPS*               pSpsP;          // current pSps based avc used, memory alloc in external
 SWelsPPS*               pPpsP;          // current pPps used
 } SLayerInfo;
+typedef struct TagQualityMetrics {
+bool            bEnabled;       // the picture of the layer is measured, refer to WelsQualityMetricsInit()
+int32_t         iWidth;         // picture size without the cropped MB padding
+int32_t         iHeight;
+int32_t         iMbRowsDone;    // MB rows measured, a row is final once the row below is deblocked
+int64_t         iSse[3];        // squared error of Y, Cb and Cr
+double          dSsimSum;       // SSIM summed over the luma 8x8 blocks
+int32_t         iSsimBlockNum;
+} SQualityMetrics;
+
 /* Layer Representation */
 struct TagDqLayer {
 SLayerInfo              sLayerInfo;
@@ -106,6 +147,7 @@ uint8_t                 uiDisableInterLayerDeblockingFilterIdc;
 int8_t                  iInterLayerSliceAlphaC0Offset;
 int8_t                  iInterLayerSliceBetaOffset;
 bool                    bDeblockingParallelFlag; //parallel_deblocking_flag
+bool                    bDeblockingOverlappedFlag; // frame deblocking done by rows while the slices are coded
 
 SPicture*               pRefPic;        // reference picture pointer
 SPicture*               pDecPic;        // reconstruction picture pointer for layer
@@ -124,6 +166,15 @@ int32_t*                pCountMbNumInSlice;
 bool                    bNeedAdjustingSlicing;
 
 SFeatureSearchPreparation* pFeatureSearchPreparation;
+SMePyramid*             pMePyramid;     // allocated once hierarchical ME is in use
+SStaticSkipMap*         pStaticSkipMap; // allocated once the static skip prefilter is in use
+
+/* intra refresh of the current picture, refer to WelsIntraRefreshLayerInit() */
+int32_t                 iRefreshMbRowStart;     // first MB row of the intra band, the rows above predict from the refreshed rows of pRefPic only
+int32_t                 iRefreshMbRowEnd;       // MB row below the band
+int32_t                 iRefreshRefMbRows;      // refreshed MB rows of pRefPic
+
+SQualityMetrics         sQualityMetrics;        // PSNR and SSIM of the current picture, refer to ENCODER_OPTION_QUALITY_METRICS
 
 SDqLayer*               pRefLayer;              // pointer to referencing dq_layer of current layer to be decoded
 };
@@ -233,6 +233,11 @@ void WelsDiamondCrossSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice*
 #define LIST_SIZE_MSE_16x16 0x00878  //(avg+mse)/2, max= (255+16*255)/2
 
 #define FME_DEFAULT_FEATURE_INDEX (0)
+int32_t RequestMePyramid (CMemoryAlign* pMa, const int32_t kiMbWidth, const int32_t kiMbHeight,
+                          SMePyramid** ppMePyramid);
+void ReleaseMePyramid (CMemoryAlign* pMa, SMePyramid** ppMePyramid);
+void PerformMePyramidSearch (SWelsFuncPtrList* pFunc, SDqLayer* pCurLayer, SStageProfiler* pProfiler);
+
 #define FMESWITCH_DEFAULT_GOODFRAME_NUM (2)
 #define FMESWITCH_MBSAD_THRESHOLD   30 // empirically set.
 
@@ -248,6 +253,7 @@ void SumOf8x8BlockOfFrame_c (uint8_t* pRefPicture, const int32_t kiWidth, const
 void SumOf16x16BlockOfFrame_c (uint8_t* pRefPicture, const int32_t kiWidth, const int32_t kiHeight,
                                const int32_t kiRefStride,
                                uint16_t* pFeatureOfBlock, uint32_t pTimesOfFeatureValue[]);
+void BlockHash8x8_c (const uint8_t* pSrc, const int32_t kiStride, const int32_t kiNum, uint64_t* pHash);
 
 #ifdef X86_ASM
 extern "C"
@@ -266,6 +272,7 @@ void SumOf8x8BlockOfFrame_sse4 (uint8_t* pRefPicture, const int32_t kiWidth, con
                 const int32_t kiRefStride, uint16_t* pFeatureOfBlock, uint32_t pTimesOfFeatureValue[]);
 void SumOf16x16BlockOfFrame_sse4 (uint8_t* pRefPicture, const int32_t kiWidth, const int32_t kiHeight,
                 const int32_t kiRefStride, uint16_t* pFeatureOfBlock, uint32_t pTimesOfFeatureValue[]);
+void BlockHash8x8_sse42 (const uint8_t* pSrc, const int32_t kiStride, const int32_t kiNum, uint64_t* pHash);
 }
 #endif
 #ifdef HAVE_NEON
@@ -311,6 +318,9 @@ int32_t RequestFeatureSearchPreparation (CMemoryAlign* pMa, const int32_t kiFram
     const int32_t iNeedFeatureStorage,
     SFeatureSearchPreparation* pFeatureSearchPreparation);
 int32_t ReleaseFeatureSearchPreparation (CMemoryAlign* pMa, uint16_t*& pFeatureOfBlock);
+int32_t RequestScreenBlockHashIndex (CMemoryAlign* pMa, const int32_t kiFrameWidth, const int32_t kiFrameHeight,
+                                     SScreenBlockHashIndex** ppHashIndex);
+void ReleaseScreenBlockHashIndex (CMemoryAlign* pMa, SScreenBlockHashIndex** ppHashIndex);
 
 #define FMESWITCH_DEFAULT_GOODFRAME_NUM (2)
 #define FME_DEFAULT_FEATURE_INDEX (0)
@@ -318,6 +328,8 @@ int32_t ReleaseFeatureSearchPreparation (CMemoryAlign* pMa, uint16_t*& pFeatureO
 
 void PerformFMEPreprocess (SWelsFuncPtrList* pFunc, SPicture* pRef, uint16_t* pFeatureOfBlock,
                            SScreenBlockFeatureStorage* pScreenBlockFeatureStorage);
+void PerformBlockHashIndex (SWelsFuncPtrList* pFunc, SPicture* pRef, SScreenBlockHashIndex* pHashIndex,
+                            const SScreenBlockHashIndex* kpPrevIndex);
 bool SetFeatureSearchIn (SWelsFuncPtrList* pFunc,  const SWelsME& sMe,
                          const SSlice* pSlice, SScreenBlockFeatureStorage* pRefFeatureStorage,
                          const int32_t kiEncStride, const int32_t kiRefStride,
@@ -330,6 +342,10 @@ void UpdateFMESwitchNull (SDqLayer* pCurLayer);
 
 void WelsDiamondCrossFeatureSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice,
                                     const int32_t kiEncStride, const int32_t kiRefStride);
+bool WelsBlockHashSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice,
+                          const int32_t kiEncStride, const int32_t kiRefStride);
+bool WelsBlockHashSearchNull (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice,
+                              const int32_t kiEncStride, const int32_t kiRefStride);
 
 //inline functions
 inline void SetMvWithinIntegerMvRange (const int32_t kiMbWidth, const int32_t kiMbHeight, const int32_t kiMbX,
@@ -59,7 +59,8 @@ void WelsSpatialWriteSubMbPred (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurM
 
 void WelsSpatialWriteMbPred (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb);
 void WelsInitSliceCabac(sWelsEncCtx* pEncCtx,SSlice* pSlice);
-void WelsCabacInit(void *pCtx);
+void WelsCabacInit();
+uint32_t WelsCabacContextTableSize();
 void WelsWriteSliceEndSyn(SSlice *pSlice,bool bEntropyCodingModeFlag);
 //for Base Layer CAVLC writing
 int32_t WelsSpatialWriteMbSyn (sWelsEncCtx* Ctx, SSlice* pSlice, SMB* pCurMb);
@@ -126,17 +126,34 @@ typedef void (*PInterMdFunc) (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* sl
 
 typedef int32_t (*PSampleSadSatdCostFunc) (uint8_t*, int32_t, uint8_t*, int32_t);
 typedef void (*PSample4SadCostFunc) (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
+typedef void (*PSampleSadMultiCostFunc) (uint8_t*, int32_t, uint8_t**, int32_t, const uint16_t*, int32_t, int32_t*);
+typedef void (*PSampleSadRowFunc) (uint8_t*, int32_t, uint8_t*, int32_t, int32_t, int32_t*);
+typedef void (*PSampleSatdQuarFourFunc) (uint8_t*, int32_t, uint8_t**, int32_t, uint8_t**, const int32_t*, int32_t*);
 typedef int32_t (*PIntraPred4x4Combined3Func) (uint8_t*, int32_t, uint8_t*, int32_t, uint8_t*, int32_t*, int32_t,
     int32_t, int32_t);
 typedef int32_t (*PIntraPred16x16Combined3Func) (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*, int32_t, uint8_t*);
 typedef int32_t (*PIntraPred8x8Combined3Func) (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*, int32_t, uint8_t*,
     uint8_t*, uint8_t*);
+typedef void (*PGetIntraPredFunc) (uint8_t* pPrediction, uint8_t* pRef, const int32_t kiStride);
+//all available modes in one call: kpModeCost is indexed by mode, the best predictor goes to the uint8_t* output
+//the PSampleSadSatdCostFunc measures the modes the source transform cannot be shared with
+typedef int32_t (*PIntraPred4x4AllModesFunc) (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const uint8_t*, int32_t, const int32_t*, uint8_t*, int32_t*);
+typedef int32_t (*PIntraPred16x16AllModesFunc) (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const int8_t*, int32_t, const int32_t*, uint8_t*, int32_t*);
+typedef int32_t (*PIntraPred8x8AllModesFunc) (uint8_t*, int32_t, uint8_t*, int32_t, PGetIntraPredFunc*,
+    PSampleSadSatdCostFunc, const int8_t*, int32_t, const int32_t*, uint8_t*, int32_t*, uint8_t*, uint8_t*);
+//sums of the source, the reconstruction, the squares of both and their products over an 8x8 block, for PSNR and SSIM
+typedef void (*PSampleSsimStatsFunc) (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
 
 typedef uint32_t (*PSampleSadHor8Func) (uint8_t*, int32_t, uint8_t*, int32_t, uint16_t*, int32_t*);
 typedef void (*PMotionSearchFunc) (SWelsFuncPtrList* pFuncList, SDqLayer* pCurDqLayer, SWelsME* pMe,
                                    SSlice* pSlice);
 typedef void (*PSearchMethodFunc) (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice, const int32_t kiEncStride,
                                    const int32_t kiRefStride);
+typedef bool (*PBlockHashSearchFunc) (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice,
+                                      const int32_t kiEncStride, const int32_t kiRefStride);
+typedef void (*PBlockHash8x8Func) (const uint8_t* pSrc, const int32_t kiStride, const int32_t kiNum, uint64_t* pHash);
 typedef void (*PCalculateSatdFunc) (PSampleSadSatdCostFunc pSatd, SWelsME* pMe, const int32_t kiEncStride,
                                     const int32_t kiRefStride);
 typedef bool (*PCheckDirectionalMv) (PSampleSadSatdCostFunc pSad, SWelsME* pMe,
@@ -163,19 +180,34 @@ typedef struct TagSampleDealingFunc {
   PSampleSadSatdCostFunc            pfSampleSad[MAX_BLOCK_TYPE];
   PSampleSadSatdCostFunc            pfSampleSatd[MAX_BLOCK_TYPE];
   PSample4SadCostFunc                 pfSample4Sad[MAX_BLOCK_TYPE];
+  // arbitrary candidates with their MVD cost, NULL without a batched kernel: one by one through pfSampleSad
+  PSampleSadMultiCostFunc             pfSampleSadMulti[MAX_BLOCK_TYPE];
+  // SATDs of the four quarter-pel averages in one pass, NULL: pfSampleAveraging and pfMeCost per point
+  PSampleSatdQuarFourFunc             pfSampleSatdQuarFour[MAX_BLOCK_TYPE];
+  // 8x8 SADs of a run of blocks side by side, refer to PerformStaticSkipPrefilter()
+  PSampleSadRowFunc                   pfSampleSad8x8Row;
   PIntraPred4x4Combined3Func      pfIntra4x4Combined3Satd;
   PIntraPred16x16Combined3Func  pfIntra16x16Combined3Satd;
   PIntraPred16x16Combined3Func  pfIntra16x16Combined3Sad;
   PIntraPred8x8Combined3Func      pfIntra8x8Combined3Satd;
   PIntraPred8x8Combined3Func      pfIntra8x8Combined3Sad;
+  PIntraPred4x4AllModesFunc       pfIntra4x4AllModesSatd;
+  PIntraPred16x16AllModesFunc     pfIntra16x16AllModesSatd;
+  PIntraPred16x16AllModesFunc     pfIntra16x16AllModesSad;
+  PIntraPred8x8AllModesFunc       pfIntra8x8AllModesSatd;
+  PIntraPred8x8AllModesFunc       pfIntra8x8AllModesSad;
 
   PSampleSadSatdCostFunc*            pfMdCost;
   PSampleSadSatdCostFunc*            pfMeCost;
   PIntraPred16x16Combined3Func   pfIntra16x16Combined3;
   PIntraPred8x8Combined3Func       pfIntra8x8Combined3;
   PIntraPred4x4Combined3Func       pfIntra4x4Combined3;
+  PIntraPred16x16AllModesFunc     pfIntra16x16AllModes;
+  PIntraPred8x8AllModesFunc       pfIntra8x8AllModes;
+  PIntraPred4x4AllModesFunc       pfIntra4x4AllModes;
+
+  PSampleSsimStatsFunc            pfSampleSsimStats8x8;
 } SSampleDealingFunc;
-typedef void (*PGetIntraPredFunc) (uint8_t* pPrediction, uint8_t* pRef, const int32_t kiStride);
 
 typedef int32_t (*PGetVarianceFromIntraVaaFunc) (uint8_t* pSampelY, const int32_t kiStride);
 typedef uint8_t (*PGetMbSignFromInterVaaFunc) (int32_t* pSad8x8);
@@ -224,6 +256,8 @@ struct TagWelsFuncPointerList {
   PMotionSearchFunc
   pfMotionSearch[BLOCK_STATIC_IDC_ALL]; //svc_encode_slice.c svc_mode_decision.c svc_enhance_layer_md.c svc_base_layer_md.c
   PSearchMethodFunc pfSearchMethod[BLOCK_SIZE_ALL];
+  PBlockHashSearchFunc pfBlockHashSearch;
+  PBlockHash8x8Func pfBlockHash8x8;   // hashes of the kiNum 8x8 blocks starting at consecutive pixels of a row
   PCalculateSatdFunc pfCalculateSatd;
   PCheckDirectionalMv pfCheckDirectionalMv;
 
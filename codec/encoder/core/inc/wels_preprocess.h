@@ -77,6 +77,40 @@ typedef struct {
   unsigned char*        pBestBlockStaticIdc;
 } SRefInfoParam;
 
+/*
+ *  preprocessing results of the highest spatial layer of a picture, handed to the encoders of the other bitrates of the
+ *  same source through SMotionAnalysis::pPreprocess; the results of each macroblock follow, refer to SharedAnalysisSize()
+ */
+#define SHARED_VAA_SSD          0x01  // VAA statistics with the square differences
+#define SHARED_VAA_VAR          0x02  // VAA statistics with the variances
+#define SHARED_VAA_BGD          0x04  // VAA statistics for the background detection
+#define SHARED_BGD              0x08  // background flags
+#define SHARED_BGD_DETECT       0x10  // background flags detected rather than cleared
+#define SHARED_AQ               0x20  // adaptive quantization
+
+typedef struct TagSharedSrcId {
+  int64_t     iTimeStamp;
+  uint32_t    uiSeq;                  // order of input, 0: none
+} SSharedSrcId;
+
+typedef struct TagSharedAnalysis {
+  int32_t       iSize;                // bytes of the header and of the results of the macroblocks
+  int32_t       iMbWidth;
+  int32_t       iMbHeight;
+  bool          bDenoised;            // the source pictures were denoised before the analysis
+  bool          bSceneChange;         // bSceneChangeFlag is known for sSceneCur against sSceneRef
+  bool          bSceneChangeFlag;
+  bool          bVaa;                 // the results of the macroblocks are known for sCur against sRef and sLast
+  uint8_t       uiVaaFlags;           // SHARED_* the results were computed with
+  int32_t       iFrameSad;
+  int32_t       iAverMotionTextureIndexToDeltaQp;
+  SSharedSrcId  sSceneCur;
+  SSharedSrcId  sSceneRef;
+  SSharedSrcId  sCur;
+  SSharedSrcId  sRef;
+  SSharedSrcId  sLast;                // reference of the adaptive quantization
+} SSharedAnalysis;
+
 typedef struct TagVAAFrameInfo {
   SVAACalcResult        sVaaCalcInfo;
   SAdaptiveQuantizationParam sAdaptiveQuantParam;
@@ -142,6 +176,16 @@ class CWelsPreProcess {
   void UpdateSrcListLosslessScreenRefSelectionWithLtr (SPicture* pCurPicture, const int32_t kiCurDid,
       const int32_t kuiMarkLongTermPicIdx, SPicture** pLongRefList);
 
+  void GetInPlaceSourceInfo (int32_t iStride[3], bool* pLastInPlace);
+  void EndInPlaceSource ();
+
+  /*!
+  * \brief  preprocessing results shared between the encoders of the bitrates of the same source, highest layer only;
+  *         the results handed in apply to the next picture wherever it compares the same source pictures
+  */
+  int32_t SetSharedAnalysis (const void* kpData, const int32_t kiSize);
+  void    GetSharedAnalysis (const bool kbHandedIn, const void** ppData, int32_t* pSize);
+
 
  protected:
   bool GetSceneChangeFlag (ESceneChangeIdc eSceneChangeIdc);
@@ -178,6 +222,23 @@ class CWelsPreProcess {
   void WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic, const SSourcePicture* kpSrc,
                               const int32_t kiWidth, const int32_t kiHeight);
 
+  /*!
+  * \brief  in place reading of the source picture, the orig frame takes the planes of the caller during the encoding
+  *         and those of its reconstruction afterwards, which stands for the source in the analysis of the next frame;
+  *         a frame ending before its reconstruction (skip, error) gives its own planes back, see EndInPlaceSource()
+  */
+  bool IsInPlaceSourceAllowed (sWelsEncCtx* pCtx, const SSourcePicture* kpSrc);
+  void BindInPlaceSource (SPicture* pPic, const SSourcePicture* kpSrc);
+  void ReleaseInPlaceSource (SPicture* pRecPic);
+  void RestoreOwnPlanes (SPicture* pPic);
+
+  bool IsAnalysisShareable (sWelsEncCtx* pCtx);
+  bool TakeSharedAnalysis (sWelsEncCtx* pCtx, SPicture* pCurPic, SPicture* pRefPic, SPicture* pLastPic,
+                           const uint8_t kuiFlags);
+  void KeepSharedAnalysis (sWelsEncCtx* pCtx, SPicture* pCurPic, SPicture* pRefPic, SPicture* pLastPic,
+                           const uint8_t kuiFlags);
+  SSharedAnalysis* AllocSharedAnalysis (sWelsEncCtx* pCtx, const char* kpTag);
+
   /*!
   * \brief  exchange two picture pData planes
   * \param  ppPic1      picture pointer to picture 1
@@ -190,6 +251,11 @@ class CWelsPreProcess {
                            int32_t iRefTemporalIdx);
   SPicture* GetBestRefPic (const int32_t kiDidx, const int32_t iRefTemporalIdx);
  protected:
+  /*!
+  * \brief  run a method of the processing module, timed when the profiling is enabled
+  */
+  EResult ProcessVp (int32_t iMethodIdx, SPixMap* pSrc, SPixMap* pDst);
+
   IWelsVP*         m_pInterfaceVp;
   sWelsEncCtx*     m_pEncCtx;
   uint8_t          m_uiSpatialLayersInTemporal[MAX_DEPENDENCY_LAYER];
@@ -199,6 +265,19 @@ class CWelsPreProcess {
   SPicture*        m_pLastSpatialPicture[MAX_DEPENDENCY_LAYER][2];
   bool             m_bInitDone;
   uint8_t          m_uiSpatialPicNum[MAX_DEPENDENCY_LAYER];
+
+  /* in place source reading, single spatial layer only */
+  SPicture*        m_pInPlacePic;          // orig frame reading the caller planes, NULL if none
+  bool             m_bInPlaceUsed;         // orig frames may point to planes they do not own
+  bool             m_bLastInPlace;
+  int32_t          m_iOwnPlaneOffset[3];   // layout of the orig frames of the highest layer in their buffer
+  int32_t          m_iOwnLineSize[3];
+
+  /* preprocessing results shared with the encoders of the other bitrates */
+  SSharedAnalysis* m_pSharedOut;          // results of the last picture, NULL until first kept
+  SSharedAnalysis* m_pSharedIn;           // results handed in for the next picture, NULL until first handed in
+  bool             m_bSharedIn;
+  uint32_t         m_uiSrcSeq;            // source pictures taken so far
  protected:
   /* For Downsampling & VAA I420 based source pictures */
   SPicture*        m_pSpatialPic[MAX_DEPENDENCY_LAYER][MAX_REF_PIC_COUNT + 1];
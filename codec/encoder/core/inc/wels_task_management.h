@@ -62,6 +62,7 @@ class IWelsTaskManage {
   static IWelsTaskManage* CreateTaskManage (sWelsEncCtx* pCtx, const int32_t iSpatialLayer, const bool bNeedLock);
 
   virtual int32_t  GetThreadPoolThreadNum() = 0;
+  virtual void     UpdateScheduling() {}
 };
 
 
@@ -84,6 +85,7 @@ class  CWelsTaskManageBase : public IWelsTaskManage, public WelsCommon::IWelsTas
   virtual WelsErrorType OnTaskCancelled();
 
   int32_t  GetThreadPoolThreadNum();
+  virtual void   UpdateScheduling();
 
  protected:
   virtual WelsErrorType  CreateTasks (sWelsEncCtx* pEncCtx, const int32_t kiTaskCount);
@@ -93,6 +95,8 @@ class  CWelsTaskManageBase : public IWelsTaskManage, public WelsCommon::IWelsTas
  protected:
   sWelsEncCtx*    m_pEncCtx;
   WelsCommon::CWelsThreadPool*   m_pThreadPool;
+  WelsCommon::SWelsTaskGroup     m_sTaskGroup;
+  int32_t         m_iThreadBufferNum;
 
   TASKLIST_TYPE*  m_pcAllTaskList[CWelsBaseTask::WELS_ENC_TASK_ALL][MAX_DEPENDENCY_LAYER];
   TASKLIST_TYPE*  m_cEncodingTaskList[MAX_DEPENDENCY_LAYER];
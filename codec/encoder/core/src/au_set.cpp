@@ -462,6 +462,27 @@ int32_t WelsWritePpsSyntax (SWelsPPS* pPps, SBitStringAux* pBitStringAux,
   return 0;
 }
 
+int32_t WelsWriteRecoveryPointSei (SBitStringAux* pBitStringAux, const int32_t kiRecoveryFrameCnt) {
+  // recovery_frame_cnt, exact_match_flag, broken_link_flag and changing_slice_group_idc
+  const int32_t kiPayloadBits = BsSizeUE (kiRecoveryFrameCnt) + 4;
+
+  BsWriteBits (pBitStringAux, 8, 6/*payloadType: recovery point*/);
+  BsWriteBits (pBitStringAux, 8, (kiPayloadBits + 7) >> 3);
+
+  BsWriteUE (pBitStringAux, kiRecoveryFrameCnt);
+  BsWriteOneBit (pBitStringAux, true/*bExactMatchFlag*/);
+  BsWriteOneBit (pBitStringAux, false/*bBrokenLinkFlag*/);
+  BsWriteBits (pBitStringAux, 2, 0/*uiChangingSliceGroupIdc*/);
+  if (kiPayloadBits & 7) { // bit_equal_to_one and bit_equal_to_zero up to the payload end
+    BsWriteOneBit (pBitStringAux, 1);
+    BsWriteBits (pBitStringAux, 7 - (kiPayloadBits & 7), 0);
+  }
+
+  BsRbspTrailingBits (pBitStringAux);
+
+  return 0;
+}
+
 static inline bool WelsGetPaddingOffset (int32_t iActualWidth, int32_t iActualHeight,  int32_t iWidth,
     int32_t iHeight, SCropOffset& pOffset) {
   if ((iWidth < iActualWidth) || (iHeight < iActualHeight))
@@ -653,11 +653,95 @@ void DeblockingMbAvcbase (SWelsFuncPtrList* pFunc, SMB* pCurMb, SDeblockingFilte
   }
 }
 
-void  DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc) {
+/*!
+ * \brief  quality metrics, refer to ENCODER_OPTION_QUALITY_METRICS
+ *
+ * MB row j is final once row j + 1 is deblocked, whose filter changes the last sample rows of row j, so the rows are
+ * measured right behind the filter while they are still in cache. The 8x8 blocks inside the picture give the squared
+ * error and the luma SSIM; the blocks cut by the cropped edge count in the squared error only.
+ */
+static inline int32_t SampleSse_c (uint8_t* pSrc, int32_t iSrcStride, uint8_t* pRec, int32_t iRecStride,
+                                   const int32_t kiWidth, const int32_t kiHeight) {
+  int32_t iSse = 0;
+  int32_t i, j;
+  for (i = 0; i < kiHeight; i++) {
+    for (j = 0; j < kiWidth; j++) {
+      const int32_t kiDiff = pSrc[j] - pRec[j];
+      iSse += kiDiff * kiDiff;
+    }
+    pSrc += iSrcStride;
+    pRec += iRecStride;
+  }
+  return iSse;
+}
+
+static inline double SsimOf8x8 (const int32_t* kpStats) {
+  static const double kdC1 = .01 * .01 * 255 * 255 * 64;
+  static const double kdC2 = .03 * .03 * 255 * 255 * 64 * 63;
+  const double kdSumA   = kpStats[0];
+  const double kdSumB   = kpStats[1];
+  const double kdVars   = (double)kpStats[2] * 64 - kdSumA * kdSumA - kdSumB * kdSumB;
+  const double kdCovar  = (double)kpStats[3] * 64 - kdSumA * kdSumB;
+  return (2 * kdSumA * kdSumB + kdC1) * (2 * kdCovar + kdC2) / ((kdSumA * kdSumA + kdSumB * kdSumB + kdC1) *
+         (kdVars + kdC2));
+}
+
+static void QualityMetricsRows (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, const int32_t kiRowEnd) {
+  SQualityMetrics* pMetrics           = &pCurDq->sQualityMetrics;
+  PSampleSsimStatsFunc pfSsimStats    = pFunc->sSampleDealingFuncs.pfSampleSsimStats8x8;
+  int32_t iStats[4];
+
+  for (; pMetrics->iMbRowsDone < kiRowEnd; ++ pMetrics->iMbRowsDone) {
+    for (int32_t iPlane = 0; iPlane < 3; iPlane++) {
+      const int32_t kiShift     = (iPlane == 0) ? 0 : 1;
+      const int32_t kiWidth     = pMetrics->iWidth >> kiShift;
+      const int32_t kiTop       = (pMetrics->iMbRowsDone << 4) >> kiShift;
+      const int32_t kiBottom    = WELS_MIN (kiTop + (MB_HEIGHT_LUMA >> kiShift), pMetrics->iHeight >> kiShift);
+      const int32_t kiSrcStride = pCurDq->iEncStride[iPlane];
+      const int32_t kiRecStride = pCurDq->pDecPic->iLineSize[iPlane];
+      for (int32_t iY = kiTop; iY < kiBottom; iY += 8) {
+        uint8_t* pSrc         = pCurDq->pEncData[iPlane] + iY * kiSrcStride;
+        uint8_t* pRec         = pCurDq->pDecPic->pData[iPlane] + iY * kiRecStride;
+        const int32_t kiRows  = WELS_MIN (8, kiBottom - iY);
+        for (int32_t iX = 0; iX < kiWidth; iX += 8) {
+          if (kiRows == 8 && iX + 8 <= kiWidth) {
+            pfSsimStats (pSrc + iX, kiSrcStride, pRec + iX, kiRecStride, iStats);
+            pMetrics->iSse[iPlane] += iStats[2] - 2 * iStats[3];
+            if (iPlane == 0) {
+              pMetrics->dSsimSum += SsimOf8x8 (iStats);
+              ++ pMetrics->iSsimBlockNum;
+            }
+          } else {
+            pMetrics->iSse[iPlane] += SampleSse_c (pSrc + iX, kiSrcStride, pRec + iX, kiRecStride,
+                                                   WELS_MIN (8, kiWidth - iX), kiRows);
+          }
+        }
+      }
+    }
+  }
+}
+
+void WelsQualityMetricsInit (sWelsEncCtx* pEnc) {
+  SQualityMetrics* pMetrics = &pEnc->pCurDqLayer->sQualityMetrics;
+  const SSpatialLayerInternal* kpDlp = &pEnc->pSvcParam->sDependencyLayers[pEnc->uiDependencyId];
+
+  memset (pMetrics, 0, sizeof (SQualityMetrics));
+  pMetrics->bEnabled  = pEnc->pSvcParam->bQualityMetrics;
+  pMetrics->iWidth    = kpDlp->iActualWidth & ~1;
+  pMetrics->iHeight   = kpDlp->iActualHeight & ~1;
+}
+
+void WelsQualityMetricsFinish (sWelsEncCtx* pEnc) {
+  SDqLayer* pCurDq = pEnc->pCurDqLayer;
+  if (pCurDq->sQualityMetrics.bEnabled)
+    QualityMetricsRows (pCurDq, pEnc->pFuncList, pCurDq->iMbHeight);
+}
+
+void DeblockingFilterRowsAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, const int32_t kiFirstRow,
+                                  const int32_t kiRowNum) {
   int32_t i, j;
   const int32_t kiMbWidth   = pCurDq->iMbWidth;
-  const int32_t kiMbHeight  = pCurDq->iMbHeight;
-  SMB* pCurrentMbBlock      = pCurDq->sMbDataP;
+  SMB* pCurrentMbBlock      = pCurDq->sMbDataP + kiFirstRow * kiMbWidth;
   SSliceHeaderExt* sSliceHeaderExt = &pCurDq->ppSliceInLayer[0]->sSliceHeaderExt;
   SDeblockingFilter pFilter;
 
@@ -676,7 +760,7 @@ void  DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc) {
 
   pFilter.iMbStride = kiMbWidth;
 
-  for (j = 0; j < kiMbHeight; ++j) {
+  for (j = kiFirstRow; j < kiFirstRow + kiRowNum; ++j) {
     pFilter.pCsData[0] = pCurDq->pDecPic->pData[0] + ((j * pFilter.iCsStride[0]) << 4);
     pFilter.pCsData[1] = pCurDq->pDecPic->pData[1] + ((j * pFilter.iCsStride[1]) << 3);
     pFilter.pCsData[2] = pCurDq->pDecPic->pData[2] + ((j * pFilter.iCsStride[2]) << 3);
@@ -687,9 +771,15 @@ void  DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc) {
       pFilter.pCsData[1] += MB_WIDTH_CHROMA;
       pFilter.pCsData[2] += MB_WIDTH_CHROMA;
     }
+    if (pCurDq->sQualityMetrics.bEnabled)
+      QualityMetricsRows (pCurDq, pFunc, (j + 1 == pCurDq->iMbHeight) ? (j + 1) : j);
   }
 }
 
+void  DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc) {
+  DeblockingFilterRowsAvcbase (pCurDq, pFunc, 0, pCurDq->iMbHeight);
+}
+
 void DeblockingFilterSliceAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, SSlice* pSlice) {
   SMB* pMbList                          = pCurDq->sMbDataP;
   SSliceHeaderExt* sSliceHeaderExt      = &pSlice->sSliceHeaderExt;
@@ -761,6 +851,72 @@ void PerformDeblockingFilter (sWelsEncCtx* pEnc) {
   }
 }
 
+/*!
+ * \brief  overlapped deblocking, refer to ENCODER_OPTION_OVERLAPPED_DEBLOCKING
+ *
+ * The filter of MB row j changes the last sample rows of row j which the intra prediction of row j + 1 reads, and it
+ * reads the samples row j - 1 left after its own filter. So row j is filtered once rows j and j + 1 are reconstructed
+ * and row j - 1 is filtered, in raster order as DeblockingFilterFrameAvcbase() does. The slice threads count the MBs
+ * they finish; the thread that completes a row filters whatever became ready, one thread at a time, and the caller
+ * filters the remaining rows after the slices are coded.
+ */
+void WelsOverlappedDeblockingInit (sWelsEncCtx* pEnc) {
+  SSliceThreading* pSmt = pEnc->pSliceThreading;
+  if (!pEnc->pCurDqLayer->bDeblockingOverlappedFlag)
+    return;
+  memset (pSmt->pDbkRowMbCount, 0, pEnc->pCurDqLayer->iMbHeight * sizeof (int32_t));
+  pSmt->iDbkRowsDone = 0;
+  pSmt->bDbkBusy     = false;
+}
+
+static void OverlappedDeblockingAdvance (sWelsEncCtx* pEnc, const bool kbLastRowReady) {
+  SSliceThreading* pSmt     = pEnc->pSliceThreading;
+  SDqLayer* pCurDq          = pEnc->pCurDqLayer;
+  const int32_t kiMbWidth   = pCurDq->iMbWidth;
+  const int32_t kiMbHeight  = pCurDq->iMbHeight;
+
+  WelsMutexLock (&pSmt->mutexDeblocking);
+  if (pSmt->bDbkBusy) { // the filtering thread checks the rows again before it leaves
+    WelsMutexUnlock (&pSmt->mutexDeblocking);
+    return;
+  }
+  pSmt->bDbkBusy = true;
+  for (;;) {
+    const int32_t kiRow = pSmt->iDbkRowsDone;
+    if (kiRow >= kiMbHeight || pSmt->pDbkRowMbCount[kiRow] < kiMbWidth)
+      break;
+    if ((kiRow + 1 < kiMbHeight) ? (pSmt->pDbkRowMbCount[kiRow + 1] < kiMbWidth) : !kbLastRowReady)
+      break;
+    WelsMutexUnlock (&pSmt->mutexDeblocking);
+    DeblockingFilterRowsAvcbase (pCurDq, pEnc->pFuncList, kiRow, 1);
+    WelsMutexLock (&pSmt->mutexDeblocking);
+    ++ pSmt->iDbkRowsDone;
+  }
+  pSmt->bDbkBusy = false;
+  WelsMutexUnlock (&pSmt->mutexDeblocking);
+}
+
+void WelsOverlappedDeblockingMbDone (sWelsEncCtx* pEnc, SSlice* pSlice, SMB* pCurMb) {
+  SSliceThreading* pSmt = pEnc->pSliceThreading;
+  bool bRowDone;
+
+  if (!pEnc->pCurDqLayer->bDeblockingOverlappedFlag)
+    return;
+  WelsMutexLock (&pSmt->mutexDeblocking);
+  bRowDone = (++ pSmt->pDbkRowMbCount[pCurMb->iMbY] == pEnc->pCurDqLayer->iMbWidth);
+  WelsMutexUnlock (&pSmt->mutexDeblocking);
+  if (bRowDone) {
+    const int32_t kiLastStage = ProfilerSwitchStage (&pSlice->sProfiler, PROFILING_STAGE_DEBLOCKING);
+    OverlappedDeblockingAdvance (pEnc, false);
+    ProfilerSwitchStage (&pSlice->sProfiler, kiLastStage);
+  }
+}
+
+void WelsOverlappedDeblockingFinish (sWelsEncCtx* pEnc) {
+  OverlappedDeblockingAdvance (pEnc, true);
+  assert (pEnc->pSliceThreading->iDbkRowsDone == pEnc->pCurDqLayer->iMbHeight);
+}
+
 void WelsBlockFuncInit (PSetNoneZeroCountZeroFunc* pfSetNZCZero,  int32_t iCpu) {
   *pfSetNZCZero = WelsNonZeroCount_c;
 #ifdef HAVE_NEON
@@ -404,6 +404,66 @@ EVideoFrameType DecideFrameType (sWelsEncCtx* pEncCtx, const int8_t kiSpatialNum
   return iFrameType;
 }
 
+bool WelsIntraRefreshEnabled (const SWelsSvcCodingParam* kpSvcParam) {
+  // enhancement layers of SVC predict from their base layer too, which the sweep does not follow;
+  // an intra period of 1 leaves no reference to predict from
+  return kpSvcParam->iIntraRefreshFrames > 0 && 1 != kpSvcParam->uiIntraPeriod
+         && (kpSvcParam->bSimulcastAVC || 1 == kpSvcParam->iSpatialLayerNum);
+}
+
+bool WelsIntraRefreshFrameInit (sWelsEncCtx* pEncCtx, const EVideoFrameType keFrameType, const int32_t kiDidx) {
+  SWelsSvcCodingParam* pSvcParam = pEncCtx->pSvcParam;
+  SSpatialLayerInternal* pParamInternal = &pSvcParam->sDependencyLayers[kiDidx];
+  if (videoFrameTypeP != keFrameType) { // refreshed at once
+    pParamInternal->iRefreshFrameIdx = pParamInternal->iRefreshFrameNum = 0;
+    return false;
+  }
+  // a sweep started is completed even if the option is turned off meanwhile
+  if (1 + pParamInternal->iRefreshFrameIdx < pParamInternal->iRefreshFrameNum) {
+    ++ pParamInternal->iRefreshFrameIdx;
+    return false;
+  }
+  pParamInternal->iRefreshFrameIdx = pParamInternal->iRefreshFrameNum = 0;
+  if (!WelsIntraRefreshEnabled (pSvcParam))
+    return false;
+
+  // a sweep starts where the periodic IDR would be, or right after the previous one without intra period
+  const int32_t kiIntraPeriod = (int32_t)pSvcParam->uiIntraPeriod;
+  if (kiIntraPeriod > 0 && 0 != (1 + pParamInternal->iFrameIndex) % kiIntraPeriod)
+    return false;
+  pParamInternal->iRefreshFrameNum = (kiIntraPeriod > 0) ? WELS_MIN (pSvcParam->iIntraRefreshFrames,
+                                     kiIntraPeriod) : pSvcParam->iIntraRefreshFrames;
+  ++ pParamInternal->iRefreshId;
+  return true;
+}
+
+void WelsIntraRefreshLayerInit (sWelsEncCtx* pEncCtx, const int32_t kiDidx) {
+  const SSpatialLayerInternal* kpParamInternal = &pEncCtx->pSvcParam->sDependencyLayers[kiDidx];
+  SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
+  SPicture* pDecPic = pEncCtx->pDecPic;
+  const int32_t kiMbHeight = pCurDqLayer->iMbHeight;
+  const bool kbSweep = (kpParamInternal->iRefreshFrameIdx < kpParamInternal->iRefreshFrameNum);
+
+  pCurDqLayer->iRefreshMbRowStart = pCurDqLayer->iRefreshMbRowEnd = 0;
+  pCurDqLayer->iRefreshRefMbRows  = kiMbHeight;
+  pDecPic->iRefreshId             = kpParamInternal->iRefreshId;
+  pDecPic->iRefreshedMbRows       = kiMbHeight;
+  if (P_SLICE != pEncCtx->eSliceType || NULL == pCurDqLayer->pRefPic
+      || (!kbSweep && !WelsIntraRefreshEnabled (pEncCtx->pSvcParam)))
+    return;
+
+  if (kbSweep) { // band of frame i covers the MB rows [i * h / n, (i + 1) * h / n)
+    pCurDqLayer->iRefreshMbRowStart = kpParamInternal->iRefreshFrameIdx * kiMbHeight / kpParamInternal->iRefreshFrameNum;
+    pCurDqLayer->iRefreshMbRowEnd   = (1 + kpParamInternal->iRefreshFrameIdx) * kiMbHeight /
+                                      kpParamInternal->iRefreshFrameNum;
+  } else { // a reference of an older sweep may still be in use, e.g. a long term one
+    pCurDqLayer->iRefreshMbRowStart = pCurDqLayer->iRefreshMbRowEnd = kiMbHeight;
+  }
+  const SPicture* kpRefPic = pCurDqLayer->pRefPic;
+  pCurDqLayer->iRefreshRefMbRows = (kpRefPic->iRefreshId == kpParamInternal->iRefreshId) ? kpRefPic->iRefreshedMbRows : 0;
+  pDecPic->iRefreshedMbRows      = pCurDqLayer->iRefreshMbRowEnd;
+}
+
 /*!
  * \brief   Dump reconstruction for dependency layer
  */
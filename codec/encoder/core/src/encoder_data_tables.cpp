@@ -34,6 +34,7 @@
 // export date cross various modules (.c)
 #include "md.h"
 #include "vlc_encoder.h"
+#include "set_mb_syn_cabac.h"
 namespace WelsEnc {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -75,6 +76,26 @@ const int8_t g_kiMapModeIntraChroma[7] = {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// extern at set_mb_syn_cabac.h
+// cost of coding the MPS [0] or the LPS [1] of a CABAC state, -log2 of its probability in 1/256 bit
+const uint16_t g_kuiCabacBinCost[64][2] = {
+  { 256,  256}, { 238,  275}, { 221,  294}, { 206,  314},
+  { 192,  333}, { 180,  352}, { 168,  371}, { 157,  391},
+  { 148,  410}, { 139,  429}, { 130,  448}, { 122,  468},
+  { 115,  487}, { 108,  506}, { 102,  525}, {  96,  545},
+  {  90,  564}, {  85,  583}, {  80,  602}, {  76,  622},
+  {  72,  641}, {  68,  660}, {  64,  679}, {  60,  699},
+  {  57,  718}, {  54,  737}, {  51,  756}, {  48,  776},
+  {  46,  795}, {  43,  814}, {  41,  833}, {  39,  853},
+  {  37,  872}, {  35,  891}, {  33,  910}, {  31,  930},
+  {  29,  949}, {  28,  968}, {  26,  987}, {  25, 1007},
+  {  24, 1026}, {  22, 1045}, {  21, 1064}, {  20, 1084},
+  {  19, 1103}, {  18, 1122}, {  17, 1141}, {  16, 1161},
+  {  15, 1180}, {  15, 1199}, {  14, 1218}, {  13, 1238},
+  {  12, 1257}, {  12, 1276}, {  11, 1295}, {  11, 1315},
+  {  10, 1334}, {  10, 1353}, {   9, 1372}, {   9, 1392},
+  {   8, 1411}, {   8, 1430}, {   7, 1449}, {   7, 1469},
+};
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
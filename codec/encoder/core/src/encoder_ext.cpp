@@ -39,6 +39,7 @@
  */
 
 #include "encoder.h"
+#include "extern.h"
 #include "cpu.h"
 #include "utils.h"
 #include "svc_enc_golomb.h"
@@ -738,6 +739,36 @@ int32_t WelsEncoderApplyBitVaryRang (SLogContext* pLogCtx, SWelsSvcCodingParam*
   return ENC_RETURN_SUCCESS;
 }
 
+/*!
+ * \brief   slices per picture of the layer the slice, NAL and bitstream buffers are sized for up front
+ *          refer to ENCODER_OPTION_PREALLOCATE_BUFFERS
+ * \pParam  pParam          SWelsSvcCodingParam*
+ * \pParam  kiDid           dependency layer
+ * \return  0 - buffers grown on demand; otherwise count of slices
+ */
+int32_t GetPreallocSliceNum (SWelsSvcCodingParam* pParam, const int32_t kiDid) {
+  const SSpatialLayerConfig* kpDLayer = &pParam->sSpatialLayers[kiDid];
+  const int32_t kiMbNum = ((kpDLayer->iVideoWidth + 15) >> 4) * ((kpDLayer->iVideoHeight + 15) >> 4);
+
+  if (0 == pParam->iPreallocSliceNum || SM_SIZELIMITED_SLICE != kpDLayer->sSliceArgument.uiSliceMode)
+    return 0;
+  if (pParam->iPreallocSliceNum > 0)
+    return WELS_MIN (pParam->iPreallocSliceNum, kiMbNum);
+
+  // worst case: the largest picture of the level (Table A-1, MinCR) cut into the smallest slices,
+  // a slice is closed once above JUMPPACKETSIZE_CONSTRAINT less the macroblock stepped back,
+  // and the slice partition of each thread may end one slice early
+  const SLevelLimits* pLevelLimit = g_ksLevelLimits;
+  while ((pLevelLimit->uiLevelIdc != LEVEL_5_2) && (pLevelLimit->uiLevelIdc != kpDLayer->uiLevelIdc))
+    pLevelLimit++;
+  const int32_t kiMaxPicBytes   = 384 * kiMbNum / pLevelLimit->uiMinCR;
+  const int32_t kiMinSliceBytes = (int32_t)JUMPPACKETSIZE_CONSTRAINT (kpDLayer->sSliceArgument.uiSliceSizeConstraint)
+                                  - MAX_MACROBLOCK_SIZE_IN_BYTE;
+  if (kiMinSliceBytes <= 0)
+    return kiMbNum;
+  return WELS_MIN (kiMaxPicBytes / kiMinSliceBytes + pParam->iMultipleThreadIdc, kiMbNum);
+}
+
 /*!
  * \brief   acquire count number of layers and NALs based on configurable paramters dependency
  * \pParam  pCtx            sWelsEncCtx*
@@ -762,18 +793,21 @@ int32_t AcquireLayersNals (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pParam, int
     SSpatialLayerConfig* pDLayer = &pParam->sSpatialLayers[iDIndex];
 //    pDLayer->ptr_cfg = pParam;
     int32_t iOrgNumNals = iCountNumNals;
+    const int32_t kiPreallocSliceNum = (*ppCtx)->iPreallocSliceNum[iDIndex];
 
     //Note: Sep. 2010
     //Review this part and suggest no change, since the memory over-use
     //(1) counts little to the overall performance
     //(2) should not be critial even under mobile case
     if (SM_SIZELIMITED_SLICE == pDLayer->sSliceArgument.uiSliceMode) {
-      iCountNumNals += MAX_SLICES_NUM;
+      // the slices sized for up front, refer to ENCODER_OPTION_PREALLOCATE_BUFFERS, otherwise grown on demand
+      const int32_t kiNumOfSlice = (kiPreallocSliceNum > 0) ? kiPreallocSliceNum : MAX_SLICES_NUM;
+      iCountNumNals += kiNumOfSlice;
       // plus prefix NALs
       if (iDIndex == 0)
-        iCountNumNals += MAX_SLICES_NUM;
+        iCountNumNals += kiNumOfSlice;
       // MAX_SLICES_NUM < MAX_LAYER_NUM_OF_FRAME ensured at svc_enc_slice_segment.h
-      if (iCountNumNals - iOrgNumNals > MAX_NAL_UNITS_IN_LAYER) {
+      if (0 == kiPreallocSliceNum && iCountNumNals - iOrgNumNals > MAX_NAL_UNITS_IN_LAYER) {
         WelsLog (& (*ppCtx)->sLogCtx, WELS_LOG_ERROR,
                  "AcquireLayersNals(), num_of_slice(%d) > existing slice(%d) at (iDid= %d), max=%d",
                  iCountNumNals, iOrgNumNals, iDIndex, MAX_NAL_UNITS_IN_LAYER);
@@ -796,7 +830,7 @@ int32_t AcquireLayersNals (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pParam, int
       }
     }
 
-    if (iCountNumNals - iOrgNumNals > MAX_NAL_UNITS_IN_LAYER) {
+    if (0 == kiPreallocSliceNum && iCountNumNals - iOrgNumNals > MAX_NAL_UNITS_IN_LAYER) {
       WelsLog (& (*ppCtx)->sLogCtx, WELS_LOG_ERROR,
                "AcquireLayersNals(), num_of_nals(%d) > MAX_NAL_UNITS_IN_LAYER(%d) per (iDid= %d, qid= %d) settings!",
                (iCountNumNals - iOrgNumNals), MAX_NAL_UNITS_IN_LAYER, iDIndex, 0);
@@ -976,6 +1010,9 @@ void FreeDqLayer (SDqLayer*& pDq, CMemoryAlign* pMa) {
     pDq->pFeatureSearchPreparation = NULL;
   }
 
+  ReleaseMePyramid (pMa, &pDq->pMePyramid);
+  ReleaseStaticSkipMap (pMa, &pDq->pStaticSkipMap);
+
   UninitSlicePEncCtx (pDq, pMa);
   pDq->iMaxSliceNum = 0;
 
@@ -1089,6 +1126,9 @@ static inline int32_t InitDqLayers (sWelsEncCtx** ppCtx, SExistingParasetList* p
     const int32_t kiSliceNum = GetInitialSliceNum (&pDlayer->sSliceArgument);
     if (iMaxSliceNum < kiSliceNum)
       iMaxSliceNum = kiSliceNum;
+    // one slice more for the boundary check ahead of coding each slice
+    if ((*ppCtx)->iPreallocSliceNum[iDlayerIndex] > 0)
+      iMaxSliceNum = (*ppCtx)->iPreallocSliceNum[iDlayerIndex] + 1;
     pDqLayer->iMaxSliceNum = iMaxSliceNum;
 
     iResult = InitSliceInLayer (*ppCtx, pDqLayer, iDlayerIndex, pMa);
@@ -1566,6 +1606,10 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx, SExistingParasetList* pExistingPa
   iMaxPicHeight = pFinalSpatial->iVideoHeight;
   iCountMaxMbNum = ((15 + iMaxPicWidth) >> 4) * ((15 + iMaxPicHeight) >> 4);
 
+  (*ppCtx)->iPreallocSliceNumRequested = pParam->iPreallocSliceNum;
+  for (iIndex = 0; iIndex < kiNumDependencyLayers; iIndex++)
+    (*ppCtx)->iPreallocSliceNum[iIndex] = GetPreallocSliceNum (pParam, iIndex);
+
   iResult = AcquireLayersNals (ppCtx, pParam, &iCountLayers, &iCountNals);
   if (iResult) {
     WelsLog (& (*ppCtx)->sLogCtx, WELS_LOG_WARNING, "RequestMemorySvc(), AcquireLayersNals failed(%d)!", iResult);
@@ -1598,6 +1642,8 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx, SExistingParasetList* pExistingPa
       bDynamicSlice = true;
       uiMaxSliceNumEstimation = WELS_MIN (AVERSLICENUM_CONSTRAINT,
                                           (iLayerBsSize / pSliceArgument->uiSliceSizeConstraint) + 1);
+      if ((*ppCtx)->iPreallocSliceNum[iIndex] > 0)
+        uiMaxSliceNumEstimation = (*ppCtx)->iPreallocSliceNum[iIndex];
       (*ppCtx)->iMaxSliceCount = WELS_MAX ((*ppCtx)->iMaxSliceCount, (int) uiMaxSliceNumEstimation);
       iSliceBufferSize = (WELS_MAX (pSliceArgument->uiSliceSizeConstraint,
                                     iLayerBsSize / uiMaxSliceNumEstimation) << 1) + MAX_MACROBLOCK_SIZE_IN_BYTE_x2;
@@ -1622,7 +1668,9 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx, SExistingParasetList* pExistingPa
   // Output
   (*ppCtx)->pOut = (SWelsEncoderOutput*)pMa->WelsMallocz (sizeof (SWelsEncoderOutput), "SWelsEncoderOutput");
   WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pOut))
-  (*ppCtx)->pOut->pBsBuffer = (uint8_t*)pMa->WelsMallocz (iCountBsLen, "pOut->pBsBuffer");
+  // the writer never reads beyond what it wrote, so in the low footprint mode the pages are only backed once written
+  (*ppCtx)->pOut->pBsBuffer = (uint8_t*) (pParam->bLowFootprint ? pMa->WelsMalloc (iCountBsLen, "pOut->pBsBuffer") :
+                                          pMa->WelsMallocz (iCountBsLen, "pOut->pBsBuffer"));
   WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pOut->pBsBuffer))
   (*ppCtx)->pOut->uiSize = iCountBsLen;
   (*ppCtx)->pOut->sNalList = (SWelsNalRaw*)pMa->WelsMallocz (iCountNals * sizeof (SWelsNalRaw), "pOut->sNalList");
@@ -1638,13 +1686,6 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx, SExistingParasetList* pExistingPa
   (*ppCtx)->iFrameBsSize = iTotalLength;
   (*ppCtx)->iPosBsBuffer = 0;
 
-  // for dynamic slice mode&& CABAC,allocate slice buffer to restore slice data
-  if (bDynamicSlice && pParam->iEntropyCodingModeFlag) {
-    for (int32_t iIdx = 0; iIdx < MAX_THREADS_NUM; iIdx++) {
-      (*ppCtx)->pDynamicBsBuffer[iIdx] = (uint8_t*)pMa->WelsMalloc (iMaxSliceBufferSize, "DynamicSliceBs");
-      WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pDynamicBsBuffer[iIdx]))
-    }
-  }
   // for pSlice bs buffers
   if (pParam->iMultipleThreadIdc > 1
       && RequestMtResource (ppCtx, pParam, iCountBsLen, iMaxSliceBufferSize, bDynamicSlice)) {
@@ -1717,6 +1758,10 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx, SExistingParasetList* pExistingPa
     (*ppCtx)->pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp   = static_cast<int8_t*>
         (pMa->WelsMallocz (iCountMaxMbNum * sizeof (int8_t), "pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp"));
     WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp))
+    // the squared differences are only calculated for the AQ, refer to AnalyzeSpatialPic()
+    (*ppCtx)->pVaa->sVaaCalcInfo.pSsd16x16 = static_cast<int32_t*>
+        (pMa->WelsMallocz (iCountMaxMbNum * sizeof (int32_t), "pVaa->sVaaCalcInfo.pSsd16x16"));
+    WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pVaa->sVaaCalcInfo.pSsd16x16))
   }
 
   (*ppCtx)->pVaa->pVaaBackgroundMbFlag = (int8_t*)pMa->WelsMallocz (iCountMaxMbNum * sizeof (int8_t),
@@ -1726,9 +1771,6 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx, SExistingParasetList* pExistingPa
   (*ppCtx)->pVaa->sVaaCalcInfo.pSad8x8 = static_cast<int32_t (*)[4]>
                                          (pMa->WelsMallocz (iCountMaxMbNum * 4 * sizeof (int32_t), "pVaa->sVaaCalcInfo.sad8x8"));
   WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pVaa->sVaaCalcInfo.pSad8x8))
-  (*ppCtx)->pVaa->sVaaCalcInfo.pSsd16x16 = static_cast<int32_t*>
-      (pMa->WelsMallocz (iCountMaxMbNum * sizeof (int32_t), "pVaa->sVaaCalcInfo.pSsd16x16"));
-  WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pVaa->sVaaCalcInfo.pSsd16x16))
   (*ppCtx)->pVaa->sVaaCalcInfo.pSum16x16 = static_cast<int32_t*>
       (pMa->WelsMallocz (iCountMaxMbNum * sizeof (int32_t), "pVaa->sVaaCalcInfo.pSum16x16"));
   WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pVaa->sVaaCalcInfo.pSum16x16))
@@ -1769,13 +1811,11 @@ int32_t RequestMemorySvc (sWelsEncCtx** ppCtx, SExistingParasetList* pExistingPa
   GetMvMvdRange (pParam, (*ppCtx)->iMvRange, iMvdRange);
   const uint32_t kuiMvdInterTableSize   = (iMvdRange << 2); //intepel*4=qpel
   const uint32_t kuiMvdInterTableStride =  1 + (kuiMvdInterTableSize << 1);//qpel_mv_range*2=(+/-);
-  const uint32_t kuiMvdCacheAlignedSize = kuiMvdInterTableStride * sizeof (uint16_t);
 
   (*ppCtx)->iMvdCostTableSize = kuiMvdInterTableSize;
   (*ppCtx)->iMvdCostTableStride = kuiMvdInterTableStride;
-  (*ppCtx)->pMvdCostTable = (uint16_t*)pMa->WelsMallocz (52 * kuiMvdCacheAlignedSize, "pMvdCostTable");
+  (*ppCtx)->pMvdCostTable = MvdCostTableAcquire (kuiMvdInterTableStride);
   WELS_VERIFY_RETURN_IF (1, (NULL == (*ppCtx)->pMvdCostTable))
-  MvdCostInit ((*ppCtx)->pMvdCostTable, kuiMvdInterTableStride);  //should put to a better place?
 
   if ((*ppCtx)->ppRefPicListExt[0] != NULL && (*ppCtx)->ppRefPicListExt[0]->pRef[0] != NULL)
     (*ppCtx)->pDecPic = (*ppCtx)->ppRefPicListExt[0]->pRef[0];
@@ -1815,6 +1855,21 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
       pMa->WelsFree (pCtx->pDqIdcMap, "pDqIdcMap");
       pCtx->pDqIdcMap = NULL;
     }
+    // motion hint
+    if (NULL != pCtx->pMotionHint) {
+      pMa->WelsFree (pCtx->pMotionHint, "pMotionHint");
+      pCtx->pMotionHint = NULL;
+      pCtx->iMotionHintCapacity = 0;
+    }
+    if (NULL != pCtx->pEffortMap) {
+      pMa->WelsFree (pCtx->pEffortMap, "pEffortMap");
+      pCtx->pEffortMap = NULL;
+      pCtx->iEffortMapCapacity = 0;
+    }
+    if (NULL != pCtx->pMotionAnalysis) {
+      pMa->WelsFree (pCtx->pMotionAnalysis, "pMotionAnalysis");
+      pCtx->pMotionAnalysis = NULL;
+    }
 
     if (NULL != pCtx->pOut) {
       // bs pBuffer
@@ -1848,11 +1903,6 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
       pMa->WelsFree (pCtx->pFrameBs, "pFrameBs");
       pCtx->pFrameBs = NULL;
     }
-    for (int32_t iIdx = 0; iIdx < MAX_THREADS_NUM; iIdx++) {
-      pMa->WelsFree (pCtx->pDynamicBsBuffer[iIdx], "DynamicSliceBs");
-      pCtx->pDynamicBsBuffer[iIdx] = NULL;
-
-    }
     // pSpsArray
     if (NULL != pCtx->pSpsArray) {
       pMa->WelsFree (pCtx->pSpsArray, "pSpsArray");
@@ -1945,14 +1995,14 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
         pMa->WelsFree (pCtx->pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp,
                        "pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp");
         pCtx->pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp = NULL;
+        pMa->WelsFree (pCtx->pVaa->sVaaCalcInfo.pSsd16x16, "pVaa->sVaaCalcInfo.pSsd16x16");
+        pCtx->pVaa->sVaaCalcInfo.pSsd16x16 = NULL;
       }
 
       pMa->WelsFree (pCtx->pVaa->pVaaBackgroundMbFlag, "pVaa->pVaaBackgroundMbFlag");
       pCtx->pVaa->pVaaBackgroundMbFlag = NULL;
       pMa->WelsFree (pCtx->pVaa->sVaaCalcInfo.pSad8x8, "pVaa->sVaaCalcInfo.sad8x8");
       pCtx->pVaa->sVaaCalcInfo.pSad8x8 = NULL;
-      pMa->WelsFree (pCtx->pVaa->sVaaCalcInfo.pSsd16x16, "pVaa->sVaaCalcInfo.pSsd16x16");
-      pCtx->pVaa->sVaaCalcInfo.pSsd16x16 = NULL;
       pMa->WelsFree (pCtx->pVaa->sVaaCalcInfo.pSum16x16, "pVaa->sVaaCalcInfo.pSum16x16");
       pCtx->pVaa->sVaaCalcInfo.pSum16x16 = NULL;
       pMa->WelsFree (pCtx->pVaa->sVaaCalcInfo.pSumOfSquare16x16, "pVaa->sVaaCalcInfo.pSumOfSquare16x16");
@@ -1979,7 +2029,7 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
 
     /* MVD cost tables for Inter */
     if (NULL != pCtx->pMvdCostTable) {
-      pMa->WelsFree (pCtx->pMvdCostTable, "pMvdCostTable");
+      MvdCostTableRelease (pCtx->pMvdCostTable);
       pCtx->pMvdCostTable = NULL;
     }
 
@@ -2000,7 +2050,11 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
     if ((*ppCtx)->pMemAlign != NULL) {
       WelsLog (& (*ppCtx)->sLogCtx, WELS_LOG_INFO, "FreeMemorySvc(), verify memory usage (%d bytes) after free..",
                (*ppCtx)->pMemAlign->WelsGetMemoryUsage());
-      WELS_DELETE_OP ((*ppCtx)->pMemAlign);
+      if ((*ppCtx)->bKeepMemAlign) {
+        (*ppCtx)->pMemAlign = NULL;
+      } else {
+        WELS_DELETE_OP ((*ppCtx)->pMemAlign);
+      }
     }
 
     free (*ppCtx);
@@ -2049,8 +2103,9 @@ int32_t InitSliceSettings (SLogContext* pLogCtx,     SWelsSvcCodingParam* pCodin
   } while (iSpatialIdx < iSpatialNum);
 
   pCodingParam->iMultipleThreadIdc = WELS_MIN (kiCpuCores, iMaxSliceCount);
-  if (pCodingParam->iLoopFilterDisableIdc == 0
-      && pCodingParam->iMultipleThreadIdc != 1) // Loop filter requested to be enabled, with threading enabled
+  pCodingParam->bLoopFilterIdcForced = (pCodingParam->iLoopFilterDisableIdc == 0
+                                        && pCodingParam->iMultipleThreadIdc != 1);
+  if (pCodingParam->bLoopFilterIdcForced) // Loop filter requested to be enabled, with threading enabled
     pCodingParam->iLoopFilterDisableIdc =
       2; // Disable loop filter on slice boundaries since that's not allowed with multithreading
   *pMaxSliceCount = iMaxSliceCount;
@@ -2270,18 +2325,56 @@ void WelsUninitEncoderExt (sWelsEncCtx** ppCtx) {
     (*ppCtx)->pVpp->FreeSpatialPictures (*ppCtx);
     WELS_DELETE_OP ((*ppCtx)->pVpp);
   }
+  if ((*ppCtx)->pIdleThreadPool) {
+    (*ppCtx)->pIdleThreadPool->RemoveInstance();
+    (*ppCtx)->pIdleThreadPool = NULL;
+  }
   FreeMemorySvc (ppCtx);
   *ppCtx = NULL;
 }
 
+/*!
+ * \brief   size of the arena of a reconfiguration pool, taken by a context with the pictures of all the layers
+ *          scaled to the largest picture of sReconfigPool
+ * \return  bytes of the arena; 0 if such a context can not be set up
+ */
+static uint32_t ReconfigPoolArenaSize (const SWelsSvcCodingParam* kpCodingParam, SLogContext* pLogCtx) {
+  SWelsSvcCodingParam sMaxParam = *kpCodingParam;
+  const int32_t kiMaxWidth  = WELS_MAX (kpCodingParam->sReconfigPool.iMaxPicWidth, kpCodingParam->iPicWidth);
+  const int32_t kiMaxHeight = WELS_MAX (kpCodingParam->sReconfigPool.iMaxPicHeight, kpCodingParam->iPicHeight);
+  sMaxParam.iPicWidth  = kiMaxWidth;
+  sMaxParam.iPicHeight = kiMaxHeight;
+  sMaxParam.SUsedPicRect.iWidth  = (kiMaxWidth >> 1) << 1;
+  sMaxParam.SUsedPicRect.iHeight = (kiMaxHeight >> 1) << 1;
+  for (int32_t i = 0; i < sMaxParam.iSpatialLayerNum; i++) {
+    SSpatialLayerInternal* pDlp = &sMaxParam.sDependencyLayers[i];
+    pDlp->iActualWidth  = WELS_ALIGN ((int32_t) ((int64_t)pDlp->iActualWidth * kiMaxWidth / kpCodingParam->iPicWidth), 2);
+    pDlp->iActualHeight = WELS_ALIGN ((int32_t) ((int64_t)pDlp->iActualHeight * kiMaxHeight / kpCodingParam->iPicHeight),
+                                      2);
+    sMaxParam.sSpatialLayers[i].iVideoWidth  = WELS_ALIGN (pDlp->iActualWidth, MB_WIDTH_LUMA);
+    sMaxParam.sSpatialLayers[i].iVideoHeight = WELS_ALIGN (pDlp->iActualHeight, MB_HEIGHT_LUMA);
+  }
+  memset (&sMaxParam.sReconfigPool, 0, sizeof (sMaxParam.sReconfigPool));
+  memset (&sMaxParam.sMemoryArena, 0, sizeof (sMaxParam.sMemoryArena));
+
+  sWelsEncCtx* pMaxCtx = NULL;
+  if (WelsInitEncoderExt (&pMaxCtx, &sMaxParam, pLogCtx, NULL, NULL))
+    return 0;
+  const uint32_t kuiUsedBytes = pMaxCtx->pMemAlign->WelsGetMemoryUsage();
+  WelsUninitEncoderExt (&pMaxCtx);
+  // room for the blocks taken while encoding, as the grown slice buffers; beyond it they come from the heap
+  return kuiUsedBytes + (kuiUsedBytes >> 2);
+}
+
 /*!
  * \brief   initialize Wels avc encoder core library
  * \pParam  ppCtx       sWelsEncCtx**
  * \pParam  pParam      SWelsSvcCodingParam*
+ * \pParam  pMemAlign   memory kept over a reset to take over, deleted if the initialization fails; NULL for a new one
  * \return  successful - 0; otherwise none 0 for failed
  */
 int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingParam, SLogContext* pLogCtx,
-                            SExistingParasetList* pExistingParasetList) {
+                            SExistingParasetList* pExistingParasetList, CMemoryAlign* pMemAlign) {
   sWelsEncCtx* pCtx      = NULL;
   int32_t iRet           = 0;
   int16_t iSliceNum      = 1;    // number of slices used
@@ -2290,12 +2383,14 @@ int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPar
   if (NULL == ppCtx || NULL == pCodingParam) {
     WelsLog (pLogCtx, WELS_LOG_ERROR, "WelsInitEncoderExt(), NULL == ppCtx(0x%p) or NULL == pCodingParam(0x%p).",
              (void*)ppCtx, (void*)pCodingParam);
+    WELS_DELETE_OP (pMemAlign);
     return 1;
   }
 
   iRet = ParamValidationExt (pLogCtx, pCodingParam);
   if (iRet != 0) {
     WelsLog (pLogCtx, WELS_LOG_ERROR, "WelsInitEncoderExt(), ParamValidationExt failed return %d.", iRet);
+    WELS_DELETE_OP (pMemAlign);
     return iRet;
   }
   iRet = pCodingParam->DetermineTemporalSettings();
@@ -2303,11 +2398,13 @@ int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPar
     WelsLog (pLogCtx, WELS_LOG_ERROR,
              "WelsInitEncoderExt(), DetermineTemporalSettings failed return %d (check in/out frame rate and temporal layer setting! -- in/out = 2^x, x <= temppral_layer_num)",
              iRet);
+    WELS_DELETE_OP (pMemAlign);
     return iRet;
   }
   iRet = GetMultipleThreadIdc (pLogCtx, pCodingParam, iSliceNum, iCacheLineSize, uiCpuFeatureFlags);
   if (iRet != 0) {
     WelsLog (pLogCtx, WELS_LOG_ERROR, "WelsInitEncoderExt(), GetMultipleThreadIdc failed return %d.", iRet);
+    WELS_DELETE_OP (pMemAlign);
     return iRet;
   }
 
@@ -2316,12 +2413,26 @@ int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPar
 
   pCtx = static_cast<sWelsEncCtx*> (malloc (sizeof (sWelsEncCtx)));
 
-  WELS_VERIFY_RETURN_IF (1, (NULL == pCtx))
+  WELS_VERIFY_RETURN_PROC_IF (1, (NULL == pCtx), WELS_DELETE_OP (pMemAlign))
   memset (pCtx, 0, sizeof (sWelsEncCtx));
 
   pCtx->sLogCtx = *pLogCtx;
 
-  pCtx->pMemAlign = new CMemoryAlign (iCacheLineSize);
+  pCtx->sMemoryArena = pCodingParam->sMemoryArena;
+  pCtx->bLowFootprint = pCodingParam->bLowFootprint;
+  pCtx->sReconfigPool = pCodingParam->sReconfigPool;
+  uint32_t uiArenaSize = pCtx->sMemoryArena.uiArenaSize;
+  if (0 == uiArenaSize && pCtx->sReconfigPool.iMaxPicWidth > 0 && NULL == pMemAlign)
+    uiArenaSize = ReconfigPoolArenaSize (pCodingParam, pLogCtx);
+  if (NULL != pMemAlign) {
+    pCtx->pMemAlign = pMemAlign;
+  } else if (uiArenaSize > 0) {
+    const uint32_t kuiArenaFlags = (pCtx->sMemoryArena.bHugePages ? MEMORY_ARENA_HUGE_PAGES : 0)
+                                   | (pCtx->sMemoryArena.bPrefault ? MEMORY_ARENA_PREFAULT : 0);
+    pCtx->pMemAlign = new CMemoryAlign (iCacheLineSize, uiArenaSize, kuiArenaFlags);
+  } else {
+    pCtx->pMemAlign = new CMemoryAlign (iCacheLineSize);
+  }
   WELS_VERIFY_RETURN_PROC_IF (1, (NULL == pCtx->pMemAlign), WelsUninitEncoderExt (&pCtx))
 
   iRet = AllocCodingParam (&pCtx->pSvcParam, pCtx->pMemAlign);
@@ -2348,7 +2459,7 @@ int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPar
   }
 
   if (pCodingParam->iEntropyCodingModeFlag)
-    WelsCabacInit (pCtx);
+    WelsCabacInit();
   WelsRcInitModule (pCtx,  pCtx->pSvcParam->iRCMode);
 
   pCtx->pVpp = CWelsPreProcess::CreatePreProcess (pCtx);
@@ -2544,6 +2655,9 @@ void WelsInitCurrentLayer (sWelsEncCtx* pCtx,
     return;
 
   pCurDq->pDecPic = pDecPic;
+  pDecPic->bHalfPelReady = false;
+  if (NULL != pDecPic->pScreenBlockFeatureStorage && NULL != pDecPic->pScreenBlockFeatureStorage->pHashIndex)
+    pDecPic->pScreenBlockFeatureStorage->pHashIndex->bIndexed = false;
 
   assert (iSliceCount > 0);
 
@@ -2618,6 +2732,8 @@ static inline void SetFastCodingFunc (SWelsFuncPtrList* pFuncList) {
   pFuncList->sSampleDealingFuncs.pfMdCost = pFuncList->sSampleDealingFuncs.pfSampleSad;
   pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3 = pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Sad;
   pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3 = pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Sad;
+  pFuncList->sSampleDealingFuncs.pfIntra16x16AllModes = pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSad;
+  pFuncList->sSampleDealingFuncs.pfIntra8x8AllModes = pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSad;
 }
 static inline void SetNormalCodingFunc (SWelsFuncPtrList* pFuncList) {
   pFuncList->pfIntraFineMd = WelsMdIntraFinePartition;
@@ -2628,6 +2744,12 @@ static inline void SetNormalCodingFunc (SWelsFuncPtrList* pFuncList) {
     pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Satd;
   pFuncList->sSampleDealingFuncs.pfIntra4x4Combined3 =
     pFuncList->sSampleDealingFuncs.pfIntra4x4Combined3Satd;
+  pFuncList->sSampleDealingFuncs.pfIntra16x16AllModes =
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSatd;
+  pFuncList->sSampleDealingFuncs.pfIntra8x8AllModes =
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSatd;
+  pFuncList->sSampleDealingFuncs.pfIntra4x4AllModes =
+    pFuncList->sSampleDealingFuncs.pfIntra4x4AllModesSatd;
 }
 bool SetMeMethod (const uint8_t uiMethod, PSearchMethodFunc& pSearchMethodFunc) {
   switch (uiMethod) {
@@ -2655,6 +2777,20 @@ bool SetMeMethod (const uint8_t uiMethod, PSearchMethodFunc& pSearchMethodFunc)
 
 
 
+// the latest built block hash index among the pictures of the list, to update the next one from it
+static const SScreenBlockHashIndex* LatestBlockHashIndex (const SRefList* kpRefList) {
+  const SScreenBlockHashIndex* kpLatest = NULL;
+  for (int32_t i = 0; i < 1 + MAX_REF_PIC_COUNT; i++) {
+    const SPicture* kpPic = kpRefList->pRef[i];
+    if (NULL == kpPic || NULL == kpPic->pScreenBlockFeatureStorage)
+      continue;
+    const SScreenBlockHashIndex* kpHashIndex = kpPic->pScreenBlockFeatureStorage->pHashIndex;
+    if (NULL != kpHashIndex && (NULL == kpLatest || kpHashIndex->uiIndexSeq > kpLatest->uiIndexSeq))
+      kpLatest = kpHashIndex;
+  }
+  return kpLatest;
+}
+
 void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
   SDqLayer* pCurLayer           = pCtx->pCurDqLayer;
   //const bool kbBaseAvail      = pCurLayer->bBaseLayerAvailableFlag;
@@ -2685,6 +2821,7 @@ void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
     pFuncList->pfFirstIntraMode = WelsMdFirstIntraMode;
     pFuncList->sSampleDealingFuncs.pfMeCost = pCtx->pFuncList->sSampleDealingFuncs.pfSampleSatd;
     pFuncList->pfSetScrollingMv = SetScrollingMvToMdNull;
+    pFuncList->pfBlockHashSearch = WelsBlockHashSearchNull;
 
     if (bFastMode) {
       pFuncList->pfCalculateSatd = NotCalculateSatdCost;
@@ -2719,9 +2856,35 @@ void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
       if (!SetMeMethod (ME_DIA_CROSS, pFuncList->pfSearchMethod[BLOCK_16x16])) {
         WelsLog (pLogCtx, WELS_LOG_WARNING, "SetMeMethod(BLOCK_16x16) ME_DIA_CROSS unsuccessful, switched to default search");
       }
-      //ME8x8
+      //exact block hash look-up, the index is built once per reference, from the latest one, and kept with it
+      SScreenBlockFeatureStorage* pScreenBlockFeatureStorage = pCurLayer->pRefPic->pScreenBlockFeatureStorage;
+      if (pCtx->pSvcParam->bScreenBlockHash && pScreenBlockFeatureStorage) {
+        SPicture* pRef = (pCtx->pSvcParam->bEnableLongTermReference ? pCurLayer->pRefOri[0] : pCurLayer->pRefPic);
+        if (NULL == pScreenBlockFeatureStorage->pHashIndex
+            && ENC_RETURN_SUCCESS != RequestScreenBlockHashIndex (pCtx->pMemAlign, pRef->iWidthInPixel, pRef->iHeightInPixel,
+                &pScreenBlockFeatureStorage->pHashIndex)) {
+          ReleaseScreenBlockHashIndex (pCtx->pMemAlign, &pScreenBlockFeatureStorage->pHashIndex);
+          WelsLog (pLogCtx, WELS_LOG_WARNING, "PreprocessSliceCoding(), RequestScreenBlockHashIndex failed, block hash skipped");
+        }
+        SScreenBlockHashIndex* pHashIndex = pScreenBlockFeatureStorage->pHashIndex;
+        if (pHashIndex) {
+          if (!pHashIndex->bIndexed) {
+            const int32_t kiLastStage = ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_ME_INTEGER);
+            PerformBlockHashIndex (pFuncList, pRef, pHashIndex,
+                                   LatestBlockHashIndex (pCtx->ppRefPicListExt[pCtx->uiDependencyId]));
+            ProfilerSwitchStage (&pCtx->sProfiler, kiLastStage);
+          }
+          // the thresholds of the cross search of ME_DIA_CROSS, otherwise set along with the block features
+          memcpy (pScreenBlockFeatureStorage->uiSadCostThreshold, pHashIndex->uiSadCostThreshold,
+                  sizeof (pScreenBlockFeatureStorage->uiSadCostThreshold));
+          pFuncList->pfBlockHashSearch = WelsBlockHashSearch;
+        }
+      }
+
+      //ME8x8, the block hash look-up replaces the feature search
       SFeatureSearchPreparation* pFeatureSearchPreparation = pCurLayer->pFeatureSearchPreparation;
-      if (pFeatureSearchPreparation) {
+      pFuncList->pfUpdateFMESwitch = UpdateFMESwitchNull;
+      if (pFeatureSearchPreparation && WelsBlockHashSearch != pFuncList->pfBlockHashSearch) {
         pFeatureSearchPreparation->iHighFreMbCount = 0;
 
         //calculate bFMESwitchFlag
@@ -2732,7 +2895,6 @@ void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
             pVaaExt->sScrollDetectInfo.bScrollDetectFlag);
 
         //PerformFMEPreprocess
-        SScreenBlockFeatureStorage* pScreenBlockFeatureStorage = pCurLayer->pRefPic->pScreenBlockFeatureStorage;
         pFeatureSearchPreparation->pRefBlockFeature = pScreenBlockFeatureStorage;
         if (pFeatureSearchPreparation->bFMESwitchFlag
             && !pScreenBlockFeatureStorage->bRefBlockFeatureCalculated) {
@@ -2764,23 +2926,95 @@ void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
     }
   }
 
+  // complexity adapted to the frame time budget, refer to WelsComplexityUpdate()
+  if (P_SLICE == pCtx->eSliceType) {
+    if (pCtx->iComplexityLevel >= COMPLEXITY_LEVEL_NO_INTRA4x4)
+      pFuncList->pfIntraFineMd = WelsMdIntraFinePartitionNull;
+    if (pCtx->iComplexityLevel >= COMPLEXITY_LEVEL_16x16_ONLY)
+      pFuncList->pfInterFineMd = WelsMdInterFinePartitionNull;
+  }
+
   // update some layer dependent variable to save judgements in mb-level
   pCurLayer->bSatdInMdFlag = ((pFuncList->sSampleDealingFuncs.pfMeCost == pFuncList->sSampleDealingFuncs.pfSampleSatd)
                               && (pFuncList->sSampleDealingFuncs.pfMdCost == pFuncList->sSampleDealingFuncs.pfSampleSatd));
 
   const int32_t kiCurDid            = pCtx->uiDependencyId;
   const int32_t kiCurTid            = pCtx->uiTemporalId;
+  const uint32_t kuiSliceMode       = pCtx->pSvcParam->sSpatialLayers[kiCurDid].sSliceArgument.uiSliceMode;
+  // overlapped deblocking gives the slice boundaries back the loop filter the threading had to disable
+  if (pCtx->pSvcParam->bLoopFilterIdcForced && (SM_SINGLE_SLICE != kuiSliceMode)) {
+    const bool kbOverlapped = pCtx->pSvcParam->bOverlappedDeblocking && (SM_SIZELIMITED_SLICE != kuiSliceMode);
+    pCurLayer->iLoopFilterDisableIdc   = kbOverlapped ? 0 : 2;
+    pCurLayer->bDeblockingParallelFlag = !kbOverlapped;
+  }
   if (pCurLayer->bDeblockingParallelFlag && (pCurLayer->iLoopFilterDisableIdc != 1)
 #if !defined(ENABLE_FRAME_DUMP)
-      && (NRI_PRI_LOWEST != pCtx->eNalPriority)
-      && (pCtx->pSvcParam->sDependencyLayers[kiCurDid].iHighestTemporalId == 0
-          || kiCurTid < pCtx->pSvcParam->sDependencyLayers[kiCurDid].iHighestTemporalId)
+      && (pCtx->pSvcParam->bQualityMetrics || ((NRI_PRI_LOWEST != pCtx->eNalPriority)
+          && (pCtx->pSvcParam->sDependencyLayers[kiCurDid].iHighestTemporalId == 0
+              || kiCurTid < pCtx->pSvcParam->sDependencyLayers[kiCurDid].iHighestTemporalId)))
 #endif// !ENABLE_FRAME_DUMP
      ) {
     pFuncList->pfDeblocking.pfDeblockingFilterSlice = DeblockingFilterSliceAvcbase;
   } else {
     pFuncList->pfDeblocking.pfDeblockingFilterSlice = DeblockingFilterSliceAvcbaseNull;
   }
+  // the frame deblocking below is moved into the slice threads, only for slicing fixed ahead of the coding
+  pCurLayer->bDeblockingOverlappedFlag = pCtx->pSvcParam->bOverlappedDeblocking && (NULL != pCtx->pSliceThreading)
+                                         && (!pCurLayer->bDeblockingParallelFlag) && (pCurLayer->iLoopFilterDisableIdc != 1)
+                                         && (SM_SINGLE_SLICE != kuiSliceMode) && (SM_SIZELIMITED_SLICE != kuiSliceMode)
+#if !defined(ENABLE_FRAME_DUMP)
+                                         && (pCtx->pSvcParam->bQualityMetrics || ((NRI_PRI_LOWEST != pCtx->eNalPriority)
+                                             && (pCtx->pSvcParam->sDependencyLayers[kiCurDid].iHighestTemporalId == 0
+                                                 || kiCurTid < pCtx->pSvcParam->sDependencyLayers[kiCurDid].iHighestTemporalId)))
+#endif// !ENABLE_FRAME_DUMP
+                                         ;
+  WelsOverlappedDeblockingInit (pCtx);
+  WelsQualityMetricsInit (pCtx);
+
+  // hierarchical ME, the pyramid is allocated on first use since the option can be switched on at any time
+  if (pCurLayer->pMePyramid)
+    pCurLayer->pMePyramid->bMbMvValid = false;
+  if (pCtx->pSvcParam->bHierarchicalMe && pCtx->pSvcParam->iUsageType == CAMERA_VIDEO_REAL_TIME
+      && P_SLICE == pCtx->eSliceType && NULL != pCurLayer->pRefPic) {
+    if (NULL == pCurLayer->pMePyramid
+        && ENC_RETURN_SUCCESS != RequestMePyramid (pCtx->pMemAlign, pCurLayer->iMbWidth, pCurLayer->iMbHeight,
+            &pCurLayer->pMePyramid)) {
+      ReleaseMePyramid (pCtx->pMemAlign, &pCurLayer->pMePyramid);
+      WelsLog (pLogCtx, WELS_LOG_WARNING, "PreprocessSliceCoding(), RequestMePyramid failed, hierarchical ME skipped");
+    }
+    if (pCurLayer->pMePyramid) {
+      const int32_t kiLastStage = ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_ME_INTEGER);
+      PerformMePyramidSearch (pFuncList, pCurLayer, &pCtx->sProfiler);
+      ProfilerSwitchStage (&pCtx->sProfiler, kiLastStage);
+    }
+  }
+
+  // static skip prefilter, the MBs left unchanged against the reference are classified ahead of the MB loop
+  if (pCurLayer->pStaticSkipMap)
+    pCurLayer->pStaticSkipMap->bMapValid = false;
+  if (pCtx->pSvcParam->bStaticSkipPrefilter && P_SLICE == pCtx->eSliceType && NULL != pCurLayer->pRefPic
+      && !pCurLayer->bBaseLayerAvailableFlag) {
+    if (NULL == pCurLayer->pStaticSkipMap
+        && ENC_RETURN_SUCCESS != RequestStaticSkipMap (pCtx->pMemAlign, pCurLayer->iMbWidth, pCurLayer->iMbHeight,
+            &pCurLayer->pStaticSkipMap)) {
+      ReleaseStaticSkipMap (pCtx->pMemAlign, &pCurLayer->pStaticSkipMap);
+      WelsLog (pLogCtx, WELS_LOG_WARNING, "PreprocessSliceCoding(), RequestStaticSkipMap failed, static skip prefilter skipped");
+    }
+    if (pCurLayer->pStaticSkipMap) {
+      const int32_t kiLastStage = ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_MODE_DECISION);
+      PerformStaticSkipPrefilter (pFuncList, pCurLayer, pCtx->pVaa, pCtx->iGlobalQp);
+      ProfilerSwitchStage (&pCtx->sProfiler, kiLastStage);
+    }
+  }
+
+  // half-pel planes, filled once per reference picture and kept until it is reconstructed into again
+  if (pCtx->pSvcParam->bHalfPelCache && pCtx->pSvcParam->iUsageType == CAMERA_VIDEO_REAL_TIME
+      && P_SLICE == pCtx->eSliceType && NULL != pCurLayer->pRefPic && !pCurLayer->pRefPic->bHalfPelReady) {
+    const int32_t kiLastStage = ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_ME_SUBPEL);
+    if (ENC_RETURN_SUCCESS != WelsHalfPelPlanesFill (pCtx->pMemAlign, &pFuncList->sMcFuncs, pCurLayer->pRefPic))
+      WelsLog (pLogCtx, WELS_LOG_WARNING, "PreprocessSliceCoding(), WelsHalfPelPlanesFill failed, half-pel cache skipped");
+    ProfilerSwitchStage (&pCtx->sProfiler, kiLastStage);
+  }
 }
 
 /*!
@@ -3104,6 +3338,25 @@ int32_t WelsEncoderEncodeParameterSets (sWelsEncCtx* pCtx, void* pDst) {
   return ENC_RETURN_SUCCESS;
 }
 
+/*!
+ * \brief  PSNR and SSIM of the coded layer into sLayerQualityMetrics, left unmeasured unless ENCODER_OPTION_QUALITY_METRICS
+ *         is set
+ */
+static void UpdateLayerQualityMetrics (sWelsEncCtx* pCtx, const int32_t kiDid) {
+  const SQualityMetrics* kpMetrics = &pCtx->pCurDqLayer->sQualityMetrics;
+  SLayerQualityMetrics* pLayerMetrics = &pCtx->sLayerQualityMetrics[kiDid];
+
+  if (!kpMetrics->bEnabled)
+    return;
+  WelsQualityMetricsFinish (pCtx);
+  pLayerMetrics->bMeasured = true;
+  pLayerMetrics->fPsnrY = WelsCalcPsnrFromSse (kpMetrics->iSse[0], kpMetrics->iWidth, kpMetrics->iHeight);
+  pLayerMetrics->fPsnrU = WelsCalcPsnrFromSse (kpMetrics->iSse[1], kpMetrics->iWidth >> 1, kpMetrics->iHeight >> 1);
+  pLayerMetrics->fPsnrV = WelsCalcPsnrFromSse (kpMetrics->iSse[2], kpMetrics->iWidth >> 1, kpMetrics->iHeight >> 1);
+  if (kpMetrics->iSsimBlockNum > 0)
+    pLayerMetrics->fSsim = (float) (kpMetrics->dSsimSum / kpMetrics->iSsimBlockNum);
+}
+
 int32_t GetSubSequenceId (sWelsEncCtx* pCtx, EVideoFrameType eFrameType) {
   int32_t iSubSeqId = 0;
   if (eFrameType == videoFrameTypeIDR)
@@ -3349,6 +3602,11 @@ void StackBackEncoderStatus (sWelsEncCtx* pEncCtx,
     }
 
     LoadBackFrameNum (pEncCtx, pEncCtx->uiDependencyId);
+    if (pParamInternal->iRefreshFrameIdx > 0) {
+      -- pParamInternal->iRefreshFrameIdx;
+    } else { // the sweep starts over with the next frame
+      pParamInternal->iRefreshFrameNum = 0;
+    }
 
     pEncCtx->eNalType     = NAL_UNIT_CODED_SLICE;
     pEncCtx->eSliceType   = P_SLICE;
@@ -3376,7 +3634,49 @@ void ClearFrameBsInfo (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi) {
   }
   pFbi->iLayerNum = 0;
   pFbi->iFrameSizeInBytes = 0;
+  pCtx->iSliceOutputLayerNum = 0;
+}
+/*!
+ * \brief   announce the intra refresh sweep starting with the frame of dependency layer kiDid
+ */
+static int32_t WriteRecoveryPointSei (sWelsEncCtx* pCtx, const int32_t kiDid,
+                                      SLayerBSInfo*& pLayerBsInfo, int32_t& iLayerNum, int32_t& iFrameSize) {
+  const SSpatialLayerInternal* kpParamInternal = &pCtx->pSvcParam->sDependencyLayers[kiDid];
+  int32_t iNal = pCtx->pOut->iNalIndex;
+  int32_t iNalSize = 0;
+
+  WelsLoadNal (pCtx->pOut, NAL_UNIT_SEI, NRI_PRI_LOWEST);
+  // exact once the band passed the last MB row, the temporal layers in between are counted as well
+  WelsWriteRecoveryPointSei (&pCtx->pOut->sBsWrite, kpParamInternal->iRefreshFrameNum - 1);
+  WelsUnloadNal (pCtx->pOut);
+
+  int32_t iReturn = WelsEncodeNal (&pCtx->pOut->sNalList[iNal], NULL,
+                                   pCtx->iFrameBsSize - pCtx->iPosBsBuffer,
+                                   pCtx->pFrameBs + pCtx->iPosBsBuffer,
+                                   &iNalSize);
+  WELS_VERIFY_RETURN_IFNEQ (iReturn, ENC_RETURN_SUCCESS)
+  pCtx->iPosBsBuffer += iNalSize;
+
+  pLayerBsInfo->pNalLengthInByte[0] = iNalSize;
+  pLayerBsInfo->uiSpatialId   = kiDid;
+  pLayerBsInfo->uiTemporalId  = 0;
+  pLayerBsInfo->uiQualityId   = 0;
+  pLayerBsInfo->uiLayerType   = NON_VIDEO_CODING_LAYER;
+  pLayerBsInfo->iNalCount     = 1;
+  pLayerBsInfo->eFrameType    = videoFrameTypeP;
+  pLayerBsInfo->iSubSeqId     = GetSubSequenceId (pCtx, videoFrameTypeP);
+  //point to next pLayerBsInfo
+  ++ pLayerBsInfo;
+  ++ pCtx->pOut->iLayerBsIndex;
+  pLayerBsInfo->pBsBuf           = pCtx->pFrameBs + pCtx->iPosBsBuffer;
+  pLayerBsInfo->pNalLengthInByte = (pLayerBsInfo - 1)->pNalLengthInByte + 1;
+  //update for external countings
+  ++ iLayerNum;
+
+  iFrameSize += iNalSize;
+  return ENC_RETURN_SUCCESS;
 }
+
 EVideoFrameType PrepareEncodeFrame (sWelsEncCtx* pCtx, SLayerBSInfo*& pLayerBsInfo, int32_t iSpatialNum,
                                     int8_t& iCurDid, int32_t& iCurTid,
                                     int32_t& iLayerNum, int32_t& iFrameSize, long long uiTimeStamp) {
@@ -3427,9 +3727,239 @@ EVideoFrameType PrepareEncodeFrame (sWelsEncCtx* pCtx, SLayerBSInfo*& pLayerBsIn
 
       }
     }
+    if (WelsIntraRefreshFrameInit (pCtx, eFrameType, iCurDid)) {
+      pCtx->iEncoderError = WriteRecoveryPointSei (pCtx, iCurDid, pLayerBsInfo, iLayerNum, iFrameSize);
+    }
   }
   return eFrameType;
 }
+void WelsProfilingFrameBegin (sWelsEncCtx* pCtx) {
+  ProfilerStart (&pCtx->sProfiler, pCtx->pSvcParam->bProfiling);
+  if (pCtx->sProfiler.bEnabled)
+    ProfilerClear (&pCtx->sProfiler);
+}
+
+void WelsProfilingFrameEnd (sWelsEncCtx* pCtx) {
+  SStageProfiler* pProfiler = &pCtx->sProfiler;
+  if (!pProfiler->bEnabled)
+    return;
+
+  // the slice threads are done, gather what they counted
+  for (int32_t iDid = 0; iDid < pCtx->pSvcParam->iSpatialLayerNum; iDid++) {
+    SDqLayer* pDqLayer = pCtx->ppDqLayerList[iDid];
+    if (NULL == pDqLayer || NULL == pDqLayer->ppSliceInLayer)
+      continue;
+    for (int32_t iSliceIdx = 0; iSliceIdx < pDqLayer->iMaxSliceNum; iSliceIdx++) {
+      SStageProfiler* pSliceProfiler = &pDqLayer->ppSliceInLayer[iSliceIdx]->sProfiler;
+      if (pSliceProfiler->bEnabled) {
+        ProfilerAccumulate (pProfiler, pSliceProfiler);
+        ProfilerClear (pSliceProfiler);
+      }
+    }
+  }
+
+  ProfilerAccumulate (&pCtx->sProfilerTotal, pProfiler);
+  ++ pCtx->uiProfiledFrameCount;
+}
+
+void WelsProfilingReset (sWelsEncCtx* pCtx) {
+  ProfilerClear (&pCtx->sProfiler);
+  ProfilerClear (&pCtx->sProfilerTotal);
+  pCtx->uiProfiledFrameCount = 0;
+}
+
+static void ProfilerToCounters (const SStageProfiler* kpProfiler, SProfilingCounters* pCounters) {
+  int32_t i;
+  for (i = 0; i < PROFILING_STAGE_NUM; i++)
+    pCounters->iStageTimeUs[i] = kpProfiler->iStageTime[i] / 1000;
+  for (i = 0; i < PROFILING_VP_NUM; i++)
+    pCounters->iVpTimeUs[i] = kpProfiler->iVpTime[i] / 1000;
+  pCounters->iSadCount          = kpProfiler->iSadCount;
+  pCounters->iSatdCount         = kpProfiler->iSatdCount;
+  pCounters->iSubpelRefineCount = kpProfiler->iSubpelRefineCount;
+  pCounters->iPrefilteredSkipCount = kpProfiler->iPrefilteredSkipCount;
+  // EProfilingMbType follows the order of the types counted by WelsCountMbType()
+  for (i = 0; i < PROFILING_MB_TYPE_NUM; i++) {
+    pCounters->uiMbTypeCount[i] = kpProfiler->iMbCount[P_SLICE][i] + kpProfiler->iMbCount[I_SLICE][i];
+  }
+}
+
+void WelsProfilingGet (sWelsEncCtx* pCtx, SEncoderProfiling* pProfiling) {
+  pProfiling->bEnable      = pCtx->pSvcParam->bProfiling;
+  pProfiling->bReset       = false;
+  pProfiling->uiFrameCount = pCtx->uiProfiledFrameCount;
+  ProfilerToCounters (&pCtx->sProfilerTotal, &pProfiling->sTotal);
+  ProfilerToCounters (&pCtx->sProfiler, &pProfiling->sLastFrame);
+}
+
+void WelsMotionHintClear (sWelsEncCtx* pCtx) {
+  // the buffer is kept for the hints of the next frames
+  pCtx->iMotionHintMbWidth  = 0;
+  pCtx->iMotionHintMbHeight = 0;
+  pCtx->bMotionHintEarlyTermination = false;
+  if (NULL != pCtx->pVpp)
+    pCtx->pVpp->SetSharedAnalysis (NULL, 0);
+}
+
+int32_t WelsMotionHintSet (sWelsEncCtx* pCtx, const SMotionHintParam* kpHint) {
+  WelsMotionHintClear (pCtx);
+  const int32_t kiRet = pCtx->pVpp->SetSharedAnalysis (kpHint->pPreprocess, kpHint->iPreprocessSize);
+  if (ENC_RETURN_SUCCESS != kiRet)
+    return kiRet;
+  if (NULL == kpHint->pHints)
+    return ENC_RETURN_SUCCESS;
+  if (kpHint->iMbWidth <= 0 || kpHint->iMbHeight <= 0)
+    return ENC_RETURN_UNSUPPORTED_PARA;
+
+  const int32_t kiHintNum = kpHint->iMbWidth * kpHint->iMbHeight;
+  if (kiHintNum > pCtx->iMotionHintCapacity) {
+    CMemoryAlign* pMa = pCtx->pMemAlign;
+    if (NULL != pCtx->pMotionHint) {
+      pMa->WelsFree (pCtx->pMotionHint, "pMotionHint");
+    }
+    pCtx->pMotionHint = (SMbMotionHint*)pMa->WelsMalloc (kiHintNum * sizeof (SMbMotionHint), "pMotionHint");
+    pCtx->iMotionHintCapacity = (NULL != pCtx->pMotionHint) ? kiHintNum : 0;
+    WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pCtx->pMotionHint))
+  }
+  memcpy (pCtx->pMotionHint, kpHint->pHints, kiHintNum * sizeof (SMbMotionHint));
+  pCtx->iMotionHintMbWidth  = kpHint->iMbWidth;
+  pCtx->iMotionHintMbHeight = kpHint->iMbHeight;
+  pCtx->bMotionHintEarlyTermination = kpHint->bEarlyTermination;
+  return ENC_RETURN_SUCCESS;
+}
+
+void WelsEffortMapClear (sWelsEncCtx* pCtx) {
+  // the buffer is kept for the maps of the next frames
+  pCtx->iEffortMapMbWidth  = 0;
+  pCtx->iEffortMapMbHeight = 0;
+}
+
+void WelsComplexityReset (sWelsEncCtx* pCtx) {
+  pCtx->iComplexityLevel = COMPLEXITY_LEVEL_FULL;
+  pCtx->iFrameTimeAvgUs  = 0;
+}
+
+void WelsComplexityUpdate (sWelsEncCtx* pCtx, const int64_t kiFrameTimeUs) {
+  const int64_t kiBudgetUs = pCtx->pSvcParam->iFrameTimeBudgetUs;
+  pCtx->iLastComplexityLevel = pCtx->iComplexityLevel;
+  if (kiBudgetUs <= 0) {
+    WelsComplexityReset (pCtx);
+    return;
+  }
+
+  // smoothed over a few frames, so that a single late frame does not switch the level
+  pCtx->iFrameTimeAvgUs = (0 == pCtx->iFrameTimeAvgUs) ? kiFrameTimeUs : ((pCtx->iFrameTimeAvgUs * 3 + kiFrameTimeUs) >> 2);
+  int32_t iLevel = pCtx->iComplexityLevel;
+  if (pCtx->iFrameTimeAvgUs > kiBudgetUs)
+    iLevel = WELS_MIN (iLevel + 1, COMPLEXITY_LEVEL_NUM - 1);
+  else if (pCtx->iFrameTimeAvgUs * 100 < kiBudgetUs * COMPLEXITY_RELAX_PERCENT)
+    iLevel = WELS_MAX (iLevel - 1, COMPLEXITY_LEVEL_FULL);
+
+  // the time measured at the previous level no longer applies
+  if (iLevel != pCtx->iComplexityLevel) {
+    pCtx->iComplexityLevel = iLevel;
+    pCtx->iFrameTimeAvgUs  = 0;
+  }
+}
+
+int32_t WelsEffortMapSet (sWelsEncCtx* pCtx, const SEffortMapParam* kpMap) {
+  WelsEffortMapClear (pCtx);
+  if (NULL == kpMap->pEffort)
+    return ENC_RETURN_SUCCESS;
+  if (kpMap->iMbWidth <= 0 || kpMap->iMbHeight <= 0)
+    return ENC_RETURN_UNSUPPORTED_PARA;
+
+  const int32_t kiMapNum = kpMap->iMbWidth * kpMap->iMbHeight;
+  for (int32_t i = 0; i < kiMapNum; i++) {
+    if (kpMap->pEffort[i] > EFFORT_SKIP)
+      return ENC_RETURN_UNSUPPORTED_PARA;
+  }
+  if (kiMapNum > pCtx->iEffortMapCapacity) {
+    CMemoryAlign* pMa = pCtx->pMemAlign;
+    if (NULL != pCtx->pEffortMap) {
+      pMa->WelsFree (pCtx->pEffortMap, "pEffortMap");
+    }
+    pCtx->pEffortMap = (uint8_t*)pMa->WelsMalloc (kiMapNum * sizeof (uint8_t), "pEffortMap");
+    pCtx->iEffortMapCapacity = (NULL != pCtx->pEffortMap) ? kiMapNum : 0;
+    WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pCtx->pEffortMap))
+  }
+  memcpy (pCtx->pEffortMap, kpMap->pEffort, kiMapNum * sizeof (uint8_t));
+  pCtx->iEffortMapMbWidth  = kpMap->iMbWidth;
+  pCtx->iEffortMapMbHeight = kpMap->iMbHeight;
+  return ENC_RETURN_SUCCESS;
+}
+
+static void MotionAnalysisOfMb (const SMB* kpMb, SMbMotionHint* pHint) {
+  static const uint8_t kuiScan4Idx8x8[4] = { 0, 2, 8, 10 }; // top-left 4x4 of each 8x8 block
+  const Mb_Type kuiMbType = kpMb->uiMbType;
+
+  memset (pHint, 0, sizeof (SMbMotionHint));
+  pHint->uiQp = kpMb->uiLumaQp;
+  if (IS_INTRA (kuiMbType)) {
+    pHint->iRefIdx     = -1;
+    pHint->uiPartition = MOTION_HINT_INTRA;
+    return;
+  }
+
+  if (IS_SKIP (kuiMbType)) {
+    pHint->uiPartition = MOTION_HINT_SKIP;
+  } else if (MB_TYPE_16x16 == kuiMbType) {
+    pHint->uiPartition = MOTION_HINT_16x16;
+  } else if (MB_TYPE_16x8 == kuiMbType) {
+    pHint->uiPartition = MOTION_HINT_16x8;
+  } else if (MB_TYPE_8x16 == kuiMbType) {
+    pHint->uiPartition = MOTION_HINT_8x16;
+  } else {
+    pHint->uiPartition = MOTION_HINT_8x8;
+  }
+  pHint->iRefIdx = kpMb->pRefIndex[0];
+  // the 16x16 search result is kept even when a smaller partition won
+  const SMVUnitXY ksMv16x16 = (MOTION_HINT_SKIP == pHint->uiPartition
+                               || MOTION_HINT_16x16 == pHint->uiPartition) ? kpMb->sMv[0] : kpMb->sP16x16Mv;
+  pHint->iMv16x16[0] = ksMv16x16.iMvX;
+  pHint->iMv16x16[1] = ksMv16x16.iMvY;
+  for (int32_t i = 0; i < 4; i++) {
+    pHint->iMv8x8[i][0] = kpMb->sMv[kuiScan4Idx8x8[i]].iMvX;
+    pHint->iMv8x8[i][1] = kpMb->sMv[kuiScan4Idx8x8[i]].iMvY;
+  }
+}
+
+void WelsMotionAnalysisOutput (sWelsEncCtx* pCtx, const SFrameBSInfo* kpFbi) {
+  pCtx->iMotionAnalysisMbWidth  = 0;
+  pCtx->iMotionAnalysisMbHeight = 0;
+  if (!pCtx->pSvcParam->bMotionAnalysis || videoFrameTypeSkip == kpFbi->eFrameType
+      || videoFrameTypeInvalid == kpFbi->eFrameType)
+    return;
+
+  SDqLayer* pDqLayer = pCtx->ppDqLayerList[pCtx->pSvcParam->iSpatialLayerNum - 1];
+  const int32_t kiMbNum = pDqLayer->iMbWidth * pDqLayer->iMbHeight;
+  if (NULL == pCtx->pMotionAnalysis) {
+    // the layer size only changes with a new context
+    pCtx->pMotionAnalysis = (SMbMotionHint*)pCtx->pMemAlign->WelsMalloc (kiMbNum * sizeof (SMbMotionHint),
+                            "pMotionAnalysis");
+    if (NULL == pCtx->pMotionAnalysis)
+      return;
+  }
+  for (int32_t i = 0; i < kiMbNum; i++) {
+    MotionAnalysisOfMb (&pDqLayer->sMbDataP[i], &pCtx->pMotionAnalysis[i]);
+  }
+  pCtx->iMotionAnalysisMbWidth    = pDqLayer->iMbWidth;
+  pCtx->iMotionAnalysisMbHeight   = pDqLayer->iMbHeight;
+  pCtx->eMotionAnalysisFrameType  = kpFbi->eFrameType;
+  pCtx->uiMotionAnalysisTimeStamp = kpFbi->uiTimeStamp;
+}
+
+void WelsMotionAnalysisGet (sWelsEncCtx* pCtx, SMotionAnalysis* pAnalysis) {
+  const bool kbValid = (pCtx->iMotionAnalysisMbWidth > 0);
+  pAnalysis->bEnable     = pCtx->pSvcParam->bMotionAnalysis;
+  pAnalysis->pHints      = kbValid ? pCtx->pMotionAnalysis : NULL;
+  pAnalysis->iMbWidth    = pCtx->iMotionAnalysisMbWidth;
+  pAnalysis->iMbHeight   = pCtx->iMotionAnalysisMbHeight;
+  pAnalysis->eFrameType  = kbValid ? pCtx->eMotionAnalysisFrameType : videoFrameTypeInvalid;
+  pAnalysis->uiTimeStamp = kbValid ? pCtx->uiMotionAnalysisTimeStamp : 0;
+  pCtx->pVpp->GetSharedAnalysis (false, &pAnalysis->pPreprocess, &pAnalysis->iPreprocessSize);
+}
+
 /*!
  * \brief   core svc encoding process
  *
@@ -3480,21 +4010,32 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
   pCtx->bCurFrameMarkedAsSceneLtr = false;
   pFbi->eFrameType = videoFrameTypeSkip;
   pFbi->iLayerNum = 0; // for initialization
+  pCtx->iSliceOutputLayerNum = 0;
   pFbi->uiTimeStamp = GetTimestampForRc (pSrcPic->uiTimeStamp, pCtx->uiLastTimestamp,
                                          pCtx->pSvcParam->sSpatialLayers[pCtx->pSvcParam->iSpatialLayerNum - 1].fFrameRate);
   for (int32_t iNalIdx = 0; iNalIdx < MAX_LAYER_NUM_OF_FRAME; iNalIdx++) {
     pFbi->sLayerInfo[iNalIdx].eFrameType = videoFrameTypeSkip;
     pFbi->sLayerInfo[iNalIdx].iNalCount  = 0;
   }
+  memset (pCtx->sLayerQualityMetrics, 0, sizeof (pCtx->sLayerQualityMetrics));
   // perform csc/denoise/downsample/padding, generate spatial layers
+  ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_PREPROCESS);
   iSpatialNum = pCtx->pVpp->BuildSpatialPicList (pCtx, pSrcPic);
+  ProfilerSwitchStage (&pCtx->sProfiler, -1);
   if (iSpatialNum == -1) {
     WelsLog (& (pCtx->sLogCtx), WELS_LOG_ERROR, "Failed in allocating memory in BuildSpatialPicList");
     return ENC_RETURN_MEMALLOCERR;
   }
+  if (iSpatialNum == -2) {
+    WelsLog (& (pCtx->sLogCtx), WELS_LOG_ERROR, "Failed in converting the source picture in BuildSpatialPicList");
+    pFbi->eFrameType = videoFrameTypeInvalid;
+    return ENC_RETURN_INVALIDINPUT;
+  }
 
   if (pCtx->pFuncList->pfRc.pfWelsUpdateMaxBrWindowStatus) {
+    ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_RATE_CONTROL);
     pCtx->pFuncList->pfRc.pfWelsUpdateMaxBrWindowStatus (pCtx, iSpatialNum, pFbi->uiTimeStamp);
+    ProfilerSwitchStage (&pCtx->sProfiler, -1);
   }
 
   if (iSpatialNum < 1) {
@@ -3552,7 +4093,9 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
       }
     }
     InitFrameCoding (pCtx, eFrameType, iCurDid);
+    ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_PREPROCESS);
     pCtx->pVpp->AnalyzeSpatialPic (pCtx, iCurDid);
+    ProfilerSwitchStage (&pCtx->sProfiler, -1);
 
     pCtx->pEncPic               = pEncPic = (pSpatialIndexMap + iSpatialIdx)->pSrc;
     pCtx->pEncPic->iPictureType = pCtx->eSliceType;
@@ -3645,15 +4188,22 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
 #ifdef LONG_TERM_REF_DUMP
     DumpRef (pCtx);
 #endif
-    if (pSvcParam->iRCMode != RC_OFF_MODE)
+    if (pSvcParam->iRCMode != RC_OFF_MODE) {
+      ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_PREPROCESS);
       pCtx->pVpp->AnalyzePictureComplexity (pCtx, pCtx->pEncPic, ((pCtx->eSliceType == P_SLICE)
                                             && (pCtx->iNumRef0 > 0)) ? pCtx->pRefList0[0] : NULL,
                                             iCurDid, (pCtx->eSliceType == P_SLICE) && pSvcParam->bEnableBackgroundDetection);
+      ProfilerSwitchStage (&pCtx->sProfiler, -1);
+    }
     WelsUpdateRefSyntax (pCtx,  pParamInternal->iPOC,
                          eFrameType); //get reordering syntax used for writing slice header and transmit to encoder.
     PrefetchReferencePicture (pCtx, eFrameType); // update reference picture for current pDq layer
+    WelsIntraRefreshLayerInit (pCtx, iCurDid);
+    ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_RATE_CONTROL);
     pCtx->pFuncList->pfRc.pfWelsRcPictureInit (pCtx, pFbi->uiTimeStamp);
+    ProfilerSwitchStage (&pCtx->sProfiler, -1);
     PreprocessSliceCoding (pCtx); // MUST be called after pfWelsRcPictureInit() and WelsInitCurrentLayer()
+    InitSliceOutput (pCtx, pFbi, iLayerNum, eFrameType);
 
     //TODO Complexity Calculation here for screen content
     iLayerSize = 0;
@@ -3661,6 +4211,7 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
       int32_t iSliceSize   = 0;
       int32_t iPayloadSize = 0;
       SSlice* pCurSlice    = &pCtx->pCurDqLayer->sSliceBufferInfo[0].pSliceBuffer[0];
+      uint8_t* pSliceBs    = pCtx->pFrameBs + pCtx->iPosBsBuffer;
 
       if (pCtx->bNeedPrefixNalFlag) {
         pCtx->iEncoderError = AddPrefixNal (pCtx, pLayerBsInfo, &pLayerBsInfo->pNalLengthInByte[0], &iNalIdxInLayer, eNalType,
@@ -3687,6 +4238,7 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
                                            &pLayerBsInfo->pNalLengthInByte[iNalIdxInLayer]);
       WELS_VERIFY_RETURN_IFNEQ (pCtx->iEncoderError, ENC_RETURN_SUCCESS)
       iSliceSize = pLayerBsInfo->pNalLengthInByte[iNalIdxInLayer];
+      OutputSlice (pCtx, 0, pSliceBs, &pLayerBsInfo->pNalLengthInByte[0], iNalIdxInLayer + 1);
 
       iLayerSize += iSliceSize;
       pCtx->iPosBsBuffer               += iSliceSize;
@@ -3800,6 +4352,8 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
         while (iSliceIdx < iSliceCount) {
           int32_t iSliceSize    = 0;
           int32_t iPayloadSize  = 0;
+          const int32_t kiFirstNalIdx = iNalIdxInLayer;
+          uint8_t* pSliceBs     = pCtx->pFrameBs + pCtx->iPosBsBuffer;
 
           if (bNeedPrefix) {
             pCtx->iEncoderError = AddPrefixNal (pCtx, pLayerBsInfo, &pLayerBsInfo->pNalLengthInByte[0], &iNalIdxInLayer, eNalType,
@@ -3826,6 +4380,8 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
                                                pCtx->pFrameBs + pCtx->iPosBsBuffer, &pLayerBsInfo->pNalLengthInByte[iNalIdxInLayer]);
           WELS_VERIFY_RETURN_IFNEQ (pCtx->iEncoderError, ENC_RETURN_SUCCESS)
           iSliceSize = pLayerBsInfo->pNalLengthInByte[iNalIdxInLayer];
+          OutputSlice (pCtx, iSliceIdx, pSliceBs, &pLayerBsInfo->pNalLengthInByte[kiFirstNalIdx],
+                       iNalIdxInLayer + 1 - kiFirstNalIdx);
 
           pCtx->iPosBsBuffer += iSliceSize;
           iLayerSize         += iSliceSize;
@@ -3852,8 +4408,11 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
       }
     }
 
-    if (NULL != pCtx->pFuncList->pfRc.pfWelsRcPostFrameSkipping
-        && pCtx->pFuncList->pfRc.pfWelsRcPostFrameSkipping (pCtx, iCurDid, pFbi->uiTimeStamp)) {
+    ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_RATE_CONTROL);
+    const bool kbPostFrameSkipped = (NULL != pCtx->pFuncList->pfRc.pfWelsRcPostFrameSkipping
+                                     && pCtx->pFuncList->pfRc.pfWelsRcPostFrameSkipping (pCtx, iCurDid, pFbi->uiTimeStamp));
+    ProfilerSwitchStage (&pCtx->sProfiler, -1);
+    if (kbPostFrameSkipped) {
 
       StackBackEncoderStatus (pCtx, eFrameType);
       ClearFrameBsInfo (pCtx, pFbi);
@@ -3875,15 +4434,24 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
     if (
       (!pCtx->pCurDqLayer->bDeblockingParallelFlag) &&
 #if !defined(ENABLE_FRAME_DUMP)
-      ((eNalRefIdc != NRI_PRI_LOWEST) && (pSvcParam->sDependencyLayers[iCurDid].iHighestTemporalId == 0
-                                          || iCurTid < pSvcParam->sDependencyLayers[iCurDid].iHighestTemporalId)) &&
+      (pSvcParam->bQualityMetrics || ((eNalRefIdc != NRI_PRI_LOWEST)
+                                      && (pSvcParam->sDependencyLayers[iCurDid].iHighestTemporalId == 0
+                                          || iCurTid < pSvcParam->sDependencyLayers[iCurDid].iHighestTemporalId))) &&
 #endif//!ENABLE_FRAME_DUMP
       true
     ) {
-      PerformDeblockingFilter (pCtx);
+      ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_DEBLOCKING);
+      if (pCtx->pCurDqLayer->bDeblockingOverlappedFlag)
+        WelsOverlappedDeblockingFinish (pCtx);
+      else
+        PerformDeblockingFilter (pCtx);
+      ProfilerSwitchStage (&pCtx->sProfiler, -1);
     }
+    UpdateLayerQualityMetrics (pCtx, iCurDid);
 
+    ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_RATE_CONTROL);
     pCtx->pFuncList->pfRc.pfWelsRcPictureInfoUpdate (pCtx, iLayerSize);
+    ProfilerSwitchStage (&pCtx->sProfiler, -1);
     iFrameSize += iLayerSize;
     RcTraceFrameBits (pCtx, pFbi->uiTimeStamp, iFrameSize);
     pCtx->pDecPic->iFrameAverageQp = pCtx->pWelsSvcRc[iCurDid].iAverageFrameQp;
@@ -4149,6 +4717,16 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
   return ENC_RETURN_SUCCESS;
 }
 
+static inline bool IsSameReconfigPool (const SReconfigPoolParam* kpPool1, const SReconfigPoolParam* kpPool2) {
+  return kpPool1->iMaxPicWidth == kpPool2->iMaxPicWidth && kpPool1->iMaxPicHeight == kpPool2->iMaxPicHeight;
+}
+
+static inline bool IsSameMemoryArena (const SMemoryArenaParam* kpArena1, const SMemoryArenaParam* kpArena2) {
+  return kpArena1->uiArenaSize == kpArena2->uiArenaSize
+         && kpArena1->bHugePages == kpArena2->bHugePages
+         && kpArena1->bPrefault == kpArena2->bPrefault;
+}
+
 /*!
  * \brief   Wels SVC encoder parameters adjustment
  *          SVC adjustment results in new requirement in memory blocks adjustment
@@ -4198,7 +4776,12 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
                (pOldParam->iMultipleThreadIdc != pNewParam->iMultipleThreadIdc) ||
                (pOldParam->bEnableBackgroundDetection != pNewParam->bEnableBackgroundDetection) ||
                (pOldParam->bEnableAdaptiveQuant != pNewParam->bEnableAdaptiveQuant) ||
-               (pOldParam->eSpsPpsIdStrategy != pNewParam->eSpsPpsIdStrategy);
+               (pOldParam->eSpsPpsIdStrategy != pNewParam->eSpsPpsIdStrategy) ||
+               (pOldParam->iPreallocSliceNum != (*ppCtx)->iPreallocSliceNumRequested) ||
+               (!IsSameMemoryArena (&pOldParam->sMemoryArena, & (*ppCtx)->sMemoryArena)) ||
+               (pOldParam->bLowFootprint != (*ppCtx)->bLowFootprint) ||
+               (pOldParam->bLowFootprint && pOldParam->iTemporalLayerNum != pNewParam->iTemporalLayerNum) ||
+               (!IsSameReconfigPool (&pOldParam->sReconfigPool, & (*ppCtx)->sReconfigPool));
   if ((pNewParam->iMaxNumRefFrame > pOldParam->iMaxNumRefFrame) ||
       ((pOldParam->iMaxNumRefFrame == 1) && (pOldParam->iTemporalLayerNum == 1) && (pNewParam->iTemporalLayerNum == 2))) {
     bNeedReset = true;
@@ -4321,6 +4904,39 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
     int32_t            iStatisticsLogInterval = (*ppCtx)->iStatisticsLogInterval;
     int64_t            iLastStatisticsLogTs = (*ppCtx)->iLastStatisticsLogTs;
     //for sEncoderStatistics
+    //keep the profiling counters
+    SStageProfiler     sTempProfiler = (*ppCtx)->sProfiler;
+    SStageProfiler     sTempProfilerTotal = (*ppCtx)->sProfilerTotal;
+    uint32_t           uiProfiledFrameCount = (*ppCtx)->uiProfiledFrameCount;
+    SEncoderBufferStatistics sTempBufferStatistics = (*ppCtx)->sBufferStatistics;
+    SEncoderReconfigStatistics sTempReconfigStatistics = (*ppCtx)->sReconfigStatistics;
+    uint32_t           uiIntraRefreshNum = (*ppCtx)->uiIntraRefreshNum;
+    SLayerQualityMetrics sTempQualityAverage[MAX_DEPENDENCY_LAYER];
+    uint32_t           uiTempQualityFrameCount[MAX_DEPENDENCY_LAYER];
+    memcpy (sTempQualityAverage, (*ppCtx)->sLayerQualityAverage, sizeof (sTempQualityAverage));
+    memcpy (uiTempQualityFrameCount, (*ppCtx)->uiQualityFrameCount, sizeof (uiTempQualityFrameCount));
+
+    //keep the thread scheduling set through SetOption
+    pNewParam->iThreadPriorityClass = pOldParam->iThreadPriorityClass;
+    pNewParam->iMaxThreadsInUse = pOldParam->iMaxThreadsInUse;
+    //keep the source reading mode set through SetOption
+    pNewParam->bZeroCopyInput = pOldParam->bZeroCopyInput;
+    //keep the slice output callback set through SetOption
+    pNewParam->sSliceOutput = pOldParam->sSliceOutput;
+    pNewParam->bProfiling = pOldParam->bProfiling;
+    pNewParam->bMotionAnalysis = pOldParam->bMotionAnalysis;
+    pNewParam->bHierarchicalMe = pOldParam->bHierarchicalMe;
+    pNewParam->bHalfPelCache = pOldParam->bHalfPelCache;
+    pNewParam->bScreenBlockHash = pOldParam->bScreenBlockHash;
+    pNewParam->bStaticSkipPrefilter = pOldParam->bStaticSkipPrefilter;
+    pNewParam->iFrameTimeBudgetUs = pOldParam->iFrameTimeBudgetUs;
+    pNewParam->bOverlappedDeblocking = pOldParam->bOverlappedDeblocking;
+    pNewParam->iPreallocSliceNum = pOldParam->iPreallocSliceNum;
+    pNewParam->sMemoryArena = pOldParam->sMemoryArena;
+    pNewParam->bLowFootprint = pOldParam->bLowFootprint;
+    pNewParam->sReconfigPool = pOldParam->sReconfigPool;
+    pNewParam->iIntraRefreshFrames = pOldParam->iIntraRefreshFrames;
+    pNewParam->bQualityMetrics = pOldParam->bQualityMetrics;
 
     SExistingParasetList sExistingParasetList;
     SExistingParasetList* pExistingParasetList = NULL;
@@ -4335,11 +4951,43 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
       }
     }
 
+    const int64_t kiReconfigStartNs = WelsTimeNs();
+    // the threads of the pool are kept for the new context unless it takes more
+    CWelsThreadPool* pKeptThreadPool = (*ppCtx)->pIdleThreadPool;
+    (*ppCtx)->pIdleThreadPool = NULL;
+    if (NULL == pKeptThreadPool && NULL != (*ppCtx)->pTaskManage
+        && pNewParam->iMultipleThreadIdc <= (*ppCtx)->pTaskManage->GetThreadPoolThreadNum())
+      pKeptThreadPool = CWelsThreadPool::AddReference();
+    // with a reconfiguration pool kept as it is, the arena is given back at once and carved again for the new context
+    CMemoryAlign* pKeptMa = NULL;
+    if ((*ppCtx)->sReconfigPool.iMaxPicWidth > 0
+        && IsSameReconfigPool (&pNewParam->sReconfigPool, & (*ppCtx)->sReconfigPool)
+        && IsSameMemoryArena (&pNewParam->sMemoryArena, & (*ppCtx)->sMemoryArena)
+        && (*ppCtx)->pMemAlign->WelsGetArenaSize() > 0) {
+      pKeptMa = (*ppCtx)->pMemAlign;
+      (*ppCtx)->bKeepMemAlign = true;
+    }
+
     WelsUninitEncoderExt (ppCtx);
+    if (NULL != pKeptMa && !pKeptMa->WelsArenaRewind()) {
+      WELS_DELETE_OP (pKeptMa);
+    }
 
     /* Update new parameters */
-    if (WelsInitEncoderExt (ppCtx, pNewParam, &sLogCtx, pExistingParasetList))
+    iReturn = WelsInitEncoderExt (ppCtx, pNewParam, &sLogCtx, pExistingParasetList, pKeptMa);
+    if (NULL != pKeptThreadPool) {
+      // with a reconfiguration pool, a context without threads holds the pool for the next reset
+      if (0 == iReturn && NULL == (*ppCtx)->pTaskManage && (*ppCtx)->sReconfigPool.iMaxPicWidth > 0)
+        (*ppCtx)->pIdleThreadPool = pKeptThreadPool;
+      else
+        pKeptThreadPool->RemoveInstance();
+    }
+    if (iReturn)
       return 1;
+    const uint32_t kuiReconfigUs = (uint32_t) ((WelsTimeNs() - kiReconfigStartNs) / 1000);
+    sTempReconfigStatistics.uiReconfigCount ++;
+    sTempReconfigStatistics.uiLastReconfigUs = kuiReconfigUs;
+    sTempReconfigStatistics.uiMaxReconfigUs = WELS_MAX (sTempReconfigStatistics.uiMaxReconfigUs, kuiReconfigUs);
     //if WelsInitEncoderExt succeed
     //for LTR or SPS,PPS ID update
     for (iIndexD = 0; iIndexD < pNewParam->iSpatialLayerNum; iIndexD++) {
@@ -4351,6 +4999,14 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
     (*ppCtx)->uiStartTimestamp = uiStartTimestamp;
     (*ppCtx)->iStatisticsLogInterval = iStatisticsLogInterval;
     (*ppCtx)->iLastStatisticsLogTs = iLastStatisticsLogTs;
+    (*ppCtx)->sProfiler = sTempProfiler;
+    (*ppCtx)->sProfilerTotal = sTempProfilerTotal;
+    (*ppCtx)->uiProfiledFrameCount = uiProfiledFrameCount;
+    (*ppCtx)->sBufferStatistics = sTempBufferStatistics;
+    (*ppCtx)->sReconfigStatistics = sTempReconfigStatistics;
+    (*ppCtx)->uiIntraRefreshNum = uiIntraRefreshNum;
+    memcpy ((*ppCtx)->sLayerQualityAverage, sTempQualityAverage, sizeof (sTempQualityAverage));
+    memcpy ((*ppCtx)->uiQualityFrameCount, uiTempQualityFrameCount, sizeof (uiTempQualityFrameCount));
     //for sEncoderStatistics
 
     //load back the needed structure for eSpsPpsIdStrategy
@@ -4545,6 +5201,8 @@ int32_t WelsCodeOnePicPartition (sWelsEncCtx* pCtx,
     int32_t iSliceSize      = 0;
     int32_t iPayloadSize    = 0;
     SSlice* pCurSlice = NULL;
+    int32_t iFirstNalIdx    = iNalIdxInLayer;
+    uint8_t* pSliceBs       = pCtx->pFrameBs + pCtx->iPosBsBuffer;
 
     if (iSliceIdx >= (pCurLayer->sSliceBufferInfo[uSlcBuffIdx].iMaxSliceNum -
                       kiSliceIdxStep)) { // insufficient memory in pSliceInLayer[]
@@ -4585,6 +5243,8 @@ int32_t WelsCodeOnePicPartition (sWelsEncCtx* pCtx,
                              &pLayerBsInfo->pNalLengthInByte[iNalIdxInLayer]);
     WELS_VERIFY_RETURN_IFNEQ (iReturn, ENC_RETURN_SUCCESS)
     iSliceSize = pLayerBsInfo->pNalLengthInByte[iNalIdxInLayer];
+    OutputSlice (pCtx, iSliceIdx, pSliceBs, &pLayerBsInfo->pNalLengthInByte[iFirstNalIdx],
+                 iNalIdxInLayer + 1 - iFirstNalIdx);
 
     pCtx->iPosBsBuffer  += iSliceSize;
     iPartitionBsSize    += iSliceSize;
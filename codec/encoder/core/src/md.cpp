@@ -42,6 +42,26 @@
 #include "md.h"
 #include "cpu_core.h"
 #include "svc_enc_golomb.h"
+#include "WelsLock.h"
+
+namespace {
+
+// MVD cost tables in use, one per MVD range shared by all the encoders
+typedef struct TagSharedMvdCostTable {
+  struct TagSharedMvdCostTable* pNext;
+  int32_t   iMvdSz;
+  int32_t   iRefCount;
+  uint16_t* pTable;
+} SSharedMvdCostTable;
+
+SSharedMvdCostTable* g_pSharedMvdCostTables = NULL;
+
+WelsCommon::CWelsLock& GetMvdCostTableLock() {
+  static WelsCommon::CWelsLock* pLock = new WelsCommon::CWelsLock;
+  return *pLock;
+}
+
+} // anon ns.
 
 namespace WelsEnc {
 #define INTRA_VARIANCE_SAD_THRESHOLD 150
@@ -512,6 +532,7 @@ void InitMeRefinePointer (SMeRefinePointer* pMeRefine, SMbCache* pMbCache, int32
 typedef struct TagQuarParams {
   int32_t iBestCost;
   int32_t iBestHalfPix;
+  int32_t iStrideHalf;  // stride of pSrcA
   int32_t iStrideA;
   int32_t iStrideB;
   uint8_t* pRef;
@@ -536,8 +557,30 @@ inline void MeRefineQuarPixel (SWelsFuncPtrList* pFunc, SWelsME* pMe, SMeRefineP
   uint8_t* pEncMb                       = pMe->pEncMb;
   uint8_t* pTmp                         = NULL;
   const uint8_t kuiPixel                = pMe->uiBlockSize;
+  PSampleSatdQuarFourFunc pSatdQuarFour = pFunc->sSampleDealingFuncs.pfSampleSatdQuarFour[kuiPixel];
+
+  if (NULL != pSatdQuarFour && pFunc->sSampleDealingFuncs.pfMeCost == pFunc->sSampleDealingFuncs.pfSampleSatd) {
+    // the four points are averaged and scored in one pass, only the best one is averaged again into the buffer
+    static const int32_t kiQuarPix[4] = {ME_QUAR_PIXEL_TOP, ME_QUAR_PIXEL_BOTTOM, ME_QUAR_PIXEL_LEFT, ME_QUAR_PIXEL_RIGHT};
+    const int32_t kiStrideB[4] = {pParams->iStrideA, pParams->iStrideA, pParams->iStrideB, pParams->iStrideB};
+    int32_t iSatd[4];
+    int32_t iBest = -1;
+    pSatdQuarFour (pEncMb, iStrideEnc, pParams->pSrcA, pParams->iStrideHalf, pParams->pSrcB, kiStrideB, iSatd);
+    for (int32_t i = 0; i < 4; i++) {
+      iCurCost = iSatd[i] + pParams->iLms[i];
+      if (iCurCost < pParams->iBestCost) {
+        pParams->iBestCost = iCurCost;
+        pParams->iBestQuarPix = kiQuarPix[i];
+        iBest = i;
+      }
+    }
+    if (iBest >= 0)
+      pSampleAvg (pMeRefine->pQuarPixBest, ME_REFINE_BUF_STRIDE, pParams->pSrcA[iBest], pParams->iStrideHalf,
+                  pParams->pSrcB[iBest], kiStrideB[iBest], kiWidth, kiHeight);
+    return;
+  }
 
-  pSampleAvg (pMeRefine->pQuarPixTmp, ME_REFINE_BUF_STRIDE, pParams->pSrcA[0], ME_REFINE_BUF_STRIDE,
+  pSampleAvg (pMeRefine->pQuarPixTmp, ME_REFINE_BUF_STRIDE, pParams->pSrcA[0], pParams->iStrideHalf,
               pParams->pSrcB[0], pParams->iStrideA, kiWidth, kiHeight);
 
   iCurCost = CALC_COST (pMeRefine->pQuarPixTmp, pParams->iLms[0]);
@@ -547,7 +590,7 @@ inline void MeRefineQuarPixel (SWelsFuncPtrList* pFunc, SWelsME* pMe, SMeRefineP
   }
   //=========================(0, 1)=======================//
   pSampleAvg (pMeRefine->pQuarPixTmp, ME_REFINE_BUF_STRIDE, pParams->pSrcA[1],
-              ME_REFINE_BUF_STRIDE, pParams->pSrcB[1], pParams->iStrideA, kiWidth, kiHeight);
+              pParams->iStrideHalf, pParams->pSrcB[1], pParams->iStrideA, kiWidth, kiHeight);
   iCurCost = CALC_COST (pMeRefine->pQuarPixTmp, pParams->iLms[1]);
   if (iCurCost < pParams->iBestCost) {
     pParams->iBestQuarPix = ME_QUAR_PIXEL_BOTTOM;
@@ -555,7 +598,7 @@ inline void MeRefineQuarPixel (SWelsFuncPtrList* pFunc, SWelsME* pMe, SMeRefineP
   }
   //==========================(-1, 0)=========================//
   pSampleAvg (pMeRefine->pQuarPixTmp, ME_REFINE_BUF_STRIDE, pParams->pSrcA[2],
-              ME_REFINE_BUF_STRIDE, pParams->pSrcB[2], pParams->iStrideB, kiWidth, kiHeight);
+              pParams->iStrideHalf, pParams->pSrcB[2], pParams->iStrideB, kiWidth, kiHeight);
   iCurCost = CALC_COST (pMeRefine->pQuarPixTmp, pParams->iLms[2]);
   if (iCurCost < pParams->iBestCost) {
     pParams->iBestQuarPix = ME_QUAR_PIXEL_LEFT;
@@ -563,7 +606,7 @@ inline void MeRefineQuarPixel (SWelsFuncPtrList* pFunc, SWelsME* pMe, SMeRefineP
   }
   //==========================(1, 0)=========================//
   pSampleAvg (pMeRefine->pQuarPixTmp, ME_REFINE_BUF_STRIDE, pParams->pSrcA[3],
-              ME_REFINE_BUF_STRIDE, pParams->pSrcB[3], pParams->iStrideB,  kiWidth, kiHeight);
+              pParams->iStrideHalf, pParams->pSrcB[3], pParams->iStrideB,  kiWidth, kiHeight);
 
   iCurCost = CALC_COST (pMeRefine->pQuarPixTmp, pParams->iLms[3]);
   if (iCurCost < pParams->iBestCost) {
@@ -572,6 +615,24 @@ inline void MeRefineQuarPixel (SWelsFuncPtrList* pFunc, SWelsME* pMe, SMeRefineP
   }
 }
 
+/*!
+ * \brief   whether the half-pel planes of the reference cover the refinement of a block
+ */
+static inline bool HalfPelPlanesCover (const SPicture* kpRefPic, const uint8_t* kpRef, const int32_t kiWidth,
+                                       const int32_t kiHeight) {
+  if (!kpRefPic->bHalfPelReady)
+    return false;
+  const int32_t kiStride = kpRefPic->iLineSize[0];
+  const int32_t kiPlaneWidth = WELS_ALIGN (kpRefPic->iWidthInPixel, MB_WIDTH_LUMA) + HALFPEL_PLANE_MARGIN;
+  const int32_t kiPlaneHeight = WELS_ALIGN (kpRefPic->iHeightInPixel, MB_HEIGHT_LUMA) + HALFPEL_PLANE_MARGIN;
+  // position of kpRef, counted from the top-left of the padded picture
+  const int32_t kiOffset = static_cast<int32_t> (kpRef - kpRefPic->pData[0]) + PADDING_LENGTH * (kiStride + 1);
+  const int32_t kiX = kiOffset % kiStride - PADDING_LENGTH;
+  const int32_t kiY = kiOffset / kiStride - PADDING_LENGTH;
+  return (kiX - 1 >= -HALFPEL_PLANE_MARGIN) && (kiX + kiWidth < kiPlaneWidth)
+         && (kiY - 1 >= -HALFPEL_PLANE_MARGIN) && (kiY + kiHeight < kiPlaneHeight);
+}
+
 void MeRefineFracPixel (sWelsEncCtx* pEncCtx, uint8_t* pMemPredInterMb, SWelsME* pMe,
                         SMeRefinePointer* pMeRefine, int32_t iWidth, int32_t iHeight) {
   SWelsFuncPtrList* pFunc = pEncCtx->pFuncList;
@@ -581,11 +642,26 @@ void MeRefineFracPixel (sWelsEncCtx* pEncCtx, uint8_t* pMemPredInterMb, SWelsME*
   int16_t iHalfMvx = iMvx;
   int16_t iHalfMvy = iMvy;
   const int32_t kiStrideEnc = pEncCtx->pCurDqLayer->iEncStride[0];
-  const int32_t kiStrideRef = pEncCtx->pCurDqLayer->pRefPic->iLineSize[0];
+  SPicture* pRefPic = pEncCtx->pCurDqLayer->pRefPic;
+  const int32_t kiStrideRef = pRefPic->iLineSize[0];
 
   uint8_t* pEncData = pMe->pEncMb;
   uint8_t* pRef = pMe->pRefMb;//091010
 
+  // the half-pel samples are read from the planes of the reference if filled, else filtered here
+  const bool kbHalfPelPlanes = HalfPelPlanesCover (pRefPic, pRef, iWidth, iHeight);
+  uint8_t* pHalfPixH = pMeRefine->pHalfPixH;
+  uint8_t* pHalfPixV = pMeRefine->pHalfPixV;
+  uint8_t* pHalfPixHV = NULL;
+  int32_t iStrideHalf = ME_REFINE_BUF_STRIDE;
+  if (kbHalfPelPlanes) {
+    const int32_t kiOffset = static_cast<int32_t> (pRef - pRefPic->pData[0]);
+    pHalfPixH  = pRefPic->pHalfPel[0] + kiOffset - 1;
+    pHalfPixV  = pRefPic->pHalfPel[1] + kiOffset - kiStrideRef;
+    pHalfPixHV = pRefPic->pHalfPel[2] + kiOffset - 1 - kiStrideRef;
+    iStrideHalf = kiStrideRef;
+  }
+
   int32_t iBestQuarPix = ME_NO_BEST_QUAR_PIXEL;
 
   SQuarRefineParams sParams;
@@ -607,65 +683,72 @@ void MeRefineFracPixel (sWelsEncCtx* pEncCtx, uint8_t* pMemPredInterMb, SWelsME*
 
   iBestHalfPix = REFINE_ME_NO_BEST_HALF_PIXEL;
 
-  pFunc->sMcFuncs.pfLumaHalfpelVer (pRef - kiStrideRef, kiStrideRef, pMeRefine->pHalfPixV, ME_REFINE_BUF_STRIDE, iWidth,
-                                    iHeight + 1);
+  if (!kbHalfPelPlanes)
+    pFunc->sMcFuncs.pfLumaHalfpelVer (pRef - kiStrideRef, kiStrideRef, pHalfPixV, ME_REFINE_BUF_STRIDE, iWidth,
+                                      iHeight + 1);
 
   //step 1: get [iWidth][iHeight+1] half pixel from vertical filter
   //===========================(0, -2)==============================//
-  iCurCost = pFunc->sSampleDealingFuncs.pfMeCost[pMe->uiBlockSize] (pEncData, kiStrideEnc, pMeRefine->pHalfPixV,
-             ME_REFINE_BUF_STRIDE) +
+  iCurCost = pFunc->sSampleDealingFuncs.pfMeCost[pMe->uiBlockSize] (pEncData, kiStrideEnc, pHalfPixV,
+             iStrideHalf) +
              COST_MVD (pMe->pMvdCost, iMvx - pMe->sMvp.iMvX, iMvy - 2 - pMe->sMvp.iMvY);
   if (iCurCost < iBestCost) {
     iBestCost = iCurCost;
     iBestHalfPix = REFINE_ME_HALF_PIXEL_TOP;
-    pBestPredInter = pMeRefine->pHalfPixV;
+    pBestPredInter = pHalfPixV;
+    iInterBlk4Stride = iStrideHalf;
   }
   //===========================(0, 2)==============================//
   iCurCost = pFunc->sSampleDealingFuncs.pfMeCost[pMe->uiBlockSize] (pEncData, kiStrideEnc,
-             pMeRefine->pHalfPixV + ME_REFINE_BUF_STRIDE, ME_REFINE_BUF_STRIDE) +
+             pHalfPixV + iStrideHalf, iStrideHalf) +
              COST_MVD (pMe->pMvdCost, iMvx - pMe->sMvp.iMvX, iMvy + 2 - pMe->sMvp.iMvY);
   if (iCurCost < iBestCost) {
     iBestCost = iCurCost;
     iBestHalfPix = REFINE_ME_HALF_PIXEL_BOTTOM;
-    pBestPredInter = pMeRefine->pHalfPixV + ME_REFINE_BUF_STRIDE;
+    pBestPredInter = pHalfPixV + iStrideHalf;
+    iInterBlk4Stride = iStrideHalf;
   }
-  pFunc->sMcFuncs.pfLumaHalfpelHor (pRef - 1, kiStrideRef, pMeRefine->pHalfPixH, ME_REFINE_BUF_STRIDE, iWidth + 1,
-                                    iHeight);
+  if (!kbHalfPelPlanes)
+    pFunc->sMcFuncs.pfLumaHalfpelHor (pRef - 1, kiStrideRef, pHalfPixH, ME_REFINE_BUF_STRIDE, iWidth + 1,
+                                      iHeight);
   //step 2: get [iWidth][iHeight+1] half pixel from horizon filter
 
   //===========================(-2, 0)==============================//
-  iCurCost = pFunc->sSampleDealingFuncs.pfMeCost[pMe->uiBlockSize] (pEncData, kiStrideEnc, pMeRefine->pHalfPixH,
-             ME_REFINE_BUF_STRIDE) +
+  iCurCost = pFunc->sSampleDealingFuncs.pfMeCost[pMe->uiBlockSize] (pEncData, kiStrideEnc, pHalfPixH,
+             iStrideHalf) +
              COST_MVD (pMe->pMvdCost, iMvx - 2 - pMe->sMvp.iMvX, iMvy - pMe->sMvp.iMvY);
   if (iCurCost < iBestCost) {
     iBestCost = iCurCost;
     iBestHalfPix = REFINE_ME_HALF_PIXEL_LEFT;
-    pBestPredInter = pMeRefine->pHalfPixH;
+    pBestPredInter = pHalfPixH;
+    iInterBlk4Stride = iStrideHalf;
   }
   //===========================(2, 0)===============================//
-  iCurCost = pFunc->sSampleDealingFuncs.pfMeCost[pMe->uiBlockSize] (pEncData, kiStrideEnc, pMeRefine->pHalfPixH + 1,
-             ME_REFINE_BUF_STRIDE) +
+  iCurCost = pFunc->sSampleDealingFuncs.pfMeCost[pMe->uiBlockSize] (pEncData, kiStrideEnc, pHalfPixH + 1,
+             iStrideHalf) +
              COST_MVD (pMe->pMvdCost, iMvx + 2 - pMe->sMvp.iMvX, iMvy - pMe->sMvp.iMvY);
   if (iCurCost < iBestCost) {
     iBestCost = iCurCost;
     iBestHalfPix = REFINE_ME_HALF_PIXEL_RIGHT;
-    pBestPredInter = pMeRefine->pHalfPixH + 1;
+    pBestPredInter = pHalfPixH + 1;
+    iInterBlk4Stride = iStrideHalf;
   }
 
   sParams.iBestCost = iBestCost;
   sParams.iBestHalfPix = iBestHalfPix;
   sParams.pRef = pRef;
   sParams.iBestQuarPix = ME_NO_BEST_QUAR_PIXEL;
+  sParams.iStrideHalf = iStrideHalf;
 
   //step 5: if no best half-pixel prediction, try quarter pixel prediction
   //        if yes, must get [X+1][X+1] half-pixel from (2, 2) horizontal and vertical filter
   if (REFINE_ME_NO_BEST_HALF_PIXEL == iBestHalfPix) {
     sParams.iStrideA = kiStrideRef;
     sParams.iStrideB = kiStrideRef;
-    sParams.pSrcA[0] = pMeRefine->pHalfPixV;
-    sParams.pSrcA[1] = pMeRefine->pHalfPixV + ME_REFINE_BUF_STRIDE;
-    sParams.pSrcA[2] = pMeRefine->pHalfPixH;
-    sParams.pSrcA[3] = pMeRefine->pHalfPixH + 1;
+    sParams.pSrcA[0] = pHalfPixV;
+    sParams.pSrcA[1] = pHalfPixV + iStrideHalf;
+    sParams.pSrcA[2] = pHalfPixH;
+    sParams.pSrcA[3] = pHalfPixH + 1;
 
     sParams.pSrcB[0] = sParams.pSrcB[1] = sParams.pSrcB[2] = sParams.pSrcB[3] = pRef;
 
@@ -676,66 +759,74 @@ void MeRefineFracPixel (sWelsEncCtx* pEncCtx, uint8_t* pMemPredInterMb, SWelsME*
   } else { //must get [X+1][X+1] half-pixel from (2, 2) horizontal and vertical filter
     switch (iBestHalfPix) {
     case REFINE_ME_HALF_PIXEL_LEFT: {
-      pMeRefine->pHalfPixHV = pMeRefine->pHalfPixV;//reuse pBuffer, here only h&hv
-      pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pMeRefine->pHalfPixHV, ME_REFINE_BUF_STRIDE,
-                                        iWidth + 1, iHeight + 1);
+      if (!kbHalfPelPlanes) {
+        pHalfPixHV = pHalfPixV;//reuse pBuffer, here only h&hv
+        pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pHalfPixHV, ME_REFINE_BUF_STRIDE,
+                                          iWidth + 1, iHeight + 1);
+      }
 
       iHalfMvx -= 2;
-      sParams.iStrideA = ME_REFINE_BUF_STRIDE;
+      sParams.iStrideA = iStrideHalf;
       sParams.iStrideB = kiStrideRef;
-      sParams.pSrcA[0] = pMeRefine->pHalfPixH;
+      sParams.pSrcA[0] = pHalfPixH;
       sParams.pSrcA[3] = sParams.pSrcA[2] = sParams.pSrcA[1] = sParams.pSrcA[0];
-      sParams.pSrcB[0] = pMeRefine->pHalfPixHV;
-      sParams.pSrcB[1] = pMeRefine->pHalfPixHV + ME_REFINE_BUF_STRIDE;
+      sParams.pSrcB[0] = pHalfPixHV;
+      sParams.pSrcB[1] = pHalfPixHV + iStrideHalf;
       sParams.pSrcB[2] = pRef - 1;
       sParams.pSrcB[3] = pRef;
 
     }
     break;
     case REFINE_ME_HALF_PIXEL_RIGHT: {
-      pMeRefine->pHalfPixHV = pMeRefine->pHalfPixV;//reuse pBuffer, here only h&hv
-      pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pMeRefine->pHalfPixHV, ME_REFINE_BUF_STRIDE,
-                                        iWidth + 1, iHeight + 1);
+      if (!kbHalfPelPlanes) {
+        pHalfPixHV = pHalfPixV;//reuse pBuffer, here only h&hv
+        pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pHalfPixHV, ME_REFINE_BUF_STRIDE,
+                                          iWidth + 1, iHeight + 1);
+      }
       iHalfMvx += 2;
-      sParams.iStrideA = ME_REFINE_BUF_STRIDE;
+      sParams.iStrideA = iStrideHalf;
       sParams.iStrideB = kiStrideRef;
-      sParams.pSrcA[0] = pMeRefine->pHalfPixH + 1;
+      sParams.pSrcA[0] = pHalfPixH + 1;
       sParams.pSrcA[3] = sParams.pSrcA[2] = sParams.pSrcA[1] = sParams.pSrcA[0];
-      sParams.pSrcB[0] = pMeRefine->pHalfPixHV + 1;
-      sParams.pSrcB[1] = pMeRefine->pHalfPixHV + 1 + ME_REFINE_BUF_STRIDE;
+      sParams.pSrcB[0] = pHalfPixHV + 1;
+      sParams.pSrcB[1] = pHalfPixHV + 1 + iStrideHalf;
       sParams.pSrcB[2] = pRef;
       sParams.pSrcB[3] = pRef + 1;
     }
     break;
     case REFINE_ME_HALF_PIXEL_TOP: {
-      pMeRefine->pHalfPixHV = pMeRefine->pHalfPixH;//reuse pBuffer, here only v&hv
-      pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pMeRefine->pHalfPixHV, ME_REFINE_BUF_STRIDE,
-                                        iWidth + 1, iHeight + 1);
+      if (!kbHalfPelPlanes) {
+        pHalfPixHV = pHalfPixH;//reuse pBuffer, here only v&hv
+        pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pHalfPixHV, ME_REFINE_BUF_STRIDE,
+                                          iWidth + 1, iHeight + 1);
+      }
 
       iHalfMvy -= 2;
       sParams.iStrideA = kiStrideRef;
-      sParams.iStrideB = ME_REFINE_BUF_STRIDE;
-      sParams.pSrcA[0] = pMeRefine->pHalfPixV;
+      sParams.iStrideB = iStrideHalf;
+      sParams.pSrcA[0] = pHalfPixV;
       sParams.pSrcA[3] = sParams.pSrcA[2] = sParams.pSrcA[1] = sParams.pSrcA[0];
       sParams.pSrcB[0] = pRef - kiStrideRef;
       sParams.pSrcB[1] = pRef;
-      sParams.pSrcB[2] = pMeRefine->pHalfPixHV;
-      sParams.pSrcB[3] = pMeRefine->pHalfPixHV + 1;
+      sParams.pSrcB[2] = pHalfPixHV;
+      sParams.pSrcB[3] = pHalfPixHV + 1;
     }
     break;
     case REFINE_ME_HALF_PIXEL_BOTTOM: {
-      pMeRefine->pHalfPixHV = pMeRefine->pHalfPixH;//reuse pBuffer, here only v&hv
-      pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pMeRefine->pHalfPixHV, ME_REFINE_BUF_STRIDE,
-                                        iWidth + 1, iHeight + 1);
+      if (!kbHalfPelPlanes) {
+        pHalfPixHV = pHalfPixH;//reuse pBuffer, here only v&hv
+        pFunc->sMcFuncs.pfLumaHalfpelCen (pRef - 1 - kiStrideRef, kiStrideRef, pHalfPixHV, ME_REFINE_BUF_STRIDE,
+                                          iWidth + 1, iHeight + 1);
+      }
       iHalfMvy += 2;
       sParams.iStrideA = kiStrideRef;
-      sParams.iStrideB = ME_REFINE_BUF_STRIDE;
-      sParams.pSrcA[0] = pMeRefine->pHalfPixV + ME_REFINE_BUF_STRIDE;
+      sParams.iStrideB = iStrideHalf;
+      sParams.pSrcA[0] = pHalfPixV + iStrideHalf;
       sParams.pSrcA[3] = sParams.pSrcA[2] = sParams.pSrcA[1] = sParams.pSrcA[0];
       sParams.pSrcB[0] = pRef;
       sParams.pSrcB[1] = pRef + kiStrideRef;
-      sParams.pSrcB[2] = pMeRefine->pHalfPixHV + ME_REFINE_BUF_STRIDE;
-      sParams.pSrcB[3] = pMeRefine->pHalfPixHV + ME_REFINE_BUF_STRIDE + 1;
+      sParams.pSrcB[2] = pHalfPixHV + iStrideHalf;
+      sParams.pSrcB[3] = pHalfPixHV + iStrideHalf + 1;
     }
     break;
     default:
@@ -746,10 +837,12 @@ void MeRefineFracPixel (sWelsEncCtx* pEncCtx, uint8_t* pMemPredInterMb, SWelsME*
     sParams.iLms[2] = COST_MVD (pMe->pMvdCost, iHalfMvx - 1 - pMe->sMvp.iMvX, iHalfMvy - pMe->sMvp.iMvY);
     sParams.iLms[3] = COST_MVD (pMe->pMvdCost, iHalfMvx + 1 - pMe->sMvp.iMvX, iHalfMvy - pMe->sMvp.iMvY);
   }
-  MeRefineQuarPixel (pFunc, pMe, pMeRefine, iWidth, iHeight, &sParams, kiStrideEnc);
+  if (pEncCtx->iComplexityLevel < COMPLEXITY_LEVEL_HALF_PEL)
+    MeRefineQuarPixel (pFunc, pMe, pMeRefine, iWidth, iHeight, &sParams, kiStrideEnc);
 
   if (iBestCost > sParams.iBestCost) {
     pBestPredInter = pMeRefine->pQuarPixBest;
+    iInterBlk4Stride = ME_REFINE_BUF_STRIDE;
     iBestCost = sParams.iBestCost;
   }
   iBestQuarPix = sParams.iBestQuarPix;
@@ -768,6 +861,41 @@ void MeRefineFracPixel (sWelsEncCtx* pEncCtx, uint8_t* pMemPredInterMb, SWelsME*
                                 iInterBlk4Stride);
 }
 
+/*!
+ * \brief   fill the horizontal, vertical and center half-pel planes of the luma of a reconstructed picture,
+ *          so that the sub-pel refinement of all blocks referring to it need not filter them again
+ */
+int32_t WelsHalfPelPlanesFill (CMemoryAlign* pMa, SMcFunc* pMcFuncs, SPicture* pPic) {
+  static const int16_t kiHalfPelMv[3][2] = { {2, 0}, {0, 2}, {2, 2} };
+  const int32_t kiStride = pPic->iLineSize[0];
+  const int32_t kiWidth = WELS_ALIGN (pPic->iWidthInPixel, MB_WIDTH_LUMA) + (HALFPEL_PLANE_MARGIN << 1);
+  const int32_t kiHeight = WELS_ALIGN (pPic->iHeightInPixel, MB_HEIGHT_LUMA) + (HALFPEL_PLANE_MARGIN << 1);
+  const int32_t kiPlaneSize = kiStride * kiHeight;
+  const int32_t kiTopLeft = HALFPEL_PLANE_MARGIN * (kiStride + 1);
+
+  if (NULL == pPic->pHalfPelBuffer) {
+    pPic->pHalfPelBuffer = static_cast<uint8_t*> (pMa->WelsMalloc (kiPlaneSize * 3, "pPic->pHalfPelBuffer"));
+    if (NULL == pPic->pHalfPelBuffer)
+      return ENC_RETURN_MEMALLOCERR;
+    for (int32_t i = 0; i < 3; i++)
+      pPic->pHalfPel[i] = pPic->pHalfPelBuffer + i * kiPlaneSize + kiTopLeft;
+  }
+
+  const uint8_t* pSrc = pPic->pData[0] - kiTopLeft;
+  for (int32_t i = 0; i < 3; i++) {
+    uint8_t* pDst = pPic->pHalfPel[i] - kiTopLeft;
+    for (int32_t y = 0; y < kiHeight; y += MB_HEIGHT_LUMA) {
+      const int32_t kiOffset = y * kiStride;
+      for (int32_t x = 0; x < kiWidth; x += MB_WIDTH_LUMA) {
+        pMcFuncs->pMcLumaFunc (pSrc + kiOffset + x, kiStride, pDst + kiOffset + x, kiStride,
+                               kiHalfPelMv[i][0], kiHalfPelMv[i][1], MB_WIDTH_LUMA, MB_HEIGHT_LUMA);
+      }
+    }
+  }
+  pPic->bHalfPelReady = true;
+  return ENC_RETURN_SUCCESS;
+}
+
 void InitBlkStrideWithRef (int32_t* pBlkStride, const int32_t kiStrideRef) {
   static const uint8_t kuiStrideX[16] = {
     0, 4 , 0, 4 ,
@@ -823,6 +951,48 @@ void MvdCostInit (uint16_t* pMvdCostInter, const int32_t kiMvdSz) {
   }
 }
 
+uint16_t* MvdCostTableAcquire (const int32_t kiMvdSz) {
+  WelsCommon::CWelsAutoLock cAutoLock (GetMvdCostTableLock());
+  SSharedMvdCostTable* pShared = g_pSharedMvdCostTables;
+  for (; pShared != NULL; pShared = pShared->pNext) {
+    if (pShared->iMvdSz == kiMvdSz) {
+      ++ pShared->iRefCount;
+      return pShared->pTable;
+    }
+  }
+
+  pShared = static_cast<SSharedMvdCostTable*> (WelsCommon::WelsMallocz (sizeof (SSharedMvdCostTable), "SSharedMvdCostTable"));
+  if (NULL == pShared)
+    return NULL;
+  pShared->pTable = static_cast<uint16_t*> (WelsCommon::WelsMallocz (52 * kiMvdSz * sizeof (uint16_t), "pMvdCostTable"));
+  if (NULL == pShared->pTable) {
+    WelsCommon::WelsFree (pShared, "SSharedMvdCostTable");
+    return NULL;
+  }
+  MvdCostInit (pShared->pTable, kiMvdSz);
+  pShared->iMvdSz    = kiMvdSz;
+  pShared->iRefCount = 1;
+  pShared->pNext     = g_pSharedMvdCostTables;
+  g_pSharedMvdCostTables = pShared;
+  return pShared->pTable;
+}
+
+void MvdCostTableRelease (uint16_t* pMvdCostTable) {
+  WelsCommon::CWelsAutoLock cAutoLock (GetMvdCostTableLock());
+  for (SSharedMvdCostTable** ppShared = &g_pSharedMvdCostTables; *ppShared != NULL;
+       ppShared = & (*ppShared)->pNext) {
+    SSharedMvdCostTable* pShared = *ppShared;
+    if (pShared->pTable == pMvdCostTable) {
+      if (-- pShared->iRefCount == 0) {
+        *ppShared = pShared->pNext;
+        WelsCommon::WelsFree (pShared->pTable, "pMvdCostTable");
+        WelsCommon::WelsFree (pShared, "SSharedMvdCostTable");
+      }
+      return;
+    }
+  }
+}
+
 void PredictSad (int8_t* pRefIndexCache, int32_t* pSadCostCache, int32_t uiRef, int32_t* pSadPred) {
   const int32_t kiRefB  = pRefIndexCache[1];//top g_uiCache12_8x8RefIdx[0] - 4
   int32_t iRefC         = pRefIndexCache[5];//top-right g_uiCache12_8x8RefIdx[0] - 2
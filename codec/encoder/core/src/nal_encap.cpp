@@ -107,6 +107,15 @@ void WelsUnloadNalForSlice (SWelsSliceBs* pSliceBs) {
   ++ (*pIdx);
 }
 
+/*!
+ * \brief   length of the leading span free of zero bytes
+ *          memchr() of the C library is vectorised and picks SSE2/AVX2/NEON at run time on the usual platforms
+ */
+static inline int32_t NalZeroFreeSpan (const uint8_t* kpSrc, const uint8_t* kpSrcEnd) {
+  const uint8_t* kpZero = static_cast<const uint8_t*> (memchr (kpSrc, 0, kpSrcEnd - kpSrc));
+  return (int32_t) ((NULL != kpZero ? kpZero : kpSrcEnd) - kpSrc);
+}
+
 /*!
  * \brief   encode NAL with emulation forbidden three bytes checking
  * \param   pDst        pDst NAL pData
@@ -161,6 +170,15 @@ int32_t WelsEncodeNal (SWelsNalRaw* pRawNal, void* pNalHeaderExt, const int32_t
   }
 
   while (pSrcPointer < pSrcEnd) {
+    if (iZeroCount == 0) {
+      // no 0x03 can be due until two zero bytes were seen, so the bytes up to the next zero are copied as a whole
+      const int32_t kiSpan = NalZeroFreeSpan (pSrcPointer, pSrcEnd);
+      memcpy (pDstPointer, pSrcPointer, kiSpan); // confirmed_safe_unsafe_usage
+      pDstPointer += kiSpan;
+      pSrcPointer += kiSpan;
+      if (pSrcPointer >= pSrcEnd)
+        break;
+    }
     if (iZeroCount == 2 && *pSrcPointer <= 3) {
       //add the code 03
       *pDstPointer++ = 3;
@@ -175,6 +175,11 @@ void FreePicture (CMemoryAlign* pMa, SPicture** ppPic) {
       pPic->pScreenBlockFeatureStorage = NULL;
     }
 
+    if (pPic->pHalfPelBuffer) {
+      pMa->WelsFree (pPic->pHalfPelBuffer, "pPic->pHalfPelBuffer");
+      pPic->pHalfPelBuffer = NULL;
+    }
+
     pMa->WelsFree (*ppPic, "pPic");
     *ppPic = NULL;
   }
@@ -371,10 +371,14 @@ bool WelsUpdateRefList (sWelsEncCtx* pCtx) {
 #if !defined(ENABLE_FRAME_DUMP) // to save complexity, 1/6/2009
     if ((pParamD->iHighestTemporalId == 0) || (kuiTid < pParamD->iHighestTemporalId))
 #endif// !ENABLE_FRAME_DUMP
+    {
       // Expanding picture for future reference
+      ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_PADDING);
       ExpandReferencingPicture (pCtx->pDecPic->pData, pCtx->pDecPic->iWidthInPixel, pCtx->pDecPic->iHeightInPixel,
                                 pCtx->pDecPic->iLineSize,
                                 pCtx->pFuncList->sExpandPicFunc.pfExpandLumaPicture, pCtx->pFuncList->sExpandPicFunc.pfExpandChromaPicture);
+      ProfilerSwitchStage (&pCtx->sProfiler, -1);
+    }
 
     // move picture in list
     pCtx->pDecPic->uiTemporalId = kuiTid;
@@ -776,10 +780,14 @@ bool WelsUpdateRefListScreen (sWelsEncCtx* pCtx) {
 #if !defined(ENABLE_FRAME_DUMP) // to save complexity, 1/6/2009
     if ((pParamD->iHighestTemporalId == 0) || (kuiTid < pParamD->iHighestTemporalId))
 #endif// !ENABLE_FRAME_DUMP
+    {
       // Expanding picture for future reference
+      ProfilerSwitchStage (&pCtx->sProfiler, PROFILING_STAGE_PADDING);
       ExpandReferencingPicture (pCtx->pDecPic->pData, pCtx->pDecPic->iWidthInPixel, pCtx->pDecPic->iHeightInPixel,
                                 pCtx->pDecPic->iLineSize,
                                 pCtx->pFuncList->sExpandPicFunc.pfExpandLumaPicture, pCtx->pFuncList->sExpandPicFunc.pfExpandChromaPicture);
+      ProfilerSwitchStage (&pCtx->sProfiler, -1);
+    }
 
     // move picture in list
     pCtx->pDecPic->uiTemporalId = pCtx->uiTemporalId;
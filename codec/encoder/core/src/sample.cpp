@@ -333,6 +333,329 @@ int32_t WelsSampleSadIntra16x16Combined3_c (uint8_t* pDec, int32_t iDecStride, u
 
 }
 
+/*!
+ * \brief  all-mode intra cost kernels
+ *
+ * Each kernel evaluates every available mode of a block in one call, in the order of kpAvailMode so the result is
+ * identical to looping predictor + cost per mode. For SATD the source 4x4 Hadamard coefficients are computed once;
+ * V, H and the DC family only have energy in the first row, the first column or the DC coefficient of their
+ * transform, so they are costed in the transform domain without building a predictor or a residual. The SAD kernels
+ * cost V, H and DC straight from the neighbouring samples. The best predictor is written to pDst.
+ */
+typedef struct TagHadamard4x4 {
+  int32_t iCoef[16];
+  int32_t iAbsSum;      // all coefficients
+  int32_t iAbsRow;      // first row, iCoef[0..3]
+  int32_t iAbsCol;      // first column, iCoef[0,4,8,12]
+} SHadamard4x4;
+
+static inline void WelsHadamardRow4_c (int32_t* pOut, const int32_t kiS0, const int32_t kiS1, const int32_t kiS2,
+                                       const int32_t kiS3) {
+  const int32_t kiSum02 = kiS0 + kiS2, kiSum13 = kiS1 + kiS3;
+  const int32_t kiDif02 = kiS0 - kiS2, kiDif13 = kiS1 - kiS3;
+  pOut[0] = kiSum02 + kiSum13;
+  pOut[1] = kiDif02 + kiDif13;
+  pOut[2] = kiDif02 - kiDif13;
+  pOut[3] = kiSum02 - kiSum13;
+}
+
+static inline void WelsHadamard4x4Src_c (SHadamard4x4* pHad, uint8_t* pSrc, const int32_t kiStride) {
+  int32_t iTmp[16], iCol[4];
+  int32_t i;
+  for (i = 0; i < 4; i++, pSrc += kiStride)
+    WelsHadamardRow4_c (&iTmp[i << 2], pSrc[0], pSrc[1], pSrc[2], pSrc[3]);
+  for (i = 0; i < 4; i++) {
+    WelsHadamardRow4_c (iCol, iTmp[i], iTmp[4 + i], iTmp[8 + i], iTmp[12 + i]);
+    pHad->iCoef[i]      = iCol[0];
+    pHad->iCoef[4 + i]  = iCol[1];
+    pHad->iCoef[8 + i]  = iCol[2];
+    pHad->iCoef[12 + i] = iCol[3];
+  }
+  pHad->iAbsSum = 0;
+  for (i = 0; i < 16; i++)
+    pHad->iAbsSum += WELS_ABS (pHad->iCoef[i]);
+  pHad->iAbsRow = WELS_ABS (pHad->iCoef[0]) + WELS_ABS (pHad->iCoef[1]) + WELS_ABS (pHad->iCoef[2]) + WELS_ABS (
+                    pHad->iCoef[3]);
+  pHad->iAbsCol = WELS_ABS (pHad->iCoef[0]) + WELS_ABS (pHad->iCoef[4]) + WELS_ABS (pHad->iCoef[8]) + WELS_ABS (
+                    pHad->iCoef[12]);
+}
+
+//kpEdge holds 4x the transform of the top row (V) or of the left column (H) of the block
+static inline int32_t WelsSatdHadamardRow_c (const SHadamard4x4* kpHad, const int32_t* kpEdge) {
+  return (kpHad->iAbsSum - kpHad->iAbsRow + WELS_ABS (kpHad->iCoef[0] - kpEdge[0]) + WELS_ABS (kpHad->iCoef[1] -
+          kpEdge[1]) + WELS_ABS (kpHad->iCoef[2] - kpEdge[2]) + WELS_ABS (kpHad->iCoef[3] - kpEdge[3]) + 1) >> 1;
+}
+static inline int32_t WelsSatdHadamardCol_c (const SHadamard4x4* kpHad, const int32_t* kpEdge) {
+  return (kpHad->iAbsSum - kpHad->iAbsCol + WELS_ABS (kpHad->iCoef[0] - kpEdge[0]) + WELS_ABS (kpHad->iCoef[4] -
+          kpEdge[1]) + WELS_ABS (kpHad->iCoef[8] - kpEdge[2]) + WELS_ABS (kpHad->iCoef[12] - kpEdge[3]) + 1) >> 1;
+}
+static inline int32_t WelsSatdHadamardDc_c (const SHadamard4x4* kpHad, const int32_t kiDc) {
+  return (kpHad->iAbsSum - WELS_ABS (kpHad->iCoef[0]) + WELS_ABS (kpHad->iCoef[0] - (kiDc << 4)) + 1) >> 1;
+}
+
+static inline void WelsHadamardTop4_c (int32_t* pEdge, uint8_t* pTop) {
+  WelsHadamardRow4_c (pEdge, pTop[0] << 2, pTop[1] << 2, pTop[2] << 2, pTop[3] << 2);
+}
+static inline void WelsHadamardLeft4_c (int32_t* pEdge, uint8_t* pLeft, const int32_t kiStride) {
+  WelsHadamardRow4_c (pEdge, pLeft[0] << 2, pLeft[kiStride] << 2, pLeft[kiStride << 1] << 2, pLeft[kiStride * 3] << 2);
+}
+
+//SATD of all 4x4 blocks of a (iBlkW x iBlkH) 4x4-block area against V, H or a predictor that is flat per 4x4 block
+static int32_t WelsSatdIntraFlatModes_c (const SHadamard4x4* kpHad, const int32_t kiBlkW, const int32_t kiBlkH,
+    const int32_t kiMode, uint8_t* pDec, const int32_t kiDecStride, uint8_t* pFlatPred, const int32_t kiPredStride) {
+  int32_t iEdge[4][4];
+  int32_t iCost = 0;
+  int32_t i, j;
+  if (kiMode == 0) { // V
+    for (i = 0; i < kiBlkW; i++)
+      WelsHadamardTop4_c (iEdge[i], pDec - kiDecStride + (i << 2));
+    for (j = 0; j < kiBlkH; j++)
+      for (i = 0; i < kiBlkW; i++)
+        iCost += WelsSatdHadamardRow_c (&kpHad[j * kiBlkW + i], iEdge[i]);
+  } else if (kiMode == 1) { // H
+    for (j = 0; j < kiBlkH; j++)
+      WelsHadamardLeft4_c (iEdge[j], pDec - 1 + (j << 2) * kiDecStride, kiDecStride);
+    for (j = 0; j < kiBlkH; j++)
+      for (i = 0; i < kiBlkW; i++)
+        iCost += WelsSatdHadamardCol_c (&kpHad[j * kiBlkW + i], iEdge[j]);
+  } else { // flat within each 4x4 block
+    for (j = 0; j < kiBlkH; j++)
+      for (i = 0; i < kiBlkW; i++)
+        iCost += WelsSatdHadamardDc_c (&kpHad[j * kiBlkW + i], pFlatPred[ (j << 2) * kiPredStride + (i << 2)]);
+  }
+  return iCost;
+}
+
+//SAD of a (iWidth x iHeight) area against V, H or a predictor that is flat per 4x4 block
+static int32_t WelsSadIntraFlatModes_c (uint8_t* pEnc, const int32_t kiEncStride, const int32_t kiWidth,
+                                        const int32_t kiHeight, const int32_t kiMode, uint8_t* pDec, const int32_t kiDecStride, uint8_t* pFlatPred,
+                                        const int32_t kiPredStride) {
+  int32_t iCost = 0;
+  int32_t i, j;
+  if (kiMode == 0) { // V
+    uint8_t* pTop = pDec - kiDecStride;
+    for (j = 0; j < kiHeight; j++, pEnc += kiEncStride)
+      for (i = 0; i < kiWidth; i++)
+        iCost += WELS_ABS (pEnc[i] - pTop[i]);
+  } else if (kiMode == 1) { // H
+    for (j = 0; j < kiHeight; j++, pEnc += kiEncStride) {
+      const int32_t kiLeft = pDec[j * kiDecStride - 1];
+      for (i = 0; i < kiWidth; i++)
+        iCost += WELS_ABS (pEnc[i] - kiLeft);
+    }
+  } else { // flat within each 4x4 block
+    for (j = 0; j < kiHeight; j++, pEnc += kiEncStride) {
+      const uint8_t* kpFlatRow = pFlatPred + (j & ~3) * kiPredStride;
+      for (i = 0; i < kiWidth; i++)
+        iCost += WELS_ABS (pEnc[i] - kpFlatRow[i & ~3]);
+    }
+  }
+  return iCost;
+}
+
+int32_t WelsSampleSatdIntra4x4AllModes_c (uint8_t* pDec, int32_t iDecStride, uint8_t* pEnc, int32_t iEncStride,
+    PGetIntraPredFunc* pfGetPred, PSampleSadSatdCostFunc pfCost, const uint8_t* kpAvailMode, int32_t iAvailCount,
+    const int32_t* kpModeCost, uint8_t* pDst, int32_t* pBestMode) {
+  ENFORCE_STACK_ALIGN_1D (uint8_t, uiPred, 16, 16)
+  SHadamard4x4 sHad;
+  int32_t iBestMode = kpAvailMode[0];
+  int32_t iCurCost, iBestCost = INT_MAX;
+  int32_t i;
+
+  WelsHadamard4x4Src_c (&sHad, pEnc, iEncStride);
+  for (i = 0; i < iAvailCount; i++) {
+    const int32_t kiMode = kpAvailMode[i];
+    if (kiMode == I4_PRED_V || kiMode == I4_PRED_H) {
+      iCurCost = WelsSatdIntraFlatModes_c (&sHad, 1, 1, kiMode, pDec, iDecStride, NULL, 0);
+    } else if (kiMode == I4_PRED_DC || (kiMode >= I4_PRED_DC_L && kiMode <= I4_PRED_DC_128)) {
+      pfGetPred[kiMode] (uiPred, pDec, iDecStride);
+      iCurCost = WelsSatdHadamardDc_c (&sHad, uiPred[0]);
+    } else {
+      pfGetPred[kiMode] (uiPred, pDec, iDecStride);
+      iCurCost = pfCost (uiPred, 4, pEnc, iEncStride);
+    }
+    iCurCost += kpModeCost[kiMode];
+    if (iCurCost < iBestCost) {
+      iBestMode = kiMode;
+      iBestCost = iCurCost;
+    }
+  }
+
+  pfGetPred[iBestMode] (pDst, pDec, iDecStride);
+  *pBestMode = iBestMode;
+  return iBestCost;
+}
+
+int32_t WelsSampleSatdIntra16x16AllModes_c (uint8_t* pDec, int32_t iDecStride, uint8_t* pEnc, int32_t iEncStride,
+    PGetIntraPredFunc* pfGetPred, PSampleSadSatdCostFunc pfCost, const int8_t* kpAvailMode, int32_t iAvailCount,
+    const int32_t* kpModeCost, uint8_t* pDst, int32_t* pBestMode) {
+  SHadamard4x4 sHad[16];
+  int32_t iBestMode = kpAvailMode[0];
+  int32_t iCurCost, iBestCost = INT_MAX;
+  int32_t i;
+
+  for (i = 0; i < 16; i++)
+    WelsHadamard4x4Src_c (&sHad[i], pEnc + (i >> 2) * (iEncStride << 2) + ((i & 3) << 2), iEncStride);
+  for (i = 0; i < iAvailCount; i++) {
+    const int32_t kiMode = kpAvailMode[i];
+    if (kiMode == I16_PRED_V || kiMode == I16_PRED_H) {
+      iCurCost = WelsSatdIntraFlatModes_c (sHad, 4, 4, kiMode, pDec, iDecStride, NULL, 0);
+    } else {
+      //pDst serves as scratch, the winner is predicted again at the end
+      pfGetPred[kiMode] (pDst, pDec, iDecStride);
+      if (kiMode == I16_PRED_P)
+        iCurCost = pfCost (pDst, 16, pEnc, iEncStride);
+      else
+        iCurCost = WelsSatdIntraFlatModes_c (sHad, 4, 4, kiMode, pDec, iDecStride, pDst, 16);
+    }
+    iCurCost += kpModeCost[kiMode];
+    if (iCurCost < iBestCost) {
+      iBestMode = kiMode;
+      iBestCost = iCurCost;
+    }
+  }
+
+  pfGetPred[iBestMode] (pDst, pDec, iDecStride);
+  *pBestMode = iBestMode;
+  return iBestCost;
+}
+
+int32_t WelsSampleSadIntra16x16AllModes_c (uint8_t* pDec, int32_t iDecStride, uint8_t* pEnc, int32_t iEncStride,
+    PGetIntraPredFunc* pfGetPred, PSampleSadSatdCostFunc pfCost, const int8_t* kpAvailMode, int32_t iAvailCount,
+    const int32_t* kpModeCost, uint8_t* pDst, int32_t* pBestMode) {
+  int32_t iBestMode = kpAvailMode[0];
+  int32_t iCurCost, iBestCost = INT_MAX;
+  int32_t i;
+
+  for (i = 0; i < iAvailCount; i++) {
+    const int32_t kiMode = kpAvailMode[i];
+    if (kiMode == I16_PRED_V || kiMode == I16_PRED_H) {
+      iCurCost = WelsSadIntraFlatModes_c (pEnc, iEncStride, 16, 16, kiMode, pDec, iDecStride, NULL, 0);
+    } else {
+      pfGetPred[kiMode] (pDst, pDec, iDecStride);
+      if (kiMode == I16_PRED_P)
+        iCurCost = pfCost (pDst, 16, pEnc, iEncStride);
+      else
+        iCurCost = WelsSadIntraFlatModes_c (pEnc, iEncStride, 16, 16, kiMode, pDec, iDecStride, pDst, 16);
+    }
+    iCurCost += kpModeCost[kiMode];
+    if (iCurCost < iBestCost) {
+      iBestMode = kiMode;
+      iBestCost = iCurCost;
+    }
+  }
+
+  pfGetPred[iBestMode] (pDst, pDec, iDecStride);
+  *pBestMode = iBestMode;
+  return iBestCost;
+}
+
+//chroma modes map V/H onto the 0/1 selector of the flat-mode helpers
+static inline int32_t WelsChromaFlatMode (const int32_t kiMode) {
+  return (kiMode == C_PRED_V) ? 0 : ((kiMode == C_PRED_H) ? 1 : 2);
+}
+
+int32_t WelsSampleSatdIntra8x8AllModes_c (uint8_t* pDecCb, int32_t iDecStride, uint8_t* pEncCb, int32_t iEncStride,
+    PGetIntraPredFunc* pfGetPred, PSampleSadSatdCostFunc pfCost, const int8_t* kpAvailMode, int32_t iAvailCount,
+    const int32_t* kpModeCost, uint8_t* pDstChroma, int32_t* pBestMode, uint8_t* pDecCr, uint8_t* pEncCr) {
+  SHadamard4x4 sHadCb[4], sHadCr[4];
+  int32_t iBestMode = kpAvailMode[0];
+  int32_t iCurCost, iBestCost = INT_MAX;
+  int32_t i;
+
+  for (i = 0; i < 4; i++) {
+    const int32_t kiOffset = (i >> 1) * (iEncStride << 2) + ((i & 1) << 2);
+    WelsHadamard4x4Src_c (&sHadCb[i], pEncCb + kiOffset, iEncStride);
+    WelsHadamard4x4Src_c (&sHadCr[i], pEncCr + kiOffset, iEncStride);
+  }
+  for (i = 0; i < iAvailCount; i++) {
+    const int32_t kiMode = kpAvailMode[i];
+    const int32_t kiFlatMode = WelsChromaFlatMode (kiMode);
+    if (kiFlatMode < 2) {
+      iCurCost = WelsSatdIntraFlatModes_c (sHadCb, 2, 2, kiFlatMode, pDecCb, iDecStride, NULL, 0) +
+                 WelsSatdIntraFlatModes_c (sHadCr, 2, 2, kiFlatMode, pDecCr, iDecStride, NULL, 0);
+    } else {
+      pfGetPred[kiMode] (pDstChroma, pDecCb, iDecStride);
+      pfGetPred[kiMode] (pDstChroma + 64, pDecCr, iDecStride);
+      if (kiMode == C_PRED_P)
+        iCurCost = pfCost (pDstChroma, 8, pEncCb, iEncStride) + pfCost (pDstChroma + 64, 8, pEncCr, iEncStride);
+      else
+        iCurCost = WelsSatdIntraFlatModes_c (sHadCb, 2, 2, kiFlatMode, pDecCb, iDecStride, pDstChroma, 8) +
+                   WelsSatdIntraFlatModes_c (sHadCr, 2, 2, kiFlatMode, pDecCr, iDecStride, pDstChroma + 64, 8);
+    }
+    iCurCost += kpModeCost[kiMode];
+    if (iCurCost < iBestCost) {
+      iBestMode = kiMode;
+      iBestCost = iCurCost;
+    }
+  }
+
+  pfGetPred[iBestMode] (pDstChroma, pDecCb, iDecStride);
+  pfGetPred[iBestMode] (pDstChroma + 64, pDecCr, iDecStride);
+  *pBestMode = iBestMode;
+  return iBestCost;
+}
+
+int32_t WelsSampleSadIntra8x8AllModes_c (uint8_t* pDecCb, int32_t iDecStride, uint8_t* pEncCb, int32_t iEncStride,
+    PGetIntraPredFunc* pfGetPred, PSampleSadSatdCostFunc pfCost, const int8_t* kpAvailMode, int32_t iAvailCount,
+    const int32_t* kpModeCost, uint8_t* pDstChroma, int32_t* pBestMode, uint8_t* pDecCr, uint8_t* pEncCr) {
+  int32_t iBestMode = kpAvailMode[0];
+  int32_t iCurCost, iBestCost = INT_MAX;
+  int32_t i;
+
+  for (i = 0; i < iAvailCount; i++) {
+    const int32_t kiMode = kpAvailMode[i];
+    const int32_t kiFlatMode = WelsChromaFlatMode (kiMode);
+    if (kiFlatMode < 2) {
+      iCurCost = WelsSadIntraFlatModes_c (pEncCb, iEncStride, 8, 8, kiFlatMode, pDecCb, iDecStride, NULL, 0) +
+                 WelsSadIntraFlatModes_c (pEncCr, iEncStride, 8, 8, kiFlatMode, pDecCr, iDecStride, NULL, 0);
+    } else {
+      pfGetPred[kiMode] (pDstChroma, pDecCb, iDecStride);
+      pfGetPred[kiMode] (pDstChroma + 64, pDecCr, iDecStride);
+      if (kiMode == C_PRED_P)
+        iCurCost = pfCost (pDstChroma, 8, pEncCb, iEncStride) + pfCost (pDstChroma + 64, 8, pEncCr, iEncStride);
+      else
+        iCurCost = WelsSadIntraFlatModes_c (pEncCb, iEncStride, 8, 8, kiFlatMode, pDecCb, iDecStride, pDstChroma, 8) +
+                   WelsSadIntraFlatModes_c (pEncCr, iEncStride, 8, 8, kiFlatMode, pDecCr, iDecStride, pDstChroma + 64, 8);
+    }
+    iCurCost += kpModeCost[kiMode];
+    if (iCurCost < iBestCost) {
+      iBestMode = kiMode;
+      iBestCost = iCurCost;
+    }
+  }
+
+  pfGetPred[iBestMode] (pDstChroma, pDecCb, iDecStride);
+  pfGetPred[iBestMode] (pDstChroma + 64, pDecCr, iDecStride);
+  *pBestMode = iBestMode;
+  return iBestCost;
+}
+
+/*!
+ * \brief  pStats[0]: sum of pSrc, [1]: sum of pRec, [2]: sum of pSrc^2 + pRec^2, [3]: sum of pSrc * pRec
+ *         the squared error is pStats[2] - 2 * pStats[3]
+ */
+void WelsSampleSsimStats8x8_c (uint8_t* pSrc, int32_t iSrcStride, uint8_t* pRec, int32_t iRecStride, int32_t* pStats) {
+  int32_t iSumA = 0, iSumB = 0, iSumSq = 0, iSumAB = 0;
+  int32_t i, j;
+  for (i = 0; i < 8; i++) {
+    for (j = 0; j < 8; j++) {
+      const int32_t kiA = pSrc[j];
+      const int32_t kiB = pRec[j];
+      iSumA  += kiA;
+      iSumB  += kiB;
+      iSumSq += kiA * kiA + kiB * kiB;
+      iSumAB += kiA * kiB;
+    }
+    pSrc += iSrcStride;
+    pRec += iRecStride;
+  }
+  pStats[0] = iSumA;
+  pStats[1] = iSumB;
+  pStats[2] = iSumSq;
+  pStats[3] = iSumAB;
+}
+
 void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
   //pfSampleSad init
   pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_16x16] = WelsSampleSad16x16_c;
@@ -360,12 +683,35 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
   pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x4] = WelsSampleSadFour8x4_c;
   pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_4x8] = WelsSampleSadFour4x8_c;
 
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x4] = WelsSampleSadMulti8x4_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x8] = WelsSampleSadMulti4x8_c;
+
+  pFuncList->sSampleDealingFuncs.pfSampleSad8x8Row = WelsSampleSad8x8Row_c;
+
+  for (int32_t i = 0; i < MAX_BLOCK_TYPE; i++)
+    pFuncList->sSampleDealingFuncs.pfSampleSatdQuarFour[i] = NULL;
+
   pFuncList->sSampleDealingFuncs.pfIntra4x4Combined3Satd   = NULL;
   pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Satd   = NULL;
   pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Sad    = NULL;
   pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Satd = NULL;
   pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Sad  = NULL;
 
+  // the flat modes share one transform of the source, which only pays off against the C costs:
+  // dropped below wherever pfSampleSad and pfSampleSatd get SIMD kernels
+  pFuncList->sSampleDealingFuncs.pfIntra4x4AllModesSatd    = WelsSampleSatdIntra4x4AllModes_c;
+  pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSatd    = WelsSampleSatdIntra8x8AllModes_c;
+  pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSad     = WelsSampleSadIntra8x8AllModes_c;
+  pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSatd  = WelsSampleSatdIntra16x16AllModes_c;
+  pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSad   = WelsSampleSadIntra16x16AllModes_c;
+
+  pFuncList->sSampleDealingFuncs.pfSampleSsimStats8x8      = WelsSampleSsimStats8x8_c;
+
 #if defined (X86_ASM)
   if (uiCpuFlag & WELS_CPU_MMXEXT) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_4x4  ] = WelsSampleSad4x4_mmx;
@@ -383,12 +729,28 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x8] = WelsSampleSadFour8x8_sse2;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_4x4] = WelsSampleSadFour4x4_sse2;
 
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_sse2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_sse2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_sse2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_sse2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_sse2;
+
+    pFuncList->sSampleDealingFuncs.pfSampleSad8x8Row = WelsSampleSad8x8Row_sse2;
+
+    pFuncList->sSampleDealingFuncs.pfIntra4x4AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSad     = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSatd  = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSad   = NULL;
+
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_4x4  ] = WelsSampleSatd4x4_sse2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8  ] = WelsSampleSatd8x8_sse2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16 ] = WelsSampleSatd8x16_sse2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_16x8 ] = WelsSampleSatd16x8_sse2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_16x16] = WelsSampleSatd16x16_sse2;
     pFuncList->sSampleDealingFuncs.pfIntra4x4Combined3Satd = WelsSampleSatdThree4x4_sse2;
+
+    pFuncList->sSampleDealingFuncs.pfSampleSsimStats8x8 = WelsSampleSsimStats8x8_sse2;
   }
 
   if (uiCpuFlag & WELS_CPU_SSSE3) {
@@ -401,6 +763,10 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16] = WelsSampleSatd8x16_sse41;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8] = WelsSampleSatd8x8_sse41;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_4x4] = WelsSampleSatd4x4_sse41;
+    pFuncList->sSampleDealingFuncs.pfSampleSatdQuarFour[BLOCK_16x16] = WelsSampleSatdQuarFour16x16_sse41;
+    pFuncList->sSampleDealingFuncs.pfSampleSatdQuarFour[BLOCK_16x8] = WelsSampleSatdQuarFour16x8_sse41;
+    pFuncList->sSampleDealingFuncs.pfSampleSatdQuarFour[BLOCK_8x16] = WelsSampleSatdQuarFour8x16_sse41;
+    pFuncList->sSampleDealingFuncs.pfSampleSatdQuarFour[BLOCK_8x8] = WelsSampleSatdQuarFour8x8_sse41;
     pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Satd = WelsIntra16x16Combined3Satd_sse41;
     pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Satd = WelsIntraChroma8x8Combined3Satd_sse41;
   }
@@ -410,6 +776,9 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_16x8]  = WelsSampleSatd16x8_avx2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16]  = WelsSampleSatd8x16_avx2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8]   = WelsSampleSatd8x8_avx2;
+
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_avx2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8]  = WelsSampleSadMulti16x8_avx2;
   }
 #endif
 #endif //(X86_ASM)
@@ -428,6 +797,13 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x8] = WelsSampleSadFour8x8_neon;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_4x4] = WelsSampleSadFour4x4_neon;
 
+    // no batched kernel, the candidates go one by one through pfSampleSad
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = NULL;
+
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_4x4  ] = WelsSampleSatd4x4_neon;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8  ] = WelsSampleSatd8x8_neon;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16 ] = WelsSampleSatd8x16_neon;
@@ -439,6 +815,14 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Sad    = WelsIntra8x8Combined3Sad_neon;
     pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Satd = WelsIntra16x16Combined3Satd_neon;
     pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Sad  = WelsIntra16x16Combined3Sad_neon;
+
+    pFuncList->sSampleDealingFuncs.pfSampleSsimStats8x8      = WelsSampleSsimStats8x8_neon;
+
+    pFuncList->sSampleDealingFuncs.pfIntra4x4AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSad     = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSatd  = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSad   = NULL;
   }
 #endif
 
@@ -456,6 +840,13 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x8] = WelsSampleSadFour8x8_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_4x4] = WelsSampleSadFour4x4_AArch64_neon;
 
+    // no batched kernel, the candidates go one by one through pfSampleSad
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = NULL;
+
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_4x4  ] = WelsSampleSatd4x4_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8  ] = WelsSampleSatd8x8_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16 ] = WelsSampleSatd8x16_AArch64_neon;
@@ -467,6 +858,14 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Sad    = WelsIntra8x8Combined3Sad_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Satd = WelsIntra16x16Combined3Satd_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfIntra16x16Combined3Sad  = WelsIntra16x16Combined3Sad_AArch64_neon;
+
+    pFuncList->sSampleDealingFuncs.pfSampleSsimStats8x8      = WelsSampleSsimStats8x8_AArch64_neon;
+
+    pFuncList->sSampleDealingFuncs.pfIntra4x4AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSad     = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSatd  = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSad   = NULL;
   }
 #endif
 
@@ -478,6 +877,13 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x8] = WelsSampleSad8x8_mmi;
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_4x4  ] = WelsSampleSad4x4_mmi;
 
+    // no batched kernel, the candidates go one by one through pfSampleSad
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = NULL;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = NULL;
+
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_4x4  ] = WelsSampleSatd4x4_mmi;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8  ] = WelsSampleSatd8x8_mmi;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16 ] = WelsSampleSatd8x16_mmi;
@@ -488,6 +894,12 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x8] = WelsSampleSadFour16x8_mmi;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x16] = WelsSampleSadFour8x16_mmi;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x8] = WelsSampleSadFour8x8_mmi;
+
+    pFuncList->sSampleDealingFuncs.pfIntra4x4AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSatd    = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra8x8AllModesSad     = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSatd  = NULL;
+    pFuncList->sSampleDealingFuncs.pfIntra16x16AllModesSad   = NULL;
   }
 #endif//HAVE_MMI
 }
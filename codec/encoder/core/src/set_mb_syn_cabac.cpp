@@ -51,23 +51,35 @@ const int8_t g_kiClz5Table[32] = {
   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
 };
 
-void PropagateCarry (uint8_t* pBufCur, uint8_t* pBufStart) {
-  for (; pBufCur > pBufStart; --pBufCur)
-    if (++ * (pBufCur - 1))
-      break;
+/*
+ *  pass one byte with the carry out of it in bit 8 to the output: a carry adds to the buffered byte and turns
+ *  the buffered 0xff bytes into 0x00, then these are final; 0xff bytes stay buffered as a carry may pass them
+ */
+inline uint8_t* CabacPutByte (WelsEnc::SCabacCtx* pCbCtx, uint8_t* pBufCur, uint32_t uiLeadByte) {
+  if (uiLeadByte == 0xff) {
+    ++ pCbCtx->m_iBufferedByteNum;
+  } else if (pCbCtx->m_iBufferedByteNum > 0) {
+    const uint32_t kuiCarry = uiLeadByte >> 8;
+    *pBufCur++ = pCbCtx->m_uiBufferedByte + kuiCarry;
+    for (; pCbCtx->m_iBufferedByteNum > 1; -- pCbCtx->m_iBufferedByteNum)
+      *pBufCur++ = (uint8_t) (0xff + kuiCarry);
+    pCbCtx->m_uiBufferedByte = (uint8_t) uiLeadByte;
+  } else {
+    pCbCtx->m_uiBufferedByte = (uint8_t) uiLeadByte;
+    pCbCtx->m_iBufferedByteNum = 1;
+  }
+  return pBufCur;
 }
 
-} // anon ns.
+// the initial states depend on the model and the QP only, so one table serves all the encoders
+WelsEnc::SStateCtx g_sWelsCabacContexts[4][WELS_QP_MAX + 1][WELS_CONTEXT_COUNT];
 
-namespace WelsEnc {
-
-void WelsCabacInit (void* pCtx) {
-  sWelsEncCtx* pEncCtx = (sWelsEncCtx*)pCtx;
+bool InitCabacContexts() {
   for (int32_t iModel = 0; iModel < 4; iModel++) {
     for (int32_t iQp = 0; iQp <= WELS_QP_MAX; iQp++)
       for (int32_t iIdx = 0; iIdx < WELS_CONTEXT_COUNT; iIdx++) {
-        int32_t m               = g_kiCabacGlobalContextIdx[iIdx][iModel][0];
-        int32_t n               = g_kiCabacGlobalContextIdx[iIdx][iModel][1];
+        int32_t m               = WelsCommon::g_kiCabacGlobalContextIdx[iIdx][iModel][0];
+        int32_t n               = WelsCommon::g_kiCabacGlobalContextIdx[iIdx][iModel][1];
         int32_t iPreCtxState    = WELS_CLIP3 ((((m * iQp) >> 4) + n), 1, 126);
         uint8_t uiValMps         = 0;
         uint8_t uiStateIdx       = 0;
@@ -78,16 +90,31 @@ void WelsCabacInit (void* pCtx) {
           uiStateIdx = iPreCtxState - 64;
           uiValMps = 1;
         }
-        pEncCtx->sWelsCabacContexts[iModel][iQp][iIdx].Set (uiStateIdx, uiValMps);
+        g_sWelsCabacContexts[iModel][iQp][iIdx].Set (uiStateIdx, uiValMps);
       }
   }
+  return true;
+}
+
+} // anon ns.
+
+namespace WelsEnc {
+
+void WelsCabacInit() {
+  // filled once, by the first encoder taking CABAC
+  static const bool kbCabacContextsInit = InitCabacContexts();
+  (void)kbCabacContextsInit;
+}
+
+uint32_t WelsCabacContextTableSize() {
+  return sizeof (g_sWelsCabacContexts);
 }
 
 void WelsCabacContextInit (void* pCtx, SCabacCtx* pCbCtx, int32_t iModel) {
   sWelsEncCtx* pEncCtx = (sWelsEncCtx*)pCtx;
   int32_t iIdx =  pEncCtx->eSliceType == WelsCommon::I_SLICE ? 0 : iModel + 1;
   int32_t iQp = pEncCtx->iGlobalQp;
-  memcpy (pCbCtx->m_sStateCtx, pEncCtx->sWelsCabacContexts[iIdx][iQp],
+  memcpy (pCbCtx->m_sStateCtx, g_sWelsCabacContexts[iIdx][iQp],
           WELS_CONTEXT_COUNT * sizeof (SStateCtx));
 }
 
@@ -99,6 +126,8 @@ void  WelsCabacEncodeInit (SCabacCtx* pCbCtx, uint8_t* pBuf,  uint8_t* pEnd) {
   pCbCtx->m_pBufStart = pBuf;
   pCbCtx->m_pBufEnd = pEnd;
   pCbCtx->m_pBufCur = pBuf;
+  pCbCtx->m_uiBufferedByte = 0;
+  pCbCtx->m_iBufferedByteNum = 0;
 }
 
 void WelsCabacEncodeUpdateLowNontrivial_ (SCabacCtx* pCbCtx) {
@@ -111,15 +140,25 @@ void WelsCabacEncodeUpdateLowNontrivial_ (SCabacCtx* pCbCtx) {
     const int32_t kiInc = CABAC_LOW_WIDTH - 1 - iLowBitCnt;
 
     uiLow <<= kiInc;
-    if (uiLow & cabac_low_t (1) << (CABAC_LOW_WIDTH - 1))
-      PropagateCarry (pBufCur, pCbCtx->m_pBufStart);
+    const uint32_t kuiCarry = (uint32_t) (uiLow >> (CABAC_LOW_WIDTH - 1));
 
-    if (CABAC_LOW_WIDTH > 32) {
-      WRITE_BE_32 (pBufCur, (uint32_t) (uiLow >> 31));
-      pBufCur += 4;
+    if ((uint8_t) (uiLow >> 15) != 0xff && pCbCtx->m_iBufferedByteNum > 0) {
+      // the last byte stops any later carry, so the bytes before it are final and it is buffered alone
+      *pBufCur++ = pCbCtx->m_uiBufferedByte + kuiCarry;
+      for (; pCbCtx->m_iBufferedByteNum > 1; -- pCbCtx->m_iBufferedByteNum)
+        *pBufCur++ = (uint8_t) (0xff + kuiCarry);
+      if (CABAC_LOW_WIDTH > 32) {
+        WRITE_BE_32 (pBufCur, (uint32_t) (uiLow >> 31));
+        pBufCur += 4;
+      }
+      *pBufCur++ = (uint8_t) (uiLow >> 23);
+      pCbCtx->m_uiBufferedByte = (uint8_t) (uiLow >> 15);
+    } else {
+      int32_t iShift = CABAC_LOW_WIDTH - 9;
+      pBufCur = CabacPutByte (pCbCtx, pBufCur, (uint32_t) (uiLow >> iShift) & 0x1ff);
+      for (iShift -= 8; iShift >= 15; iShift -= 8)
+        pBufCur = CabacPutByte (pCbCtx, pBufCur, (uint8_t) (uiLow >> iShift));
     }
-    *pBufCur++ = (uint8_t) (uiLow >> 23);
-    *pBufCur++ = (uint8_t) (uiLow >> 15);
     iRenormCnt -= kiInc;
     iLowBitCnt = 15;
     uiLow &= (1u << iLowBitCnt) - 1;
@@ -164,22 +203,50 @@ void WelsCabacEncodeTerminate (SCabacCtx* pCbCtx, uint32_t uiBin) {
     pCbCtx->m_iRenormCnt += kiRenormAmount;
   }
 }
+static inline void CabacEncodeBypassBinsLong (SCabacCtx* pCbCtx, int32_t iBinNum, uint32_t uiBins) {
+  for (; iBinNum > 16; iBinNum -= 16)
+    WelsCabacEncodeBypassBins (pCbCtx, 16, (uiBins >> (iBinNum - 16)) & 0xffff);
+  WelsCabacEncodeBypassBins (pCbCtx, iBinNum, uiBins & ((1u << iBinNum) - 1));
+}
+
+// k-th order Exp-Golomb bins: a unary prefix of ones closed by a zero, then k suffix bins, then iTailNum more
+// bypass bins, batched into as few register updates as the 32-bit bin word allows
+static inline void CabacEncodeUeBypassTail (SCabacCtx* pCbCtx, int32_t iExpBits, uint32_t uiVal, int32_t iTailNum,
+    uint32_t uiTail) {
+  uint32_t uiSufS = uiVal;
+  int32_t k = iExpBits;
+  while (uiSufS >= (1u << k)) {
+    uiSufS -= 1u << k;
+    k++;
+  }
+  const int32_t kiPrefixOnes = k - iExpBits;
+  const int32_t kiSuffixNum = k + iTailNum;
+  if (kiPrefixOnes + 1 + kiSuffixNum <= 32) {
+    const uint32_t kuiPrefix = ((1u << kiPrefixOnes) - 1) << 1;
+    CabacEncodeBypassBinsLong (pCbCtx, kiPrefixOnes + 1 + kiSuffixNum,
+                               (kuiPrefix << kiSuffixNum) | (uiSufS << iTailNum) | uiTail);
+    return;
+  }
+  CabacEncodeBypassBinsLong (pCbCtx, kiPrefixOnes + 1, ((1u << kiPrefixOnes) - 1) << 1);
+  CabacEncodeBypassBinsLong (pCbCtx, kiSuffixNum, (uiSufS << iTailNum) | uiTail);
+}
+
 void WelsCabacEncodeUeBypass (SCabacCtx* pCbCtx, int32_t iExpBits, uint32_t uiVal) {
-  int32_t iSufS = uiVal;
-  int32_t iStopLoop = 0;
+  CabacEncodeUeBypassTail (pCbCtx, iExpBits, uiVal, 0, 0);
+}
+
+// the sign of an escaped level or mvd is the bypass bin right after its suffix, so it goes in the same batch
+void WelsCabacEncodeUeBypassSign (SCabacCtx* pCbCtx, int32_t iExpBits, uint32_t uiVal, uint32_t uiSign) {
+  CabacEncodeUeBypassTail (pCbCtx, iExpBits, uiVal, 1, uiSign);
+}
+
+uint32_t WelsCabacEstimateUeBypass (int32_t iExpBits, uint32_t uiVal) {
   int32_t k = iExpBits;
-  do {
-    if (iSufS >= (1 << k)) {
-      WelsCabacEncodeBypassOne (pCbCtx, 1);
-      iSufS = iSufS - (1 << k);
-      k++;
-    } else {
-      WelsCabacEncodeBypassOne (pCbCtx, 0);
-      while (k--)
-        WelsCabacEncodeBypassOne (pCbCtx, (iSufS >> k) & 1);
-      iStopLoop = 1;
-    }
-  } while (!iStopLoop);
+  while (uiVal >= (1u << k)) {
+    uiVal -= 1u << k;
+    k++;
+  }
+  return WelsCabacEstimateBypass ((k - iExpBits) + 1 + k);
 }
 
 void WelsCabacEncodeFlush (SCabacCtx* pCbCtx) {
@@ -190,10 +257,18 @@ void WelsCabacEncodeFlush (SCabacCtx* pCbCtx) {
   uint8_t* pBufCur = pCbCtx->m_pBufCur;
 
   uiLow <<= CABAC_LOW_WIDTH - 1 - iLowBitCnt;
-  if (uiLow & cabac_low_t (1) << (CABAC_LOW_WIDTH - 1))
-    PropagateCarry (pBufCur, pCbCtx->m_pBufStart);
-  for (; (iLowBitCnt -= 8) >= 0; uiLow <<= 8)
-    * pBufCur++ = (uint8_t) (uiLow >> (CABAC_LOW_WIDTH - 9));
+  uint32_t uiCarry = (uint32_t) (uiLow >> (CABAC_LOW_WIDTH - 1));
+  for (; (iLowBitCnt -= 8) >= 0; uiLow <<= 8) {
+    pBufCur = CabacPutByte (pCbCtx, pBufCur, (uiCarry << 8) | (uint8_t) (uiLow >> (CABAC_LOW_WIDTH - 9)));
+    uiCarry = 0;
+  }
+  // nothing follows, the buffered bytes are final now
+  if (pCbCtx->m_iBufferedByteNum > 0) {
+    *pBufCur++ = pCbCtx->m_uiBufferedByte + uiCarry;
+    for (; pCbCtx->m_iBufferedByteNum > 1; -- pCbCtx->m_iBufferedByteNum)
+      *pBufCur++ = (uint8_t) (0xff + uiCarry);
+    pCbCtx->m_iBufferedByteNum = 0;
+  }
 
   pCbCtx->m_pBufCur = pBufCur;
 }
@@ -54,30 +54,37 @@ const  ALIGNED_DECLARE (uint8_t, g_kuiZeroLeftMap[16], 16) = {
  *  Exponential Golomb codes encoding routines
  */
 
+/*
+ *  The code words of a block are gathered left aligned in a 64-bit register, which is stored once at the end of the
+ *  block, or before a code word that would take more than 56 bits pending, so the byte shift of a store stays
+ *  below 64. A store writes all 8 bytes and moves on by the whole bytes only. The bit string keeps the usual 32-bit
+ *  state and is updated once per block. A code word is at most 28 bits, fewer than 32 bits are pending on entry,
+ *  and MAX_MACROBLOCK_SIZE_IN_BYTE_x2 bytes are left ahead of every MB.
+ */
 #define    CAVLC_BS_INIT( pBs )  \
   uint8_t  * pBufPtr = pBs->pCurBuf; \
-  uint32_t   uiCurBits = pBs->uiCurBits; \
-  int32_t    iLeftBits = pBs->iLeftBits;
+  int32_t    iUsedBits = 32 - pBs->iLeftBits; \
+  uint64_t   uiCurBits = ((uint64_t)pBs->uiCurBits << 32) << (32 - iUsedBits);
+
+#define    CAVLC_BS_FLUSH \
+  WRITE_BE_64(pBufPtr, uiCurBits);\
+  pBufPtr += iUsedBits >> 3;\
+  uiCurBits <<= iUsedBits & ~7;\
+  iUsedBits &= 7;
 
 #define    CAVLC_BS_UNINIT( pBs ) \
+  CAVLC_BS_FLUSH \
   pBs->pCurBuf = pBufPtr;  \
-  pBs->uiCurBits = uiCurBits;  \
-  pBs->iLeftBits = iLeftBits;
+  pBs->uiCurBits = (uint32_t) ((uiCurBits >> 32) >> (32 - iUsedBits));  \
+  pBs->iLeftBits = 32 - iUsedBits;
 
 #define    CAVLC_BS_WRITE( n,  v ) \
   {  \
-  if ( (n) < iLeftBits ) {\
-  uiCurBits = (uiCurBits<<(n))|(v);\
-  iLeftBits -= (n);\
-  }\
-  else {\
-  (n) -= iLeftBits;\
-  uiCurBits = (uiCurBits<<iLeftBits) | ((v)>>(n));\
-  WRITE_BE_32(pBufPtr, uiCurBits);\
-  pBufPtr += 4;\
-  uiCurBits = (v) & ((1<<(n))-1);\
-  iLeftBits = 32 - (n);\
+  if (iUsedBits + (n) > 56) {\
+  CAVLC_BS_FLUSH\
   }\
+  iUsedBits += (n);\
+  uiCurBits |= (uint64_t) (v) << (64 - iUsedBits);\
   } ;
 
 
@@ -247,25 +254,16 @@ int32_t StashPopMBStatusCavlc (SDynamicSlicingStack* pDss, SSlice* pSlice) {
   pSlice->uiLastMbQp    = pDss->uiLastMbQp;
   return pDss->iMbSkipRunStack;
 }
+// the bytes before m_pBufCur are final (see SCabacCtx), the context alone brings the slice back
 void StashMBStatusCabac (SDynamicSlicingStack* pDss, SSlice* pSlice, int32_t iMbSkipRun) {
   SCabacCtx* pCtx = &pSlice->sCabacCtx;
   memcpy (&pDss->sStoredCabac, pCtx, sizeof (SCabacCtx));
-  if (pDss->pRestoreBuffer) {
-    int32_t iPosBitOffset =  GetBsPosCabac (pSlice) - pDss->iStartPos;
-    int32_t iLen = ((iPosBitOffset >> 3) + ((iPosBitOffset & 0x07) ? 1 : 0));
-    memcpy (pDss->pRestoreBuffer, pCtx->m_pBufStart, iLen);
-  }
   pDss->uiLastMbQp =  pSlice->uiLastMbQp;
   pDss->iMbSkipRunStack = iMbSkipRun;
 }
 int32_t StashPopMBStatusCabac (SDynamicSlicingStack* pDss, SSlice* pSlice) {
   SCabacCtx* pCtx = &pSlice->sCabacCtx;
   memcpy (pCtx, &pDss->sStoredCabac, sizeof (SCabacCtx));
-  if (pDss->pRestoreBuffer) {
-    int32_t iPosBitOffset = GetBsPosCabac (pSlice) - pDss->iStartPos;
-    int32_t iLen = ((iPosBitOffset >> 3) + ((iPosBitOffset & 0x07) ? 1 : 0));
-    memcpy (pCtx->m_pBufStart, pDss->pRestoreBuffer, iLen);
-  }
   pSlice->uiLastMbQp = pDss->uiLastMbQp;
   return pDss->iMbSkipRunStack;
 }
@@ -273,8 +271,8 @@ int32_t GetBsPosCavlc (SSlice* pSlice) {
   return BsGetBitsPos (pSlice->pSliceBsa);
 }
 int32_t GetBsPosCabac (SSlice* pSlice) {
-  return (int32_t) ((pSlice->sCabacCtx.m_pBufCur - pSlice->sCabacCtx.m_pBufStart) << 3) +
-         (pSlice->sCabacCtx.m_iLowBitCnt - 9);
+  return (int32_t) ((pSlice->sCabacCtx.m_pBufCur - pSlice->sCabacCtx.m_pBufStart
+                     + pSlice->sCabacCtx.m_iBufferedByteNum) << 3) + (pSlice->sCabacCtx.m_iLowBitCnt - 9);
 }
 void WelsWriteSliceEndSyn (SSlice* pSlice, bool bEntropyCodingModeFlag) {
   SBitStringAux* pBs = pSlice->pSliceBsa;
@@ -351,9 +351,21 @@ int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPara
   iReturn = WelsMutexInit (&pSmt->mutexThreadSlcBuffReallocate);
   WELS_VERIFY_RETURN_PROC_IF (1, (WELS_THREAD_ERROR_OK != iReturn), FreeMemorySvc (ppCtx))
 
+  iReturn = WelsMutexInit (&pSmt->mutexSliceOutput);
+  WELS_VERIFY_RETURN_PROC_IF (1, (WELS_THREAD_ERROR_OK != iReturn), FreeMemorySvc (ppCtx))
+
   iReturn = WelsMutexInit (& (*ppCtx)->mutexEncoderError);
   WELS_VERIFY_RETURN_IF (1, (WELS_THREAD_ERROR_OK != iReturn))
 
+  iReturn = WelsMutexInit (&pSmt->mutexDeblocking);
+  WELS_VERIFY_RETURN_IF (1, (WELS_THREAD_ERROR_OK != iReturn))
+  // overlapped deblocking counters, sized for the tallest layer
+  int32_t iMaxMbHeight = 0;
+  for (iIdx = 0; iIdx < iNumSpatialLayers; iIdx++)
+    iMaxMbHeight = WELS_MAX (iMaxMbHeight, (pPara->sSpatialLayers[iIdx].iVideoHeight + 15) >> 4);
+  pSmt->pDbkRowMbCount = (int32_t*)pMa->WelsMallocz (iMaxMbHeight * sizeof (int32_t), "pSmt->pDbkRowMbCount");
+  WELS_VERIFY_RETURN_IF (1, (NULL == pSmt->pDbkRowMbCount))
+
   MT_TRACE_LOG (pLogCtx, WELS_LOG_INFO, "RequestMtResource(), iThreadNum=%d, iMultipleThreadIdc= %d",
                 pPara->iMultipleThreadIdc,
                 (*ppCtx)->iMaxSliceCount);
@@ -396,8 +408,14 @@ void ReleaseMtResource (sWelsEncCtx** ppCtx) {
   WelsMutexDestroy (&pSmt->mutexSliceNumUpdate);
   WelsMutexDestroy (&pSmt->mutexThreadBsBufferUsage);
   WelsMutexDestroy (&pSmt->mutexThreadSlcBuffReallocate);
+  WelsMutexDestroy (&pSmt->mutexSliceOutput);
   WelsMutexDestroy (& ((*ppCtx)->mutexEncoderError));
   WelsMutexDestroy (&pSmt->mutexEvent);
+  WelsMutexDestroy (&pSmt->mutexDeblocking);
+  if (pSmt->pDbkRowMbCount != NULL) {
+    pMa->WelsFree (pSmt->pDbkRowMbCount, "pSmt->pDbkRowMbCount");
+    pSmt->pDbkRowMbCount = NULL;
+  }
   if (pSmt->pThreadPEncCtx != NULL) {
     pMa->WelsFree (pSmt->pThreadPEncCtx, "pThreadPEncCtx");
     pSmt->pThreadPEncCtx = NULL;
@@ -426,6 +444,85 @@ void ReleaseMtResource (sWelsEncCtx** ppCtx) {
   (*ppCtx)->pSliceThreading = NULL;
 }
 
+void InitSliceOutput (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const int32_t kiLayerNum,
+                      const EVideoFrameType keFrameType) {
+  const SSliceOutputCallbackParam* kpSliceOutput = &pCtx->pSvcParam->sSliceOutput;
+  SSliceOutputInfo sInfo;
+
+  pCtx->iSliceOutputNext        = 0;
+  pCtx->eSliceOutputFrameType   = keFrameType;
+  pCtx->uiSliceOutputTimeStamp  = pFbi->uiTimeStamp;
+  if (NULL == kpSliceOutput->pCallback)
+    return;
+
+  // parameter sets written since the previous layer go first, so that an IDR can be decoded from its first slice
+  memset (&sInfo, 0, sizeof (sInfo));
+  sInfo.iSliceIdx   = -1;
+  sInfo.eFrameType  = keFrameType;
+  sInfo.uiTimeStamp = pFbi->uiTimeStamp;
+  for (int32_t iLayerIdx = pCtx->iSliceOutputLayerNum; iLayerIdx < kiLayerNum; iLayerIdx++) {
+    const SLayerBSInfo* kpLbi = &pFbi->sLayerInfo[iLayerIdx];
+    if (kpLbi->uiLayerType != NON_VIDEO_CODING_LAYER || kpLbi->iNalCount <= 0)
+      continue;
+    sInfo.iSpatialId        = kpLbi->uiSpatialId;
+    sInfo.iTemporalId       = kpLbi->uiTemporalId;
+    sInfo.iNalCount         = kpLbi->iNalCount;
+    sInfo.pNalLengthInByte  = kpLbi->pNalLengthInByte;
+    sInfo.pBsBuf            = kpLbi->pBsBuf;
+    kpSliceOutput->pCallback (kpSliceOutput->pContext, &sInfo);
+  }
+  pCtx->iSliceOutputLayerNum = kiLayerNum;
+
+  // the slices of an earlier frame which failed are not waiting any more
+  if (pCtx->pSvcParam->iMultipleThreadIdc > 1) {
+    const int32_t kiSliceCount = GetCurrentSliceNum (pCtx->pCurDqLayer);
+    for (int32_t iSliceIdx = 0; iSliceIdx < kiSliceCount; iSliceIdx++) {
+      if (NULL != pCtx->pCurDqLayer->ppSliceInLayer[iSliceIdx])
+        pCtx->pCurDqLayer->ppSliceInLayer[iSliceIdx]->sSliceBs.bOutputPending = false;
+    }
+  }
+}
+
+void OutputSlice (sWelsEncCtx* pCtx, const int32_t kiSliceIdx, const uint8_t* kpBs, const int32_t* kpNalLen,
+                  const int32_t kiNalCount) {
+  const SSliceOutputCallbackParam* kpSliceOutput = &pCtx->pSvcParam->sSliceOutput;
+  SSliceOutputInfo sInfo;
+
+  if (NULL == kpSliceOutput->pCallback || kiNalCount <= 0)
+    return;
+
+  sInfo.iSpatialId        = pCtx->uiDependencyId;
+  sInfo.iTemporalId       = pCtx->uiTemporalId;
+  sInfo.iSliceIdx         = kiSliceIdx;
+  sInfo.eFrameType        = pCtx->eSliceOutputFrameType;
+  sInfo.uiTimeStamp       = pCtx->uiSliceOutputTimeStamp;
+  sInfo.iNalCount         = kiNalCount;
+  sInfo.pNalLengthInByte  = kpNalLen;
+  sInfo.pBsBuf            = kpBs;
+  kpSliceOutput->pCallback (kpSliceOutput->pContext, &sInfo);
+}
+
+/*!
+ * \brief   a slice written by a slice task is given once all the slices before it have been,
+ *          by whichever task completes the run
+ */
+static void OutputSlicesInOrder (sWelsEncCtx* pCtx, SWelsSliceBs* pSliceBs) {
+  SSlice** ppSliceInLayer   = pCtx->pCurDqLayer->ppSliceInLayer;
+  const int32_t kiSliceCount = GetCurrentSliceNum (pCtx->pCurDqLayer);
+
+  WelsMutexLock (&pCtx->pSliceThreading->mutexSliceOutput);
+  pSliceBs->bOutputPending = true;
+  while (pCtx->iSliceOutputNext < kiSliceCount) {
+    SWelsSliceBs* pNextBs = &ppSliceInLayer[pCtx->iSliceOutputNext]->sSliceBs;
+    if (!pNextBs->bOutputPending)
+      break;
+    pNextBs->bOutputPending = false;
+    OutputSlice (pCtx, pCtx->iSliceOutputNext, pNextBs->pBs, pNextBs->iNalLen, pNextBs->iNalIndex);
+    ++ pCtx->iSliceOutputNext;
+  }
+  WelsMutexUnlock (&pCtx->pSliceThreading->mutexSliceOutput);
+}
+
 int32_t AppendSliceToFrameBs (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32_t iSliceCount) {
   SSlice** ppSliceInlayer = pCtx->pCurDqLayer->ppSliceInLayer;
   SWelsSliceBs* pSliceBs  = NULL;
@@ -445,6 +542,11 @@ int32_t AppendSliceToFrameBs (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32
 #endif//MT_DEBUG_BS_WR
 
       memmove (pCtx->pFrameBs + pCtx->iPosBsBuffer, pSliceBs->pBs, pSliceBs->uiBsPos); // confirmed_safe_unsafe_usage
+      // slices not given while being written (size limited slicing) are given from the frame bitstream
+      if (iSliceIdx >= pCtx->iSliceOutputNext) {
+        OutputSlice (pCtx, iSliceIdx, pCtx->pFrameBs + pCtx->iPosBsBuffer, pSliceBs->iNalLen, iCountNal);
+        pCtx->iSliceOutputNext = iSliceIdx + 1;
+      }
       pCtx->iPosBsBuffer += pSliceBs->uiBsPos;
 
       iLayerSize += pSliceBs->uiBsPos;
@@ -489,6 +591,10 @@ int32_t WriteSliceBs (sWelsEncCtx* pCtx, SWelsSliceBs* pSliceBs, const int32_t i
   }
   pSliceBs->uiBsPos = iSliceSize;
 
+  if (NULL != pCtx->pSvcParam->sSliceOutput.pCallback
+      && SM_SIZELIMITED_SLICE != pCtx->pSvcParam->sSpatialLayers[pCtx->uiDependencyId].sSliceArgument.uiSliceMode)
+    OutputSlicesInOrder (pCtx, pSliceBs);
+
   return iReturn;
 }
 
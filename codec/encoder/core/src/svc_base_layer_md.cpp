@@ -358,10 +358,80 @@ void WelsMdInterInit (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb, const i
   ST32 (&pCurMb->sP16x16Mv, 0);
   ST32 (&pCurLayer->pDecPic->sMvList[kiMbXY], 0);
 
-  SetMvWithinIntegerMvRange (kiMbWidth, kiMbHeight, kiMbX, kiMbY, pEncCtx->iMvRange, & (pSlice->sMvStartMin),
+  const int32_t kiMvRange = (pEncCtx->iComplexityLevel >= COMPLEXITY_LEVEL_SMALL_SEARCH) ?
+                            WELS_MIN (pEncCtx->iMvRange, COMPLEXITY_MV_RANGE) : pEncCtx->iMvRange;
+  SetMvWithinIntegerMvRange (kiMbWidth, kiMbHeight, kiMbX, kiMbY, kiMvRange, & (pSlice->sMvStartMin),
                              & (pSlice->sMvStartMax));
 }
 
+static inline int16_t ScaleHintMv (const int32_t kiMv, const int32_t kiMul, const int32_t kiDiv) {
+  const int32_t kiProduct = kiMv * kiMul;
+  return (int16_t) ((kiProduct + ((kiProduct >= 0) ? (kiDiv >> 1) : - (kiDiv >> 1))) / kiDiv);
+}
+
+//////
+//  load the motion hint of the current MB, refer to ENCODER_OPTION_MOTION_HINT
+//////
+void WelsMdInterMotionHint (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb) {
+  const int32_t kiHintMbWidth  = pEncCtx->iMotionHintMbWidth;
+  const int32_t kiHintMbHeight = pEncCtx->iMotionHintMbHeight;
+  pWelsMd->bMotionHint     = false;
+  pWelsMd->uiHintPartition = MOTION_HINT_NONE;
+  if (0 == kiHintMbWidth)
+    return;
+
+  const int32_t kiMbWidth  = pEncCtx->pCurDqLayer->iMbWidth;
+  const int32_t kiMbHeight = pEncCtx->pCurDqLayer->iMbHeight;
+  const SMbMotionHint* kpHint = &pEncCtx->pMotionHint[ (pCurMb->iMbY * kiHintMbHeight / kiMbHeight) * kiHintMbWidth
+                                + (pCurMb->iMbX * kiHintMbWidth / kiMbWidth)];
+  if (kpHint->iRefIdx < 0 || MOTION_HINT_INTRA == kpHint->uiPartition)
+    return;
+
+  //the vectors of the hint map resolution pointing iRefIdx + 1 pictures back
+  const int32_t kiDivX = kiHintMbWidth * (kpHint->iRefIdx + 1);
+  const int32_t kiDivY = kiHintMbHeight * (kpHint->iRefIdx + 1);
+  pWelsMd->sHintMv16x16.iMvX = ScaleHintMv (kpHint->iMv16x16[0], kiMbWidth, kiDivX);
+  pWelsMd->sHintMv16x16.iMvY = ScaleHintMv (kpHint->iMv16x16[1], kiMbHeight, kiDivY);
+  for (int32_t i = 0; i < 4; i++) {
+    pWelsMd->sHintMv8x8[i].iMvX = ScaleHintMv (kpHint->iMv8x8[i][0], kiMbWidth, kiDivX);
+    pWelsMd->sHintMv8x8[i].iMvY = ScaleHintMv (kpHint->iMv8x8[i][1], kiMbHeight, kiDivY);
+  }
+  pWelsMd->bMotionHint = true;
+
+  //the partition of the source only matches at the same resolution, and at a close QP
+  if (pEncCtx->bMotionHintEarlyTermination && kiHintMbWidth == kiMbWidth && kiHintMbHeight == kiMbHeight
+      && kpHint->uiPartition <= MOTION_HINT_8x8
+      && (0 == kpHint->uiQp || WELS_ABS (pCurMb->uiLumaQp - kpHint->uiQp) <= MOTION_HINT_QP_GAP_MAX)) {
+    pWelsMd->uiHintPartition = kpHint->uiPartition;
+  }
+}
+
+//////
+//  load the effort of the current MB, refer to ENCODER_OPTION_EFFORT_MAP
+//////
+void WelsMdEffort (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb) {
+  const int32_t kiMapMbWidth  = pEncCtx->iEffortMapMbWidth;
+  const int32_t kiMapMbHeight = pEncCtx->iEffortMapMbHeight;
+  pWelsMd->uiEffort = EFFORT_FULL;
+  if (0 == kiMapMbWidth)
+    return;
+
+  const int32_t kiMbWidth  = pEncCtx->pCurDqLayer->iMbWidth;
+  const int32_t kiMbHeight = pEncCtx->pCurDqLayer->iMbHeight;
+  pWelsMd->uiEffort = pEncCtx->pEffortMap[ (pCurMb->iMbY * kiMapMbHeight / kiMbHeight) * kiMapMbWidth
+                      + (pCurMb->iMbX * kiMapMbWidth / kiMbWidth)];
+}
+
+void WelsMdInterEffort (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb) {
+  WelsMdEffort (pEncCtx, pWelsMd, pCurMb);
+  //a skip falling back to 16x16 searches the small range as well
+  if (EFFORT_FULL != pWelsMd->uiEffort) {
+    SetMvWithinIntegerMvRange (pEncCtx->pCurDqLayer->iMbWidth, pEncCtx->pCurDqLayer->iMbHeight, pCurMb->iMbX,
+                               pCurMb->iMbY, WELS_MIN (pEncCtx->iMvRange, EFFORT_LOW_MV_RANGE),
+                               & (pSlice->sMvStartMin), & (pSlice->sMvStartMax));
+  }
+}
+
 int32_t WelsMdI16x16 (SWelsFuncPtrList* pFunc, SDqLayer* pCurDqLayer, SMbCache* pMbCache, int32_t iLambda) {
   const int8_t*  kpAvailMode;
   int32_t iAvailCount;
@@ -391,6 +461,14 @@ int32_t WelsMdI16x16 (SWelsFuncPtrList* pFunc, SDqLayer* pCurDqLayer, SMbCache*
     }
     iIdx = 1;
     iBestCost += iLambda;
+  } else if (pFunc->sSampleDealingFuncs.pfIntra16x16AllModes) {
+    int32_t iModeCost[I16_PRED_DC_A];
+    for (i = 0; i < iAvailCount; ++ i)
+      iModeCost[kpAvailMode[i]] = iLambda * BsSizeUE (g_kiMapModeI16x16[kpAvailMode[i]]);
+    iBestCost = pFunc->sSampleDealingFuncs.pfIntra16x16AllModes (pDec, iLineSizeDec, pEnc, iLineSizeEnc,
+                pFunc->pfGetLumaI16x16Pred, pFunc->sSampleDealingFuncs.pfMdCost[BLOCK_16x16], kpAvailMode, iAvailCount,
+                iModeCost, pDst, &iBestMode);
+    iIdx = 1;
   } else {
     iBestMode = kpAvailMode[0];
     for (i = 0; i < iAvailCount; ++ i) {
@@ -497,6 +575,14 @@ int32_t WelsMdI4x4 (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCach
           iBestPredBufferNum = 1 - iBestPredBufferNum;
         }
       }
+    } else if (pFunc->sSampleDealingFuncs.pfIntra4x4AllModes) {
+      int32_t iModeCost[I4_PRED_A];
+      for (j = 0; j < iAvailCount; ++ j)
+        iModeCost[kpAvailMode[j]] = lambda[iPredMode == g_kiMapModeI4x4[kpAvailMode[j]]];
+      pDst = &pMbCache->pMemPredBlk4[iBestPredBufferNum << 4];
+      iBestCost = pFunc->sSampleDealingFuncs.pfIntra4x4AllModes (pCurDec, kiLineSizeDec, pCurEnc, kiLineSizeEnc,
+                  pFunc->pfGetLumaI4x4Pred, pFunc->sSampleDealingFuncs.pfSampleSatd[BLOCK_4x4], kpAvailMode,
+                  iAvailCount, iModeCost, pDst, &iBestMode);
     } else {
       for (j = 0; j < iAvailCount; ++ j) {
         iCurMode = kpAvailMode[j];
@@ -901,6 +987,14 @@ int32_t WelsMdIntraChroma (SWelsFuncPtrList* pFunc, SDqLayer* pCurDqLayer, SMbCa
     }
     iBestCost += iLambda;
     iChmaIdx = 1;
+  } else if (pFunc->sSampleDealingFuncs.pfIntra8x8AllModes) {
+    int32_t iModeCost[C_PRED_A];
+    for (i = 0; i < iAvailCount; ++ i)
+      iModeCost[kpAvailMode[i]] = iLambda * BsSizeUE (g_kiMapModeIntraChroma[kpAvailMode[i]]);
+    iBestCost = pFunc->sSampleDealingFuncs.pfIntra8x8AllModes (pDecCb, kiLineSizeDec, pEncCb, kiLineSizeEnc,
+                pFunc->pfGetChromaPred, pFunc->sSampleDealingFuncs.pfMdCost[BLOCK_8x8], kpAvailMode, iAvailCount,
+                iModeCost, pDstChma, &iBestMode, pDecCr, pEncCr);
+    iChmaIdx = 1;
   } else {
     iBestMode = kpAvailMode[0];
     for (i = 0; i < iAvailCount; ++ i) {
@@ -930,6 +1024,9 @@ int32_t WelsMdIntraChroma (SWelsFuncPtrList* pFunc, SDqLayer* pCurDqLayer, SMbCa
   return iBestCost;
 }
 int32_t WelsMdIntraFinePartition (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCache* pMbCache) {
+  if (EFFORT_FULL != pWelsMd->uiEffort)
+    return pWelsMd->iCostLuma;
+
   int32_t iCosti4x4 = WelsMdI4x4 (pEncCtx, pWelsMd, pCurMb, pMbCache);
 
   if (iCosti4x4 < pWelsMd->iCostLuma) {
@@ -941,7 +1038,7 @@ int32_t WelsMdIntraFinePartition (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* p
 
 int32_t WelsMdIntraFinePartitionVaa (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCache* pMbCache) {
 
-  if (MdIntraAnalysisVaaInfo (pEncCtx, pMbCache->SPicData.pEncMb[0])) {
+  if (EFFORT_FULL == pWelsMd->uiEffort && MdIntraAnalysisVaaInfo (pEncCtx, pMbCache->SPicData.pEncMb[0])) {
     int32_t iCosti4x4 = WelsMdI4x4Fast (pEncCtx, pWelsMd, pCurMb, pMbCache);
 
     if (iCosti4x4 < pWelsMd->iCostLuma) {
@@ -953,6 +1050,10 @@ int32_t WelsMdIntraFinePartitionVaa (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB
   return pWelsMd->iCostLuma;
 }
 
+int32_t WelsMdIntraFinePartitionNull (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCache* pMbCache) {
+  return pWelsMd->iCostLuma;
+}
+
 void WelsMdIntraMb (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCache* pMbCache) {
   //initial prediction memory for I_16x16
   pWelsMd->iCostLuma = WelsMdI16x16 (pEncCtx->pFuncList, pEncCtx->pCurDqLayer, pMbCache, pWelsMd->iLambda);
@@ -996,6 +1097,12 @@ int32_t WelsMdP16x16 (SWelsFuncPtrList* pFunc, SDqLayer* pCurLayer, SWelsMD* pWe
   if (uiNeighborAvail & TOP_MB_POS) { //top available
     pSlice->sMvc[pSlice->uiMvcNum++] = (pCurMb - kiMbWidth)->sP16x16Mv;
   }
+  if (pWelsMd->bMotionHint) {
+    pSlice->sMvc[pSlice->uiMvcNum++] = pWelsMd->sHintMv16x16;
+  }
+  if (pCurLayer->pMePyramid && pCurLayer->pMePyramid->bMbMvValid) {
+    pSlice->sMvc[pSlice->uiMvcNum++] = pCurLayer->pMePyramid->pMbMv[pCurMb->iMbXY];
+  }
   //temporal motion vector predictors
   if (pCurLayer->pRefPic->iPictureType == P_SLICE) {
     if (pCurMb->iMbX < kiMbWidth - 1) {
@@ -1041,6 +1148,9 @@ int32_t WelsMdP16x8 (SWelsFuncPtrList* pFunc, SDqLayer* pCurDqLayer, SWelsMD* pW
 
     pSlice->sMvc[0] = sMe16x8->sMvBase;
     pSlice->uiMvcNum = 1;
+    if (pWelsMd->bMotionHint) {
+      pSlice->sMvc[pSlice->uiMvcNum++] = pWelsMd->sHintMv8x8[i << 1];
+    }
 
     PredInter16x8Mv (pMbCache, i << 3, 0, & (sMe16x8->sMvp));
     pFunc->pfMotionSearch[0] (pFunc, pCurDqLayer, sMe16x8, pSlice);
@@ -1069,6 +1179,9 @@ int32_t WelsMdP8x16 (SWelsFuncPtrList* pFunc, SDqLayer* pCurLayer, SWelsMD* pWel
 
     pSlice->sMvc[0] = sMe8x16->sMvBase;
     pSlice->uiMvcNum = 1;
+    if (pWelsMd->bMotionHint) {
+      pSlice->sMvc[pSlice->uiMvcNum++] = pWelsMd->sHintMv8x8[i];
+    }
 
     PredInter8x16Mv (pMbCache, i << 2, 0, & (sMe8x16->sMvp));
     pFunc->pfMotionSearch[0] (pFunc, pCurLayer, sMe8x16, pSlice);
@@ -1107,6 +1220,9 @@ int32_t WelsMdP8x8 (SWelsFuncPtrList* pFunc, SDqLayer* pCurDqLayer, SWelsMD* pWe
 
     pSlice->sMvc[0] = sMe8x8->sMvBase;
     pSlice->uiMvcNum = 1;
+    if (pWelsMd->bMotionHint) {
+      pSlice->sMvc[pSlice->uiMvcNum++] = pWelsMd->sHintMv8x8[i];
+    }
 
     PredMv (&pMbCache->sMvComponents, i << 2, 2, pWelsMd->uiRef, & (sMe8x8->sMvp));
     pFunc->pfMotionSearch[pWelsMd->iBlock8x8StaticIdc[i]] (pFunc, pCurDqLayer, sMe8x8, pSlice);
@@ -1267,6 +1383,44 @@ void WelsMdInterFinePartition (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* p
   }
 }
 
+//////
+//  partition suggested by the motion hint instead of the partition search
+//////
+void WelsMdInterFinePartitionNull (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb,
+                                   int32_t iBestCost) {
+}
+
+void WelsMdInterHintedPartition (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb,
+                                 int32_t iBestCost) {
+  SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
+  int32_t iCost = 0;
+
+  switch (pWelsMd->uiHintPartition) {
+  case MOTION_HINT_16x8:
+    iCost = WelsMdP16x8 (pEncCtx->pFuncList, pCurDqLayer, pWelsMd, pSlice);
+    if (iCost < iBestCost) {
+      pCurMb->uiMbType = MB_TYPE_16x8;
+    }
+    break;
+  case MOTION_HINT_8x16:
+    iCost = WelsMdP8x16 (pEncCtx->pFuncList, pCurDqLayer, pWelsMd, pSlice);
+    if (iCost < iBestCost) {
+      pCurMb->uiMbType = MB_TYPE_8x16;
+    }
+    break;
+  case MOTION_HINT_8x8:
+    iCost = WelsMdP8x8 (pEncCtx->pFuncList, pCurDqLayer, pWelsMd, pSlice);
+    if (iCost < iBestCost) {
+      pCurMb->uiMbType = MB_TYPE_8x8;
+      memset (pCurMb->uiSubMbType, SUB_MB_TYPE_8x8, 4);
+    }
+    break;
+  default:
+    //16x16, or skip not confirmed by WelsMdPSkipEnc: P_16x16 stands
+    break;
+  }
+}
+
 void WelsMdInterFinePartitionVaa (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb,
                                   int32_t iBestCost) {
   SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
@@ -1570,7 +1724,8 @@ const int32_t g_kiPixStrideIdx4x4[4][4] = {
   } //[3][]
 };
 
-void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCache* pMbCache) {
+void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb,
+                              SMbCache* pMbCache) {
   SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
   SWelsFuncPtrList* pFunc = pEncCtx->pFuncList;
   uint8_t* pTmpRefCb, *pTmpRefCr, *pTmpDstCb, *pTmpDstCr;
@@ -1588,6 +1743,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
   uint8_t* pDstLuma = pMbCache->pMemPredLuma;
 
   int32_t iLineSizeRefUV = pCurDqLayer->pRefPic->iLineSize[1];
+  const int32_t kiLastStage = ProfilerSwitchStage (&pSlice->sProfiler, PROFILING_STAGE_ME_SUBPEL);
 
   switch (pCurMb->uiMbType) {
   case MB_TYPE_16x16:
@@ -1596,6 +1752,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
     sMeRefine.pfCopyBlockByMode =
       pFunc->pfCopy16x16NotAligned; // dst can be align with 16 bytes, but not sure at pSrc, 12/29/2011
     MeRefineFracPixel (pEncCtx, pDstLuma, &pWelsMd->sMe.sMe16x16, &sMeRefine, 16, 16);
+    ++ pSlice->sProfiler.iSubpelRefineCount;
     UpdateP16x16MotionInfo (pMbCache, pCurMb, pWelsMd->uiRef, &pWelsMd->sMe.sMe16x16.sMv);
 
     pMbCache->sMbMvp[0] = pWelsMd->sMe.sMe16x16.sMvp;
@@ -1630,6 +1787,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
       iPixStride += ME_REFINE_BUF_STRIDE_BLK8;
       PredInter16x8Mv (pMbCache, iIdx, pWelsMd->uiRef, &pWelsMd->sMe.sMe16x8[i].sMvp);
       MeRefineFracPixel (pEncCtx, pDstLuma + g_kuiSmb4AddrIn256[iIdx], &pWelsMd->sMe.sMe16x8[i], &sMeRefine, 16, 8);
+      ++ pSlice->sProfiler.iSubpelRefineCount;
       UpdateP16x8MotionInfo (pMbCache, pCurMb, iIdx, pWelsMd->uiRef, &pWelsMd->sMe.sMe16x8[i].sMv);
       pMbCache->sMbMvp[i] = pWelsMd->sMe.sMe16x8[i].sMvp;
       //save the best cost of final mode
@@ -1660,6 +1818,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
       iPixStride += ME_REFINE_BUF_WIDTH_BLK8;
       PredInter8x16Mv (pMbCache, iIdx, pWelsMd->uiRef, &pWelsMd->sMe.sMe8x16[i].sMvp);
       MeRefineFracPixel (pEncCtx, pDstLuma + g_kuiSmb4AddrIn256[iIdx], &pWelsMd->sMe.sMe8x16[i], &sMeRefine, 8, 16);
+      ++ pSlice->sProfiler.iSubpelRefineCount;
       update_P8x16_motion_info (pMbCache, pCurMb, iIdx, pWelsMd->uiRef, &pWelsMd->sMe.sMe8x16[i].sMv);
       pMbCache->sMbMvp[i] = pWelsMd->sMe.sMe8x16[i].sMvp;
       //save the best cost of final mode
@@ -1692,6 +1851,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
         InitMeRefinePointer (&sMeRefine, pMbCache, g_kiPixStrideIdx8x8[i]);
         PredMv (&pMbCache->sMvComponents, iBlk8Idx, 2, pWelsMd->uiRef, &pWelsMd->sMe.sMe8x8[i].sMvp);
         MeRefineFracPixel (pEncCtx, pDstLuma + g_kuiSmb4AddrIn256[iBlk8Idx], &pWelsMd->sMe.sMe8x8[i], &sMeRefine, 8, 8);
+        ++ pSlice->sProfiler.iSubpelRefineCount;
         UpdateP8x8MotionInfo (pMbCache, pCurMb, iBlk8Idx, pWelsMd->uiRef, &pWelsMd->sMe.sMe8x8[i].sMv);
         pMbCache->sMbMvp[g_kuiMbCountScan4Idx[iBlk8Idx]] = pWelsMd->sMe.sMe8x8[i].sMvp;
         iBestSadCost += pWelsMd->sMe.sMe8x8[i].uiSadCost;
@@ -1723,6 +1883,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
           InitMeRefinePointer (&sMeRefine, pMbCache, g_kiPixStrideIdx4x4[i][j]);
           PredMv (&pMbCache->sMvComponents, iBlk4x4Idx, 1, pWelsMd->uiRef, &pWelsMd->sMe.sMe4x4[i][j].sMvp);
           MeRefineFracPixel (pEncCtx, pDstLuma + g_kuiSmb4AddrIn256[iBlk4x4Idx], &pWelsMd->sMe.sMe4x4[i][j], &sMeRefine, 4, 4);
+          ++ pSlice->sProfiler.iSubpelRefineCount;
           UpdateP4x4MotionInfo (pMbCache, pCurMb, iBlk4x4Idx, pWelsMd->uiRef, &pWelsMd->sMe.sMe4x4[i][j].sMv);
           pMbCache->sMbMvp[g_kuiMbCountScan4Idx[iBlk4x4Idx]] = pWelsMd->sMe.sMe4x4[i][j].sMvp;
           iBestSadCost += pWelsMd->sMe.sMe4x4[i][j].uiSadCost;
@@ -1755,6 +1916,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
           InitMeRefinePointer (&sMeRefine, pMbCache, g_kiPixStrideIdx4x4[i][j << 1]);
           PredMv (&pMbCache->sMvComponents, iBlk4x4Idx, 2, pWelsMd->uiRef, &pWelsMd->sMe.sMe8x4[i][j].sMvp);
           MeRefineFracPixel (pEncCtx, pDstLuma + g_kuiSmb4AddrIn256[iBlk4x4Idx], &pWelsMd->sMe.sMe8x4[i][j], &sMeRefine, 8, 4);
+          ++ pSlice->sProfiler.iSubpelRefineCount;
           UpdateP8x4MotionInfo (pMbCache, pCurMb, iBlk4x4Idx, pWelsMd->uiRef, &pWelsMd->sMe.sMe8x4[i][j].sMv);
           pMbCache->sMbMvp[g_kuiMbCountScan4Idx[    iBlk4x4Idx]] = pWelsMd->sMe.sMe8x4[i][j].sMvp;
           //pMbCache->sMbMvp[g_kuiMbCountScan4Idx[1 + iBlk4x4Idx]] = pWelsMd->sMe.sMe8x4[i][j].sMvp;
@@ -1788,6 +1950,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
           InitMeRefinePointer (&sMeRefine, pMbCache, g_kiPixStrideIdx4x4[i][j]);
           PredMv (&pMbCache->sMvComponents, iBlk4x4Idx, 1, pWelsMd->uiRef, &pWelsMd->sMe.sMe4x8[i][j].sMvp);
           MeRefineFracPixel (pEncCtx, pDstLuma + g_kuiSmb4AddrIn256[iBlk4x4Idx], &pWelsMd->sMe.sMe4x8[i][j], &sMeRefine, 4, 8);
+          ++ pSlice->sProfiler.iSubpelRefineCount;
           UpdateP4x8MotionInfo (pMbCache, pCurMb, iBlk4x4Idx, pWelsMd->uiRef, &pWelsMd->sMe.sMe4x8[i][j].sMv);
           pMbCache->sMbMvp[g_kuiMbCountScan4Idx[    iBlk4x4Idx]] = pWelsMd->sMe.sMe4x8[i][j].sMvp;
           //pMbCache->sMbMvp[g_kuiMbCountScan4Idx[4 + iBlk4x4Idx]] = pWelsMd->sMe.sMe8x4[i][j].sMvp;
@@ -1825,6 +1988,7 @@ void WelsMdInterMbRefinement (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurM
   else
     pWelsMd->iCostLuma = iBestSatdCost;
 
+  ProfilerSwitchStage (&pSlice->sProfiler, kiLastStage);
 }
 bool WelsMdFirstIntraMode (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCache* pMbCache) {
   SWelsFuncPtrList* pFunc = pEncCtx->pFuncList;
@@ -1865,10 +2029,16 @@ void WelsMdInterMb (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB*
   const bool bMbTopAvailPskip       = ((kuiNeighborAvail & TOP_MB_POS) ? IS_SKIP (top_mb->uiMbType) : false);
   const bool bMbTopLeftAvailPskip   = ((kuiNeighborAvail & TOPLEFT_MB_POS) ? IS_SKIP ((top_mb - 1)->uiMbType) : false);
   const bool bMbTopRightAvailPskip = ((kuiNeighborAvail & TOPRIGHT_MB_POS) ? IS_SKIP ((top_mb + 1)->uiMbType) : false);
-  bool bTrySkip = bMbLeftAvailPskip || bMbTopAvailPskip || bMbTopLeftAvailPskip || bMbTopRightAvailPskip;
-  bool bKeepSkip = bMbLeftAvailPskip && bMbTopAvailPskip && bMbTopRightAvailPskip;
+  const bool kbHintedSkip            = (MOTION_HINT_SKIP == pWelsMd->uiHintPartition);
+  bool bTrySkip = bMbLeftAvailPskip || bMbTopAvailPskip || bMbTopLeftAvailPskip || bMbTopRightAvailPskip
+                  || kbHintedSkip;
+  bool bKeepSkip = (bMbLeftAvailPskip && bMbTopAvailPskip && bMbTopRightAvailPskip) || kbHintedSkip;
   bool bSkip = false;
 
+  if (WelsMdInterForcedPskip (pEncCtx, pWelsMd, pSlice, pCurMb, pMbCache)) {
+    return;
+  }
+
   //try BGD skip
   if (pEncCtx->pFuncList->pfInterMdBackgroundDecision (pEncCtx, pWelsMd, pSlice, pCurMb, pMbCache, &bKeepSkip)) {
     return;
@@ -1953,9 +2123,313 @@ void WelsMdInterDoubleCheckPskip (SMB* pCurMb, SMbCache* pMbCache) {
 //////
 void WelsMdInterDecidedPskip (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb, SMbCache* pMbCache) {
   SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
+  const int32_t kiLastStage = ProfilerSwitchStage (&pSlice->sProfiler, PROFILING_STAGE_TRANSFORM_QUANT);
   pCurMb->uiMbType = MB_TYPE_SKIP;
   WelsRecPskip (pCurDqLayer, pEncCtx->pFuncList, pCurMb, pMbCache);
   WelsMdInterUpdatePskip (pCurDqLayer, pSlice, pCurMb, pMbCache);
+  ProfilerSwitchStage (&pSlice->sProfiler, kiLastStage);
+}
+
+//////
+//  static skip prefilter, refer to ENCODER_OPTION_STATIC_SKIP_PREFILTER
+//////
+int32_t RequestStaticSkipMap (CMemoryAlign* pMa, const int32_t kiMbWidth, const int32_t kiMbHeight,
+                              SStaticSkipMap** ppStaticSkipMap) {
+  SStaticSkipMap* pStaticSkipMap = static_cast<SStaticSkipMap*> (pMa->WelsMallocz (sizeof (SStaticSkipMap),
+                                   "pStaticSkipMap"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pStaticSkipMap)
+  *ppStaticSkipMap = pStaticSkipMap;
+
+  pStaticSkipMap->pMb = static_cast<SStaticSkipMb*> (pMa->WelsMalloc (kiMbWidth * kiMbHeight * sizeof (SStaticSkipMb),
+                        "pStaticSkipMap->pMb"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pStaticSkipMap->pMb)
+  pStaticSkipMap->pRowSad = static_cast<int32_t*> (pMa->WelsMalloc (6 * kiMbWidth * sizeof (int32_t),
+                            "pStaticSkipMap->pRowSad"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pStaticSkipMap->pRowSad)
+  pStaticSkipMap->bMapValid = false;
+
+  return ENC_RETURN_SUCCESS;
+}
+
+void ReleaseStaticSkipMap (CMemoryAlign* pMa, SStaticSkipMap** ppStaticSkipMap) {
+  SStaticSkipMap* pStaticSkipMap = *ppStaticSkipMap;
+  if (NULL == pStaticSkipMap)
+    return;
+  if (pStaticSkipMap->pMb)
+    pMa->WelsFree (pStaticSkipMap->pMb, "pStaticSkipMap->pMb");
+  if (pStaticSkipMap->pRowSad)
+    pMa->WelsFree (pStaticSkipMap->pRowSad, "pStaticSkipMap->pRowSad");
+  pMa->WelsFree (pStaticSkipMap, "pStaticSkipMap");
+  *ppStaticSkipMap = NULL;
+}
+
+/*!
+ * \brief  whether the residual of an 8x8 block leaves no coefficient after the inter quantization
+ *          the chroma DC goes through the 2x2 Hadamard as in WelsEncRecUV()
+ */
+static inline bool StaticSkipBlockZero (SWelsFuncPtrList* pFunc, uint8_t* pEnc, const int32_t kiEncStride, uint8_t* pRef,
+                                        const int32_t kiRefStride, const int32_t kiQp, const bool kbChroma) {
+  ENFORCE_STACK_ALIGN_1D (int16_t, iRes, 64, 16);
+  ENFORCE_STACK_ALIGN_1D (int16_t, iMax, 4, 16);
+  int16_t iDct2x2[4], iDc[4];
+  const int16_t* kpMF = g_kiQuantMF[kiQp];
+  const int16_t* kpFF = g_kiQuantInterFF[kiQp];
+
+  pFunc->pfDctFourT4 (iRes, pEnc, kiEncStride, pRef, kiRefStride);
+  if (kbChroma && pFunc->pfQuantizationHadamard2x2 (iRes, kpFF[0] << 1, kpMF[0] >> 1, iDct2x2, iDc))
+    return false;
+  pFunc->pfQuantizationFour4x4Max (iRes, kpFF, kpMF, iMax);
+  return 0 == (iMax[0] | iMax[1] | iMax[2] | iMax[3]);
+}
+
+/*!
+ * \brief  largest SAD of an 8x8 residual block that quantizes to nothing at kiQp whatever its distribution
+ *          no 4x4 coefficient exceeds four times the SAD, and no 2x2 chroma DC coefficient exceeds the SAD
+ */
+static inline int32_t StaticSkipSadZeroLimit (const int32_t kiQp, const bool kbChroma) {
+  const int16_t* kpMF = g_kiQuantMF[kiQp];
+  const int16_t* kpFF = g_kiQuantInterFF[kiQp];
+  int32_t iLimit = 65535 / kpMF[0] - kpFF[0];
+  for (int32_t j = 1; j < 8; j++)
+    iLimit = WELS_MIN (iLimit, 65535 / kpMF[j] - kpFF[j]);
+  iLimit >>= 2;
+  if (kbChroma)
+    iLimit = WELS_MIN (iLimit, 65535 / (kpMF[0] >> 1) - (kpFF[0] << 1));
+  return WELS_MAX (iLimit, 0);
+}
+
+/*!
+ * \brief  classify the MBs of the current layer coded as skip whatever the mode decision, row by row ahead of the MB loop
+ *          an MB is kept when its residual at zero motion against the reference quantizes to nothing at kiQp, so that
+ *          any MB QP not below kiQp would code it with no coefficient either; MBs whose source already changed by
+ *          more than the DC dead zone against the source of the reference in the video analysis are not measured
+ *          the 8x8 SADs of a whole MB row come from pfSampleSad8x8Row, the transform is only run on the blocks whose
+ *          SAD is above StaticSkipSadZeroLimit()
+ */
+void PerformStaticSkipPrefilter (SWelsFuncPtrList* pFunc, SDqLayer* pCurLayer, const SVAAFrameInfo* kpVaa,
+                                 const int32_t kiQp) {
+  SStaticSkipMap* pStaticSkipMap = pCurLayer->pStaticSkipMap;
+  SPicture* pRefPic = pCurLayer->pRefPic;
+  const int32_t kiMbWidth  = pCurLayer->iMbWidth;
+  const int32_t kiMbHeight = pCurLayer->iMbHeight;
+  const int32_t kiEncStride   = pCurLayer->iEncStride[0];
+  const int32_t kiEncStrideUV = pCurLayer->iEncStride[1];
+  const int32_t kiRefStride   = pRefPic->iLineSize[0];
+  const int32_t kiRefStrideUV = pRefPic->iLineSize[1];
+  const int32_t kiChromaQp    = g_kuiChromaQpTable[CLIP3_QP_0_51 (kiQp + pCurLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset)];
+  // DC of a 4x4 block is the sum of its residual, four of them in an 8x8 block
+  const int32_t kiLimitVaa    = (65535 / g_kiQuantMF[kiQp][0] - g_kiQuantInterFF[kiQp][0]) << 2;
+  const int32_t kiSadZeroLuma   = StaticSkipSadZeroLimit (kiQp, false);
+  const int32_t kiSadZeroChroma = StaticSkipSadZeroLimit (kiChromaQp, true);
+  PSampleSadRowFunc pfSad8x8Row = pFunc->sSampleDealingFuncs.pfSampleSad8x8Row;
+  int32_t (*pVaaSad8x8)[4] = kpVaa->sVaaCalcInfo.pSad8x8;
+  int32_t* pSadLuma[2] = {pStaticSkipMap->pRowSad, pStaticSkipMap->pRowSad + (kiMbWidth << 1)};
+  int32_t* pSadChroma[2] = {pSadLuma[1] + (kiMbWidth << 1), pSadLuma[1] + 3 * kiMbWidth};
+
+  for (int32_t iMbY = 0; iMbY < kiMbHeight; iMbY++) {
+    SStaticSkipMb* pRowMb = &pStaticSkipMap->pMb[iMbY * kiMbWidth];
+    int32_t* pRowVaaSad = pVaaSad8x8[iMbY * kiMbWidth];
+    uint8_t* pEncY = pCurLayer->pEncData[0] + (iMbY << 4) * kiEncStride;
+    uint8_t* pRefY = pRefPic->pData[0] + (iMbY << 4) * kiRefStride;
+    const int32_t kiOffsetEncUV = (iMbY << 3) * kiEncStrideUV;
+    const int32_t kiOffsetRefUV = (iMbY << 3) * kiRefStrideUV;
+    int32_t i;
+
+    pfSad8x8Row (pEncY, kiEncStride, pRefY, kiRefStride, kiMbWidth << 1, pSadLuma[0]);
+    pfSad8x8Row (pEncY + (kiEncStride << 3), kiEncStride, pRefY + (kiRefStride << 3), kiRefStride, kiMbWidth << 1,
+                 pSadLuma[1]);
+    for (i = 0; i < 2; i++)
+      pfSad8x8Row (pCurLayer->pEncData[1 + i] + kiOffsetEncUV, kiEncStrideUV, pRefPic->pData[1 + i] + kiOffsetRefUV,
+                   kiRefStrideUV, kiMbWidth, pSadChroma[i]);
+
+    for (int32_t iMbX = 0; iMbX < kiMbWidth; iMbX++, pRowVaaSad += 4) {
+      SStaticSkipMb* pMb = &pRowMb[iMbX];
+      pMb->bStatic = false;
+      if (WELS_MAX (WELS_MAX (pRowVaaSad[0], pRowVaaSad[1]), WELS_MAX (pRowVaaSad[2], pRowVaaSad[3])) > kiLimitVaa)
+        continue;
+
+      int32_t iSadLuma = 0, iSadChroma = 0;
+      for (i = 0; i < 4; i++) {
+        const int32_t kiSad = pSadLuma[i >> 1][(iMbX << 1) + (i & 1)];
+        if (kiSad > kiSadZeroLuma) {
+          const int32_t kiOffsetX = (iMbX << 4) + ((i & 1) << 3);
+          const int32_t kiOffsetY = (i >> 1) << 3;
+          if (!StaticSkipBlockZero (pFunc, pEncY + kiOffsetY * kiEncStride + kiOffsetX, kiEncStride,
+                                    pRefY + kiOffsetY * kiRefStride + kiOffsetX, kiRefStride, kiQp, false))
+            break;
+        }
+        iSadLuma += kiSad;
+      }
+      if (i < 4)
+        continue;
+      for (i = 0; i < 2; i++) {
+        const int32_t kiSad = pSadChroma[i][iMbX];
+        if (kiSad > kiSadZeroChroma
+            && !StaticSkipBlockZero (pFunc, pCurLayer->pEncData[1 + i] + kiOffsetEncUV + (iMbX << 3), kiEncStrideUV,
+                                     pRefPic->pData[1 + i] + kiOffsetRefUV + (iMbX << 3), kiRefStrideUV,
+                                     kiChromaQp, true))
+          break;
+        iSadChroma += kiSad;
+      }
+      if (i < 2)
+        continue;
+
+      pMb->uiSadLuma   = (uint16_t)iSadLuma;
+      pMb->uiSadChroma = (uint16_t)iSadChroma;
+      pMb->bStatic     = true;
+    }
+  }
+  pStaticSkipMap->uiQp      = (uint8_t)kiQp;
+  pStaticSkipMap->uiChromaQp = (uint8_t)kiChromaQp;
+  pStaticSkipMap->bMapValid = true;
+}
+
+//////
+//  Pskip of the MB pre-classified by PerformStaticSkipPrefilter(), ME, MD and transform are bypassed
+//////
+bool WelsMdInterStaticPskip (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb, SMbCache* pMbCache) {
+  SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
+  const SStaticSkipMap* kpStaticSkipMap = pCurDqLayer->pStaticSkipMap;
+  if (NULL == kpStaticSkipMap || !kpStaticSkipMap->bMapValid)
+    return false;
+  const SStaticSkipMb* kpMb = &kpStaticSkipMap->pMb[pCurMb->iMbXY];
+  if (!kpMb->bStatic)
+    return false;
+
+  //a coarser quantization leaves no coefficient either, a finer one may
+  if (pCurMb->uiLumaQp < kpStaticSkipMap->uiQp || pCurMb->uiChromaQp < kpStaticSkipMap->uiChromaQp)
+    return false;
+
+  //the skip predicts from the collocated block only if its MV predictor is zero
+  SMVUnitXY sMvp = { 0 };
+  PredSkipMv (pMbCache, &sMvp);
+  if (0 != LD32 (&sMvp))
+    return false;
+
+  SWelsFuncPtrList* pFunc = pEncCtx->pFuncList;
+  const int32_t kiLineSizeY  = pCurDqLayer->pRefPic->iLineSize[0];
+  const int32_t kiLineSizeUV = pCurDqLayer->pRefPic->iLineSize[1];
+  uint8_t* pDstLuma = pMbCache->pSkipMb;
+  pFunc->sMcFuncs.pMcLumaFunc (pMbCache->SPicData.pRefMb[0], kiLineSizeY, pDstLuma, 16, 0, 0, 16, 16);
+  pFunc->sMcFuncs.pMcChromaFunc (pMbCache->SPicData.pRefMb[1], kiLineSizeUV, pMbCache->pSkipMb + 256, 8, 0, 0, 8, 8);
+  pFunc->sMcFuncs.pMcChromaFunc (pMbCache->SPicData.pRefMb[2], kiLineSizeUV, pMbCache->pSkipMb + 320, 8, 0, 0, 8, 8);
+
+  //update motion info to current MB
+  ST32 (pCurMb->pRefIndex, 0);
+  pFunc->pfUpdateMbMv (pCurMb->sMv, sMvp);
+  if (pWelsMd->bMdUsingSad) {
+    pCurMb->pSadCost[0] = kpMb->uiSadLuma;
+    pWelsMd->iCostLuma = pCurMb->pSadCost[0];
+  } else
+    pWelsMd->iCostLuma = pFunc->sSampleDealingFuncs.pfSampleSatd[BLOCK_16x16] (pMbCache->SPicData.pEncMb[0],
+                         pCurDqLayer->iEncStride[0], pDstLuma, 16);
+  pWelsMd->iCostSkipMb = kpMb->uiSadLuma + kpMb->uiSadChroma;
+  ST32 (&pCurMb->sP16x16Mv, 0);
+  ST32 (&pCurDqLayer->pDecPic->sMvList[pCurMb->iMbXY], 0);
+
+  WelsMdInterDecidedPskip (pEncCtx, pSlice, pCurMb, pMbCache);
+  ++ pSlice->sProfiler.iPrefilteredSkipCount;
+  return true;
+}
+
+//////
+//  intra refresh, refer to WelsIntraRefreshLayerInit(): the MB in the band is coded intra, the MB above it
+//  searches the refreshed rows of the reference only
+//////
+bool WelsMdInterIntraRefresh (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb, SMbCache* pMbCache) {
+  const SDqLayer* kpCurDqLayer = pEncCtx->pCurDqLayer;
+  const int32_t kiMbY = pCurMb->iMbY;
+  if (kiMbY >= kpCurDqLayer->iRefreshMbRowEnd)
+    return false;
+  if (kiMbY < kpCurDqLayer->iRefreshMbRowStart) {
+    if (kpCurDqLayer->iRefreshRefMbRows >= kpCurDqLayer->iMbHeight)
+      return false;
+    //the 6-tap filter reads 3 rows below the block, the deblocking of the band bottom changed 3 rows above it
+    const int32_t kiMvMaxY = ((kpCurDqLayer->iRefreshRefMbRows - kiMbY) << 4) - 22;
+    if (kiMvMaxY > pSlice->sMvStartMin.iMvY) {
+      pSlice->sMvStartMax.iMvY = WELS_MIN (pSlice->sMvStartMax.iMvY, kiMvMaxY);
+      return false;
+    }
+  }
+
+  WelsMdIntraMb (pEncCtx, pWelsMd, pCurMb, pMbCache);
+  pMbCache->bCollocatedPredFlag = false;
+  return true;
+}
+
+//////
+//  the MVs the search clipped may still be moved by the subpel refinement or predicted by the skip,
+//  the MB reading stale rows falls back to intra
+//////
+void WelsMdInterIntraRefreshCheck (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SMB* pCurMb, SMbCache* pMbCache) {
+  const SDqLayer* kpCurDqLayer = pEncCtx->pCurDqLayer;
+  if (pCurMb->iMbY >= kpCurDqLayer->iRefreshMbRowStart || kpCurDqLayer->iRefreshRefMbRows >= kpCurDqLayer->iMbHeight
+      || IS_INTRA (pCurMb->uiMbType))
+    return;
+
+  const int32_t kiLumaRows   = (kpCurDqLayer->iRefreshRefMbRows << 4) - 3;
+  const int32_t kiChromaRows = (kpCurDqLayer->iRefreshRefMbRows << 3) - 1;
+  for (int32_t i = 0; i < 16; i++) {
+    const int32_t kiPixY = (pCurMb->iMbY << 4) + ((i >> 2) << 2);
+    const int32_t kiMvY  = pCurMb->sMv[i].iMvY;
+    if (kiPixY + 3 + (kiMvY >> 2) + ((kiMvY & 3) ? 3 : 0) >= kiLumaRows
+        || (kiPixY >> 1) + 1 + (kiMvY >> 3) + ((kiMvY & 7) ? 1 : 0) >= kiChromaRows) {
+      pCurMb->uiCbp = 0;
+      WelsMdIntraMb (pEncCtx, pWelsMd, pCurMb, pMbCache);
+      pMbCache->bCollocatedPredFlag = false;
+      return;
+    }
+  }
+}
+
+//////
+//  skip asked by the application, refer to ENCODER_OPTION_EFFORT_MAP
+//////
+bool WelsMdInterForcedPskip (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb, SMbCache* pMbCache) {
+  if (EFFORT_SKIP != pWelsMd->uiEffort)
+    return false;
+
+  SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
+  SWelsFuncPtrList* pFunc = pEncCtx->pFuncList;
+  SMVUnitXY sMvp = { 0 };
+  PredSkipMv (pMbCache, &sMvp);
+
+  //the same clipping as WelsMdPSkipEnc, a MB the skip cannot reach is coded with low effort instead
+  const SMVUnitXY ksQpelMvp = { static_cast<int16_t> (sMvp.iMvX >> 2), static_cast<int16_t> (sMvp.iMvY >> 2) };
+  const int32_t kiPosX = (pCurMb->iMbX << 4) + ksQpelMvp.iMvX;
+  const int32_t kiPosY = (pCurMb->iMbY << 4) + ksQpelMvp.iMvY;
+  if (kiPosX < -29 || kiPosX > ((pCurDqLayer->iMbWidth << 4) + 12)
+      || kiPosY < -29 || kiPosY > ((pCurDqLayer->iMbHeight << 4) + 12))
+    return false;
+
+  const int32_t kiLineSizeY  = pCurDqLayer->pRefPic->iLineSize[0];
+  const int32_t kiLineSizeUV = pCurDqLayer->pRefPic->iLineSize[1];
+  const int32_t kiOffsetUV   = (ksQpelMvp.iMvY >> 1) * kiLineSizeUV + (ksQpelMvp.iMvX >> 1);
+  uint8_t* pDstLuma = pMbCache->pSkipMb;
+  pFunc->sMcFuncs.pMcLumaFunc (pMbCache->SPicData.pRefMb[0] + ksQpelMvp.iMvY * kiLineSizeY + ksQpelMvp.iMvX,
+                               kiLineSizeY, pDstLuma, 16, sMvp.iMvX, sMvp.iMvY, 16, 16);
+  pFunc->sMcFuncs.pMcChromaFunc (pMbCache->SPicData.pRefMb[1] + kiOffsetUV, kiLineSizeUV, pMbCache->pSkipMb + 256, 8,
+                                 sMvp.iMvX, sMvp.iMvY, 8, 8);
+  pFunc->sMcFuncs.pMcChromaFunc (pMbCache->SPicData.pRefMb[2] + kiOffsetUV, kiLineSizeUV, pMbCache->pSkipMb + 320, 8,
+                                 sMvp.iMvX, sMvp.iMvY, 8, 8);
+  const int32_t kiSadLuma = pFunc->sSampleDealingFuncs.pfSampleSad[BLOCK_16x16] (pMbCache->SPicData.pEncMb[0],
+                            pCurDqLayer->iEncStride[0], pDstLuma, 16);
+
+  //update motion info to current MB
+  ST32 (pCurMb->pRefIndex, 0);
+  pFunc->pfUpdateMbMv (pCurMb->sMv, sMvp);
+  if (pWelsMd->bMdUsingSad) {
+    pCurMb->pSadCost[0] = kiSadLuma;
+    pWelsMd->iCostLuma = pCurMb->pSadCost[0];
+  } else
+    pWelsMd->iCostLuma = pFunc->sSampleDealingFuncs.pfSampleSatd[BLOCK_16x16] (pMbCache->SPicData.pEncMb[0],
+                         pCurDqLayer->iEncStride[0], pDstLuma, 16);
+  pWelsMd->iCostSkipMb = kiSadLuma;
+  pCurMb->sP16x16Mv = sMvp;
+  pCurDqLayer->pDecPic->sMvList[pCurMb->iMbXY] = sMvp;
+
+  WelsMdInterDecidedPskip (pEncCtx, pSlice, pCurMb, pMbCache);
+  return true;
 }
 
 //////
@@ -2006,10 +2480,16 @@ void WelsMdInterSecondaryModesEnc (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlic
   } else {
     //Step 3: SubP16 MD
     pEncCtx->pFuncList->pfSetScrollingMv (pEncCtx->pVaa, pWelsMd); //SCC
-    pEncCtx->pFuncList->pfInterFineMd (pEncCtx, pWelsMd, pSlice, pCurMb, pWelsMd->iCostLuma);
+    if (EFFORT_FULL != pWelsMd->uiEffort) {
+      //16x16 only
+    } else if (MOTION_HINT_NONE == pWelsMd->uiHintPartition) {
+      pEncCtx->pFuncList->pfInterFineMd (pEncCtx, pWelsMd, pSlice, pCurMb, pWelsMd->iCostLuma);
+    } else {
+      WelsMdInterHintedPartition (pEncCtx, pWelsMd, pSlice, pCurMb, pWelsMd->iCostLuma);
+    }
 
     //refinement for inter type
-    WelsMdInterMbRefinement (pEncCtx, pWelsMd, pCurMb, pMbCache);
+    WelsMdInterMbRefinement (pEncCtx, pWelsMd, pSlice, pCurMb, pMbCache);
 
     //step 7: invoke encoding
     WelsMdInterEncode (pEncCtx, pSlice, pCurMb, pMbCache);
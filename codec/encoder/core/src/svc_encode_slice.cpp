@@ -46,6 +46,7 @@
 #include "svc_set_mb_syn.h"
 #include "decode_mb_aux.h"
 #include "svc_mode_decision.h"
+#include "deblocking.h"
 
 namespace WelsEnc {
 //#define ENC_TRACE
@@ -172,8 +173,7 @@ void UpdateMbNeighbor (SDqLayer* pCurDq, SMB* pMb, const int32_t kiMbWidth, uint
   pMb->uiNeighborAvail = (uint8_t)uiNeighborAvailFlag;
 }
 
-/* count MB types if enabled FRAME_INFO_OUTPUT*/
-#if defined(MB_TYPES_CHECK)
+/* count MB types, used by MB_TYPES_CHECK and ENCODER_OPTION_PROFILING */
 void WelsCountMbType (int32_t (*iMbCount)[18], const EWelsSliceType keSt, const SMB* kpMb) {
   if (NULL == iMbCount)
     return;
@@ -207,7 +207,6 @@ void WelsCountMbType (int32_t (*iMbCount)[18], const EWelsSliceType keSt, const
     break;
   }
 }
-#endif//MB_TYPES_CHECK
 
 /*!
 * \brief    write reference picture list on reordering syntax in Slice header
@@ -443,10 +442,12 @@ void WelsSliceHeaderExtWrite (sWelsEncCtx* pCtx, SBitStringAux* pBs, SDqLayer* p
 //only for inter part
 void WelsInterMbEncode (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb) {
   SMbCache* pMbCache = &pSlice->sMbCacheInfo;
+  const int32_t kiLastStage = ProfilerSwitchStage (&pSlice->sProfiler, PROFILING_STAGE_TRANSFORM_QUANT);
 
   WelsDctMb (pMbCache->pCoeffLevel,  pMbCache->SPicData.pEncMb[0], pEncCtx->pCurDqLayer->iEncStride[0],
              pMbCache->pMemPredLuma, pEncCtx->pFuncList->pfDctFourT4);
   WelsEncInterY (pEncCtx->pFuncList, pCurMb, pMbCache);
+  ProfilerSwitchStage (&pSlice->sProfiler, kiLastStage);
 }
 
 
@@ -483,12 +484,14 @@ void WelsPMbChromaEncode (sWelsEncCtx* pEncCtx, SSlice* pSlice, SMB* pCurMb) {
   SMbCache* pMbCache            = &pSlice->sMbCacheInfo;
   int16_t* pCurRS               = pMbCache->pCoeffLevel + 256;
   uint8_t* pBestPred            = pMbCache->pMemPredChroma;
+  const int32_t kiLastStage     = ProfilerSwitchStage (&pSlice->sProfiler, PROFILING_STAGE_TRANSFORM_QUANT);
 
   pFunc->pfDctFourT4 (pCurRS,       pMbCache->SPicData.pEncMb[1],   kiEncStride,    pBestPred,      8);
   pFunc->pfDctFourT4 (pCurRS + 64,  pMbCache->SPicData.pEncMb[2],   kiEncStride,    pBestPred + 64, 8);
 
   WelsEncRecUV (pFunc, pCurMb, pMbCache, pCurRS, 1);
   WelsEncRecUV (pFunc, pCurMb, pMbCache, pCurRS + 64, 2);
+  ProfilerSwitchStage (&pSlice->sProfiler, kiLastStage);
 }
 
 void OutputPMbWithoutConstructCsRsNoCopy (sWelsEncCtx* pCtx, SDqLayer* pDq, SSlice* pSlice, SMB* pMb) {
@@ -520,6 +523,7 @@ void UpdateQpForOverflow (SMB* pCurMb, uint8_t kuiChromaQpIndexOffset) {
 int32_t WelsISliceMdEnc (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd + encoding
   SDqLayer* pCurLayer           = pEncCtx->pCurDqLayer;
   SMbCache* pMbCache            = &pSlice->sMbCacheInfo;
+  SStageProfiler* pProfiler     = &pSlice->sProfiler;
   SSliceHeaderExt* pSliceHdExt  = &pSlice->sSliceHeaderExt;
   SMB* pMbList                  = pCurLayer->sMbDataP;
   SMB* pCurMb                   = NULL;
@@ -535,7 +539,6 @@ int32_t WelsISliceMdEnc (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd + encodin
   SDynamicSlicingStack sDss;
   if (pEncCtx->pSvcParam->iEntropyCodingModeFlag) {
     WelsInitSliceCabac (pEncCtx, pSlice);
-    sDss.pRestoreBuffer = NULL;
     sDss.iStartPos = sDss.iCurrentPos = 0;
   }
   for (; ;) {
@@ -544,8 +547,11 @@ int32_t WelsISliceMdEnc (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd + encodin
     iCurMbIdx = iNextMbIdx;
     pCurMb = &pMbList[ iCurMbIdx ];
 
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInit (pEncCtx, pCurMb, pSlice);
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
     WelsMdIntraInit (pEncCtx, pCurMb, pMbCache, kiSliceFirstMbXY);
+    WelsMdEffort (pEncCtx, &sMd, pCurMb);
 
 TRY_REENCODING:
     sMd.iLambda = g_kiQpCostTable[pCurMb->uiLumaQp];
@@ -553,11 +559,13 @@ TRY_REENCODING:
     UpdateNonZeroCountCache (pCurMb, pMbCache);
 
 
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_ENTROPY_CODING);
     iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
     if (!pEncCtx->pSvcParam->iEntropyCodingModeFlag) {
       if ((iEncReturn == ENC_RETURN_VLCOVERFLOWFOUND) && (pCurMb->uiLumaQp < 50)) {
         pEncCtx->pFuncList->pfStashPopMBStatus (&sDss, pSlice);
         UpdateQpForOverflow (pCurMb, kuiChromaQpIndexOffset);
+        ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
         goto TRY_REENCODING;
       }
     }
@@ -569,9 +577,13 @@ TRY_REENCODING:
 #if defined(MB_TYPES_CHECK)
     WelsCountMbType (pEncCtx->sPerInfo.iMbCount, I_SLICE, pCurMb);
 #endif//MB_TYPES_CHECK
+    if (pProfiler->bEnabled)
+      WelsCountMbType (pProfiler->iMbCount, I_SLICE, pCurMb);
 
     pEncCtx->pFuncList->pfMdBackgroundInfoUpdate (pCurLayer, pCurMb, pMbCache->bCollocatedPredFlag, I_SLICE);
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, sMd.iCostLuma, pSlice);
+    WelsOverlappedDeblockingMbDone (pEncCtx, pSlice, pCurMb);
 
     ++iNumMbCoded;
     iNextMbIdx = WelsGetNextMbOfSlice (pCurLayer, iCurMbIdx);
@@ -589,6 +601,7 @@ int32_t WelsISliceMdEncDynamic (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd +
   SDqLayer* pCurLayer           = pEncCtx->pCurDqLayer;
   SSliceCtx* pSliceCtx          = &pCurLayer->sSliceEncCtx;
   SMbCache* pMbCache            = &pSlice->sMbCacheInfo;
+  SStageProfiler* pProfiler     = &pSlice->sProfiler;
   SSliceHeaderExt* pSliceHdExt  = &pSlice->sSliceHeaderExt;
   SMB* pMbList                  = pCurLayer->sMbDataP;
   SMB* pCurMb                   = NULL;
@@ -605,7 +618,6 @@ int32_t WelsISliceMdEncDynamic (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd +
   SDynamicSlicingStack sDss;
   if (pEncCtx->pSvcParam->iEntropyCodingModeFlag) {
     WelsInitSliceCabac (pEncCtx, pSlice);
-    sDss.pRestoreBuffer = pEncCtx->pDynamicBsBuffer[kiPartitionId];
     sDss.iStartPos = sDss.iCurrentPos = 0;
   } else {
     sDss.iStartPos = BsGetBitsPos (pBs);
@@ -615,23 +627,28 @@ int32_t WelsISliceMdEncDynamic (sWelsEncCtx* pEncCtx, SSlice* pSlice) { //pMd +
     pCurMb = &pMbList[ iCurMbIdx ];
 
     pEncCtx->pFuncList->pfStashMBStatus (&sDss, pSlice, 0);
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInit (pEncCtx, pCurMb, pSlice);
     // if already reaches the largest number of slices, set QPs to the upper bound
     if (pSlice->bDynamicSlicingSliceSizeCtrlFlag) {
       pCurMb->uiLumaQp = pEncCtx->pWelsSvcRc[pEncCtx->uiDependencyId].iMaxQp;
       pCurMb->uiChromaQp = g_kuiChromaQpTable[CLIP3_QP_0_51 (pCurMb->uiLumaQp + kuiChromaQpIndexOffset)];
     }
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
     WelsMdIntraInit (pEncCtx, pCurMb, pMbCache, kiSliceFirstMbXY);
+    WelsMdEffort (pEncCtx, &sMd, pCurMb);
 
 TRY_REENCODING:
     sMd.iLambda = g_kiQpCostTable[pCurMb->uiLumaQp];
     WelsMdIntraMb (pEncCtx, &sMd, pCurMb, pMbCache);
     UpdateNonZeroCountCache (pCurMb, pMbCache);
 
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_ENTROPY_CODING);
     iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
     if (iEncReturn == ENC_RETURN_VLCOVERFLOWFOUND && (pCurMb->uiLumaQp < 50)) {
       pEncCtx->pFuncList->pfStashPopMBStatus (&sDss, pSlice);
       UpdateQpForOverflow (pCurMb, kuiChromaQpIndexOffset);
+      ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
       goto TRY_REENCODING;
     }
     if (ENC_RETURN_SUCCESS != iEncReturn)
@@ -654,7 +671,10 @@ TRY_REENCODING:
 #if defined(MB_TYPES_CHECK)
     WelsCountMbType (pEncCtx->sPerInfo.iMbCount, I_SLICE, pCurMb);
 #endif//MB_TYPES_CHECK
+    if (pProfiler->bEnabled)
+      WelsCountMbType (pProfiler->iMbCount, I_SLICE, pCurMb);
 
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, sMd.iCostLuma, pSlice);
 
     ++iNumMbCoded;
@@ -1030,7 +1050,9 @@ int32_t InitSliceThreadInfo (sWelsEncCtx* pCtx,
 
   //for fixed slice num case, no need to reallocate, so one slice buffer for all thread
   if (pDqLayer->bThreadSlcBufferFlag) {
-    iMaxSliceNum  = pDqLayer->iMaxSliceNum / iThreadNum + 1;
+    // sized up front, any thread may code all the slices of the picture
+    iMaxSliceNum  = (pCtx->iPreallocSliceNum[kiDlayerIndex] > 0) ? pDqLayer->iMaxSliceNum :
+                    (pDqLayer->iMaxSliceNum / iThreadNum + 1);
     iSlcBufferNum = iThreadNum;
   } else {
     iMaxSliceNum  = pDqLayer->iMaxSliceNum;
@@ -1273,6 +1295,7 @@ int32_t ReallocateSliceList (sWelsEncCtx* pCtx,
 
   pMA->WelsFree (pSliceList, "pSliceBuffer");
   pSliceList = pNewSliceList;
+  ++ pCtx->uiBufferReallocCount;
 
   return ENC_RETURN_SUCCESS;
 }
@@ -1376,6 +1399,7 @@ int32_t ExtendLayerBuffer (sWelsEncCtx* pCtx,
   memcpy (pCountMbNumInSlice, pCurLayer->pCountMbNumInSlice, sizeof (int32_t) * kiMaxSliceNumOld);
   pMA->WelsFree (pCurLayer->pCountMbNumInSlice, "pCountMbNumInSlice");
   pCurLayer->pCountMbNumInSlice = pCountMbNumInSlice;
+  ++ pCtx->uiBufferReallocCount;
 
   return ENC_RETURN_SUCCESS;
 }
@@ -1568,6 +1592,7 @@ int32_t FrameBsRealloc (sWelsEncCtx* pCtx,
   pCtx->pOut->pNalLen = pNalLen;
 
   pCtx->pOut->iCountNals = iCountNals;
+  ++ pCtx->uiBufferReallocCount;
   SLayerBSInfo* pLBI1, *pLBI2;
   pLBI1 = &pFrameBsInfo->sLayerInfo[0];
   pLBI1->pNalLengthInByte = pCtx->pOut->pNalLen;
@@ -1653,7 +1678,9 @@ int32_t WelsCodeOneSlice (sWelsEncCtx* pEncCtx, SSlice* pCurSlice, const int32_t
 
   pCurSlice->uiLastMbQp = pCurLayer->sLayerInfo.pPpsP->iPicInitQp + pCurSlice->sSliceHeaderExt.sSliceHeader.iSliceQpDelta;
 
+  ProfilerStart (&pCurSlice->sProfiler, pEncCtx->pSvcParam->bProfiling);
   int32_t iEncReturn = g_pWelsSliceCoding[pNalHeadExt->bIdrFlag][kiDynamicSliceFlag] (pEncCtx, pCurSlice);
+  ProfilerSwitchStage (&pCurSlice->sProfiler, -1);
   if (ENC_RETURN_SUCCESS != iEncReturn)
     return iEncReturn;
 
@@ -1795,6 +1822,7 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
   SBitStringAux* pBs    = pSlice->pSliceBsa;
   SDqLayer* pCurLayer   = pEncCtx->pCurDqLayer;
   SMbCache* pMbCache    = &pSlice->sMbCacheInfo;
+  SStageProfiler* pProfiler     = &pSlice->sProfiler;
   SMB* pMbList          = pCurLayer->sMbDataP;
   SMB* pCurMb           = NULL;
   int32_t iNumMbCoded   = 0;
@@ -1809,7 +1837,6 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
   SDynamicSlicingStack sDss;
   if (pEncCtx->pSvcParam->iEntropyCodingModeFlag) {
     WelsInitSliceCabac (pEncCtx, pSlice);
-    sDss.pRestoreBuffer = NULL;
     sDss.iStartPos = sDss.iCurrentPos = 0;
   }
   pSlice->iMbSkipRun = 0;
@@ -1822,15 +1849,23 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
 
 
     //step(1): set QP for the current MB
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInit (pEncCtx, pCurMb, pSlice);
 
     //step (2). save some vale for future use, initial pWelsMd
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
     WelsMdIntraInit (pEncCtx, pCurMb, pMbCache, kiSliceFirstMbXY);
     WelsMdInterInit (pEncCtx, pSlice, pCurMb, kiSliceFirstMbXY);
+    WelsMdInterMotionHint (pEncCtx, pMd, pCurMb);
+    WelsMdInterEffort (pEncCtx, pMd, pSlice, pCurMb);
 
 TRY_REENCODING:
     WelsInitInterMDStruc (pCurMb, pMvdCostTable, kiMvdInterTableStride, pMd);
-    pEncCtx->pFuncList->pfInterMd (pEncCtx, pMd, pSlice, pCurMb, pMbCache);
+    if (!WelsMdInterIntraRefresh (pEncCtx, pMd, pSlice, pCurMb, pMbCache)) {
+      if (!WelsMdInterStaticPskip (pEncCtx, pMd, pSlice, pCurMb, pMbCache))
+        pEncCtx->pFuncList->pfInterMd (pEncCtx, pMd, pSlice, pCurMb, pMbCache);
+      WelsMdInterIntraRefreshCheck (pEncCtx, pMd, pCurMb, pMbCache);
+    }
     //mb_qp
 
     //step (4): save from the MD process from future use
@@ -1844,11 +1879,13 @@ TRY_REENCODING:
 
     //step (6): begin to write bit stream; if the pSlice size is controlled, the writing may be skipped
 
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_ENTROPY_CODING);
     iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
     if (!pEncCtx->pSvcParam->iEntropyCodingModeFlag) {
       if (iEncReturn == ENC_RETURN_VLCOVERFLOWFOUND && (pCurMb->uiLumaQp < 50)) {
         pSlice->iMbSkipRun = pEncCtx->pFuncList->pfStashPopMBStatus (&sDss, pSlice);
         UpdateQpForOverflow (pCurMb, kuiChromaQpIndexOffset);
+        ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
         goto TRY_REENCODING;
       }
     }
@@ -1858,14 +1895,19 @@ TRY_REENCODING:
 
     //step (7): reconstruct current MB
     pCurMb->uiSliceIdc = kiSliceIdx;
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RECONSTRUCTION);
     OutputPMbWithoutConstructCsRsNoCopy (pEncCtx, pCurLayer, pSlice, pCurMb);
 
 #if defined(MB_TYPES_CHECK)
     WelsCountMbType (pEncCtx->sPerInfo.iMbCount, P_SLICE, pCurMb);
 #endif//MB_TYPES_CHECK
+    if (pProfiler->bEnabled)
+      WelsCountMbType (pProfiler->iMbCount, P_SLICE, pCurMb);
 
     //step (8): update status and other parameters
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, pMd->iCostLuma, pSlice);
+    WelsOverlappedDeblockingMbDone (pEncCtx, pSlice, pCurMb);
 
     /*judge if all pMb in cur pSlice has been encoded*/
     ++ iNumMbCoded;
@@ -1891,6 +1933,7 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
   SDqLayer* pCurLayer   = pEncCtx->pCurDqLayer;
   SSliceCtx* pSliceCtx  = &pCurLayer->sSliceEncCtx;
   SMbCache* pMbCache    = &pSlice->sMbCacheInfo;
+  SStageProfiler* pProfiler     = &pSlice->sProfiler;
   SMB* pMbList          = pCurLayer->sMbDataP;
   SMB* pCurMb           = NULL;
   int32_t iNumMbCoded   = 0;
@@ -1908,7 +1951,6 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
   if (pEncCtx->pSvcParam->iEntropyCodingModeFlag) {
     WelsInitSliceCabac (pEncCtx, pSlice);
     sDss.iStartPos = sDss.iCurrentPos = 0;
-    sDss.pRestoreBuffer = pEncCtx->pDynamicBsBuffer[kiPartitionId];
   } else {
     sDss.iStartPos = BsGetBitsPos (pBs);
   }
@@ -1923,6 +1965,7 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
     pCurMb = &pMbList[ iCurMbIdx ];
 
     //step(1): set QP for the current MB
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInit (pEncCtx, pCurMb, pSlice);
     // if already reaches the largest number of slices, set QPs to the upper bound
     if (pSlice->bDynamicSlicingSliceSizeCtrlFlag) {
@@ -1934,12 +1977,19 @@ int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice,
     }
 
     //step (2). save some vale for future use, initial pWelsMd
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
     WelsMdIntraInit (pEncCtx, pCurMb, pMbCache, kiSliceFirstMbXY);
     WelsMdInterInit (pEncCtx, pSlice, pCurMb, kiSliceFirstMbXY);
+    WelsMdInterMotionHint (pEncCtx, pMd, pCurMb);
+    WelsMdInterEffort (pEncCtx, pMd, pSlice, pCurMb);
 
 TRY_REENCODING:
     WelsInitInterMDStruc (pCurMb, pMvdCostTable, kiMvdInterTableStride, pMd);
-    pEncCtx->pFuncList->pfInterMd (pEncCtx, pMd, pSlice, pCurMb, pMbCache);
+    if (!WelsMdInterIntraRefresh (pEncCtx, pMd, pSlice, pCurMb, pMbCache)) {
+      if (!WelsMdInterStaticPskip (pEncCtx, pMd, pSlice, pCurMb, pMbCache))
+        pEncCtx->pFuncList->pfInterMd (pEncCtx, pMd, pSlice, pCurMb, pMbCache);
+      WelsMdInterIntraRefreshCheck (pEncCtx, pMd, pCurMb, pMbCache);
+    }
     //mb_qp
 
     //step (4): save from the MD process from future use
@@ -1955,10 +2005,12 @@ TRY_REENCODING:
 
 
 
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_ENTROPY_CODING);
     iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
     if (iEncReturn == ENC_RETURN_VLCOVERFLOWFOUND  && (pCurMb->uiLumaQp < 50)) {
       pSlice->iMbSkipRun = pEncCtx->pFuncList->pfStashPopMBStatus (&sDss, pSlice);
       UpdateQpForOverflow (pCurMb, kuiChromaQpIndexOffset);
+      ProfilerSwitchStage (pProfiler, PROFILING_STAGE_MODE_DECISION);
       goto TRY_REENCODING;
     }
     if (ENC_RETURN_SUCCESS != iEncReturn)
@@ -1978,13 +2030,17 @@ TRY_REENCODING:
 
     //step (7): reconstruct current MB
     pCurMb->uiSliceIdc = kiSliceIdx;
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RECONSTRUCTION);
     OutputPMbWithoutConstructCsRsNoCopy (pEncCtx, pCurLayer, pSlice, pCurMb);
 
 #if defined(MB_TYPES_CHECK)
     WelsCountMbType (pEncCtx->sPerInfo.iMbCount, P_SLICE, pCurMb);
 #endif//MB_TYPES_CHECK
+    if (pProfiler->bEnabled)
+      WelsCountMbType (pProfiler->iMbCount, P_SLICE, pCurMb);
 
     //step (8): update status and other parameters
+    ProfilerSwitchStage (pProfiler, PROFILING_STAGE_RATE_CONTROL);
     pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, pMd->iCostLuma, pSlice);
 
     /*judge if all pMb in cur pSlice has been encoded*/
@@ -67,6 +67,10 @@ void WelsMdSpatialelInterMbIlfmdNoilp (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, S
   bool bKeepSkip = kbMbLeftAvailPskip & kbMbTopAvailPskip & kbMbTopRightAvailPskip;
   bool bSkip = false;
 
+  if (WelsMdInterForcedPskip (pEncCtx, pWelsMd, pSlice, pCurMb, pMbCache)) {
+    return;
+  }
+
   if (pEncCtx->pFuncList->pfInterMdBackgroundDecision (pEncCtx, pWelsMd, pSlice, pCurMb, pMbCache, &bKeepSkip)) {
     return;
   }
@@ -41,6 +41,7 @@
 #include "cpu_core.h"
 #include "ls_defines.h"
 #include "svc_motion_estimate.h"
+#include "sad_common.h"
 #include "wels_transpose_matrix.h"
 
 namespace WelsEnc {
@@ -72,6 +73,8 @@ static inline void MeEndIntepelSearch (SWelsME* pMe) {
 
 void WelsInitMeFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag, bool bScreenContent) {
   pFuncList->pfUpdateFMESwitch = UpdateFMESwitchNull;
+  pFuncList->pfBlockHashSearch = WelsBlockHashSearchNull;
+  pFuncList->pfBlockHash8x8 = BlockHash8x8_c;
 
   if (!bScreenContent) {
     pFuncList->pfCheckDirectionalMv = CheckDirectionalMvFalse;
@@ -120,6 +123,10 @@ void WelsInitMeFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag, bool bScre
       pFuncList->pfCalculateBlockFeatureOfFrame[0] = SumOf8x8BlockOfFrame_sse4;
       pFuncList->pfCalculateBlockFeatureOfFrame[1] = SumOf16x16BlockOfFrame_sse4;
     }
+    if (uiCpuFlag & WELS_CPU_SSE42) {
+      //for block hash
+      pFuncList->pfBlockHash8x8 = BlockHash8x8_sse42;
+    }
 #endif
 
 #if defined (HAVE_NEON)
@@ -162,45 +169,77 @@ void WelsInitMeFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag, bool bScre
 void WelsMotionEstimateSearch (SWelsFuncPtrList* pFuncList, SDqLayer* pCurDqLayer, SWelsME* pMe, SSlice* pSlice) {
   const int32_t kiStrideEnc = pCurDqLayer->iEncStride[0];
   const int32_t kiStrideRef = pCurDqLayer->pRefPic->iLineSize[0];
+  const int32_t kiLastStage = ProfilerSwitchStage (&pSlice->sProfiler, PROFILING_STAGE_ME_INTEGER);
 
   //  Step 1: Initial point prediction
   if (!WelsMotionEstimateInitialPoint (pFuncList, pMe, pSlice, kiStrideEnc, kiStrideRef)) {
-    pFuncList->pfSearchMethod[pMe->uiBlockSize] (pFuncList, pMe, pSlice, kiStrideEnc, kiStrideRef);
+    if (!pFuncList->pfBlockHashSearch (pFuncList, pMe, pSlice, kiStrideEnc, kiStrideRef))
+      pFuncList->pfSearchMethod[pMe->uiBlockSize] (pFuncList, pMe, pSlice, kiStrideEnc, kiStrideRef);
     MeEndIntepelSearch (pMe);
   }
 
   pFuncList->pfCalculateSatd (pFuncList->sSampleDealingFuncs.pfSampleSatd[pMe->uiBlockSize], pMe, kiStrideEnc,
                               kiStrideRef);
+  if (pFuncList->pfCalculateSatd == CalculateSatdCost)
+    ++ pSlice->sProfiler.iSatdCount;
+  ProfilerSwitchStage (&pSlice->sProfiler, kiLastStage);
 }
 
 void WelsMotionEstimateSearchStatic (SWelsFuncPtrList* pFuncList, SDqLayer* pCurDqLayer, SWelsME* pMe,
                                      SSlice* pLpslice) {
   const int32_t kiStrideEnc = pCurDqLayer->iEncStride[0];
   const int32_t kiStrideRef = pCurDqLayer->pRefPic->iLineSize[0];
+  const int32_t kiLastStage = ProfilerSwitchStage (&pLpslice->sProfiler, PROFILING_STAGE_ME_INTEGER);
 
   pMe->sMv.iMvX = pMe->sMv.iMvY = 0;
   pMe->uiSadCost =
     pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize] (pMe->pEncMb, kiStrideEnc, pMe->pRefMb, kiStrideRef) ;
   pMe->uiSadCost += COST_MVD (pMe->pMvdCost, - pMe->sMvp.iMvX, - pMe->sMvp.iMvY);
+  ++ pLpslice->sProfiler.iSadCount;
   MeEndIntepelSearch (pMe);
   pFuncList->pfCalculateSatd (pFuncList->sSampleDealingFuncs.pfSampleSatd[pMe->uiBlockSize], pMe, kiStrideEnc,
                               kiStrideRef);
+  if (pFuncList->pfCalculateSatd == CalculateSatdCost)
+    ++ pLpslice->sProfiler.iSatdCount;
+  ProfilerSwitchStage (&pLpslice->sProfiler, kiLastStage);
 }
 
 void WelsMotionEstimateSearchScrolled (SWelsFuncPtrList* pFuncList, SDqLayer* pCurDqLayer, SWelsME* pMe,
                                        SSlice* pSlice) {
   const int32_t kiStrideEnc = pCurDqLayer->iEncStride[0];
   const int32_t kiStrideRef = pCurDqLayer->pRefPic->iLineSize[0];
+  const int32_t kiLastStage = ProfilerSwitchStage (&pSlice->sProfiler, PROFILING_STAGE_ME_INTEGER);
 
   pMe->sMv = pMe->sDirectionalMv;
   pMe->pRefMb = pMe->pColoRefMb + pMe->sMv.iMvY * kiStrideRef + pMe->sMv.iMvX;
   pMe->uiSadCost =
     pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize] (pMe->pEncMb, kiStrideEnc, pMe->pRefMb, kiStrideRef)
     + COST_MVD (pMe->pMvdCost, (pMe->sMv.iMvX * (1 << 2)) - pMe->sMvp.iMvX, (pMe->sMv.iMvY * (1 << 2)) - pMe->sMvp.iMvY);
+  ++ pSlice->sProfiler.iSadCount;
   MeEndIntepelSearch (pMe);
   pFuncList->pfCalculateSatd (pFuncList->sSampleDealingFuncs.pfSampleSatd[pMe->uiBlockSize], pMe, kiStrideEnc,
                               kiStrideRef);
+  if (pFuncList->pfCalculateSatd == CalculateSatdCost)
+    ++ pSlice->sProfiler.iSatdCount;
+  ProfilerSwitchStage (&pSlice->sProfiler, kiLastStage);
 }
+/*!
+ * \brief  SADs of the candidates with their MVD cost, through the single block SAD without a batched kernel
+ *          iNum is at least 1, as for the batched kernels
+ */
+static inline void SampleSadCandidates (PSampleSadMultiCostFunc pSadMulti, PSampleSadSatdCostFunc pSad, uint8_t* pEnc,
+                                        int32_t iStrideEnc, uint8_t** ppRef, int32_t iStrideRef,
+                                        const uint16_t* pBaseCost, int32_t iNum, int32_t* pCost) {
+  if (NULL != pSadMulti) {
+    pSadMulti (pEnc, iStrideEnc, ppRef, iStrideRef, pBaseCost, iNum, pCost);
+    return;
+  }
+  int32_t n = 0;
+  do {
+    pCost[n] = pBaseCost[n] + pSad (pEnc, iStrideEnc, ppRef[n], iStrideRef);
+  } while (++ n < iNum);
+}
+
 /*!
  * \brief  EL mb motion estimate initial point testing
  *
@@ -214,50 +253,70 @@ void WelsMotionEstimateSearchScrolled (SWelsFuncPtrList* pFuncList, SDqLayer* pC
 bool WelsMotionEstimateInitialPoint (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice, int32_t iStrideEnc,
                                      int32_t iStrideRef) {
   PSampleSadSatdCostFunc pSad    = pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize];
+  PSampleSadMultiCostFunc pSadMulti = pFuncList->sSampleDealingFuncs.pfSampleSadMulti[pMe->uiBlockSize];
   const uint16_t* kpMvdCost  = pMe->pMvdCost;
   uint8_t* const kpEncMb    = pMe->pEncMb;
   int16_t iMvc0, iMvc1;
   int32_t iSadCost;
   int32_t iBestSadCost;
   uint8_t* pRefMb;
-  uint8_t* pFref2;
-  uint32_t i;
+  uint32_t i, j;
   const uint32_t kuiMvcNum    = pSlice->uiMvcNum;
   const SMVUnitXY* kpMvcList  = &pSlice->sMvc[0];
   const SMVUnitXY ksMvStartMin    = pSlice->sMvStartMin;
   const SMVUnitXY ksMvStartMax    = pSlice->sMvStartMax;
   const SMVUnitXY ksMvp    = pMe->sMvp;
   SMVUnitXY sMv;
+  // the predicted MV and the distinct candidates are scored in one call
+  SMVUnitXY sCandMv[SAD_MULTI_MAX_CANDIDATE];
+  uint8_t* pCandRef[SAD_MULTI_MAX_CANDIDATE];
+  ENFORCE_STACK_ALIGN_1D (uint16_t, uiCandMvdCost, SAD_MULTI_MAX_CANDIDATE, 16)
+  ENFORCE_STACK_ALIGN_1D (int32_t, iCandCost, SAD_MULTI_MAX_CANDIDATE, 16)
+  uint32_t uiCandNum = 0;
 
   //  Step 1: Initial point prediction
   // init with sMvp
   sMv.iMvX  = WELS_CLIP3 ((2 + ksMvp.iMvX) >> 2, ksMvStartMin.iMvX, ksMvStartMax.iMvX);
   sMv.iMvY  = WELS_CLIP3 ((2 + ksMvp.iMvY) >> 2, ksMvStartMin.iMvY, ksMvStartMax.iMvY);
 
-  pRefMb = &pMe->pRefMb[sMv.iMvY * iStrideRef + sMv.iMvX];
-
-  iBestSadCost = pSad (kpEncMb, iStrideEnc, pRefMb, iStrideRef);
-  iBestSadCost += COST_MVD (kpMvdCost, ((sMv.iMvX) * (1 << 2)) - ksMvp.iMvX, ((sMv.iMvY) * (1 << 2)) - ksMvp.iMvY);
+  sCandMv[uiCandNum]       = sMv;
+  pCandRef[uiCandNum]      = &pMe->pRefMb[sMv.iMvY * iStrideRef + sMv.iMvX];
+  uiCandMvdCost[uiCandNum] = COST_MVD (kpMvdCost, ((sMv.iMvX) * (1 << 2)) - ksMvp.iMvX,
+                                       ((sMv.iMvY) * (1 << 2)) - ksMvp.iMvY);
+  ++ uiCandNum;
 
   for (i = 0; i < kuiMvcNum; i++) {
     //clipping here is essential since some pOut-of-range MVC may happen here (i.e., refer to baseMV)
     iMvc0 = WELS_CLIP3 ((2 + kpMvcList[i].iMvX) >> 2, ksMvStartMin.iMvX, ksMvStartMax.iMvX);
     iMvc1 = WELS_CLIP3 ((2 + kpMvcList[i].iMvY) >> 2, ksMvStartMin.iMvY, ksMvStartMax.iMvY);
 
-    if (((iMvc0 - sMv.iMvX) || (iMvc1 - sMv.iMvY))) {
-      pFref2 = &pMe->pRefMb[iMvc1 * iStrideRef + iMvc0];
-
-      iSadCost = pSad (kpEncMb, iStrideEnc, pFref2, iStrideRef) +
-                 COST_MVD (kpMvdCost, (iMvc0 * (1 << 2)) - ksMvp.iMvX, (iMvc1 * (1 << 2)) - ksMvp.iMvY);
+    for (j = 0; j < uiCandNum; j++) {
+      if (iMvc0 == sCandMv[j].iMvX && iMvc1 == sCandMv[j].iMvY)
+        break;
+    }
+    if (j == uiCandNum) {
+      sCandMv[uiCandNum].iMvX  = iMvc0;
+      sCandMv[uiCandNum].iMvY  = iMvc1;
+      pCandRef[uiCandNum]      = &pMe->pRefMb[iMvc1 * iStrideRef + iMvc0];
+      uiCandMvdCost[uiCandNum] = COST_MVD (kpMvdCost, (iMvc0 * (1 << 2)) - ksMvp.iMvX, (iMvc1 * (1 << 2)) - ksMvp.iMvY);
+      ++ uiCandNum;
+    }
+  }
 
-      if (iSadCost < iBestSadCost) {
-        sMv.iMvX = iMvc0;
-        sMv.iMvY = iMvc1;
-        pRefMb = pFref2;
-        iBestSadCost = iSadCost;
-      }
+  SampleSadCandidates (pSadMulti, pSad, kpEncMb, iStrideEnc, pCandRef, iStrideRef, uiCandMvdCost, uiCandNum, iCandCost);
+  pSlice->sProfiler.iSadCount += uiCandNum;
+
+  // the first candidate of the lowest cost wins, as with the sequential checking
+  iBestSadCost = iCandCost[0];
+  pRefMb = pCandRef[0];
+  for (i = 1; i < uiCandNum; i++) {
+    if (iCandCost[i] < iBestSadCost) {
+      sMv = sCandMv[i];
+      pRefMb = pCandRef[i];
+      iBestSadCost = iCandCost[i];
     }
   }
+  iSadCost = iBestSadCost;
 
   if (pFuncList->pfCheckDirectionalMv
       (pSad, pMe, ksMvStartMin, ksMvStartMax, iStrideEnc, iStrideRef, iSadCost)) {
@@ -350,6 +409,7 @@ void WelsDiamondSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlic
     if (!CheckMvInRange (pMe->sMv, ksMvStartMin, ksMvStartMax))
       continue;
     pSad (kpEncMb, kiStrideEnc, pRefMb, kiStrideRef, &iSadCosts[0]);
+    pSlice->sProfiler.iSadCount += 4;
 
     int32_t iX, iY;
 
@@ -562,6 +622,7 @@ void LineFullSearch_c (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
                        const int32_t kiEncStride, const int32_t kiRefStride,
                        const int16_t iMinMv, const int16_t iMaxMv,
                        const bool bVerticalSearch) {
+  PSampleSadMultiCostFunc pSadMulti = pFuncList->sSampleDealingFuncs.pfSampleSadMulti[pMe->uiBlockSize];
   PSampleSadSatdCostFunc pSad = pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize];
   const int32_t kiCurMeBlockPixX = pMe->iCurMeBlockPixX;
   const int32_t kiCurMeBlockPixY = pMe->iCurMeBlockPixY;
@@ -589,16 +650,26 @@ void LineFullSearch_c (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
   uint8_t* pRef            = &pMe->pColoRefMb[ iMinMv * iStride];
   uint32_t uiBestCost    = 0xFFFFFFFF;
   int32_t iBestPos       = 0;
-
-  for (int32_t iTargetPos = iMinPos; iTargetPos < iMaxPos; ++ iTargetPos) {
-    uint8_t* const kpEncMb  = pMe->pEncMb;
-    uint32_t uiSadCost = pSad (kpEncMb, kiEncStride, pRef, kiRefStride) + (iFixedMvd + *pMvdCost);
-    if (uiSadCost < uiBestCost) {
-      uiBestCost  = uiSadCost;
-      iBestPos  = iTargetPos;
+  uint8_t* pCandRef[SAD_MULTI_MAX_CANDIDATE];
+  ENFORCE_STACK_ALIGN_1D (uint16_t, uiCandMvdCost, SAD_MULTI_MAX_CANDIDATE, 16)
+  ENFORCE_STACK_ALIGN_1D (int32_t, iCandCost, SAD_MULTI_MAX_CANDIDATE, 16)
+
+  for (int32_t iTargetPos = iMinPos; iTargetPos < iMaxPos; iTargetPos += SAD_MULTI_MAX_CANDIDATE) {
+    const int32_t kiCandNum = WELS_MIN (iMaxPos - iTargetPos, SAD_MULTI_MAX_CANDIDATE);
+    for (int32_t i = 0; i < kiCandNum; i++) {
+      pCandRef[i] = pRef;
+      uiCandMvdCost[i] = iFixedMvd + *pMvdCost;
+      pRef += iStride;
+      pMvdCost += 4;
+    }
+    SampleSadCandidates (pSadMulti, pSad, pMe->pEncMb, kiEncStride, pCandRef, kiRefStride, uiCandMvdCost, kiCandNum,
+                         iCandCost);
+    for (int32_t i = 0; i < kiCandNum; i++) {
+      if (static_cast<uint32_t> (iCandCost[i]) < uiBestCost) {
+        uiBestCost  = iCandCost[i];
+        iBestPos  = iTargetPos + i;
+      }
     }
-    pRef += iStride;
-    pMvdCost += 4;
   }
 
   if (uiBestCost < pMe->uiSadCost) {
@@ -672,6 +743,220 @@ int32_t ReleaseFeatureSearchPreparation (CMemoryAlign* pMa, uint16_t*& pFeatureO
   return ENC_RETURN_UNEXPECTED;
 }
 
+/////////////////////////
+// Hierarchical ME
+/////////////////////////
+#define ME_PYRAMID_COARSE_RANGE (8) // in pixels of the coarsest level, i.e. +-32 pixels of the layer
+
+int32_t RequestMePyramid (CMemoryAlign* pMa, const int32_t kiMbWidth, const int32_t kiMbHeight,
+                          SMePyramid** ppMePyramid) {
+  SMePyramid* pMePyramid = static_cast<SMePyramid*> (pMa->WelsMallocz (sizeof (SMePyramid), "pMePyramid"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pMePyramid)
+  *ppMePyramid = pMePyramid;
+
+  for (int32_t i = 0; i < 2; i++) {
+    pMePyramid->iWidth[i]  = kiMbWidth  << (3 - i);
+    pMePyramid->iHeight[i] = kiMbHeight << (3 - i);
+    const int32_t kiPlaneSize = pMePyramid->iWidth[i] * pMePyramid->iHeight[i];
+    pMePyramid->pCur[i] = static_cast<uint8_t*> (pMa->WelsMalloc (kiPlaneSize, "pMePyramid->pCur"));
+    pMePyramid->pRef[i] = static_cast<uint8_t*> (pMa->WelsMalloc (kiPlaneSize, "pMePyramid->pRef"));
+    WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pMePyramid->pCur[i] || NULL == pMePyramid->pRef[i])
+  }
+  const int32_t kiMbMvSize = kiMbWidth * kiMbHeight * sizeof (SMVUnitXY);
+  pMePyramid->pCoarseMv = static_cast<SMVUnitXY*> (pMa->WelsMallocz (kiMbMvSize, "pMePyramid->pCoarseMv"));
+  pMePyramid->pMbMv     = static_cast<SMVUnitXY*> (pMa->WelsMallocz (kiMbMvSize, "pMePyramid->pMbMv"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pMePyramid->pCoarseMv || NULL == pMePyramid->pMbMv)
+  pMePyramid->bMbMvValid = false;
+
+  return ENC_RETURN_SUCCESS;
+}
+
+void ReleaseMePyramid (CMemoryAlign* pMa, SMePyramid** ppMePyramid) {
+  SMePyramid* pMePyramid = *ppMePyramid;
+  if (NULL == pMePyramid)
+    return;
+  for (int32_t i = 0; i < 2; i++) {
+    if (pMePyramid->pCur[i])
+      pMa->WelsFree (pMePyramid->pCur[i], "pMePyramid->pCur");
+    if (pMePyramid->pRef[i])
+      pMa->WelsFree (pMePyramid->pRef[i], "pMePyramid->pRef");
+  }
+  if (pMePyramid->pCoarseMv)
+    pMa->WelsFree (pMePyramid->pCoarseMv, "pMePyramid->pCoarseMv");
+  if (pMePyramid->pMbMv)
+    pMa->WelsFree (pMePyramid->pMbMv, "pMePyramid->pMbMv");
+  pMa->WelsFree (pMePyramid, "pMePyramid");
+  *ppMePyramid = NULL;
+}
+
+static void MePyramidHalfAverage (uint8_t* pDst, const int32_t kiDstWidth, const int32_t kiDstHeight,
+                                  const uint8_t* pSrc, const int32_t kiSrcStride) {
+  for (int32_t j = 0; j < kiDstHeight; j++) {
+    const uint8_t* pSrc1 = pSrc + kiSrcStride;
+    for (int32_t i = 0; i < kiDstWidth; i++) {
+      const int32_t kiX = i << 1;
+      pDst[i] = (pSrc[kiX] + pSrc[kiX + 1] + pSrc1[kiX] + pSrc1[kiX + 1] + 2) >> 2;
+    }
+    pDst += kiDstWidth;
+    pSrc += kiSrcStride << 1;
+  }
+}
+
+/*!
+ * \brief   evaluate one candidate of a pyramid level, the cost is the SAD plus the length of the MV
+ *          so that flat areas keep short vectors
+ */
+static inline void MePyramidCheckPoint (PSampleSadSatdCostFunc pSad, uint8_t* pCur, uint8_t* pRef,
+                                        const int32_t kiStride, const int32_t kiMvX, const int32_t kiMvY,
+                                        const SMVUnitXY& kMvMin, const SMVUnitXY& kMvMax,
+                                        SMVUnitXY* pBestMv, int32_t* pBestCost, int64_t* pSadCount) {
+  if (kiMvX < kMvMin.iMvX || kiMvX > kMvMax.iMvX || kiMvY < kMvMin.iMvY || kiMvY > kMvMax.iMvY)
+    return;
+  if (kiMvX == pBestMv->iMvX && kiMvY == pBestMv->iMvY && *pBestCost != INT_MAX)
+    return;
+  const int32_t kiCost = pSad (pCur, kiStride, pRef + kiMvY * kiStride + kiMvX, kiStride)
+                         + WELS_ABS (kiMvX) + WELS_ABS (kiMvY);
+  ++ (*pSadCount);
+  if (kiCost < *pBestCost) {
+    *pBestCost = kiCost;
+    pBestMv->iMvX = kiMvX;
+    pBestMv->iMvY = kiMvY;
+  }
+}
+
+static inline void MePyramidRefine (PSampleSadSatdCostFunc pSad, uint8_t* pCur, uint8_t* pRef,
+                                    const int32_t kiStride, const SMVUnitXY& kMvMin, const SMVUnitXY& kMvMax,
+                                    SMVUnitXY* pBestMv, int32_t* pBestCost, int64_t* pSadCount) {
+  const SMVUnitXY kCenter = *pBestMv;
+  for (int32_t iDy = -1; iDy <= 1; iDy++) {
+    for (int32_t iDx = -1; iDx <= 1; iDx++) {
+      MePyramidCheckPoint (pSad, pCur, pRef, kiStride, kCenter.iMvX + iDx, kCenter.iMvY + iDy, kMvMin, kMvMax,
+                           pBestMv, pBestCost, pSadCount);
+    }
+  }
+}
+
+/*!
+ * \brief   evaluate a row of the sparse search of the coarsest level in one batch
+ */
+static inline void MePyramidCheckRow (PSampleSadMultiCostFunc pSadMulti, PSampleSadSatdCostFunc pSad,
+                                      uint8_t* pCur, uint8_t* pRef, const int32_t kiStride, const int32_t kiMvY,
+                                      const SMVUnitXY& kMvMin, const SMVUnitXY& kMvMax,
+                                      SMVUnitXY* pBestMv, int32_t* pBestCost, int64_t* pSadCount) {
+  uint8_t* pCandRef[SAD_MULTI_MAX_CANDIDATE];
+  int16_t iCandMvX[SAD_MULTI_MAX_CANDIDATE];
+  ENFORCE_STACK_ALIGN_1D (uint16_t, uiCandMvCost, SAD_MULTI_MAX_CANDIDATE, 16)
+  ENFORCE_STACK_ALIGN_1D (int32_t, iCandCost, SAD_MULTI_MAX_CANDIDATE, 16)
+  int32_t iCandNum = 0;
+
+  if (kiMvY < kMvMin.iMvY || kiMvY > kMvMax.iMvY)
+    return;
+  for (int32_t iMvX = -ME_PYRAMID_COARSE_RANGE; iMvX <= ME_PYRAMID_COARSE_RANGE; iMvX += 2) {
+    if (iMvX < kMvMin.iMvX || iMvX > kMvMax.iMvX)
+      continue;
+    iCandMvX[iCandNum] = iMvX;
+    pCandRef[iCandNum] = pRef + kiMvY * kiStride + iMvX;
+    uiCandMvCost[iCandNum] = WELS_ABS (iMvX) + WELS_ABS (kiMvY);
+    ++ iCandNum;
+  }
+  if (0 == iCandNum)
+    return;
+  SampleSadCandidates (pSadMulti, pSad, pCur, kiStride, pCandRef, kiStride, uiCandMvCost, iCandNum, iCandCost);
+  *pSadCount += iCandNum;
+  for (int32_t i = 0; i < iCandNum; i++) {
+    if (iCandCost[i] < *pBestCost) {
+      *pBestCost = iCandCost[i];
+      pBestMv->iMvX = iCandMvX[i];
+      pBestMv->iMvY = kiMvY;
+    }
+  }
+}
+
+/*!
+ * \brief   coarse-to-fine search of one 16x16 MV per MB against the first reference of the layer
+ *          the coarsest level (1/16 of the area) takes a sparse full search plus the neighbouring MVs,
+ *          the 1/4 level refines it, and the result seeds the diamond search of WelsMdP16x16()
+ */
+void PerformMePyramidSearch (SWelsFuncPtrList* pFunc, SDqLayer* pCurLayer, SStageProfiler* pProfiler) {
+  SMePyramid* pMePyramid = pCurLayer->pMePyramid;
+  SPicture* pRefPic = pCurLayer->pRefPic;
+  const int32_t kiMbWidth  = pCurLayer->iMbWidth;
+  const int32_t kiMbHeight = pCurLayer->iMbHeight;
+  PSampleSadSatdCostFunc pSad4x4 = pFunc->sSampleDealingFuncs.pfSampleSad[BLOCK_4x4];
+  PSampleSadSatdCostFunc pSad8x8 = pFunc->sSampleDealingFuncs.pfSampleSad[BLOCK_8x8];
+  PSampleSadMultiCostFunc pSadMulti4x4 = pFunc->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4];
+  int64_t* pSadCount = &pProfiler->iSadCount;
+
+  MePyramidHalfAverage (pMePyramid->pCur[0], pMePyramid->iWidth[0], pMePyramid->iHeight[0],
+                        pCurLayer->pEncData[0], pCurLayer->iEncStride[0]);
+  MePyramidHalfAverage (pMePyramid->pRef[0], pMePyramid->iWidth[0], pMePyramid->iHeight[0],
+                        pRefPic->pData[0], pRefPic->iLineSize[0]);
+  MePyramidHalfAverage (pMePyramid->pCur[1], pMePyramid->iWidth[1], pMePyramid->iHeight[1],
+                        pMePyramid->pCur[0], pMePyramid->iWidth[0]);
+  MePyramidHalfAverage (pMePyramid->pRef[1], pMePyramid->iWidth[1], pMePyramid->iHeight[1],
+                        pMePyramid->pRef[0], pMePyramid->iWidth[0]);
+
+  for (int32_t iMbY = 0; iMbY < kiMbHeight; iMbY++) {
+    for (int32_t iMbX = 0; iMbX < kiMbWidth; iMbX++) {
+      const int32_t kiMbXY = iMbY * kiMbWidth + iMbX;
+      SMVUnitXY sMvMin, sMvMax, sBestMv;
+      int32_t iBestCost;
+
+      // 1/16 level, 4x4 block
+      int32_t iStride = pMePyramid->iWidth[1];
+      int32_t iOffset = (iMbY << 2) * iStride + (iMbX << 2);
+      uint8_t* pCur = pMePyramid->pCur[1] + iOffset;
+      uint8_t* pRef = pMePyramid->pRef[1] + iOffset;
+      sMvMin.iMvX = WELS_MAX (- (iMbX << 2), -ME_PYRAMID_COARSE_RANGE);
+      sMvMin.iMvY = WELS_MAX (- (iMbY << 2), -ME_PYRAMID_COARSE_RANGE);
+      sMvMax.iMvX = WELS_MIN ((kiMbWidth - 1 - iMbX) << 2, ME_PYRAMID_COARSE_RANGE);
+      sMvMax.iMvY = WELS_MIN ((kiMbHeight - 1 - iMbY) << 2, ME_PYRAMID_COARSE_RANGE);
+
+      sBestMv.iMvX = sBestMv.iMvY = 0;
+      iBestCost = INT_MAX;
+      MePyramidCheckPoint (pSad4x4, pCur, pRef, iStride, 0, 0, sMvMin, sMvMax, &sBestMv, &iBestCost, pSadCount);
+      for (int32_t iMvY = -ME_PYRAMID_COARSE_RANGE; iMvY <= ME_PYRAMID_COARSE_RANGE; iMvY += 2) {
+        MePyramidCheckRow (pSadMulti4x4, pSad4x4, pCur, pRef, iStride, iMvY, sMvMin, sMvMax, &sBestMv, &iBestCost,
+                           pSadCount);
+      }
+      if (iMbX > 0) {
+        const SMVUnitXY kLeftMv = pMePyramid->pCoarseMv[kiMbXY - 1];
+        MePyramidCheckPoint (pSad4x4, pCur, pRef, iStride, kLeftMv.iMvX, kLeftMv.iMvY, sMvMin, sMvMax,
+                             &sBestMv, &iBestCost, pSadCount);
+      }
+      if (iMbY > 0) {
+        const SMVUnitXY kTopMv = pMePyramid->pCoarseMv[kiMbXY - kiMbWidth];
+        MePyramidCheckPoint (pSad4x4, pCur, pRef, iStride, kTopMv.iMvX, kTopMv.iMvY, sMvMin, sMvMax,
+                             &sBestMv, &iBestCost, pSadCount);
+      }
+      MePyramidRefine (pSad4x4, pCur, pRef, iStride, sMvMin, sMvMax, &sBestMv, &iBestCost, pSadCount);
+      pMePyramid->pCoarseMv[kiMbXY] = sBestMv;
+
+      // 1/4 level, 8x8 block
+      iStride = pMePyramid->iWidth[0];
+      iOffset = (iMbY << 3) * iStride + (iMbX << 3);
+      pCur = pMePyramid->pCur[0] + iOffset;
+      pRef = pMePyramid->pRef[0] + iOffset;
+      sMvMin.iMvX = - (iMbX << 3);
+      sMvMin.iMvY = - (iMbY << 3);
+      sMvMax.iMvX = (kiMbWidth - 1 - iMbX) << 3;
+      sMvMax.iMvY = (kiMbHeight - 1 - iMbY) << 3;
+
+      sBestMv.iMvX <<= 1;
+      sBestMv.iMvY <<= 1;
+      iBestCost = INT_MAX;
+      MePyramidCheckPoint (pSad8x8, pCur, pRef, iStride, sBestMv.iMvX, sBestMv.iMvY, sMvMin, sMvMax,
+                           &sBestMv, &iBestCost, pSadCount);
+      MePyramidRefine (pSad8x8, pCur, pRef, iStride, sMvMin, sMvMax, &sBestMv, &iBestCost, pSadCount);
+
+      // to quarter pel of the layer
+      pMePyramid->pMbMv[kiMbXY].iMvX = sBestMv.iMvX * (1 << 3);
+      pMePyramid->pMbMv[kiMbXY].iMvY = sBestMv.iMvY * (1 << 3);
+    }
+  }
+  pMePyramid->bMbMvValid = true;
+}
+
 int32_t RequestScreenBlockFeatureStorage (CMemoryAlign* pMa, const int32_t kiFrameWidth,  const int32_t kiFrameHeight,
     const int32_t iNeedFeatureStorage,
     SScreenBlockFeatureStorage* pScreenBlockFeatureStorage) {
@@ -701,13 +986,13 @@ int32_t RequestScreenBlockFeatureStorage (CMemoryAlign* pMa, const int32_t kiFra
   pScreenBlockFeatureStorage->pLocationPointer = (uint16_t*)pMa->WelsMallocz (2 * kiFrameSize * sizeof (uint16_t),
       "pScreenBlockFeatureStorage->pLocationPointer");
   WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pScreenBlockFeatureStorage->pLocationPointer)
-  //  uint16_t* pFeatureValuePointerList[WELS_MAX (LIST_SIZE_SUM_16x16, LIST_SIZE_MSE_16x16)] = {0};
-  pScreenBlockFeatureStorage->pFeatureValuePointerList = (uint16_t**)pMa->WelsMallocz (WELS_MAX (LIST_SIZE_SUM_16x16,
-      LIST_SIZE_MSE_16x16) * sizeof (uint16_t*),
+  // indexed by the feature values like pTimesOfFeatureValue, so kiListSize entries rather than the largest list
+  pScreenBlockFeatureStorage->pFeatureValuePointerList = (uint16_t**)pMa->WelsMallocz (kiListSize * sizeof (uint16_t*),
       "pScreenBlockFeatureStorage->pFeatureValuePointerList");
   WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pScreenBlockFeatureStorage->pFeatureValuePointerList)
 
   pScreenBlockFeatureStorage->pFeatureOfBlockPointer = NULL;
+  pScreenBlockFeatureStorage->pHashIndex = NULL;
   pScreenBlockFeatureStorage->iIs16x16 = !bIsBlock8x8;
   pScreenBlockFeatureStorage->uiFeatureStrategyIndex = kiFeatureStrategyIndex;
   pScreenBlockFeatureStorage->iActualListSize = kiListSize;
@@ -739,11 +1024,72 @@ int32_t ReleaseScreenBlockFeatureStorage (CMemoryAlign* pMa, SScreenBlockFeature
       pScreenBlockFeatureStorage->pFeatureValuePointerList = NULL;
     }
 
+    ReleaseScreenBlockHashIndex (pMa, &pScreenBlockFeatureStorage->pHashIndex);
     return ENC_RETURN_SUCCESS;
   }
   return ENC_RETURN_UNEXPECTED;
 }
 
+// 8x8 cells covering the pixels of kiPositionNum positions of BLOCK_HASH_SIZE
+static inline int32_t BlockHashCellNum (const int32_t kiPositionNum) {
+  return (kiPositionNum + 2 * BLOCK_HASH_SIZE - 2) / BLOCK_HASH_SIZE;
+}
+
+int32_t RequestScreenBlockHashIndex (CMemoryAlign* pMa, const int32_t kiFrameWidth, const int32_t kiFrameHeight,
+                                     SScreenBlockHashIndex** ppHashIndex) {
+  SScreenBlockHashIndex* pHashIndex = static_cast<SScreenBlockHashIndex*> (pMa->WelsMallocz (sizeof (
+                                        SScreenBlockHashIndex), "pHashIndex"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pHashIndex)
+  *ppHashIndex = pHashIndex;
+
+  pHashIndex->iWidth  = WELS_MAX (kiFrameWidth - BLOCK_HASH_SIZE + 1, 1);
+  pHashIndex->iHeight = WELS_MAX (kiFrameHeight - BLOCK_HASH_SIZE + 1, 1);
+  const int32_t kiPositionNum = pHashIndex->iWidth * pHashIndex->iHeight;
+  // about four positions per bucket
+  int32_t iBucketBits = 8;
+  while (iBucketBits < BLOCK_HASH_MAX_BUCKET_BITS && (1 << (iBucketBits + 2)) < kiPositionNum)
+    ++ iBucketBits;
+  pHashIndex->iBucketBits = iBucketBits;
+
+  const int32_t kiCellNum = BlockHashCellNum (pHashIndex->iWidth) * BlockHashCellNum (pHashIndex->iHeight);
+  pHashIndex->pHash = static_cast<uint64_t*> (pMa->WelsMalloc (kiPositionNum * sizeof (uint64_t), "pHashIndex->pHash"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pHashIndex->pHash)
+  pHashIndex->pCellChanged = static_cast<uint8_t*> (pMa->WelsMalloc (kiCellNum * sizeof (uint8_t),
+                             "pHashIndex->pCellChanged"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pHashIndex->pCellChanged)
+  pHashIndex->pDirty = static_cast<uint8_t*> (pMa->WelsMalloc (pHashIndex->iWidth * sizeof (uint8_t),
+                       "pHashIndex->pDirty"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pHashIndex->pDirty)
+  pHashIndex->pBucketHead = static_cast<int32_t*> (pMa->WelsMalloc ((1 << iBucketBits) * sizeof (int32_t),
+                            "pHashIndex->pBucketHead"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pHashIndex->pBucketHead)
+  pHashIndex->pNextPosition = static_cast<int32_t*> (pMa->WelsMalloc (kiPositionNum * sizeof (int32_t),
+                              "pHashIndex->pNextPosition"));
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pHashIndex->pNextPosition)
+  WelsSetMemMultiplebytes_c (pHashIndex->uiSadCostThreshold, UINT_MAX, BLOCK_SIZE_ALL, sizeof (uint32_t));
+  pHashIndex->uiIndexSeq = 0;
+  pHashIndex->bIndexed = false;
+  return ENC_RETURN_SUCCESS;
+}
+
+void ReleaseScreenBlockHashIndex (CMemoryAlign* pMa, SScreenBlockHashIndex** ppHashIndex) {
+  SScreenBlockHashIndex* pHashIndex = *ppHashIndex;
+  if (NULL == pHashIndex)
+    return;
+  if (pHashIndex->pHash)
+    pMa->WelsFree (pHashIndex->pHash, "pHashIndex->pHash");
+  if (pHashIndex->pCellChanged)
+    pMa->WelsFree (pHashIndex->pCellChanged, "pHashIndex->pCellChanged");
+  if (pHashIndex->pDirty)
+    pMa->WelsFree (pHashIndex->pDirty, "pHashIndex->pDirty");
+  if (pHashIndex->pBucketHead)
+    pMa->WelsFree (pHashIndex->pBucketHead, "pHashIndex->pBucketHead");
+  if (pHashIndex->pNextPosition)
+    pMa->WelsFree (pHashIndex->pNextPosition, "pHashIndex->pNextPosition");
+  pMa->WelsFree (pHashIndex, "pHashIndex");
+  *ppHashIndex = NULL;
+}
+
 //preprocess related
 int32_t SumOf8x8SingleBlock_c (uint8_t* pRef, const int32_t kiRefStride) {
   int32_t iSum = 0, i;
@@ -866,6 +1212,16 @@ bool CalculateFeatureOfBlock (SWelsFuncPtrList* pFunc, SPicture* pRef,
   return true;
 }
 
+static void SetScreenSadCostThreshold (const SPicture* pRef, uint32_t* pSadCostThreshold) {
+  uint32_t uiRefPictureAvgQstepx16 = QStepx16ByQp[WelsMedian (0, pRef->iFrameAverageQp, 51)];
+  uint32_t uiSadCostThreshold16x16 = ((30 * (uiRefPictureAvgQstepx16 + 160)) >> 3);
+  pSadCostThreshold[BLOCK_16x16] = uiSadCostThreshold16x16;
+  pSadCostThreshold[BLOCK_8x8] = (uiSadCostThreshold16x16 >> 2);
+  pSadCostThreshold[BLOCK_16x8]
+    = pSadCostThreshold[BLOCK_8x16]
+      = pSadCostThreshold[BLOCK_4x4] = UINT_MAX;
+}
+
 void PerformFMEPreprocess (SWelsFuncPtrList* pFunc, SPicture* pRef, uint16_t* pFeatureOfBlock,
                            SScreenBlockFeatureStorage* pScreenBlockFeatureStorage) {
   pScreenBlockFeatureStorage->pFeatureOfBlockPointer = pFeatureOfBlock;
@@ -873,14 +1229,155 @@ void PerformFMEPreprocess (SWelsFuncPtrList* pFunc, SPicture* pRef, uint16_t* pF
       pScreenBlockFeatureStorage);
 
   if (pScreenBlockFeatureStorage->bRefBlockFeatureCalculated) {
-    uint32_t uiRefPictureAvgQstepx16 = QStepx16ByQp[WelsMedian (0, pRef->iFrameAverageQp, 51)];
-    uint32_t uiSadCostThreshold16x16 = ((30 * (uiRefPictureAvgQstepx16 + 160)) >> 3);
-    pScreenBlockFeatureStorage->uiSadCostThreshold[BLOCK_16x16] = uiSadCostThreshold16x16;
-    pScreenBlockFeatureStorage->uiSadCostThreshold[BLOCK_8x8] = (uiSadCostThreshold16x16 >> 2);
-    pScreenBlockFeatureStorage->uiSadCostThreshold[BLOCK_16x8]
-      = pScreenBlockFeatureStorage->uiSadCostThreshold[BLOCK_8x16]
-        = pScreenBlockFeatureStorage->uiSadCostThreshold[BLOCK_4x4] = UINT_MAX;
+    SetScreenSadCostThreshold (pRef, pScreenBlockFeatureStorage->uiSadCostThreshold);
+  }
+}
+
+//block hash related
+static const uint32_t g_kuiCrc32cTable[256] = { // reflected Castagnoli polynomial 0x82F63B78
+  0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c, 0x26a1e7e8, 0xd4ca64eb,
+  0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b, 0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24,
+  0x105ec76f, 0xe235446c, 0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+  0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc, 0xbc267848, 0x4e4dfb4b,
+  0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a, 0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35,
+  0xaa64d611, 0x580f5512, 0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+  0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad, 0x1642ae59, 0xe4292d5a,
+  0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a, 0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595,
+  0x417b1dbc, 0xb3109ebf, 0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+  0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f, 0xed03a29b, 0x1f682198,
+  0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927, 0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38,
+  0xdbfc821c, 0x2997011f, 0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+  0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e, 0x4767748a, 0xb50cf789,
+  0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859, 0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46,
+  0x7198540d, 0x83f3d70e, 0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+  0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de, 0xdde0eb2a, 0x2f8b6829,
+  0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c, 0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93,
+  0x082f63b7, 0xfa44e0b4, 0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+  0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b, 0xb4091bff, 0x466298fc,
+  0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c, 0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033,
+  0xa24bb5a6, 0x502036a5, 0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+  0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975, 0x0e330a81, 0xfc588982,
+  0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d, 0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622,
+  0x38cc2a06, 0xcaa7a905, 0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+  0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8, 0xe52cc12c, 0x1747422f,
+  0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff, 0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0,
+  0xd3d3e1ab, 0x21b862a8, 0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+  0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78, 0x7fab5e8c, 0x8dc0dd8f,
+  0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee, 0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1,
+  0x69e9f0d5, 0x9b8273d6, 0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+  0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69, 0xd5cf889d, 0x27a40b9e,
+  0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e, 0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+};
+
+// CRC32C of 4 rows of 8 pixels, the same as the SSE4.2 crc32 instruction, so that the hashes are equal on every cpu
+static inline uint32_t BlockHashCrc32c8x4 (const uint8_t* pSrc, const int32_t kiStride) {
+  uint32_t uiCrc = 0xFFFFFFFF;
+  for (int32_t i = 0; i < 4; i++) {
+    for (int32_t j = 0; j < BLOCK_HASH_SIZE; j++)
+      uiCrc = g_kuiCrc32cTable[ (uiCrc ^ pSrc[j]) & 0xFF] ^ (uiCrc >> 8);
+    pSrc += kiStride;
   }
+  return uiCrc;
+}
+
+void BlockHash8x8_c (const uint8_t* pSrc, const int32_t kiStride, const int32_t kiNum, uint64_t* pHash) {
+  const uint8_t* kpBottom = pSrc + 4 * kiStride;
+  for (int32_t i = 0; i < kiNum; i++) {
+    pHash[i] = ((uint64_t)BlockHashCrc32c8x4 (pSrc + i, kiStride) << 32) | BlockHashCrc32c8x4 (kpBottom + i, kiStride);
+  }
+}
+
+static inline uint32_t BlockHashBucket (const uint64_t kuiHash, const int32_t kiBucketBits) {
+  return static_cast<uint32_t> (kuiHash >> (64 - kiBucketBits));
+}
+
+/*!
+ * \brief   hash the 8x8 block at every position of the reference and chain the positions by hash
+ *          Only the positions over the 8x8 cells that differ from kpPrevIndex, the latest index of the same size, are
+ *          hashed again, the others keep its hashes. All the positions are hashed without kpPrevIndex.
+ */
+void PerformBlockHashIndex (SWelsFuncPtrList* pFunc, SPicture* pRef, SScreenBlockHashIndex* pHashIndex,
+                            const SScreenBlockHashIndex* kpPrevIndex) {
+  const uint8_t* kpRefData = pRef->pData[0];
+  const int32_t kiStride = pRef->iLineSize[0];
+  const int32_t kiWidth  = pHashIndex->iWidth;
+  const int32_t kiHeight = pHashIndex->iHeight;
+  const int32_t kiBucketBits = pHashIndex->iBucketBits;
+  const int32_t kiCellWidth = BlockHashCellNum (kiWidth);
+  const int32_t kiCellHeight = BlockHashCellNum (kiHeight);
+  PBlockHash8x8Func pfBlockHash8x8 = pFunc->pfBlockHash8x8;
+  uint64_t* pHash = pHashIndex->pHash;
+  uint8_t* pCellChanged = pHashIndex->pCellChanged;
+  uint8_t* pDirty = pHashIndex->pDirty;
+  int32_t* pBucketHead = pHashIndex->pBucketHead;
+  int32_t* pNextPosition = pHashIndex->pNextPosition;
+
+  if (NULL != kpPrevIndex && kpPrevIndex->uiIndexSeq > 0 && kpPrevIndex->iWidth == kiWidth
+      && kpPrevIndex->iHeight == kiHeight) {
+    // a cell is unchanged if the block over it, the last one clipped to the picture, keeps its hash
+    for (int32_t iCellY = 0; iCellY < kiCellHeight; iCellY++) {
+      const int32_t kiY = WELS_MIN (iCellY * BLOCK_HASH_SIZE, kiHeight - 1);
+      for (int32_t iCellX = 0; iCellX < kiCellWidth; iCellX++) {
+        const int32_t kiX = WELS_MIN (iCellX * BLOCK_HASH_SIZE, kiWidth - 1);
+        uint64_t uiHash;
+        pfBlockHash8x8 (kpRefData + kiY * kiStride + kiX, kiStride, 1, &uiHash);
+        pCellChanged[iCellY * kiCellWidth + iCellX] = (uiHash != kpPrevIndex->pHash[kiY * kiWidth + kiX]);
+      }
+    }
+    if (kpPrevIndex != pHashIndex)
+      memcpy (pHash, kpPrevIndex->pHash, kiWidth * kiHeight * sizeof (uint64_t));
+  } else {
+    memset (pCellChanged, 1, kiCellWidth * kiCellHeight * sizeof (uint8_t));
+  }
+
+  for (int32_t y = 0; y < kiHeight; y++) {
+    // the positions of the row over the changed cells, the cells of row y / 8 and (y + 7) / 8
+    memset (pDirty, 0, kiWidth * sizeof (uint8_t));
+    for (int32_t iCellY = y / BLOCK_HASH_SIZE; iCellY <= (y + BLOCK_HASH_SIZE - 1) / BLOCK_HASH_SIZE
+         && iCellY < kiCellHeight; iCellY++) {
+      const uint8_t* kpCellChanged = pCellChanged + iCellY * kiCellWidth;
+      for (int32_t iCellX = 0; iCellX < kiCellWidth; iCellX++) {
+        if (kpCellChanged[iCellX]) {
+          const int32_t kiLeft = WELS_MAX (iCellX * BLOCK_HASH_SIZE - BLOCK_HASH_SIZE + 1, 0);
+          const int32_t kiRight = WELS_MIN (iCellX * BLOCK_HASH_SIZE + BLOCK_HASH_SIZE, kiWidth);
+          if (kiLeft < kiRight)
+            memset (pDirty + kiLeft, 1, kiRight - kiLeft);
+        }
+      }
+    }
+    const uint8_t* kpRow = kpRefData + y * kiStride;
+    uint64_t* pRowHash = pHash + y * kiWidth;
+    int32_t x = 0;
+    while (x < kiWidth) {
+      if (!pDirty[x]) {
+        ++ x;
+        continue;
+      }
+      const int32_t kiRunStart = x;
+      while (x < kiWidth && pDirty[x])
+        ++ x;
+      pfBlockHash8x8 (kpRow + kiRunStart, kiStride, x - kiRunStart, pRowHash + kiRunStart);
+    }
+  }
+
+  memset (pBucketHead, 0xff, (1 << kiBucketBits) * sizeof (int32_t));
+  int32_t iPosition = 0;
+  for (int32_t y = 0; y < kiHeight; y++) {
+    for (int32_t x = 0; x < kiWidth; x++, iPosition++) {
+      const uint64_t kuiHash = pHash[iPosition];
+      // runs of equal blocks, as in flat areas, are chained once to keep the buckets short
+      if (x > 0 && kuiHash == pHash[iPosition - 1]) {
+        pNextPosition[iPosition] = -1;
+      } else {
+        const uint32_t kuiBucket = BlockHashBucket (kuiHash, kiBucketBits);
+        pNextPosition[iPosition] = pBucketHead[kuiBucket];
+        pBucketHead[kuiBucket] = iPosition;
+      }
+    }
+  }
+  SetScreenSadCostThreshold (pRef, pHashIndex->uiSadCostThreshold);
+  pHashIndex->uiIndexSeq = (NULL != kpPrevIndex ? kpPrevIndex->uiIndexSeq : 0) + 1;
+  pHashIndex->bIndexed = true;
 }
 
 //search related
@@ -1084,6 +1581,83 @@ void WelsDiamondCrossFeatureSearch (SWelsFuncPtrList* pFunc, SWelsME* pMe, SSlic
   }
 }
 
+#define BLOCK_HASH_MAX_CANDIDATE 32
+/*!
+ * \brief   look the block up in the hash index of the reference ahead of the search method, 8x8 and 16x16 blocks only
+ * \return  true if a match below the cost threshold is found, so that the search method can be skipped
+ */
+bool WelsBlockHashSearch (SWelsFuncPtrList* pFunc, SWelsME* pMe, SSlice* pSlice, const int32_t kiEncStride,
+                          const int32_t kiRefStride) {
+  SScreenBlockHashIndex* pHashIndex = pMe->pRefFeatureStorage->pHashIndex;
+  if (NULL == pHashIndex || !pHashIndex->bIndexed || pMe->uiSadCost < pHashIndex->uiSadCostThreshold[pMe->uiBlockSize])
+    return false;
+
+  const bool kbIs16x16 = (BLOCK_16x16 == pMe->uiBlockSize);
+  const int32_t kiWidth = pHashIndex->iWidth;
+  uint64_t uiHash[4] = { 0 };
+  pFunc->pfBlockHash8x8 (pMe->pEncMb, kiEncStride, 1, &uiHash[0]);
+  if (kbIs16x16) {
+    const int32_t kiBelow = BLOCK_HASH_SIZE * kiEncStride;
+    pFunc->pfBlockHash8x8 (pMe->pEncMb + BLOCK_HASH_SIZE, kiEncStride, 1, &uiHash[1]);
+    pFunc->pfBlockHash8x8 (pMe->pEncMb + kiBelow, kiEncStride, 1, &uiHash[2]);
+    pFunc->pfBlockHash8x8 (pMe->pEncMb + kiBelow + BLOCK_HASH_SIZE, kiEncStride, 1, &uiHash[3]);
+  }
+
+  PSampleSadSatdCostFunc pSad = pFunc->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize];
+  const uint64_t* kpHash = pHashIndex->pHash;
+  const int32_t* kpNextPosition = pHashIndex->pNextPosition;
+  const int32_t kiCurX = pMe->iCurMeBlockPixX;
+  const int32_t kiCurY = pMe->iCurMeBlockPixY;
+  const int32_t kiBlockExtra = kbIs16x16 ? BLOCK_HASH_SIZE : 0;
+  const SMVUnitXY ksMvMin = pSlice->sMvStartMin;
+  const SMVUnitXY ksMvMax = pSlice->sMvStartMax;
+
+  SMVUnitXY sBestMv = pMe->sMv;
+  uint32_t uiBestCost = pMe->uiSadCost;
+  uint8_t* pBestRef = pMe->pRefMb;
+  int32_t iCandidate = 0;
+  for (int32_t iPosition = pHashIndex->pBucketHead[BlockHashBucket (uiHash[0], pHashIndex->iBucketBits)];
+       iPosition >= 0 && iCandidate < BLOCK_HASH_MAX_CANDIDATE; iPosition = kpNextPosition[iPosition]) {
+    if (kpHash[iPosition] != uiHash[0])
+      continue;
+    const int32_t kiPosY = iPosition / kiWidth;
+    const int32_t kiPosX = iPosition - kiPosY * kiWidth;
+    const int32_t kiMvX = kiPosX - kiCurX;
+    const int32_t kiMvY = kiPosY - kiCurY;
+    if (kiMvX < ksMvMin.iMvX || kiMvX > ksMvMax.iMvX || kiMvY < ksMvMin.iMvY || kiMvY > ksMvMax.iMvY
+        || (kiMvX == sBestMv.iMvX && kiMvY == sBestMv.iMvY))
+      continue;
+    if (kbIs16x16) {
+      if (kiPosX + kiBlockExtra >= kiWidth || kiPosY + kiBlockExtra >= pHashIndex->iHeight)
+        continue;
+      const int32_t kiBelow = kiBlockExtra * kiWidth;
+      if (kpHash[iPosition + kiBlockExtra] != uiHash[1] || kpHash[iPosition + kiBelow] != uiHash[2]
+          || kpHash[iPosition + kiBelow + kiBlockExtra] != uiHash[3])
+        continue;
+    }
+    ++ iCandidate;
+    uint32_t uiCost = COST_MVD (pMe->pMvdCost, (kiMvX * (1 << 2)) - pMe->sMvp.iMvX, (kiMvY * (1 << 2)) - pMe->sMvp.iMvY);
+    if (uiCost >= uiBestCost)
+      continue;
+    uint8_t* pRef = pMe->pColoRefMb + kiMvX + kiMvY * kiRefStride;
+    uiCost += pSad (pMe->pEncMb, kiEncStride, pRef, kiRefStride);
+    if (uiCost < uiBestCost) {
+      sBestMv.iMvX = kiMvX;
+      sBestMv.iMvY = kiMvY;
+      uiBestCost = uiCost;
+      pBestRef = pRef;
+    }
+  }
+  pSlice->sProfiler.iSadCount += iCandidate;
+  if (uiBestCost < pMe->uiSadCost)
+    UpdateMeResults (sBestMv, uiBestCost, pBestRef, pMe);
+  return (pMe->uiSadCost < pHashIndex->uiSadCostThreshold[pMe->uiBlockSize]);
+}
+bool WelsBlockHashSearchNull (SWelsFuncPtrList* pFunc, SWelsME* pMe, SSlice* pSlice, const int32_t kiEncStride,
+                              const int32_t kiRefStride) {
+  return false;
+}
+
 
 } // namespace WelsEnc
 
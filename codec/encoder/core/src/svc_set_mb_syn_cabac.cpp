@@ -331,8 +331,7 @@ inline void WelsCabacMbMvdLx (SCabacCtx* pCabacCtx, int32_t sMvd, int32_t iCtx,
         if (i < 3)
           iCtxInc++;
       }
-      WelsCabacEncodeUeBypass (pCabacCtx, 3, iAbsMvd - 9);
-      WelsCabacEncodeBypassOne (pCabacCtx, sMvd < 0);
+      WelsCabacEncodeUeBypassSign (pCabacCtx, 3, iAbsMvd - 9, sMvd < 0);
     }
   } else {
     WelsCabacEncodeDecision (pCabacCtx, iCtx + iCtxInc, 0);
@@ -502,17 +501,19 @@ void  WelsWriteBlockResidualCabac (SMbCache* pMbCache, SMB* pCurMb, uint32_t iMb
         iCtx = iCtxLevel + 4 + WELS_MIN (5 - (eCtxBlockCat == CHROMA_DC), iNumAbsLevelGt1);
         for (i = 1; i < iPrefix; i++)
           WelsCabacEncodeDecision (pCabacCtx, iCtx, 1);
-        if (WELS_ABS (iLevel[iNonZeroIdx]) < 15)
+        if (WELS_ABS (iLevel[iNonZeroIdx]) < 15) {
           WelsCabacEncodeDecision (pCabacCtx, iCtx, 0);
-        else
-          WelsCabacEncodeUeBypass (pCabacCtx, 0, WELS_ABS (iLevel[iNonZeroIdx]) - 15);
+          WelsCabacEncodeBypassOne (pCabacCtx, iLevel[iNonZeroIdx] < 0);
+        } else {
+          WelsCabacEncodeUeBypassSign (pCabacCtx, 0, WELS_ABS (iLevel[iNonZeroIdx]) - 15, iLevel[iNonZeroIdx] < 0);
+        }
         iCtx1 = iCtxLevel;
       } else {
         iCtx = WELS_MIN (iCtxLevel + 4, iCtx1);
         WelsCabacEncodeDecision (pCabacCtx, iCtx, 0);
         iCtx1 += iNumAbsLevelGt1 == 0;
+        WelsCabacEncodeBypassOne (pCabacCtx, iLevel[iNonZeroIdx] < 0);
       }
-      WelsCabacEncodeBypassOne (pCabacCtx, iLevel[iNonZeroIdx] < 0);
     } while (iNonZeroIdx > 0);
 
   } else {
@@ -77,6 +77,15 @@ inline  void   WelsUpdateSpatialIdxMap (sWelsEncCtx* pEncCtx, const int32_t iPos
   pEncCtx->sSpatialIndexMap[iPos].iDid = iDidx;
 }
 
+static inline bool SameSharedSource (const SSharedSrcId& kId, const SPicture* kpPic) {
+  return kId.uiSeq != 0 && kId.uiSeq == kpPic->uiSrcSeq && kId.iTimeStamp == kpPic->iSrcTimeStamp;
+}
+
+static inline void KeepSharedSource (SSharedSrcId* pId, const SPicture* kpPic) {
+  pId->iTimeStamp = kpPic->iSrcTimeStamp;
+  pId->uiSeq      = kpPic->uiSrcSeq;
+}
+
 
 /***************************************************************************
 *
@@ -113,6 +122,15 @@ CWelsPreProcess::CWelsPreProcess (sWelsEncCtx* pEncCtx) {
   memset (m_pSpatialPic, 0, sizeof (m_pSpatialPic));
   memset (m_uiSpatialLayersInTemporal, 0, sizeof (m_uiSpatialLayersInTemporal));
   memset (m_uiSpatialPicNum, 0, sizeof (m_uiSpatialPicNum));
+  m_pInPlacePic = NULL;
+  m_bInPlaceUsed = false;
+  m_bLastInPlace = false;
+  memset (m_iOwnPlaneOffset, 0, sizeof (m_iOwnPlaneOffset));
+  memset (m_iOwnLineSize, 0, sizeof (m_iOwnLineSize));
+  m_pSharedOut = NULL;
+  m_pSharedIn = NULL;
+  m_bSharedIn = false;
+  m_uiSrcSeq = 0;
 }
 
 CWelsPreProcess::~CWelsPreProcess() {
@@ -120,6 +138,33 @@ CWelsPreProcess::~CWelsPreProcess() {
   WelsPreprocessDestroy();
 }
 
+EResult CWelsPreProcess::ProcessVp (int32_t iMethodIdx, SPixMap* pSrc, SPixMap* pDst) {
+  static const int8_t kiProfilingVpMethod[METHOD_MASK] = {
+    -1,                                   // METHOD_NULL
+    PROFILING_VP_COLORSPACE_CONVERT,
+    PROFILING_VP_DENOISE,
+    PROFILING_VP_SCENE_CHANGE_DETECTION,  // METHOD_SCENE_CHANGE_DETECTION_VIDEO
+    PROFILING_VP_SCENE_CHANGE_DETECTION,  // METHOD_SCENE_CHANGE_DETECTION_SCREEN
+    PROFILING_VP_DOWNSAMPLE,
+    PROFILING_VP_VAA_STATISTICS,
+    PROFILING_VP_BACKGROUND_DETECTION,
+    PROFILING_VP_ADAPTIVE_QUANT,
+    PROFILING_VP_COMPLEXITY_ANALYSIS,     // METHOD_COMPLEXITY_ANALYSIS
+    PROFILING_VP_COMPLEXITY_ANALYSIS,     // METHOD_COMPLEXITY_ANALYSIS_SCREEN
+    -1,                                   // METHOD_IMAGE_ROTATE
+    PROFILING_VP_SCROLL_DETECTION
+  };
+  SStageProfiler* pProfiler = &m_pEncCtx->sProfiler;
+  const int32_t kiVpMethod = kiProfilingVpMethod[WELS_CLIP3 (iMethodIdx, 0, METHOD_MASK - 1)];
+  if (!pProfiler->bEnabled || kiVpMethod < 0)
+    return m_pInterfaceVp->Process (iMethodIdx, pSrc, pDst);
+
+  const int64_t kiStartNs = WelsTimeNs();
+  const EResult keRet = m_pInterfaceVp->Process (iMethodIdx, pSrc, pDst);
+  pProfiler->iVpTime[kiVpMethod] += WelsTimeNs() - kiStartNs;
+  return keRet;
+}
+
 int32_t CWelsPreProcess::WelsPreprocessCreate() {
   if (m_pInterfaceVp == NULL) {
     WelsCreateVpInterface ((void**) &m_pInterfaceVp, WELSVP_INTERFACE_VERION);
@@ -174,7 +219,10 @@ int32_t CWelsPreProcess::AllocSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCoding
   do {
     const int32_t kiPicWidth = pParam->sSpatialLayers[iDlayerIndex].iVideoWidth;
     const int32_t kiPicHeight   = pParam->sSpatialLayers[iDlayerIndex].iVideoHeight;
-    const uint8_t kuiLayerInTemporal = 2 + WELS_MAX (pParam->sDependencyLayers[iDlayerIndex].iHighestTemporalId, 1);
+    // one spare picture is kept for a temporal layer added without a reset, unless the footprint is kept low
+    const uint8_t kuiLayerInTemporal = 2 + ((pParam->bLowFootprint && pParam->iUsageType != SCREEN_CONTENT_REAL_TIME) ?
+                                            pParam->sDependencyLayers[iDlayerIndex].iHighestTemporalId :
+                                            WELS_MAX (pParam->sDependencyLayers[iDlayerIndex].iHighestTemporalId, 1));
     const uint8_t kuiRefNumInTemporal = kuiLayerInTemporal + pParam->iLTRRefNum;
     uint8_t i = 0;
 
@@ -186,6 +234,14 @@ int32_t CWelsPreProcess::AllocSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCoding
       ++ i;
     } while (i < kuiRefNumInTemporal);
 
+    if (iDlayerIndex == kiDlayerCount - 1) {
+      SPicture* pPic = m_pSpatialPic[iDlayerIndex][0];
+      for (i = 0; i < 3; i++) {
+        m_iOwnPlaneOffset[i] = (int32_t) (pPic->pData[i] - pPic->pBuffer);
+        m_iOwnLineSize[i]    = pPic->iLineSize[i];
+      }
+    }
+
     if (pParam->iUsageType == SCREEN_CONTENT_REAL_TIME)
       m_uiSpatialLayersInTemporal[iDlayerIndex] = 1;
     else
@@ -213,6 +269,15 @@ void CWelsPreProcess::FreeSpatialPictures (sWelsEncCtx* pCtx) {
     m_uiSpatialLayersInTemporal[j] = 0;
     ++ j;
   }
+  if (NULL != m_pSharedOut) {
+    pMa->WelsFree (m_pSharedOut, "m_pSharedOut");
+    m_pSharedOut = NULL;
+  }
+  if (NULL != m_pSharedIn) {
+    pMa->WelsFree (m_pSharedIn, "m_pSharedIn");
+    m_pSharedIn = NULL;
+  }
+  m_bSharedIn = false;
 }
 
 int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePicture* kpSrcPic) {
@@ -242,6 +307,10 @@ int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePi
     return -1;
 
   pCtx->pVaa->bSceneChangeFlag = pCtx->pVaa->bIdrPeriodFlag = false;
+  if (0 == ++ m_uiSrcSeq)
+    m_uiSrcSeq = 1;
+  if (NULL != m_pSharedOut)
+    m_pSharedOut->bSceneChange = m_pSharedOut->bVaa = false;
 
   iSpatialNum = SingleLayerPreprocess (pCtx, kpSrcPic, &m_sScaledPicture);
 
@@ -293,16 +362,26 @@ int32_t CWelsPreProcess::AnalyzeSpatialPic (sWelsEncCtx* pCtx, const int32_t kiD
     SPicture* pRefPic = GetBestRefPic (kiDidx, iRefTemporalIdx);
     SPicture* pLastPic = m_pLastSpatialPicture[kiDidx][0];
     bool bCalculateSQDiff = ((pLastPic->pData[0] == pRefPic->pData[0]) && bNeededMbAq);
+    const bool kbDetectBGD = bCalculateBGD && pRefPic->iPictureType != I_SLICE;
+    const bool kbShared = (kiDidx == pSvcParam->iSpatialLayerNum - 1) && IsAnalysisShareable (pCtx);
+    const uint8_t kuiSharedFlags = (bCalculateSQDiff ? SHARED_VAA_SSD : 0) | (bCalculateVar ? SHARED_VAA_VAR : 0)
+                                   | (bCalculateBGD ? SHARED_VAA_BGD : 0) | (pSvcParam->bEnableBackgroundDetection ? SHARED_BGD : 0)
+                                   | (kbDetectBGD ? SHARED_BGD_DETECT : 0) | (bNeededMbAq ? SHARED_AQ : 0);
+    // the AQ compares the current picture, m_pLastSpatialPicture[kiDidx][1], with pLastPic
+    if (kbShared && TakeSharedAnalysis (pCtx, pCurPic, pRefPic, pLastPic, kuiSharedFlags))
+      return 0;
 
     VaaCalculation (pCtx->pVaa, pCurPic, pRefPic, bCalculateSQDiff, bCalculateVar, bCalculateBGD);
 
     if (pSvcParam->bEnableBackgroundDetection) {
-      BackgroundDetection (pCtx->pVaa, pCurPic, pRefPic, bCalculateBGD && pRefPic->iPictureType != I_SLICE);
+      BackgroundDetection (pCtx->pVaa, pCurPic, pRefPic, kbDetectBGD);
     }
 
     if (bNeededMbAq) {
       AdaptiveQuantCalculation (pCtx->pVaa, m_pLastSpatialPicture[kiDidx][1], m_pLastSpatialPicture[kiDidx][0]);
     }
+    if (kbShared && pSvcParam->bMotionAnalysis)
+      KeepSharedAnalysis (pCtx, pCurPic, pRefPic, pLastPic, kuiSharedFlags);
   }
   return 0;
 }
@@ -316,6 +395,9 @@ int32_t CWelsPreProcess::UpdateSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCodin
   if (pCtx->pSvcParam->iUsageType == SCREEN_CONTENT_REAL_TIME)
     return 0;
 
+  if (m_pInPlacePic)
+    ReleaseInPlaceSource (pCtx->pDecPic);
+
   WelsExchangeSpatialPictures (&m_pLastSpatialPicture[kiDidx][1], &m_pLastSpatialPicture[kiDidx][0]);
 
   const int32_t kiCurPos = GetCurPicPosition (kiDidx);
@@ -341,7 +423,7 @@ int32_t CWelsPreProcess::UpdateSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCodin
 
 /*
  *   SingleLayerPreprocess: down sampling if applicable
- *  @return: exact number of spatial layers need to encoder indeed
+ *  @return: exact number of spatial layers need to encoder indeed, -2 if the source picture can not be converted
  */
 int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSourcePicture* kpSrc,
     Scaled_Picture* pScaledPicture) {
@@ -366,7 +448,7 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
 
   iSrcWidth   = pSvcParam->SUsedPicRect.iWidth;
   iSrcHeight  = pSvcParam->SUsedPicRect.iHeight;
-  if (pSvcParam->uiIntraPeriod) {
+  if (pSvcParam->uiIntraPeriod && !WelsIntraRefreshEnabled (pSvcParam)) { // else refreshed by a sweep
     pCtx->pVaa->bIdrPeriodFlag = (1 + pDlayerParamInternal->iFrameIndex >= (int32_t)pSvcParam->uiIntraPeriod) ? true :
                                  false;
     if (pCtx->pVaa->bIdrPeriodFlag) {
@@ -380,7 +462,18 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
   pSrcPic = pScaledPicture->pScaledInputPicture ? pScaledPicture->pScaledInputPicture : GetCurrentOrigFrame (
               iDependencyId);
 
-  WelsMoveMemoryWrapper (pSvcParam, pSrcPic, kpSrc, iSrcWidth, iSrcHeight);
+  m_pInPlacePic = NULL;
+  m_bLastInPlace = IsInPlaceSourceAllowed (pCtx, kpSrc);
+  if (m_bLastInPlace) {
+    BindInPlaceSource (pSrcPic, kpSrc);
+  } else {
+    if (m_bInPlaceUsed)
+      RestoreOwnPlanes (GetCurrentOrigFrame (iDependencyId));
+    if (kpSrc->iColorFormat == videoFormatI420)
+      WelsMoveMemoryWrapper (pSvcParam, pSrcPic, kpSrc, iSrcWidth, iSrcHeight);
+    else if (ColorspaceConvert (pSvcParam, pSrcPic, kpSrc, iSrcWidth, iSrcHeight) != 0)
+      return -2; // nothing to encode, the orig frame still holds the previous picture
+  }
 
   if (pSvcParam->bEnableDenoise)
     BilateralDenoising (pSrcPic, iSrcWidth, iSrcHeight);
@@ -397,6 +490,8 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
   }
   DownsamplePadding (pSrcPic, pDstPic, iSrcWidth, iSrcHeight, iShrinkWidth, iShrinkHeight, iTargetWidth, iTargetHeight,
                      false);
+  pDstPic->iSrcTimeStamp = kpSrc->uiTimeStamp;
+  pDstPic->uiSrcSeq      = m_uiSrcSeq;
 
   if (pSvcParam->bEnableSceneChangeDetect && !pCtx->pVaa->bIdrPeriodFlag) {
     if (pSvcParam->iUsageType == SCREEN_CONTENT_REAL_TIME) {
@@ -409,8 +504,20 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
         SPicture* pRefPic = pCtx->pLtr[iDependencyId].bReceivedT0LostFlag ?
                             m_pSpatialPic[iDependencyId][m_uiSpatialLayersInTemporal[iDependencyId] +
                                 pCtx->pVaa->uiValidLongTermPicIdx] : m_pLastSpatialPicture[iDependencyId][0];
-        //pCtx->pVaa->eSceneChangeIdc = DetectSceneChange (pDstPic, pRefPic);
-        pCtx->pVaa->bSceneChangeFlag = GetSceneChangeFlag (DetectSceneChange (pDstPic, pRefPic));
+        const bool kbShareable = IsAnalysisShareable (pCtx);
+        if (kbShareable && m_bSharedIn && m_pSharedIn->bSceneChange
+            && SameSharedSource (m_pSharedIn->sSceneCur, pDstPic) && SameSharedSource (m_pSharedIn->sSceneRef, pRefPic)) {
+          pCtx->pVaa->bSceneChangeFlag = m_pSharedIn->bSceneChangeFlag;
+        } else {
+          //pCtx->pVaa->eSceneChangeIdc = DetectSceneChange (pDstPic, pRefPic);
+          pCtx->pVaa->bSceneChangeFlag = GetSceneChangeFlag (DetectSceneChange (pDstPic, pRefPic));
+        }
+        if (kbShareable && pSvcParam->bMotionAnalysis && AllocSharedAnalysis (pCtx, "m_pSharedOut") != NULL) {
+          m_pSharedOut->bSceneChange     = true;
+          m_pSharedOut->bSceneChangeFlag = pCtx->pVaa->bSceneChangeFlag;
+          KeepSharedSource (&m_pSharedOut->sSceneCur, pDstPic);
+          KeepSharedSource (&m_pSharedOut->sSceneRef, pRefPic);
+        }
       }
     }
   }
@@ -565,10 +672,88 @@ int32_t CWelsPreProcess::InitLastSpatialPictures (sWelsEncCtx* pCtx) {
 }
 //*********************************************************************************************************/
 
+/*!
+ * \brief   convert a NV12/NV21/YUY2/BGRA/RGBA source picture into the orig frame, writing straight into its padded
+ *          planes instead of going through an intermediate I420 picture
+ * \return  0 - successful; otherwise failed
+ */
 int32_t CWelsPreProcess::ColorspaceConvert (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic,
     const SSourcePicture* kpSrc, const int32_t kiWidth, const int32_t kiHeight) {
-  return 1;
-  //not support yet
+  int32_t iMethodIdx = METHOD_COLORSPACE_CONVERT;
+  int32_t iSrcWidth  = WELS_MIN (kpSrc->iPicWidth, kiWidth);
+  int32_t iSrcHeight = WELS_MIN (kpSrc->iPicHeight, kiHeight);
+  int32_t iBytesPerPixel = 1;
+  EVideoFormat eFormat = VIDEO_FORMAT_NULL;
+
+  switch (kpSrc->iColorFormat) {
+  case videoFormatNV12:
+    eFormat = VIDEO_FORMAT_NV12;
+    break;
+  case videoFormatNV21:
+    eFormat = VIDEO_FORMAT_NV21;
+    break;
+  case videoFormatYUY2:
+    eFormat = VIDEO_FORMAT_YUY2;
+    iBytesPerPixel = 2;
+    break;
+  case videoFormatBGRA:
+    eFormat = VIDEO_FORMAT_BGRA;
+    iBytesPerPixel = 4;
+    break;
+  case videoFormatRGBA:
+    eFormat = VIDEO_FORMAT_RGBA;
+    iBytesPerPixel = 4;
+    break;
+  default:
+    return 1;
+  }
+
+  iSrcWidth  &= ~1;
+  iSrcHeight &= ~1;
+  if (iSrcWidth <= 0 || iSrcHeight <= 0 || (iSrcWidth * iSrcHeight > (MAX_MBS_PER_FRAME << 8))
+      || kpSrc->pData[0] == NULL || iSrcWidth * iBytesPerPixel > kpSrc->iStride[0] || iSrcWidth > pDstPic->iLineSize[0]
+      || pSvcParam->SUsedPicRect.iTop >= iSrcHeight || pSvcParam->SUsedPicRect.iLeft >= iSrcWidth)
+    return 1;
+
+  // the cropping offsets are kept even, as the chroma of the packed formats is shared by pairs of pixels
+  const int32_t kiSrcTop  = pSvcParam->SUsedPicRect.iTop & (~1);
+  const int32_t kiSrcLeft = pSvcParam->SUsedPicRect.iLeft & (~1);
+  SPixMap sSrcPixMap;
+  SPixMap sDstPixMap;
+  memset (&sSrcPixMap, 0, sizeof (sSrcPixMap));
+  memset (&sDstPixMap, 0, sizeof (sDstPixMap));
+  sSrcPixMap.pPixel[0] = kpSrc->pData[0] + kpSrc->iStride[0] * kiSrcTop + kiSrcLeft * iBytesPerPixel;
+  if (eFormat == VIDEO_FORMAT_NV12 || eFormat == VIDEO_FORMAT_NV21) {
+    if (kpSrc->pData[1] == NULL || iSrcWidth > kpSrc->iStride[1]) // interleaved chroma, as wide as the luma
+      return 1;
+    sSrcPixMap.pPixel[1] = kpSrc->pData[1] + kpSrc->iStride[1] * (kiSrcTop >> 1) + kiSrcLeft;
+    sSrcPixMap.iStride[1] = kpSrc->iStride[1];
+  }
+  sSrcPixMap.iSizeInBits = g_kiPixMapSizeInBits;
+  sSrcPixMap.sRect.iRectWidth = iSrcWidth;
+  sSrcPixMap.sRect.iRectHeight = iSrcHeight;
+  sSrcPixMap.iStride[0] = kpSrc->iStride[0];
+  sSrcPixMap.eFormat = eFormat;
+
+  sDstPixMap.pPixel[0] = pDstPic->pData[0];
+  sDstPixMap.pPixel[1] = pDstPic->pData[1];
+  sDstPixMap.pPixel[2] = pDstPic->pData[2];
+  sDstPixMap.iSizeInBits = g_kiPixMapSizeInBits;
+  sDstPixMap.sRect.iRectWidth = iSrcWidth;
+  sDstPixMap.sRect.iRectHeight = iSrcHeight;
+  sDstPixMap.iStride[0] = pDstPic->iLineSize[0];
+  sDstPixMap.iStride[1] = pDstPic->iLineSize[1];
+  sDstPixMap.iStride[2] = pDstPic->iLineSize[2];
+  sDstPixMap.eFormat = VIDEO_FORMAT_I420;
+
+  if (ProcessVp (iMethodIdx, &sSrcPixMap, &sDstPixMap) != RET_SUCCESS)
+    return 1;
+
+  if (kiWidth > iSrcWidth || kiHeight > iSrcHeight) {
+    Padding (pDstPic->pData[0], pDstPic->pData[1], pDstPic->pData[2], pDstPic->iLineSize[0], pDstPic->iLineSize[1],
+             iSrcWidth, kiWidth, iSrcHeight, kiHeight);
+  }
+  return 0;
 }
 
 void CWelsPreProcess::BilateralDenoising (SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight) {
@@ -586,7 +771,7 @@ void CWelsPreProcess::BilateralDenoising (SPicture* pSrc, const int32_t kiWidth,
   sSrcPixMap.iStride[2] = pSrc->iLineSize[2];
   sSrcPixMap.eFormat = VIDEO_FORMAT_I420;
 
-  m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, NULL);
+  ProcessVp (iMethodIdx, &sSrcPixMap, NULL);
 }
 
 ESceneChangeIdc CWelsPreProcessVideo::DetectSceneChange (SPicture* pCurPicture, SPicture* pRefPicture) {
@@ -610,7 +795,7 @@ ESceneChangeIdc CWelsPreProcessVideo::DetectSceneChange (SPicture* pCurPicture,
   sRefPixMap.sRect.iRectHeight = pRefPicture->iHeightInPixel;
   sRefPixMap.eFormat = VIDEO_FORMAT_I420;
 
-  int32_t iRet = m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
+  int32_t iRet = ProcessVp (iMethodIdx, &sSrcPixMap, &sRefPixMap);
   if (iRet == 0) {
     m_pInterfaceVp->Get (iMethodIdx, (void*)&sSceneChangeDetectResult);
     //bSceneChangeFlag = (sSceneChangeDetectResult.eSceneChangeIdc == LARGE_CHANGED_SCENE) ? true : false;
@@ -654,7 +839,7 @@ int32_t CWelsPreProcess::DownsamplePadding (SPicture* pSrc, SPicture* pDstPic,
     sDstPicMap.eFormat     = VIDEO_FORMAT_I420;
 
     if (iSrcWidth != iShrinkWidth || iSrcHeight != iShrinkHeight) {
-      iRet = m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sDstPicMap);
+      iRet = ProcessVp (iMethodIdx, &sSrcPixMap, &sDstPicMap);
     } else {
       WelsMoveMemory_c (pDstPic->pData[0], pDstPic->pData[1], pDstPic->pData[2], pDstPic->iLineSize[0], pDstPic->iLineSize[1],
                         pSrc->pData[0], pSrc->pData[1], pSrc->pData[2], pSrc->iLineSize[0], pSrc->iLineSize[1],
@@ -706,7 +891,7 @@ void CWelsPreProcess::VaaCalculation (SVAAFrameInfo* pVaaInfo, SPicture* pCurPic
     calc_param.pCalcResult = &pVaaInfo->sVaaCalcInfo;
 
     m_pInterfaceVp->Set (iMethodIdx, &calc_param);
-    m_pInterfaceVp->Process (iMethodIdx, &sCurPixMap, &sRefPixMap);
+    ProcessVp (iMethodIdx, &sCurPixMap, &sRefPixMap);
   }
 }
 
@@ -757,7 +942,7 @@ void CWelsPreProcess::BackgroundDetection (SVAAFrameInfo* pVaaInfo, SPicture* pC
     BGDParam.pBackgroundMbFlag = pVaaInfo->pVaaBackgroundMbFlag;
     BGDParam.pCalcRes = & (pVaaInfo->sVaaCalcInfo);
     m_pInterfaceVp->Set (iMethodIdx, (void*)&BGDParam);
-    m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
+    ProcessVp (iMethodIdx, &sSrcPixMap, &sRefPixMap);
   } else {
     int32_t iPicWidthInMb  = (pCurPicture->iWidthInPixel  + 15) >> 4;
     int32_t iPicHeightInMb = (pCurPicture->iHeightInPixel + 15) >> 4;
@@ -792,7 +977,7 @@ void CWelsPreProcess::AdaptiveQuantCalculation (SVAAFrameInfo* pVaaInfo, SPictur
     pRef.eFormat = VIDEO_FORMAT_I420;
 
     iRet = m_pInterfaceVp->Set (iMethodIdx, (void*) & (pVaaInfo->sAdaptiveQuantParam));
-    iRet = m_pInterfaceVp->Process (iMethodIdx, &pSrc, &pRef);
+    iRet = ProcessVp (iMethodIdx, &pSrc, &pRef);
     if (iRet == 0)
       m_pInterfaceVp->Get (iMethodIdx, (void*) & (pVaaInfo->sAdaptiveQuantParam));
   }
@@ -878,7 +1063,7 @@ void CWelsPreProcess::AnalyzePictureComplexity (sWelsEncCtx* pCtx, SPicture* pCu
     }
 
     iRet = m_pInterfaceVp->Set (iMethodIdx, (void*)sComplexityAnalysisParam);
-    iRet = m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
+    iRet = ProcessVp (iMethodIdx, &sSrcPixMap, &sRefPixMap);
     if (iRet == 0)
       m_pInterfaceVp->Get (iMethodIdx, (void*)sComplexityAnalysisParam);
 
@@ -940,7 +1125,7 @@ void CWelsPreProcess::AnalyzePictureComplexity (sWelsEncCtx* pCtx, SPicture* pCu
       sRefPixMap.eFormat = VIDEO_FORMAT_I420;
 
       iRet = m_pInterfaceVp->Set (iMethodIdx, (void*)sComplexityAnalysisParam);
-      iRet = m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
+      iRet = ProcessVp (iMethodIdx, &sSrcPixMap, &sRefPixMap);
       if (iRet == 0)
         m_pInterfaceVp->Get (iMethodIdx, (void*)sComplexityAnalysisParam);
     }
@@ -1173,7 +1358,7 @@ ESceneChangeIdc CWelsPreProcessScreen::DetectSceneChange (SPicture* pCurPicture,
       int32_t iMethodIdx = METHOD_SCROLL_DETECTION;
 
       m_pInterfaceVp->Set (iMethodIdx, (void*) (pScrollDetectInfo));
-      ret = m_pInterfaceVp->Process (iMethodIdx, &sSrcMap, &sRefMap);
+      ret = ProcessVp (iMethodIdx, &sSrcMap, &sRefMap);
 
       if (ret == 0) {
         m_pInterfaceVp->Get (iMethodIdx, (void*) (pScrollDetectInfo));
@@ -1182,7 +1367,7 @@ ESceneChangeIdc CWelsPreProcessScreen::DetectSceneChange (SPicture* pCurPicture,
     }
 
     m_pInterfaceVp->Set (iSceneChangeMethodIdx, (void*) (&sSceneChangeResult));
-    ret = m_pInterfaceVp->Process (iSceneChangeMethodIdx, &sSrcMap, &sRefMap);
+    ret = ProcessVp (iSceneChangeMethodIdx, &sSrcMap, &sRefMap);
 
     if (ret == 0) {
       m_pInterfaceVp->Get (iSceneChangeMethodIdx, (void*)&sSceneChangeResult);
@@ -1287,7 +1472,7 @@ int32_t CWelsPreProcess::UpdateBlockIdcForScreen (uint8_t*  pCurBlockStaticPoint
   InitPixMap (kpRefPic, &sRefMap);
 
   m_pInterfaceVp->Set (iSceneChangeMethodIdx, (void*) (&sSceneChangeResult));
-  int32_t iRet = m_pInterfaceVp->Process (iSceneChangeMethodIdx, &sSrcMap, &sRefMap);
+  int32_t iRet = ProcessVp (iSceneChangeMethodIdx, &sSrcMap, &sRefMap);
   if (iRet == 0) {
     m_pInterfaceVp->Get (iSceneChangeMethodIdx, (void*)&sSceneChangeResult);
     return 0;
@@ -1449,6 +1634,214 @@ void  CWelsPreProcess::WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SP
 
 }
 
+/*!
+ * \brief   whether the caller planes can be used as the orig frame: the picture is taken as is (no crop, scaling,
+ *          denoising or padding) and its layout matches the reconstruction which replaces it afterwards, so that
+ *          the analysis may compare both; the history of the spatial pictures must not go beyond the previous frame
+ */
+bool CWelsPreProcess::IsInPlaceSourceAllowed (sWelsEncCtx* pCtx, const SSourcePicture* kpSrc) {
+  SWelsSvcCodingParam* pSvcParam = pCtx->pSvcParam;
+  const SSpatialLayerConfig* kpLayer = &pSvcParam->sSpatialLayers[pSvcParam->iSpatialLayerNum - 1];
+
+  if (!pSvcParam->bZeroCopyInput || pSvcParam->iSpatialLayerNum != 1
+      || pSvcParam->iUsageType == SCREEN_CONTENT_REAL_TIME || pSvcParam->bEnableDenoise
+      || pSvcParam->bEnableLongTermReference || pSvcParam->uiGopSize != 1)
+    return false;
+  if (kpSrc->iColorFormat != videoFormatI420 || m_sScaledPicture.pScaledInputPicture != NULL)
+    return false;
+  if (kpSrc->iPicWidth != kpLayer->iVideoWidth || kpSrc->iPicHeight != kpLayer->iVideoHeight
+      || (kpLayer->iVideoWidth & 0x0f) || (kpLayer->iVideoHeight & 0x0f))
+    return false;
+
+  for (int32_t i = 0; i < 3; i++) {
+    if (kpSrc->pData[i] == NULL || kpSrc->iStride[i] != m_iOwnLineSize[i] || (((intptr_t)kpSrc->pData[i]) & 0x0f))
+      return false;
+  }
+  return true;
+}
+
+void CWelsPreProcess::BindInPlaceSource (SPicture* pPic, const SSourcePicture* kpSrc) {
+  for (int32_t i = 0; i < 3; i++) {
+    pPic->pData[i]    = kpSrc->pData[i];
+    pPic->iLineSize[i] = kpSrc->iStride[i];
+  }
+  m_pInPlacePic = pPic;
+  m_bInPlaceUsed = true;
+}
+
+void CWelsPreProcess::ReleaseInPlaceSource (SPicture* pRecPic) {
+  // the reconstruction is left untouched until the next frame has been analyzed
+  for (int32_t i = 0; i < 3; i++) {
+    m_pInPlacePic->pData[i]    = pRecPic->pData[i];
+    m_pInPlacePic->iLineSize[i] = pRecPic->iLineSize[i];
+  }
+  m_pInPlacePic = NULL;
+}
+
+void CWelsPreProcess::RestoreOwnPlanes (SPicture* pPic) {
+  for (int32_t i = 0; i < 3; i++) {
+    pPic->pData[i]    = pPic->pBuffer + m_iOwnPlaneOffset[i];
+    pPic->iLineSize[i] = m_iOwnLineSize[i];
+  }
+}
+
+/*!
+ * \brief   drop the caller planes still held by the orig frame when the frame was skipped or failed before its
+ *          reconstruction took them over, the orig frame is rewritten by the next picture anyway
+ */
+void CWelsPreProcess::EndInPlaceSource () {
+  if (m_pInPlacePic) {
+    RestoreOwnPlanes (m_pInPlacePic);
+    m_pInPlacePic = NULL;
+  }
+}
+
+void CWelsPreProcess::GetInPlaceSourceInfo (int32_t iStride[3], bool* pLastInPlace) {
+  for (int32_t i = 0; i < 3; i++) {
+    iStride[i] = m_iOwnLineSize[i];
+  }
+  *pLastInPlace = m_bLastInPlace;
+}
+
+/*!
+ * \brief   results of the macroblocks in a SSharedAnalysis: SAD 8x8, SSD 16x16, sum 16x16, sum of squares 16x16,
+ *          sum of differences 8x8, MAD 8x8, background flag, motion texture unit and delta QP of the AQ
+ */
+static int32_t SharedAnalysisSize (const int32_t kiMbNum) {
+  return (int32_t)sizeof (SSharedAnalysis) + kiMbNum * (int32_t) (11 * sizeof (int32_t) + 4 * sizeof (uint8_t)
+         + 2 * sizeof (int8_t) + sizeof (SMotionTextureUnit));
+}
+
+static inline uint8_t* CopySharedResults (void* pVaaResults, uint8_t* pShared, const int32_t kiBytes, const bool kbCopy,
+    const bool kbToVaa) {
+  if (kbCopy) {
+    if (kbToVaa)
+      memcpy (pVaaResults, pShared, kiBytes);
+    else
+      memcpy (pShared, pVaaResults, kiBytes);
+  }
+  return pShared + kiBytes;
+}
+
+static void CopySharedAnalysis (SVAAFrameInfo* pVaa, SSharedAnalysis* pShared, const uint8_t kuiFlags,
+                                const bool kbToVaa) {
+  const int32_t kiMbNum = pShared->iMbWidth * pShared->iMbHeight;
+  SVAACalcResult* pCalc = &pVaa->sVaaCalcInfo;
+  SAdaptiveQuantizationParam* pAq = &pVaa->sAdaptiveQuantParam;
+  uint8_t* pResults = (uint8_t*) (pShared + 1);
+
+  pResults = CopySharedResults (pCalc->pSad8x8, pResults, kiMbNum * 4 * sizeof (int32_t), true, kbToVaa);
+  pResults = CopySharedResults (pCalc->pSsd16x16, pResults, kiMbNum * sizeof (int32_t),
+                                0 != (kuiFlags & SHARED_VAA_SSD), kbToVaa);
+  pResults = CopySharedResults (pCalc->pSum16x16, pResults, kiMbNum * sizeof (int32_t),
+                                0 != (kuiFlags & SHARED_VAA_VAR), kbToVaa);
+  pResults = CopySharedResults (pCalc->pSumOfSquare16x16, pResults, kiMbNum * sizeof (int32_t),
+                                0 != (kuiFlags & SHARED_VAA_VAR), kbToVaa);
+  pResults = CopySharedResults (pCalc->pSumOfDiff8x8, pResults, kiMbNum * 4 * sizeof (int32_t),
+                                0 != (kuiFlags & SHARED_VAA_BGD), kbToVaa);
+  pResults = CopySharedResults (pCalc->pMad8x8, pResults, kiMbNum * 4 * sizeof (uint8_t),
+                                0 != (kuiFlags & SHARED_VAA_BGD), kbToVaa);
+  pResults = CopySharedResults (pVaa->pVaaBackgroundMbFlag, pResults, kiMbNum * sizeof (int8_t),
+                                0 != (kuiFlags & SHARED_BGD), kbToVaa);
+  pResults = CopySharedResults (pAq->pMotionTextureUnit, pResults, kiMbNum * sizeof (SMotionTextureUnit),
+                                0 != (kuiFlags & SHARED_AQ), kbToVaa);
+  CopySharedResults (pAq->pMotionTextureIndexToDeltaQp, pResults, kiMbNum * sizeof (int8_t),
+                     0 != (kuiFlags & SHARED_AQ), kbToVaa);
+  if (kbToVaa) {
+    pCalc->iFrameSad = pShared->iFrameSad;
+    pAq->iAverMotionTextureIndexToDeltaQp = pShared->iAverMotionTextureIndexToDeltaQp;
+  } else {
+    pShared->iFrameSad = pCalc->iFrameSad;
+    pShared->iAverMotionTextureIndexToDeltaQp = pAq->iAverMotionTextureIndexToDeltaQp;
+  }
+}
+
+/*!
+ * \brief   the orig frames stand for the reconstructions with the zero copy input, and the screen content
+ *          analysis keeps a state of its own, the results of another encoder do not apply then
+ */
+bool CWelsPreProcess::IsAnalysisShareable (sWelsEncCtx* pCtx) {
+  return (pCtx->pSvcParam->iUsageType != SCREEN_CONTENT_REAL_TIME && !pCtx->pSvcParam->bZeroCopyInput);
+}
+
+SSharedAnalysis* CWelsPreProcess::AllocSharedAnalysis (sWelsEncCtx* pCtx, const char* kpTag) {
+  SSharedAnalysis** ppShared = (0 == strcmp (kpTag, "m_pSharedOut")) ? &m_pSharedOut : &m_pSharedIn;
+  if (NULL == *ppShared) {
+    // the size of the highest layer only changes with a new context
+    const SSpatialLayerConfig* kpLayer = &pCtx->pSvcParam->sSpatialLayers[pCtx->pSvcParam->iSpatialLayerNum - 1];
+    const int32_t kiMbWidth  = (kpLayer->iVideoWidth + 15) >> 4;
+    const int32_t kiMbHeight = (kpLayer->iVideoHeight + 15) >> 4;
+    const int32_t kiSize     = SharedAnalysisSize (kiMbWidth * kiMbHeight);
+    *ppShared = (SSharedAnalysis*)pCtx->pMemAlign->WelsMallocz (kiSize, kpTag);
+    if (NULL == *ppShared)
+      return NULL;
+    (*ppShared)->iSize     = kiSize;
+    (*ppShared)->iMbWidth  = kiMbWidth;
+    (*ppShared)->iMbHeight = kiMbHeight;
+    (*ppShared)->bDenoised = pCtx->pSvcParam->bEnableDenoise;
+  }
+  return *ppShared;
+}
+
+bool CWelsPreProcess::TakeSharedAnalysis (sWelsEncCtx* pCtx, SPicture* pCurPic, SPicture* pRefPic, SPicture* pLastPic,
+    const uint8_t kuiFlags) {
+  if (!m_bSharedIn || !m_pSharedIn->bVaa || m_pSharedIn->uiVaaFlags != kuiFlags
+      || !SameSharedSource (m_pSharedIn->sCur, pCurPic) || !SameSharedSource (m_pSharedIn->sRef, pRefPic)
+      || ((kuiFlags & SHARED_AQ) && !SameSharedSource (m_pSharedIn->sLast, pLastPic)))
+    return false;
+
+  CopySharedAnalysis (pCtx->pVaa, m_pSharedIn, kuiFlags, true);
+  pCtx->pVaa->sVaaCalcInfo.pCurY = pCurPic->pData[0];
+  pCtx->pVaa->sVaaCalcInfo.pRefY = pRefPic->pData[0];
+  if (pCtx->pSvcParam->bMotionAnalysis)
+    KeepSharedAnalysis (pCtx, pCurPic, pRefPic, pLastPic, kuiFlags);
+  return true;
+}
+
+void CWelsPreProcess::KeepSharedAnalysis (sWelsEncCtx* pCtx, SPicture* pCurPic, SPicture* pRefPic, SPicture* pLastPic,
+    const uint8_t kuiFlags) {
+  if (NULL == AllocSharedAnalysis (pCtx, "m_pSharedOut"))
+    return;
+  CopySharedAnalysis (pCtx->pVaa, m_pSharedOut, kuiFlags, false);
+  m_pSharedOut->uiVaaFlags = kuiFlags;
+  KeepSharedSource (&m_pSharedOut->sCur, pCurPic);
+  KeepSharedSource (&m_pSharedOut->sRef, pRefPic);
+  KeepSharedSource (&m_pSharedOut->sLast, pLastPic);
+  m_pSharedOut->bVaa = true;
+}
+
+int32_t CWelsPreProcess::SetSharedAnalysis (const void* kpData, const int32_t kiSize) {
+  m_bSharedIn = false;
+  if (NULL == kpData)
+    return ENC_RETURN_SUCCESS;
+
+  const SSharedAnalysis* kpShared = static_cast<const SSharedAnalysis*> (kpData);
+  if (kiSize < (int32_t)sizeof (SSharedAnalysis) || kpShared->iSize != kiSize)
+    return ENC_RETURN_UNSUPPORTED_PARA;
+  SSharedAnalysis* pSharedIn = AllocSharedAnalysis (m_pEncCtx, "m_pSharedIn");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pSharedIn))
+  if (kpShared->iMbWidth != pSharedIn->iMbWidth || kpShared->iMbHeight != pSharedIn->iMbHeight
+      || kpShared->bDenoised != pSharedIn->bDenoised)
+    return ENC_RETURN_SUCCESS; // of other source pictures, the analysis is run in full
+  if (kiSize != pSharedIn->iSize)
+    return ENC_RETURN_UNSUPPORTED_PARA;
+
+  memcpy (pSharedIn, kpShared, kiSize);
+  m_bSharedIn = true;
+  return ENC_RETURN_SUCCESS;
+}
+
+void CWelsPreProcess::GetSharedAnalysis (const bool kbHandedIn, const void** ppData, int32_t* pSize) {
+  const SSharedAnalysis* kpShared = kbHandedIn ? (m_bSharedIn ? m_pSharedIn : NULL) : m_pSharedOut;
+  if (NULL == kpShared || (!kpShared->bSceneChange && !kpShared->bVaa)) {
+    *ppData = NULL;
+    *pSize  = 0;
+    return;
+  }
+  *ppData = kpShared;
+  *pSize  = kpShared->iSize;
+}
+
 bool CWelsPreProcess::GetSceneChangeFlag (ESceneChangeIdc eSceneChangeIdc) {
   return ((eSceneChangeIdc == LARGE_CHANGED_SCENE) ? true : false);
 }
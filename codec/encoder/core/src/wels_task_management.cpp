@@ -76,8 +76,13 @@ IWelsTaskManage*   IWelsTaskManage::CreateTaskManage (sWelsEncCtx* pCtx, const i
 CWelsTaskManageBase::CWelsTaskManageBase()
   : m_pEncCtx (NULL),
     m_pThreadPool (NULL),
+    m_iThreadBufferNum (0),
     m_iWaitTaskNum (0) {
 
+  m_sTaskGroup.iPriority = WelsCommon::WELS_TASK_PRIORITY_NORMAL;
+  m_sTaskGroup.iMaxRunningNum = 0;
+  m_sTaskGroup.iRunningNum = 0;
+
   for (int32_t iDid = 0; iDid < MAX_DEPENDENCY_LAYER; iDid++) {
     m_iTaskNum[iDid] = 0;
     m_cEncodingTaskList[iDid] = new TASKLIST_TYPE();
@@ -99,7 +104,9 @@ WelsErrorType CWelsTaskManageBase::Init (sWelsEncCtx* pEncCtx) {
 
   int32_t iReturn = ENC_RETURN_SUCCESS;
   //fprintf(stdout, "m_pThreadPool = &(CWelsThreadPool::GetInstance, this=%x\n", this);
-  iReturn = CWelsThreadPool::SetThreadNum (m_iThreadNum);
+  if (!CWelsThreadPool::IsThreadNumFixed()) {
+    iReturn = CWelsThreadPool::SetThreadNum (m_iThreadNum);
+  }
   m_pThreadPool = (CWelsThreadPool::AddReference());
   if ((iReturn != ENC_RETURN_SUCCESS) && pEncCtx) {
     WelsLog (& (pEncCtx->sLogCtx), WELS_LOG_WARNING, "Set Thread Num to %d did not succeed, current thread num in use: %d",
@@ -107,6 +114,8 @@ WelsErrorType CWelsTaskManageBase::Init (sWelsEncCtx* pEncCtx) {
   }
   WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == m_pThreadPool)
   //fprintf(stdout, "m_pThreadPool = &(CWelsThreadPool::GetInstance3\n");
+  m_iThreadBufferNum = WELS_MIN (m_pThreadPool->GetThreadNum(), MAX_THREADS_NUM);
+  UpdateScheduling();
 
   iReturn = ENC_RETURN_SUCCESS;
   for (int32_t iDid = 0; iDid < MAX_DEPENDENCY_LAYER; iDid++) {
@@ -150,6 +159,7 @@ WelsErrorType CWelsTaskManageBase::CreateTasks (sWelsEncCtx* pEncCtx, const int3
   for (int idx = 0; idx < kiTaskCount; idx++) {
     pTask = WELS_NEW_OP (CWelsUpdateMbMapTask (this, pEncCtx, idx), CWelsUpdateMbMapTask);
     WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pTask)
+    pTask->SetGroup (&m_sTaskGroup);
     WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, true != m_cPreEncodingTaskList[kiCurDid]->push_back (pTask));
   }
 
@@ -165,6 +175,7 @@ WelsErrorType CWelsTaskManageBase::CreateTasks (sWelsEncCtx* pEncCtx, const int3
       }
     }
     WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pTask)
+    pTask->SetGroup (&m_sTaskGroup);
     WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, true != m_cEncodingTaskList[kiCurDid]->push_back (pTask));
   }
 
@@ -254,6 +265,26 @@ int32_t  CWelsTaskManageBase::GetThreadPoolThreadNum() {
   return m_pThreadPool->GetThreadNum();
 }
 
+// only called between frames, i.e. while none of the tasks is queued in the pool
+void CWelsTaskManageBase::UpdateScheduling() {
+  switch (m_pEncCtx->pSvcParam->iThreadPriorityClass) {
+  case THREAD_PRIORITY_INTERACTIVE:
+    m_sTaskGroup.iPriority = WelsCommon::WELS_TASK_PRIORITY_HIGH;
+    break;
+  case THREAD_PRIORITY_ARCHIVAL:
+    m_sTaskGroup.iPriority = WelsCommon::WELS_TASK_PRIORITY_LOW;
+    break;
+  default:
+    m_sTaskGroup.iPriority = WelsCommon::WELS_TASK_PRIORITY_NORMAL;
+    break;
+  }
+  // the per-thread bitstream buffers are allocated for the pool size seen at Init(), the pool may have grown since
+  m_sTaskGroup.iMaxRunningNum = m_iThreadBufferNum;
+  if (m_pEncCtx->pSvcParam->iMaxThreadsInUse > 0) {
+    m_sTaskGroup.iMaxRunningNum = WELS_MIN (m_pEncCtx->pSvcParam->iMaxThreadsInUse, m_iThreadBufferNum);
+  }
+}
+
 // CWelsTaskManageOne is for test
 WelsErrorType CWelsTaskManageOne::Init (sWelsEncCtx* pEncCtx) {
   m_pEncCtx = pEncCtx;
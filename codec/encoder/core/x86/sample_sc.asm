@@ -1827,3 +1827,127 @@ WELS_EXTERN SampleSad8x8Hor8_sse41
     POP_XMM
     LOAD_6_PARA_POP
     ret
+
+;***********************************************************************
+;void WelsSampleSsimStats8x8_sse2 (uint8_t* pSrc, int32_t iSrcStride, uint8_t* pRec, int32_t iRecStride,
+;                                  int32_t* pStats);
+;   a^2 + b^2 and a * b from the squares of d = a - b and s = a + b: (s^2 + d^2) / 2 and (s^2 - d^2) / 4
+;***********************************************************************
+WELS_EXTERN WelsSampleSsimStats8x8_sse2
+    %assign  push_num 0
+    LOAD_5_PARA
+    PUSH_XMM 8
+    SIGN_EXTENSION  r1, r1d
+    SIGN_EXTENSION  r3, r3d
+    pxor    xmm3,   xmm3    ; sums of pSrc in dwords 0 and 2, of pRec in dwords 1 and 3
+    pxor    xmm5,   xmm5    ; sum of d^2
+    pxor    xmm6,   xmm6    ; sum of s^2
+    pxor    xmm7,   xmm7
+%rep 4
+    movq    xmm0,   [r0]
+    movhps  xmm0,   [r0+r1]
+    movq    xmm1,   [r2]
+    movhps  xmm1,   [r2+r3]
+    lea     r0,     [r0+2*r1]
+    lea     r2,     [r2+2*r3]
+
+    movdqa  xmm2,   xmm0
+    psadbw  xmm2,   xmm7
+    paddd   xmm3,   xmm2
+    movdqa  xmm2,   xmm1
+    psadbw  xmm2,   xmm7
+    pslldq  xmm2,   4
+    paddd   xmm3,   xmm2
+
+    movdqa  xmm2,   xmm0
+    punpcklbw xmm2, xmm7
+    punpckhbw xmm0, xmm7
+    movdqa  xmm4,   xmm1
+    punpcklbw xmm4, xmm7
+    punpckhbw xmm1, xmm7
+    psubw   xmm2,   xmm4    ; d
+    paddw   xmm4,   xmm4
+    paddw   xmm4,   xmm2    ; s = d + 2 * b
+    psubw   xmm0,   xmm1
+    paddw   xmm1,   xmm1
+    paddw   xmm1,   xmm0
+    pmaddwd xmm2,   xmm2
+    pmaddwd xmm4,   xmm4
+    pmaddwd xmm0,   xmm0
+    pmaddwd xmm1,   xmm1
+    paddd   xmm5,   xmm2
+    paddd   xmm6,   xmm4
+    paddd   xmm5,   xmm0
+    paddd   xmm6,   xmm1
+%endrep
+
+    pshufd  xmm0,   xmm3,   0Eh
+    paddd   xmm3,   xmm0    ; sum of pSrc, sum of pRec
+    pshufd  xmm0,   xmm5,   0Eh
+    paddd   xmm5,   xmm0
+    pshufd  xmm0,   xmm5,   01h
+    paddd   xmm5,   xmm0
+    pshufd  xmm0,   xmm6,   0Eh
+    paddd   xmm6,   xmm0
+    pshufd  xmm0,   xmm6,   01h
+    paddd   xmm6,   xmm0
+    movdqa  xmm1,   xmm6
+    paddd   xmm1,   xmm5
+    psrld   xmm1,   1       ; sum of pSrc^2 + pRec^2
+    psubd   xmm6,   xmm5
+    psrld   xmm6,   2       ; sum of pSrc * pRec
+    punpckldq   xmm1,   xmm6
+    punpcklqdq  xmm3,   xmm1
+    movdqu  [r4],   xmm3
+
+    POP_XMM
+    LOAD_5_PARA_POP
+    ret
+
+; CRC32C of the 8 pixels of a row into r6, %1=address of the row
+%macro SSE42_Crc32cRow8 1
+%ifdef X86_32
+    crc32   r6d,    dword [%1]
+    crc32   r6d,    dword [%1+4]
+%else
+    crc32   r6,     qword [%1]
+%endif
+%endmacro
+
+;***********************************************************************
+;void BlockHash8x8_sse42 (const uint8_t* pSrc, const int32_t kiStride, const int32_t kiNum, uint64_t* pHash);
+;   kiNum > 0, CRC32C of the rows 0 to 3 in the high dword and of the rows 4 to 7 in the low dword, as BlockHash8x8_c
+;***********************************************************************
+WELS_EXTERN BlockHash8x8_sse42
+    push    r4
+    push    r5
+    push    r6
+    %assign push_num 3
+    LOAD_4_PARA
+    SIGN_EXTENSION  r1, r1d
+    SIGN_EXTENSION  r2, r2d
+    lea     r4,     [r1+2*r1]       ; 3 * kiStride
+    lea     r5,     [r0+4*r1]       ; row 4
+.hash_loop:
+    mov     r6d,    0FFFFFFFFh
+    SSE42_Crc32cRow8 r0
+    SSE42_Crc32cRow8 r0+r1
+    SSE42_Crc32cRow8 r0+2*r1
+    SSE42_Crc32cRow8 r0+r4
+    mov     [r3+4], r6d
+    mov     r6d,    0FFFFFFFFh
+    SSE42_Crc32cRow8 r5
+    SSE42_Crc32cRow8 r5+r1
+    SSE42_Crc32cRow8 r5+2*r1
+    SSE42_Crc32cRow8 r5+r4
+    mov     [r3],   r6d
+    add     r0,     1
+    add     r5,     1
+    add     r3,     8
+    dec     r2
+    jg      .hash_loop
+    LOAD_4_PARA_POP
+    pop     r6
+    pop     r5
+    pop     r4
+    ret
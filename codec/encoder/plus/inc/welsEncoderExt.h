@@ -101,6 +101,7 @@ class CWelsH264SVCEncoder : public ISVCEncoder {
   void TraceParamInfo(SEncParamExt *pParam);
   void LogStatistics (const int64_t kiCurrentFrameTs,int32_t iMaxDid);
   void UpdateStatistics(SFrameBSInfo* pBsInfo, const int64_t kiCurrentFrameMs);
+  int ResetWithCurrentParam();
 
   sWelsEncCtx*      m_pEncContext;
 
@@ -110,6 +111,9 @@ class CWelsH264SVCEncoder : public ISVCEncoder {
 
   int32_t           m_iCspInternal;
   bool              m_bInitialFlag;
+  SMemoryArenaParam m_sMemoryArena;     // kept over Initialize, refer to ENCODER_OPTION_MEMORY_ARENA
+  bool              m_bLowFootprint;    // kept over Initialize, refer to ENCODER_OPTION_LOW_FOOTPRINT
+  SReconfigPoolParam m_sReconfigPool;   // kept over Initialize, refer to ENCODER_OPTION_RECONFIG_POOL
 
 #ifdef OUTPUT_BIT_STREAM
   FILE*             m_pFileBs;
@@ -40,6 +40,8 @@
 #include "version.h"
 #include "crt_util_safe_x.h" // Safe CRT routines like util for cross platforms
 #include "ref_list_mgr_svc.h"
+#include "svc_set_mb_syn.h"
+#include "encoder.h"
 #include "codec_ver.h"
 
 #include <time.h>
@@ -163,6 +165,9 @@ CWelsH264SVCEncoder::~CWelsH264SVCEncoder() {
 
 void CWelsH264SVCEncoder::InitEncoder (void) {
 
+  memset (&m_sMemoryArena, 0, sizeof (m_sMemoryArena));
+  m_bLowFootprint = false;
+  memset (&m_sReconfigPool, 0, sizeof (m_sReconfigPool));
   m_pWelsTrace = new welsCodecTrace();
   if (m_pWelsTrace == NULL) {
     return;
@@ -331,8 +336,11 @@ int CWelsH264SVCEncoder::InitializeInternal (SWelsSvcCodingParam* pCfg) {
   m_iMaxPicWidth  = pCfg->iPicWidth;
   m_iMaxPicHeight = pCfg->iPicHeight;
 
+  pCfg->sMemoryArena = m_sMemoryArena;
+  pCfg->bLowFootprint = m_bLowFootprint;
+  pCfg->sReconfigPool = m_sReconfigPool;
   TraceParamInfo (pCfg);
-  if (WelsInitEncoderExt (&m_pEncContext, pCfg, &m_pWelsTrace->m_sLogCtx, NULL)) {
+  if (WelsInitEncoderExt (&m_pEncContext, pCfg, &m_pWelsTrace->m_sLogCtx, NULL, NULL)) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::Initialize(), WelsInitEncoderExt failed.");
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_DEBUG,
              "Problematic Input Base Param: iUsageType=%d, Resolution=%dx%d, FR=%f, TLayerNum=%d, DLayerNum=%d",
@@ -377,11 +385,29 @@ int CWelsH264SVCEncoder::EncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSIn
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), cmInitParaError.");
     return cmInitParaError;
   }
-  if (kpSrcPic->iColorFormat != videoFormatI420) {
+  bool bPlanesMissing = false;
+  switch (kpSrcPic->iColorFormat) {
+  case videoFormatI420:
+    break;
+  case videoFormatNV12:
+  case videoFormatNV21:
+    bPlanesMissing = (NULL == kpSrcPic->pData[0]) || (NULL == kpSrcPic->pData[1]);
+    break;
+  case videoFormatYUY2:
+  case videoFormatBGRA:
+  case videoFormatRGBA:
+    bPlanesMissing = (NULL == kpSrcPic->pData[0]);
+    break;
+  default:
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), wrong iColorFormat %d",
              kpSrcPic->iColorFormat);
     return cmInitParaError;
   }
+  if (bPlanesMissing) {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), missing planes for iColorFormat %d",
+             kpSrcPic->iColorFormat);
+    return cmInitParaError;
+  }
 
   const int32_t kiEncoderReturn = EncodeFrameInternal (kpSrcPic, pBsInfo);
 
@@ -410,7 +436,17 @@ int CWelsH264SVCEncoder ::EncodeFrameInternal (const SSourcePicture*  pSrcPic, S
   }
 
   const int64_t kiBeforeFrameUs = WelsTime();
+  const uint32_t kuiBeforeFrameAllocCount = m_pEncContext->pMemAlign->WelsGetMemoryAllocCount();
+  m_pEncContext->uiBufferReallocCount = 0;
+  WelsProfilingFrameBegin (m_pEncContext);
   const int32_t kiEncoderReturn = WelsEncoderEncodeExt (m_pEncContext, pBsInfo, pSrcPic);
+  m_pEncContext->pVpp->EndInPlaceSource(); // the caller planes are not read after EncodeFrame() returns
+  WelsProfilingFrameEnd (m_pEncContext);
+  m_pEncContext->uiFrameAllocCount = m_pEncContext->pMemAlign->WelsGetMemoryAllocCount() - kuiBeforeFrameAllocCount;
+  m_pEncContext->sBufferStatistics.uiEncodingAllocCount += m_pEncContext->uiFrameAllocCount;
+  m_pEncContext->sBufferStatistics.uiBufferReallocCount += m_pEncContext->uiBufferReallocCount;
+  WelsMotionHintClear (m_pEncContext);
+  WelsEffortMapClear (m_pEncContext);
   const int64_t kiCurrentFrameMs = (WelsTime() - kiBeforeFrameUs) / 1000;
   if ((kiEncoderReturn == ENC_RETURN_MEMALLOCERR) || (kiEncoderReturn == ENC_RETURN_MEMOVERFLOWFOUND)
       || (kiEncoderReturn == ENC_RETURN_VLCOVERFLOWFOUND)) {
@@ -418,13 +454,18 @@ int CWelsH264SVCEncoder ::EncodeFrameInternal (const SSourcePicture*  pSrcPic, S
              kiEncoderReturn);
     WelsUninitEncoderExt (&m_pEncContext);
     return cmMallocMemeError;
+  } else if (kiEncoderReturn == ENC_RETURN_INVALIDINPUT) {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame() invalid source picture");
+    return cmInitParaError;
   } else if ((kiEncoderReturn != ENC_RETURN_SUCCESS) && (kiEncoderReturn == ENC_RETURN_CORRECTED)) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "unexpected return(%d) from EncodeFrameInternal()!",
              kiEncoderReturn);
     return cmUnknownReason;
   }
 
+  WelsMotionAnalysisOutput (m_pEncContext, pBsInfo);
   UpdateStatistics (pBsInfo, kiCurrentFrameMs);
+  WelsComplexityUpdate (m_pEncContext, WelsTime() - kiBeforeFrameUs);
 
   ///////////////////for test
 #ifdef OUTPUT_BIT_STREAM
@@ -639,6 +680,20 @@ void CWelsH264SVCEncoder::UpdateStatistics (SFrameBSInfo* pBsInfo,
     if (m_pEncContext->pLtr->bLTRMarkingFlag) {
       pStatistics->uiLTRSentNum ++;
     }
+    if (iDid == iMaxDid && !kbCurrentFrameSkipped && 0 == pSpatialLayerInternalParam->iRefreshFrameIdx
+        && pSpatialLayerInternalParam->iRefreshFrameNum > 0) {
+      m_pEncContext->uiIntraRefreshNum ++;
+    }
+    const SLayerQualityMetrics* kpLayerMetrics = &m_pEncContext->sLayerQualityMetrics[iDid];
+    if (!kbCurrentFrameSkipped && kpLayerMetrics->bMeasured) {
+      SLayerQualityMetrics* pAverage = &m_pEncContext->sLayerQualityAverage[iDid];
+      const float kfCount = static_cast<float> (++ m_pEncContext->uiQualityFrameCount[iDid]);
+      pAverage->bMeasured = true;
+      pAverage->fPsnrY += (kpLayerMetrics->fPsnrY - pAverage->fPsnrY) / kfCount;
+      pAverage->fPsnrU += (kpLayerMetrics->fPsnrU - pAverage->fPsnrU) / kfCount;
+      pAverage->fPsnrV += (kpLayerMetrics->fPsnrV - pAverage->fPsnrV) / kfCount;
+      pAverage->fSsim  += (kpLayerMetrics->fSsim - pAverage->fSsim) / kfCount;
+    }
 
     pStatistics->iTotalEncodedBytes += kiCurrentFrameSize;
 
@@ -682,6 +737,15 @@ void CWelsH264SVCEncoder::UpdateStatistics (SFrameBSInfo* pBsInfo,
 
 }
 
+// takes the current parameters again, so the encoder is reset for the settings sized at its initialization
+int CWelsH264SVCEncoder::ResetWithCurrentParam() {
+  SWelsSvcCodingParam sConfig = *m_pEncContext->pSvcParam;
+  if (WelsEncoderParamAdjust (&m_pEncContext, &sConfig)) {
+    return cmInitParaError;
+  }
+  return cmResultSuccess;
+}
+
 /************************************************************************
 * InDataFormat, IDRInterval, SVC Encode Param, Frame Rate, Bitrate,..
 ************************************************************************/
@@ -691,7 +755,9 @@ int CWelsH264SVCEncoder::SetOption (ENCODER_OPTION eOptionId, void* pOption) {
   }
 
   if ((NULL == m_pEncContext || false == m_bInitialFlag) && eOptionId != ENCODER_OPTION_TRACE_LEVEL
-      && eOptionId != ENCODER_OPTION_TRACE_CALLBACK && eOptionId != ENCODER_OPTION_TRACE_CALLBACK_CONTEXT) {
+      && eOptionId != ENCODER_OPTION_TRACE_CALLBACK && eOptionId != ENCODER_OPTION_TRACE_CALLBACK_CONTEXT
+      && eOptionId != ENCODER_OPTION_MEMORY_ARENA && eOptionId != ENCODER_OPTION_LOW_FOOTPRINT
+      && eOptionId != ENCODER_OPTION_RECONFIG_POOL) {
     return cmInitExpected;
   }
 
@@ -1185,6 +1251,226 @@ int CWelsH264SVCEncoder::SetOption (ENCODER_OPTION eOptionId, void* pOption) {
              "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_BITS_VARY_PERCENTAGE,iBitsVaryPercentage = %d", iValue);
   }
   break;
+  case ENCODER_OPTION_THREAD_SCHEDULING: {
+    SThreadSchedulingParam* pScheduling = (static_cast<SThreadSchedulingParam*> (pOption));
+    if ((pScheduling->ePriorityClass < THREAD_PRIORITY_INTERACTIVE) || (pScheduling->ePriorityClass > THREAD_PRIORITY_ARCHIVAL)
+        || (pScheduling->iMaxThreadsInUse < 0) || (pScheduling->iThreadPoolSize < 0)) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_THREAD_SCHEDULING, invalid ePriorityClass = %d,iMaxThreadsInUse = %d,iThreadPoolSize = %d",
+               pScheduling->ePriorityClass, pScheduling->iMaxThreadsInUse, pScheduling->iThreadPoolSize);
+      return cmInitParaError;
+    }
+    if (pScheduling->iThreadPoolSize > 0) {
+      if (WELS_THREAD_ERROR_OK != WelsCommon::CWelsThreadPool::SetFixedThreadNum (pScheduling->iThreadPoolSize)) {
+        WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
+                 "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_THREAD_SCHEDULING, iThreadPoolSize = %d not applied, the pool in use can only grow",
+                 pScheduling->iThreadPoolSize);
+      }
+    }
+    m_pEncContext->pSvcParam->iThreadPriorityClass = pScheduling->ePriorityClass;
+    m_pEncContext->pSvcParam->iMaxThreadsInUse = pScheduling->iMaxThreadsInUse;
+    if (m_pEncContext->pTaskManage) {
+      m_pEncContext->pTaskManage->UpdateScheduling();
+    }
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_THREAD_SCHEDULING,ePriorityClass = %d,iMaxThreadsInUse = %d,iThreadPoolSize = %d",
+             pScheduling->ePriorityClass, pScheduling->iMaxThreadsInUse, pScheduling->iThreadPoolSize);
+  }
+  break;
+  case ENCODER_OPTION_ZERO_COPY_INPUT: {
+    SZeroCopyInputParam* pZeroCopy = (static_cast<SZeroCopyInputParam*> (pOption));
+    m_pEncContext->pSvcParam->bZeroCopyInput = pZeroCopy->bEnable;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_ZERO_COPY_INPUT,bEnable = %d", pZeroCopy->bEnable);
+  }
+  break;
+  case ENCODER_OPTION_SLICE_OUTPUT_CALLBACK: {
+    SSliceOutputCallbackParam* pSliceOutput = (static_cast<SSliceOutputCallbackParam*> (pOption));
+    m_pEncContext->pSvcParam->sSliceOutput = *pSliceOutput;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_SLICE_OUTPUT_CALLBACK,callback = %p", pSliceOutput->pCallback);
+  }
+  break;
+  case ENCODER_OPTION_PROFILING: {
+    SEncoderProfiling* pProfiling = (static_cast<SEncoderProfiling*> (pOption));
+    m_pEncContext->pSvcParam->bProfiling = pProfiling->bEnable;
+    if (pProfiling->bReset) {
+      WelsProfilingReset (m_pEncContext);
+    }
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_PROFILING,bEnable = %d,bReset = %d", pProfiling->bEnable,
+             pProfiling->bReset);
+  }
+  break;
+  case ENCODER_OPTION_MOTION_HINT: {
+    SMotionHintParam* pHint = (static_cast<SMotionHintParam*> (pOption));
+    const int32_t kiRet = WelsMotionHintSet (m_pEncContext, pHint);
+    if (ENC_RETURN_SUCCESS != kiRet) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_MOTION_HINT, failed with iMbWidth = %d,iMbHeight = %d,iPreprocessSize = %d",
+               pHint->iMbWidth, pHint->iMbHeight, pHint->iPreprocessSize);
+      return (ENC_RETURN_MEMALLOCERR == kiRet) ? cmMallocMemeError : cmInitParaError;
+    }
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_DEBUG,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_MOTION_HINT,pHints = %p,iMbWidth = %d,iMbHeight = %d,bEarlyTermination = %d",
+             pHint->pHints, pHint->iMbWidth, pHint->iMbHeight, pHint->bEarlyTermination);
+  }
+  break;
+  case ENCODER_OPTION_MOTION_ANALYSIS: {
+    SMotionAnalysis* pAnalysis = (static_cast<SMotionAnalysis*> (pOption));
+    m_pEncContext->pSvcParam->bMotionAnalysis = pAnalysis->bEnable;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_MOTION_ANALYSIS,bEnable = %d", pAnalysis->bEnable);
+  }
+  break;
+  case ENCODER_OPTION_HIERARCHICAL_ME: {
+    const bool kbHierarchicalMe = * (static_cast<bool*> (pOption));
+    m_pEncContext->pSvcParam->bHierarchicalMe = kbHierarchicalMe;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_HIERARCHICAL_ME,bHierarchicalMe = %d", kbHierarchicalMe);
+  }
+  break;
+  case ENCODER_OPTION_HALFPEL_CACHE: {
+    const bool kbHalfPelCache = * (static_cast<bool*> (pOption));
+    m_pEncContext->pSvcParam->bHalfPelCache = kbHalfPelCache;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_HALFPEL_CACHE,bHalfPelCache = %d", kbHalfPelCache);
+  }
+  break;
+  case ENCODER_OPTION_SCREEN_BLOCK_HASH: {
+    const bool kbScreenBlockHash = * (static_cast<bool*> (pOption));
+    m_pEncContext->pSvcParam->bScreenBlockHash = kbScreenBlockHash;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_SCREEN_BLOCK_HASH,bScreenBlockHash = %d", kbScreenBlockHash);
+  }
+  break;
+  case ENCODER_OPTION_STATIC_SKIP_PREFILTER: {
+    const bool kbStaticSkipPrefilter = * (static_cast<bool*> (pOption));
+    m_pEncContext->pSvcParam->bStaticSkipPrefilter = kbStaticSkipPrefilter;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_STATIC_SKIP_PREFILTER,bStaticSkipPrefilter = %d",
+             kbStaticSkipPrefilter);
+  }
+  break;
+  case ENCODER_OPTION_EFFORT_MAP: {
+    SEffortMapParam* pMap = (static_cast<SEffortMapParam*> (pOption));
+    const int32_t kiRet = WelsEffortMapSet (m_pEncContext, pMap);
+    if (ENC_RETURN_SUCCESS != kiRet) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_EFFORT_MAP, failed with iMbWidth = %d,iMbHeight = %d",
+               pMap->iMbWidth, pMap->iMbHeight);
+      return (ENC_RETURN_MEMALLOCERR == kiRet) ? cmMallocMemeError : cmInitParaError;
+    }
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_DEBUG,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_EFFORT_MAP,pEffort = %p,iMbWidth = %d,iMbHeight = %d",
+             pMap->pEffort, pMap->iMbWidth, pMap->iMbHeight);
+  }
+  break;
+  case ENCODER_OPTION_FRAME_TIME_BUDGET: {
+    const int32_t kiFrameTimeBudgetUs = * (static_cast<int32_t*> (pOption));
+    if (kiFrameTimeBudgetUs < 0) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_FRAME_TIME_BUDGET, invalid iFrameTimeBudgetUs = %d",
+               kiFrameTimeBudgetUs);
+      return cmInitParaError;
+    }
+    m_pEncContext->pSvcParam->iFrameTimeBudgetUs = kiFrameTimeBudgetUs;
+    WelsComplexityReset (m_pEncContext);
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_FRAME_TIME_BUDGET,iFrameTimeBudgetUs = %d", kiFrameTimeBudgetUs);
+  }
+  break;
+  case ENCODER_OPTION_OVERLAPPED_DEBLOCKING: {
+    const bool kbOverlappedDeblocking = * (static_cast<bool*> (pOption));
+    m_pEncContext->pSvcParam->bOverlappedDeblocking = kbOverlappedDeblocking;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_OVERLAPPED_DEBLOCKING,bOverlappedDeblocking = %d",
+             kbOverlappedDeblocking);
+  }
+  break;
+  case ENCODER_OPTION_PREALLOCATE_BUFFERS: {
+    const int32_t kiPreallocSliceNum = * (static_cast<int32_t*> (pOption));
+    if (kiPreallocSliceNum < -1) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_PREALLOCATE_BUFFERS, invalid iPreallocSliceNum = %d",
+               kiPreallocSliceNum);
+      return cmInitParaError;
+    }
+    // the buffers are sized when the encoder is initialized, so the encoder is reset to take a new value
+    m_pEncContext->pSvcParam->iPreallocSliceNum = kiPreallocSliceNum;
+    if (cmResultSuccess != ResetWithCurrentParam()) {
+      return cmInitParaError;
+    }
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_PREALLOCATE_BUFFERS,iPreallocSliceNum = %d", kiPreallocSliceNum);
+  }
+  break;
+  case ENCODER_OPTION_MEMORY_ARENA: {
+    m_sMemoryArena = * (static_cast<SMemoryArenaParam*> (pOption));
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_MEMORY_ARENA,uiArenaSize = %u,bHugePages = %d,bPrefault = %d",
+             m_sMemoryArena.uiArenaSize, m_sMemoryArena.bHugePages, m_sMemoryArena.bPrefault);
+    if (NULL == m_pEncContext || false == m_bInitialFlag)
+      break; // taken by Initialize
+    // all the memory is carved again, so the encoder is reset to take a new arena
+    m_pEncContext->pSvcParam->sMemoryArena = m_sMemoryArena;
+    if (cmResultSuccess != ResetWithCurrentParam()) {
+      return cmInitParaError;
+    }
+  }
+  break;
+  case ENCODER_OPTION_LOW_FOOTPRINT: {
+    m_bLowFootprint = * (static_cast<bool*> (pOption));
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_LOW_FOOTPRINT,bLowFootprint = %d", m_bLowFootprint);
+    if (NULL == m_pEncContext || false == m_bInitialFlag)
+      break; // taken by Initialize
+    m_pEncContext->pSvcParam->bLowFootprint = m_bLowFootprint;
+    if (cmResultSuccess != ResetWithCurrentParam()) {
+      return cmInitParaError;
+    }
+  }
+  break;
+  case ENCODER_OPTION_RECONFIG_POOL: {
+    const SReconfigPoolParam* kpPool = static_cast<SReconfigPoolParam*> (pOption);
+    if (kpPool->iMaxPicWidth < 0 || kpPool->iMaxPicHeight < 0 || (kpPool->iMaxPicWidth > 0) != (kpPool->iMaxPicHeight > 0))
+      return cmInitParaError;
+    m_sReconfigPool = *kpPool;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_RECONFIG_POOL,iMaxPicWidth = %d,iMaxPicHeight = %d",
+             m_sReconfigPool.iMaxPicWidth, m_sReconfigPool.iMaxPicHeight);
+    if (NULL == m_pEncContext || false == m_bInitialFlag)
+      break; // taken by Initialize
+    // the memory is sized for the new pool, so the encoder is reset
+    m_pEncContext->pSvcParam->sReconfigPool = m_sReconfigPool;
+    if (cmResultSuccess != ResetWithCurrentParam()) {
+      return cmInitParaError;
+    }
+  }
+  break;
+
+  case ENCODER_OPTION_INTRA_REFRESH: {
+    const int32_t kiIntraRefreshFrames = * (static_cast<int32_t*> (pOption));
+    if (kiIntraRefreshFrames < 0)
+      return cmInitParaError;
+    // a sweep running goes on, the next one takes the new length
+    m_pEncContext->pSvcParam->iIntraRefreshFrames = kiIntraRefreshFrames;
+    if (kiIntraRefreshFrames > 0 && !WelsIntraRefreshEnabled (m_pEncContext->pSvcParam)) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_INTRA_REFRESH not applicable to the spatial layers of SVC or intra period 1, periodic IDR kept");
+    }
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_INTRA_REFRESH,iIntraRefreshFrames = %d", kiIntraRefreshFrames);
+  }
+  break;
+
+  case ENCODER_OPTION_QUALITY_METRICS: {
+    const bool kbQualityMetrics = * (static_cast<bool*> (pOption));
+    m_pEncContext->pSvcParam->bQualityMetrics = kbQualityMetrics;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_QUALITY_METRICS,bQualityMetrics = %d", kbQualityMetrics);
+  }
+  break;
 
   default:
     return cmInitParaError;
@@ -1300,6 +1586,143 @@ int CWelsH264SVCEncoder::GetOption (ENCODER_OPTION eOptionId, void* pOption) {
     * ((int32_t*)pOption) =  m_pEncContext->pSvcParam->iComplexityMode;
   }
   break;
+  case ENCODER_OPTION_THREAD_SCHEDULING: {
+    SThreadSchedulingParam* pScheduling = (static_cast<SThreadSchedulingParam*> (pOption));
+    pScheduling->iThreadPoolSize = (NULL != m_pEncContext->pTaskManage) ?
+                                   m_pEncContext->pTaskManage->GetThreadPoolThreadNum() : 0;
+    pScheduling->iMaxThreadsInUse = m_pEncContext->pSvcParam->iMaxThreadsInUse;
+    pScheduling->ePriorityClass = (EThreadPriorityClass)m_pEncContext->pSvcParam->iThreadPriorityClass;
+  }
+  break;
+  case ENCODER_OPTION_ZERO_COPY_INPUT: {
+    SZeroCopyInputParam* pZeroCopy = (static_cast<SZeroCopyInputParam*> (pOption));
+    pZeroCopy->bEnable = m_pEncContext->pSvcParam->bZeroCopyInput;
+    m_pEncContext->pVpp->GetInPlaceSourceInfo (pZeroCopy->iStride, &pZeroCopy->bLastInPlace);
+  }
+  break;
+  case ENCODER_OPTION_SLICE_OUTPUT_CALLBACK: {
+    * (static_cast<SSliceOutputCallbackParam*> (pOption)) = m_pEncContext->pSvcParam->sSliceOutput;
+  }
+  break;
+  case ENCODER_OPTION_PROFILING: {
+    WelsProfilingGet (m_pEncContext, static_cast<SEncoderProfiling*> (pOption));
+  }
+  break;
+  case ENCODER_OPTION_MOTION_HINT: {
+    SMotionHintParam* pHint = (static_cast<SMotionHintParam*> (pOption));
+    pHint->pHints    = (m_pEncContext->iMotionHintMbWidth > 0) ? m_pEncContext->pMotionHint : NULL;
+    pHint->iMbWidth  = m_pEncContext->iMotionHintMbWidth;
+    pHint->iMbHeight = m_pEncContext->iMotionHintMbHeight;
+    pHint->bEarlyTermination = m_pEncContext->bMotionHintEarlyTermination;
+    m_pEncContext->pVpp->GetSharedAnalysis (true, &pHint->pPreprocess, &pHint->iPreprocessSize);
+  }
+  break;
+  case ENCODER_OPTION_MOTION_ANALYSIS: {
+    WelsMotionAnalysisGet (m_pEncContext, static_cast<SMotionAnalysis*> (pOption));
+  }
+  break;
+  case ENCODER_OPTION_HIERARCHICAL_ME: {
+    * (static_cast<bool*> (pOption)) = m_pEncContext->pSvcParam->bHierarchicalMe;
+  }
+  break;
+  case ENCODER_OPTION_HALFPEL_CACHE: {
+    * (static_cast<bool*> (pOption)) = m_pEncContext->pSvcParam->bHalfPelCache;
+  }
+  break;
+  case ENCODER_OPTION_SCREEN_BLOCK_HASH: {
+    * (static_cast<bool*> (pOption)) = m_pEncContext->pSvcParam->bScreenBlockHash;
+  }
+  break;
+  case ENCODER_OPTION_STATIC_SKIP_PREFILTER: {
+    * (static_cast<bool*> (pOption)) = m_pEncContext->pSvcParam->bStaticSkipPrefilter;
+  }
+  break;
+  case ENCODER_OPTION_EFFORT_MAP: {
+    SEffortMapParam* pMap = (static_cast<SEffortMapParam*> (pOption));
+    pMap->pEffort   = (m_pEncContext->iEffortMapMbWidth > 0) ? m_pEncContext->pEffortMap : NULL;
+    pMap->iMbWidth  = m_pEncContext->iEffortMapMbWidth;
+    pMap->iMbHeight = m_pEncContext->iEffortMapMbHeight;
+  }
+  break;
+  case ENCODER_OPTION_FRAME_TIME_BUDGET: {
+    * (static_cast<int32_t*> (pOption)) = m_pEncContext->pSvcParam->iFrameTimeBudgetUs;
+  }
+  break;
+  case ENCODER_OPTION_OVERLAPPED_DEBLOCKING: {
+    * (static_cast<bool*> (pOption)) = m_pEncContext->pSvcParam->bOverlappedDeblocking;
+  }
+  break;
+  case ENCODER_OPTION_PREALLOCATE_BUFFERS: {
+    * (static_cast<int32_t*> (pOption)) = m_pEncContext->pSvcParam->iPreallocSliceNum;
+  }
+  break;
+  case ENCODER_OPTION_MEMORY_ARENA: {
+    * (static_cast<SMemoryArenaParam*> (pOption)) = m_pEncContext->sMemoryArena;
+  }
+  break;
+  case ENCODER_OPTION_LOW_FOOTPRINT: {
+    * (static_cast<bool*> (pOption)) = m_pEncContext->bLowFootprint;
+  }
+  break;
+  case ENCODER_OPTION_RECONFIG_POOL: {
+    * (static_cast<SReconfigPoolParam*> (pOption)) = m_pEncContext->sReconfigPool;
+  }
+  break;
+  case ENCODER_OPTION_INTRA_REFRESH: {
+    * (static_cast<int32_t*> (pOption)) = m_pEncContext->pSvcParam->iIntraRefreshFrames;
+  }
+  break;
+  case ENCODER_OPTION_QUALITY_METRICS: {
+    * (static_cast<bool*> (pOption)) = m_pEncContext->pSvcParam->bQualityMetrics;
+  }
+  break;
+  case ENCODER_OPTION_GET_QUALITY_METRICS: {
+    SFrameQualityMetrics* pMetrics = static_cast<SFrameQualityMetrics*> (pOption);
+    pMetrics->uiTimeStamp      = m_pEncContext->uiLastTimestamp;
+    pMetrics->iSpatialLayerNum = m_pEncContext->pSvcParam->iSpatialLayerNum;
+    for (int32_t iDid = 0; iDid < pMetrics->iSpatialLayerNum; iDid++) {
+      pMetrics->sLayerMetrics[iDid]        = m_pEncContext->sLayerQualityMetrics[iDid];
+      pMetrics->uiMeasuredFrameCount[iDid] = m_pEncContext->uiQualityFrameCount[iDid];
+      pMetrics->sLayerAverage[iDid]        = m_pEncContext->sLayerQualityAverage[iDid];
+    }
+  }
+  break;
+  case ENCODER_OPTION_GET_COMPLEXITY_LEVEL: {
+    * (static_cast<int32_t*> (pOption)) = m_pEncContext->iLastComplexityLevel;
+  }
+  break;
+  case ENCODER_OPTION_GET_BUFFER_STATISTICS: {
+    * (static_cast<SEncoderBufferStatistics*> (pOption)) = m_pEncContext->sBufferStatistics;
+  }
+  break;
+  case ENCODER_OPTION_GET_RECONFIG_STATISTICS: {
+    * (static_cast<SEncoderReconfigStatistics*> (pOption)) = m_pEncContext->sReconfigStatistics;
+  }
+  break;
+  case ENCODER_OPTION_GET_INTRA_REFRESH_NUM: {
+    * (static_cast<uint32_t*> (pOption)) = m_pEncContext->uiIntraRefreshNum;
+  }
+  break;
+  case ENCODER_OPTION_GET_MEMORY_USAGE: {
+    SMemoryUsage* pUsage = static_cast<SMemoryUsage*> (pOption);
+    const CMemoryAlign* kpMa = m_pEncContext->pMemAlign;
+    pUsage->uiUsedBytes          = kpMa->WelsGetMemoryUsage();
+    pUsage->uiArenaSize          = kpMa->WelsGetArenaSize();
+    pUsage->uiArenaUsedBytes     = kpMa->WelsGetArenaUsedBytes();
+    pUsage->uiArenaOverflowCount = kpMa->WelsGetArenaOverflowCount();
+    pUsage->uiSharedBytes        = 52 * m_pEncContext->iMvdCostTableStride * sizeof (uint16_t);
+    if (m_pEncContext->pSvcParam->iEntropyCodingModeFlag)
+      pUsage->uiSharedBytes     += WelsCabacContextTableSize();
+    pUsage->iTagNum              = kpMa->WelsGetMemoryTagNum();
+    for (int32_t i = 0; i < pUsage->iTagNum; i++) {
+      const SMemoryTagStat* kpTagStat = kpMa->WelsGetMemoryTagStat (i);
+      pUsage->sTagUsage[i].pTag         = kpTagStat->pTag;
+      pUsage->sTagUsage[i].uiUsedBytes  = kpTagStat->uiUsedBytes;
+      pUsage->sTagUsage[i].uiPeakBytes  = kpTagStat->uiPeakBytes;
+      pUsage->sTagUsage[i].uiAllocCount = kpTagStat->uiAllocCount;
+    }
+  }
+  break;
   default:
     return cmInitParaError;
   }
@@ -83,6 +83,7 @@ typedef enum {
   VIDEO_FORMAT_NV12       = 26,   /* y planar + uv packed */
   VIDEO_FORMAT_I422       = 27,   /* yuv 4:2:2 planar */
   VIDEO_FORMAT_I444       = 28,   /* yuv 4:4:4 planar */
+  VIDEO_FORMAT_NV21       = 29,   /* y planar + vu packed */
   VIDEO_FORMAT_YUYV       = 20,   /* yuv 4:2:2 packed */
 
   VIDEO_FORMAT_RGB24      = 1,
@@ -120,7 +121,7 @@ typedef struct {
 
 typedef enum {
   METHOD_NULL              = 0,
-  METHOD_COLORSPACE_CONVERT    ,//not support yet
+  METHOD_COLORSPACE_CONVERT    ,
   METHOD_DENOISE              ,
   METHOD_SCENE_CHANGE_DETECTION_VIDEO ,
   METHOD_SCENE_CHANGE_DETECTION_SCREEN ,
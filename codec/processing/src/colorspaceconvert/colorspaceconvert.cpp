@@ -0,0 +1,144 @@
+/*!
+ * \copy
+ *     Copyright (c)  2011-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file        :  colorspaceconvert.cpp
+ *
+ * \brief       :  colorspace conversion class of wels video processor class
+ *
+ * \date        :  2026/10/18
+ *
+ * \description :
+ *
+ *************************************************************************************
+ */
+
+#include "colorspaceconvert.h"
+#include "cpu.h"
+
+WELSVP_NAMESPACE_BEGIN
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CColorspaceConvert::CColorspaceConvert (int32_t iCpuFlag) {
+  m_iCPUFlag = iCpuFlag;
+  m_eMethod   = METHOD_COLORSPACE_CONVERT;
+  WelsMemset (&m_pfConvert, 0, sizeof (m_pfConvert));
+  InitColorspaceConvertFuncs (m_pfConvert, m_iCPUFlag);
+}
+
+CColorspaceConvert::~CColorspaceConvert() {
+}
+
+void CColorspaceConvert::InitColorspaceConvertFuncs (SColorspaceConvertFuncs& sConvertFuncs, int32_t iCpuFlag) {
+  sConvertFuncs.pfDeinterleaveChroma = DeinterleaveChroma_c;
+  sConvertFuncs.pfYuy2ToI420         = Yuy2ToI420_c;
+  sConvertFuncs.pfBgra32ToI420       = Bgra32ToI420_c;
+  sConvertFuncs.pfRgba32ToI420       = Rgba32ToI420_c;
+
+#if defined(X86_ASM)
+  if (iCpuFlag & WELS_CPU_SSE2) {
+    sConvertFuncs.pfDeinterleaveChroma = DeinterleaveChroma_sse2;
+    sConvertFuncs.pfYuy2ToI420         = Yuy2ToI420_sse2;
+    sConvertFuncs.pfBgra32ToI420       = Bgra32ToI420_sse2;
+    sConvertFuncs.pfRgba32ToI420       = Rgba32ToI420_sse2;
+  }
+#endif//X86_ASM
+
+#if defined(HAVE_NEON)
+  if (iCpuFlag & WELS_CPU_NEON) {
+    sConvertFuncs.pfDeinterleaveChroma = DeinterleaveChroma_neon;
+    sConvertFuncs.pfYuy2ToI420         = Yuy2ToI420_neon;
+    sConvertFuncs.pfBgra32ToI420       = Bgra32ToI420_neon;
+    sConvertFuncs.pfRgba32ToI420       = Rgba32ToI420_neon;
+  }
+#endif
+
+#if defined(HAVE_NEON_AARCH64)
+  if (iCpuFlag & WELS_CPU_NEON) {
+    sConvertFuncs.pfDeinterleaveChroma = DeinterleaveChroma_AArch64_neon;
+    sConvertFuncs.pfYuy2ToI420         = Yuy2ToI420_AArch64_neon;
+    sConvertFuncs.pfBgra32ToI420       = Bgra32ToI420_AArch64_neon;
+    sConvertFuncs.pfRgba32ToI420       = Rgba32ToI420_AArch64_neon;
+  }
+#endif
+}
+
+EResult CColorspaceConvert::Process (int32_t iType, SPixMap* pSrc, SPixMap* pDst) {
+  uint8_t* pDstY = (uint8_t*)pDst->pPixel[0];
+  uint8_t* pDstU = (uint8_t*)pDst->pPixel[1];
+  uint8_t* pDstV = (uint8_t*)pDst->pPixel[2];
+  uint8_t* pSrcY = (uint8_t*)pSrc->pPixel[0];
+  const int32_t kiWidth  = pSrc->sRect.iRectWidth & (~1);
+  const int32_t kiHeight = pSrc->sRect.iRectHeight & (~1);
+
+  if (pDst->eFormat != VIDEO_FORMAT_I420 || pDstY == NULL || pDstU == NULL || pDstV == NULL || pSrcY == NULL)
+    return RET_INVALIDPARAM;
+  if (pDst->sRect.iRectWidth < kiWidth || pDst->sRect.iRectHeight < kiHeight)
+    return RET_INVALIDPARAM;
+
+  switch (pSrc->eFormat) {
+  case VIDEO_FORMAT_NV12:
+  case VIDEO_FORMAT_NV21: {
+    if (pSrc->pPixel[1] == NULL)
+      return RET_INVALIDPARAM;
+    for (int32_t i = 0; i < kiHeight; i++) {
+      WelsMemcpy (pDstY, pSrcY, kiWidth);
+      pDstY += pDst->iStride[0];
+      pSrcY += pSrc->iStride[0];
+    }
+    if (pSrc->eFormat == VIDEO_FORMAT_NV21) {
+      uint8_t* pTmp = pDstU;
+      pDstU = pDstV;
+      pDstV = pTmp;
+    }
+    m_pfConvert.pfDeinterleaveChroma (pDstU, pDstV, pDst->iStride[1], (uint8_t*)pSrc->pPixel[1], pSrc->iStride[1],
+                                      kiWidth >> 1, kiHeight >> 1);
+    break;
+  }
+  case VIDEO_FORMAT_YUY2:
+    m_pfConvert.pfYuy2ToI420 (pDstY, pDstU, pDstV, pDst->iStride[0], pDst->iStride[1], pSrcY, pSrc->iStride[0],
+                              kiWidth, kiHeight);
+    break;
+  case VIDEO_FORMAT_BGRA:
+    m_pfConvert.pfBgra32ToI420 (pDstY, pDstU, pDstV, pDst->iStride[0], pDst->iStride[1], pSrcY, pSrc->iStride[0],
+                                kiWidth, kiHeight);
+    break;
+  case VIDEO_FORMAT_RGBA:
+    m_pfConvert.pfRgba32ToI420 (pDstY, pDstU, pDstV, pDst->iStride[0], pDst->iStride[1], pSrcY, pSrc->iStride[0],
+                                kiWidth, kiHeight);
+    break;
+  default:
+    return RET_NOTSUPPORTED;
+  }
+
+  return RET_SUCCESS;
+}
+
+WELSVP_NAMESPACE_END
@@ -0,0 +1,143 @@
+/*!
+ * \copy
+ *     Copyright (c)  2011-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file        :  colorspaceconvert.h
+ *
+ * \brief       :  colorspace conversion class of wels video processor class
+ *
+ * \date        :  2026/10/18
+ *
+ * \description :  NV12/NV21/YUY2 and 32 bits RGB to I420, written straight into the destination picture
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELSVP_COLORSPACECONVERT_H
+#define WELSVP_COLORSPACECONVERT_H
+
+#include "util.h"
+#include "WelsFrameWork.h"
+#include "IWelsVP.h"
+
+WELSVP_NAMESPACE_BEGIN
+
+// kiWidth and kiHeight in chroma samples
+typedef void (DeinterleaveChromaFunc) (uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStride,
+                                       uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth, const int32_t kiHeight);
+
+// kiWidth and kiHeight in luma samples, both even
+typedef void (PackedToI420Func) (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                                 const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                                 const int32_t kiHeight);
+
+// one row, kiWidth in chroma samples and a multiple of the width of the kernel
+typedef void (DeinterleaveChromaRowFunc) (uint8_t* pDstU, uint8_t* pDstV, uint8_t* pSrc, const int32_t kiWidth);
+
+// one pair of rows, kiWidth in luma samples and a multiple of the width of the kernel
+typedef void (PackedToI420RowsFunc) (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                     uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth);
+
+typedef DeinterleaveChromaFunc* PDeinterleaveChromaFunc;
+typedef PackedToI420Func*       PPackedToI420Func;
+typedef DeinterleaveChromaRowFunc* PDeinterleaveChromaRowFunc;
+typedef PackedToI420RowsFunc*   PPackedToI420RowsFunc;
+
+DeinterleaveChromaFunc  DeinterleaveChroma_c;
+PackedToI420Func        Yuy2ToI420_c;
+PackedToI420Func        Bgra32ToI420_c;
+PackedToI420Func        Rgba32ToI420_c;
+
+#ifdef X86_ASM
+WELSVP_EXTERN_C_BEGIN
+DeinterleaveChromaRowFunc DeinterleaveChromaWidthx16_sse2;
+PackedToI420RowsFunc      Yuy2ToI420Widthx16_sse2;
+PackedToI420RowsFunc      Bgra32ToI420Widthx8_sse2;
+PackedToI420RowsFunc      Rgba32ToI420Widthx8_sse2;
+WELSVP_EXTERN_C_END
+
+DeinterleaveChromaFunc  DeinterleaveChroma_sse2;
+PackedToI420Func        Yuy2ToI420_sse2;
+PackedToI420Func        Bgra32ToI420_sse2;
+PackedToI420Func        Rgba32ToI420_sse2;
+#endif
+
+#ifdef HAVE_NEON
+WELSVP_EXTERN_C_BEGIN
+DeinterleaveChromaRowFunc DeinterleaveChromaWidthx16_neon;
+PackedToI420RowsFunc      Yuy2ToI420Widthx16_neon;
+PackedToI420RowsFunc      Bgra32ToI420Widthx16_neon;
+PackedToI420RowsFunc      Rgba32ToI420Widthx16_neon;
+WELSVP_EXTERN_C_END
+
+DeinterleaveChromaFunc  DeinterleaveChroma_neon;
+PackedToI420Func        Yuy2ToI420_neon;
+PackedToI420Func        Bgra32ToI420_neon;
+PackedToI420Func        Rgba32ToI420_neon;
+#endif
+
+#ifdef HAVE_NEON_AARCH64
+WELSVP_EXTERN_C_BEGIN
+DeinterleaveChromaRowFunc DeinterleaveChromaWidthx16_AArch64_neon;
+PackedToI420RowsFunc      Yuy2ToI420Widthx16_AArch64_neon;
+PackedToI420RowsFunc      Bgra32ToI420Widthx16_AArch64_neon;
+PackedToI420RowsFunc      Rgba32ToI420Widthx16_AArch64_neon;
+WELSVP_EXTERN_C_END
+
+DeinterleaveChromaFunc  DeinterleaveChroma_AArch64_neon;
+PackedToI420Func        Yuy2ToI420_AArch64_neon;
+PackedToI420Func        Bgra32ToI420_AArch64_neon;
+PackedToI420Func        Rgba32ToI420_AArch64_neon;
+#endif
+
+typedef struct {
+  PDeinterleaveChromaFunc       pfDeinterleaveChroma;
+  PPackedToI420Func             pfYuy2ToI420;
+  PPackedToI420Func             pfBgra32ToI420;
+  PPackedToI420Func             pfRgba32ToI420;
+} SColorspaceConvertFuncs;
+
+class CColorspaceConvert : public IStrategy {
+ public:
+  CColorspaceConvert (int32_t iCpuFlag);
+  ~CColorspaceConvert();
+
+  EResult Process (int32_t iType, SPixMap* pSrc, SPixMap* pDst);
+
+ private:
+  void InitColorspaceConvertFuncs (SColorspaceConvertFuncs& sConvertFuncs, int32_t iCpuFlag);
+
+ private:
+  SColorspaceConvertFuncs m_pfConvert;
+  int32_t                 m_iCPUFlag;
+};
+
+WELSVP_NAMESPACE_END
+
+#endif
@@ -0,0 +1,193 @@
+/*!
+ * \copy
+ *     Copyright (c)  2011-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ * \file        :  colorspaceconvertfuncs.cpp
+ *
+ * \brief       :  colorspace conversion kernels, BT.601 limited range for RGB input
+ *
+ * \date        :  2026/10/18
+ *
+ * \description :
+ *
+ *************************************************************************************
+ */
+
+#include "colorspaceconvert.h"
+
+WELSVP_NAMESPACE_BEGIN
+
+#define RGB_TO_Y(r, g, b)  ((( 66 * (r) + 129 * (g) +  25 * (b) + 128) >> 8) + 16)
+#define RGB_TO_U(r, g, b)  (((-38 * (r) -  74 * (g) + 112 * (b) + 128) >> 8) + 128)
+#define RGB_TO_V(r, g, b)  (((112 * (r) -  94 * (g) -  18 * (b) + 128) >> 8) + 128)
+
+void DeinterleaveChroma_c (uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStride,
+                           uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth, const int32_t kiHeight) {
+  for (int32_t j = 0; j < kiHeight; j++) {
+    for (int32_t i = 0; i < kiWidth; i++) {
+      pDstU[i] = pSrc[ (i << 1)];
+      pDstV[i] = pSrc[ (i << 1) + 1];
+    }
+    pDstU += kiDstStride;
+    pDstV += kiDstStride;
+    pSrc  += kiSrcStride;
+  }
+}
+
+// Y0 U Y1 V, chroma of the two rows is averaged for the vertical subsampling
+void Yuy2ToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                   const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                   const int32_t kiHeight) {
+  for (int32_t j = 0; j < kiHeight; j += 2) {
+    uint8_t* pSrc1 = pSrc + kiSrcStride;
+    uint8_t* pDstY1 = pDstY + kiDstStrideY;
+    for (int32_t i = 0; i < (kiWidth >> 1); i++) {
+      pDstY[ (i << 1)]      = pSrc[ (i << 2)];
+      pDstY[ (i << 1) + 1]  = pSrc[ (i << 2) + 2];
+      pDstY1[ (i << 1)]     = pSrc1[ (i << 2)];
+      pDstY1[ (i << 1) + 1] = pSrc1[ (i << 2) + 2];
+      pDstU[i] = (pSrc[ (i << 2) + 1] + pSrc1[ (i << 2) + 1] + 1) >> 1;
+      pDstV[i] = (pSrc[ (i << 2) + 3] + pSrc1[ (i << 2) + 3] + 1) >> 1;
+    }
+    pDstY += kiDstStrideY << 1;
+    pDstU += kiDstStrideUV;
+    pDstV += kiDstStrideUV;
+    pSrc  += kiSrcStride << 1;
+  }
+}
+
+// kiR/kiG/kiB are the byte offsets of the components inside one 32 bits pixel
+static inline void Rgb32ToI420 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                                const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                                const int32_t kiHeight, const int32_t kiR, const int32_t kiG, const int32_t kiB) {
+  for (int32_t j = 0; j < kiHeight; j += 2) {
+    uint8_t* pSrc1 = pSrc + kiSrcStride;
+    uint8_t* pDstY1 = pDstY + kiDstStrideY;
+    for (int32_t i = 0; i < kiWidth; i++) {
+      const uint8_t* p0 = pSrc + (i << 2);
+      const uint8_t* p1 = pSrc1 + (i << 2);
+      pDstY[i]  = RGB_TO_Y (p0[kiR], p0[kiG], p0[kiB]);
+      pDstY1[i] = RGB_TO_Y (p1[kiR], p1[kiG], p1[kiB]);
+    }
+    for (int32_t i = 0; i < (kiWidth >> 1); i++) {
+      const uint8_t* p0 = pSrc + (i << 3);
+      const uint8_t* p1 = pSrc1 + (i << 3);
+      const int32_t kiSumR = (p0[kiR] + p0[4 + kiR] + p1[kiR] + p1[4 + kiR] + 2) >> 2;
+      const int32_t kiSumG = (p0[kiG] + p0[4 + kiG] + p1[kiG] + p1[4 + kiG] + 2) >> 2;
+      const int32_t kiSumB = (p0[kiB] + p0[4 + kiB] + p1[kiB] + p1[4 + kiB] + 2) >> 2;
+      pDstU[i] = RGB_TO_U (kiSumR, kiSumG, kiSumB);
+      pDstV[i] = RGB_TO_V (kiSumR, kiSumG, kiSumB);
+    }
+    pDstY += kiDstStrideY << 1;
+    pDstU += kiDstStrideUV;
+    pDstV += kiDstStrideUV;
+    pSrc  += kiSrcStride << 1;
+  }
+}
+
+void Bgra32ToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                     const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                     const int32_t kiHeight) {
+  Rgb32ToI420 (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, pSrc, kiSrcStride, kiWidth, kiHeight, 2, 1, 0);
+}
+
+void Rgba32ToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                     const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                     const int32_t kiHeight) {
+  Rgb32ToI420 (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, pSrc, kiSrcStride, kiWidth, kiHeight, 0, 1, 2);
+}
+
+#if defined(X86_ASM) || defined(HAVE_NEON) || defined(HAVE_NEON_AARCH64)
+// the simd kernels take the columns up to a multiple of their width, the c kernels the remaining ones
+static inline void DeinterleaveChromaWrap (uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStride, uint8_t* pSrc,
+    const int32_t kiSrcStride, const int32_t kiWidth, const int32_t kiHeight, const int32_t kiKernelWidth,
+    PDeinterleaveChromaRowFunc pfRow) {
+  const int32_t kiMainWidth = kiWidth - (kiWidth % kiKernelWidth);
+  if (kiMainWidth > 0) {
+    for (int32_t j = 0; j < kiHeight; j++)
+      pfRow (pDstU + j * kiDstStride, pDstV + j * kiDstStride, pSrc + j * kiSrcStride, kiMainWidth);
+  }
+  if (kiWidth > kiMainWidth)
+    DeinterleaveChroma_c (pDstU + kiMainWidth, pDstV + kiMainWidth, kiDstStride, pSrc + (kiMainWidth << 1), kiSrcStride,
+                          kiWidth - kiMainWidth, kiHeight);
+}
+
+static inline void PackedToI420Wrap (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                                     const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                                     const int32_t kiHeight, const int32_t kiBytesPerPixel, const int32_t kiKernelWidth,
+                                     PPackedToI420RowsFunc pfRows, PPackedToI420Func pfTail) {
+  const int32_t kiMainWidth = kiWidth - (kiWidth % kiKernelWidth);
+  if (kiMainWidth > 0) {
+    for (int32_t j = 0; j < kiHeight; j += 2)
+      pfRows (pDstY + j * kiDstStrideY, kiDstStrideY, pDstU + (j >> 1) * kiDstStrideUV, pDstV + (j >> 1) * kiDstStrideUV,
+              pSrc + j * kiSrcStride, kiSrcStride, kiMainWidth);
+  }
+  if (kiWidth > kiMainWidth)
+    pfTail (pDstY + kiMainWidth, pDstU + (kiMainWidth >> 1), pDstV + (kiMainWidth >> 1), kiDstStrideY, kiDstStrideUV,
+            pSrc + kiMainWidth * kiBytesPerPixel, kiSrcStride, kiWidth - kiMainWidth, kiHeight);
+}
+
+#define DEFINE_DEINTERLEAVE_CHROMA_WRAP(suffix, width) \
+  void DeinterleaveChroma_ ## suffix (uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStride, \
+      uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth, const int32_t kiHeight) { \
+    DeinterleaveChromaWrap (pDstU, pDstV, kiDstStride, pSrc, kiSrcStride, kiWidth, kiHeight, width, \
+        DeinterleaveChromaWidthx ## width ## _ ## suffix); \
+  }
+
+#define DEFINE_PACKED_TO_I420_WRAP(name, bpp, suffix, width) \
+  void name ## _ ## suffix (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY, \
+      const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth, \
+      const int32_t kiHeight) { \
+    PackedToI420Wrap (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, pSrc, kiSrcStride, kiWidth, kiHeight, bpp, \
+        width, name ## Widthx ## width ## _ ## suffix, name ## _c); \
+  }
+#endif
+
+#ifdef X86_ASM
+DEFINE_DEINTERLEAVE_CHROMA_WRAP (sse2, 16)
+DEFINE_PACKED_TO_I420_WRAP (Yuy2ToI420, 2, sse2, 16)
+DEFINE_PACKED_TO_I420_WRAP (Bgra32ToI420, 4, sse2, 8)
+DEFINE_PACKED_TO_I420_WRAP (Rgba32ToI420, 4, sse2, 8)
+#endif //X86_ASM
+
+#ifdef HAVE_NEON
+DEFINE_DEINTERLEAVE_CHROMA_WRAP (neon, 16)
+DEFINE_PACKED_TO_I420_WRAP (Yuy2ToI420, 2, neon, 16)
+DEFINE_PACKED_TO_I420_WRAP (Bgra32ToI420, 4, neon, 16)
+DEFINE_PACKED_TO_I420_WRAP (Rgba32ToI420, 4, neon, 16)
+#endif
+
+#ifdef HAVE_NEON_AARCH64
+DEFINE_DEINTERLEAVE_CHROMA_WRAP (AArch64_neon, 16)
+DEFINE_PACKED_TO_I420_WRAP (Yuy2ToI420, 2, AArch64_neon, 16)
+DEFINE_PACKED_TO_I420_WRAP (Bgra32ToI420, 4, AArch64_neon, 16)
+DEFINE_PACKED_TO_I420_WRAP (Rgba32ToI420, 4, AArch64_neon, 16)
+#endif
+
+WELSVP_NAMESPACE_END
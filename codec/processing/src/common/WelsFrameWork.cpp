@@ -40,6 +40,7 @@
 #include "../adaptivequantization/AdaptiveQuantization.h"
 #include "../complexityanalysis/ComplexityAnalysis.h"
 #include "../imagerotate/imagerotate.h"
+#include "../colorspaceconvert/colorspaceconvert.h"
 #include "util.h"
 
 /* interface API implement */
@@ -259,7 +260,7 @@ IStrategy* CVpFrameWork::CreateStrategy (EMethods m_eMethod, int32_t iCpuFlag) {
 
   switch (m_eMethod) {
   case METHOD_COLORSPACE_CONVERT:
-    //not support yet
+    pStrategy = WelsDynamicCast (IStrategy*, new CColorspaceConvert (iCpuFlag));
     break;
   case METHOD_DENOISE:
     pStrategy = WelsDynamicCast (IStrategy*, new CDenoiser (iCpuFlag));
@@ -0,0 +1,287 @@
+;*!
+;* \copy
+;*     Copyright (c)  2009-2013, Cisco Systems
+;*     All rights reserved.
+;*
+;*     Redistribution and use in source and binary forms, with or without
+;*     modification, are permitted provided that the following conditions
+;*     are met:
+;*
+;*        * Redistributions of source code must retain the above copyright
+;*          notice, this list of conditions and the following disclaimer.
+;*
+;*        * Redistributions in binary form must reproduce the above copyright
+;*          notice, this list of conditions and the following disclaimer in
+;*          the documentation and/or other materials provided with the
+;*          distribution.
+;*
+;*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+;*     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+;*     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+;*     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+;*     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+;*     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+;*     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+;*     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+;*     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+;*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+;*     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+;*     POSSIBILITY OF SUCH DAMAGE.
+;*
+;*
+;*  colorspaceconvert.asm
+;*
+;*  Abstract
+;*      NV12/NV21 chroma, YUY2 and 32 bits RGB to I420, bit exact with the c kernels
+;*
+;*  History
+;*      10/19/2026 Created
+;*
+;*************************************************************************/
+%include "asm_inc.asm"
+
+;***********************************************************************
+; Constant
+;***********************************************************************
+%ifdef X86_32_PICASM
+SECTION .text align=16
+%else
+SECTION .rodata align=16
+%endif
+
+ALIGN 16
+dd_00ff:
+    times 4 dd 0ffh
+dd_2:
+    times 4 dd 2
+dw_1:
+    times 8 dw 1
+dw_16:
+    times 8 dw 16
+dw_128:
+    times 8 dw 128
+
+; BT.601 limited range, Y, U and V weights of the bytes 0, 1 and 2 of a pixel
+rgb_coef_bgra:
+    times 8 dw 25
+    times 8 dw 129
+    times 8 dw 66
+    times 8 dw 112
+    times 8 dw -74
+    times 8 dw -38
+    times 8 dw -18
+    times 8 dw -94
+    times 8 dw 112
+rgb_coef_rgba:
+    times 8 dw 66
+    times 8 dw 129
+    times 8 dw 25
+    times 8 dw -38
+    times 8 dw -74
+    times 8 dw 112
+    times 8 dw 112
+    times 8 dw -94
+    times 8 dw -18
+
+;***********************************************************************
+; Code
+;***********************************************************************
+
+SECTION .text
+
+;***********************************************************************
+; void DeinterleaveChromaWidthx16_sse2 (uint8_t* pDstU, uint8_t* pDstV, uint8_t* pSrc, const int32_t kiWidth);
+;***********************************************************************
+WELS_EXTERN DeinterleaveChromaWidthx16_sse2
+    %assign push_num 0
+    LOAD_4_PARA
+    SIGN_EXTENSION r3, r3d
+    pcmpeqw     xmm4, xmm4
+    psrlw       xmm4, 8                 ; 0x00ff
+.width_loop:
+    movdqu      xmm0, [r2]
+    movdqu      xmm1, [r2 + 16]
+    movdqa      xmm2, xmm0
+    movdqa      xmm3, xmm1
+    pand        xmm0, xmm4
+    pand        xmm1, xmm4
+    psrlw       xmm2, 8
+    psrlw       xmm3, 8
+    packuswb    xmm0, xmm1
+    packuswb    xmm2, xmm3
+    movdqu      [r0], xmm0
+    movdqu      [r1], xmm2
+    add         r0, 16
+    add         r1, 16
+    add         r2, 32
+    sub         r3, 16
+    jg          .width_loop
+    LOAD_4_PARA_POP
+    ret
+
+;***********************************************************************
+; void Yuy2ToI420Widthx16_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                               uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth);
+;***********************************************************************
+WELS_EXTERN Yuy2ToI420Widthx16_sse2
+    %assign push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 7
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r5, r5d
+    SIGN_EXTENSION r6, r6d
+    pcmpeqw     xmm5, xmm5
+    psrlw       xmm5, 8                 ; 0x00ff
+.width_loop:
+    movdqu      xmm0, [r4]
+    movdqu      xmm1, [r4 + 16]
+    movdqu      xmm2, [r4 + r5]
+    movdqu      xmm3, [r4 + r5 + 16]
+    movdqa      xmm4, xmm0
+    movdqa      xmm6, xmm1
+    pavgb       xmm4, xmm2              ; chroma of the two rows averaged in the odd bytes
+    pavgb       xmm6, xmm3
+    pand        xmm0, xmm5
+    pand        xmm1, xmm5
+    pand        xmm2, xmm5
+    pand        xmm3, xmm5
+    packuswb    xmm0, xmm1
+    packuswb    xmm2, xmm3
+    movdqu      [r0], xmm0
+    movdqu      [r0 + r1], xmm2
+    psrlw       xmm4, 8
+    psrlw       xmm6, 8
+    packuswb    xmm4, xmm6              ; U V U V ...
+    movdqa      xmm6, xmm4
+    pand        xmm4, xmm5
+    psrlw       xmm6, 8
+    packuswb    xmm4, xmm6              ; U in the low half, V in the high half
+    movq        [r2], xmm4
+    movhps      [r3], xmm4
+    add         r0, 16
+    add         r2, 8
+    add         r3, 8
+    add         r4, 32
+    sub         r6, 16
+    jg          .width_loop
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+
+; out: xmm2/xmm3/xmm0 sums of the horizontal pairs of the components in the bytes 0/1/2 of the 8 pixels
+; %1=pSrc, %2=pDstY, %3=weights
+%macro SSE2_Rgb32RowToY 3
+    movdqu      xmm0, [%1]
+    movdqu      xmm1, [%1 + 16]
+    movdqa      xmm4, [pic(dd_00ff)]
+    movdqa      xmm2, xmm0
+    movdqa      xmm3, xmm1
+    pand        xmm2, xmm4
+    pand        xmm3, xmm4
+    packssdw    xmm2, xmm3
+    psrld       xmm0, 8
+    psrld       xmm1, 8
+    movdqa      xmm3, xmm0
+    pand        xmm3, xmm4
+    pand        xmm4, xmm1
+    packssdw    xmm3, xmm4
+    psrld       xmm0, 8
+    psrld       xmm1, 8
+    movdqa      xmm4, [pic(dd_00ff)]
+    pand        xmm0, xmm4
+    pand        xmm1, xmm4
+    packssdw    xmm0, xmm1
+    movdqa      xmm1, xmm2
+    pmullw      xmm1, [pic(%3)]
+    movdqa      xmm4, xmm3
+    pmullw      xmm4, [pic(%3 + 16)]
+    paddw       xmm1, xmm4
+    movdqa      xmm4, xmm0
+    pmullw      xmm4, [pic(%3 + 32)]
+    paddw       xmm1, xmm4              ; at most 56100, taken as unsigned
+    paddw       xmm1, [pic(dw_128)]
+    psrlw       xmm1, 8
+    paddw       xmm1, [pic(dw_16)]
+    packuswb    xmm1, xmm1
+    movq        [%2], xmm1
+    movdqa      xmm4, [pic(dw_1)]
+    pmaddwd     xmm2, xmm4
+    pmaddwd     xmm3, xmm4
+    pmaddwd     xmm0, xmm4
+%endmacro
+
+; %1=xmm of the 2x2 averages of the component 0, then 1 and 2 in the following registers, %2=weights
+%macro SSE2_Rgb32AverageToChroma 4
+    pmullw      %1, [pic(%4)]
+    pmullw      %2, [pic(%4 + 16)]
+    pmullw      %3, [pic(%4 + 32)]
+    paddw       %1, %2
+    paddw       %1, %3
+    paddw       %1, xmm4
+    psraw       %1, 8
+    paddw       %1, xmm4
+    packuswb    %1, %1
+%endmacro
+
+;***********************************************************************
+; void Bgra32ToI420Widthx8_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth);
+; void Rgba32ToI420Widthx8_sse2 (uint8_t* pDstY, const int32_t kiDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth);
+;***********************************************************************
+%macro SSE2_Rgb32ToI420Widthx8 2
+WELS_EXTERN %1
+    %assign push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 8
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r5, r5d
+    SIGN_EXTENSION r6, r6d
+%ifdef X86_32_PICASM
+    %define i_width dword arg7
+%else
+    %define i_width r6
+%endif
+    INIT_X86_32_PIC_NOPRESERVE r6
+.width_loop:
+    SSE2_Rgb32RowToY r4, r0, %2
+    movdqa      xmm5, xmm2
+    movdqa      xmm6, xmm3
+    movdqa      xmm7, xmm0
+    SSE2_Rgb32RowToY r4 + r5, r0 + r1, %2
+    movdqa      xmm4, [pic(dd_2)]
+    paddd       xmm5, xmm2
+    paddd       xmm6, xmm3
+    paddd       xmm7, xmm0
+    paddd       xmm5, xmm4
+    paddd       xmm6, xmm4
+    paddd       xmm7, xmm4
+    psrld       xmm5, 2
+    psrld       xmm6, 2
+    psrld       xmm7, 2
+    packssdw    xmm5, xmm5
+    packssdw    xmm6, xmm6
+    packssdw    xmm7, xmm7
+    movdqa      xmm0, xmm5
+    movdqa      xmm1, xmm6
+    movdqa      xmm2, xmm7
+    movdqa      xmm4, [pic(dw_128)]
+    SSE2_Rgb32AverageToChroma xmm0, xmm1, xmm2, %2 + 48
+    movd        [r2], xmm0
+    SSE2_Rgb32AverageToChroma xmm5, xmm6, xmm7, %2 + 96
+    movd        [r3], xmm5
+    add         r0, 8
+    add         r2, 4
+    add         r3, 4
+    add         r4, 32
+    sub         i_width, 8
+    jg          .width_loop
+    DEINIT_X86_32_PIC
+    %undef i_width
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+%endmacro
+
+SSE2_Rgb32ToI420Widthx8 Bgra32ToI420Widthx8_sse2, rgb_coef_bgra
+SSE2_Rgb32ToI420Widthx8 Rgba32ToI420Widthx8_sse2, rgb_coef_rgba
@@ -5,6 +5,8 @@ PROCESSING_SRCDIR=codec/processing
 PROCESSING_CPP_SRCS=\
 	$(PROCESSING_SRCDIR)/src/adaptivequantization/AdaptiveQuantization.cpp\
 	$(PROCESSING_SRCDIR)/src/backgrounddetection/BackgroundDetection.cpp\
+	$(PROCESSING_SRCDIR)/src/colorspaceconvert/colorspaceconvert.cpp\
+	$(PROCESSING_SRCDIR)/src/colorspaceconvert/colorspaceconvertfuncs.cpp\
 	$(PROCESSING_SRCDIR)/src/common/memory.cpp\
 	$(PROCESSING_SRCDIR)/src/common/WelsFrameWork.cpp\
 	$(PROCESSING_SRCDIR)/src/common/WelsFrameWorkEx.cpp\
@@ -24,6 +26,7 @@ PROCESSING_CPP_SRCS=\
 PROCESSING_OBJS += $(PROCESSING_CPP_SRCS:.cpp=.$(OBJ))
 
 PROCESSING_ASM_SRCS=\
+	$(PROCESSING_SRCDIR)/src/x86/colorspaceconvert.asm\
 	$(PROCESSING_SRCDIR)/src/x86/denoisefilter.asm\
 	$(PROCESSING_SRCDIR)/src/x86/downsample_bilinear.asm\
 	$(PROCESSING_SRCDIR)/src/x86/vaa.asm\
@@ -36,6 +39,7 @@ OBJS += $(PROCESSING_OBJSASM)
 
 PROCESSING_ASM_ARM_SRCS=\
 	$(PROCESSING_SRCDIR)/src/arm/adaptive_quantization.S\
+	$(PROCESSING_SRCDIR)/src/arm/colorspace_convert_neon.S\
 	$(PROCESSING_SRCDIR)/src/arm/down_sample_neon.S\
 	$(PROCESSING_SRCDIR)/src/arm/pixel_sad_neon.S\
 	$(PROCESSING_SRCDIR)/src/arm/vaa_calc_neon.S\
@@ -48,6 +52,7 @@ OBJS += $(PROCESSING_OBJSARM)
 
 PROCESSING_ASM_ARM64_SRCS=\
 	$(PROCESSING_SRCDIR)/src/arm64/adaptive_quantization_aarch64_neon.S\
+	$(PROCESSING_SRCDIR)/src/arm64/colorspace_convert_aarch64_neon.S\
 	$(PROCESSING_SRCDIR)/src/arm64/down_sample_aarch64_neon.S\
 	$(PROCESSING_SRCDIR)/src/arm64/pixel_sad_aarch64_neon.S\
 	$(PROCESSING_SRCDIR)/src/arm64/vaa_calc_aarch64_neon.S\
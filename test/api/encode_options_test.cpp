@@ -2386,3 +2386,2047 @@ TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_IDR_INTERVAL) {
     }
   }
 }
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_ZERO_COPY_INPUT) {
+  int iWidth       = 320;
+  int iHeight      = 192;
+  float fFrameRate = 30.0f;
+
+  SEncParamExt sParam;
+  prepareParamDefault (1, 1, iWidth, iHeight, fFrameRate, &sParam);
+  int rv = encoder_->InitializeExt (&sParam);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+  SZeroCopyInputParam sZeroCopy;
+  memset (&sZeroCopy, 0, sizeof (sZeroCopy));
+  sZeroCopy.bEnable = true;
+  rv = encoder_->SetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  memset (&sZeroCopy, 0, sizeof (sZeroCopy));
+  rv = encoder_->GetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_TRUE (sZeroCopy.bEnable);
+  ASSERT_TRUE (sZeroCopy.iStride[0] >= iWidth && sZeroCopy.iStride[1] >= (iWidth >> 1)
+               && sZeroCopy.iStride[2] >= (iWidth >> 1));
+
+  // caller planes laid out as the encoder asks for
+  const int kiLumaSize = sZeroCopy.iStride[0] * iHeight;
+  const int kiChromaSize = sZeroCopy.iStride[1] * (iHeight >> 1);
+  unsigned char* pBuf = static_cast<unsigned char*> (malloc (kiLumaSize + (kiChromaSize << 1) + 16 * 3));
+  ASSERT_TRUE (pBuf != NULL);
+  unsigned char* pAligned = (unsigned char*) (((intptr_t)pBuf + 15) & ~ (intptr_t)15);
+
+  SSourcePicture sSrcPic;
+  memset (&sSrcPic, 0, sizeof (sSrcPic));
+  sSrcPic.iColorFormat = videoFormatI420;
+  sSrcPic.iPicWidth = iWidth;
+  sSrcPic.iPicHeight = iHeight;
+  sSrcPic.iStride[0] = sZeroCopy.iStride[0];
+  sSrcPic.iStride[1] = sZeroCopy.iStride[1];
+  sSrcPic.iStride[2] = sZeroCopy.iStride[2];
+  sSrcPic.pData[0] = pAligned;
+  sSrcPic.pData[1] = sSrcPic.pData[0] + ((kiLumaSize + 15) & ~15);
+  sSrcPic.pData[2] = sSrcPic.pData[1] + ((kiChromaSize + 15) & ~15);
+
+  unsigned char* pData[3] = { NULL };
+  for (int iFrame = 0; iFrame < 10; iFrame++) {
+    for (int i = 0; i < iHeight; i++) {
+      for (int j = 0; j < iWidth; j++) {
+        sSrcPic.pData[0][i * sSrcPic.iStride[0] + j] = (unsigned char) (i + j + iFrame * 3);
+      }
+    }
+    memset (sSrcPic.pData[1], 128 + iFrame, kiChromaSize);
+    memset (sSrcPic.pData[2], 128 - iFrame, kiChromaSize);
+    sSrcPic.uiTimeStamp = iFrame * 33;
+
+    rv = encoder_->EncodeFrame (&sSrcPic, &info);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    rv = encoder_->GetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_TRUE (sZeroCopy.bLastInPlace) << "iFrame = " << iFrame;
+
+    int iLen = 0;
+    encToDecData (info, iLen);
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    ASSERT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+
+    // the encoder has seen the caller planes
+    int64_t iDiff = 0;
+    for (int i = 0; i < iHeight; i++) {
+      for (int j = 0; j < iWidth; j++) {
+        iDiff += abs (pData[0][i * dstBufInfo_.UsrData.sSystemBuffer.iStride[0] + j]
+                      - sSrcPic.pData[0][i * sSrcPic.iStride[0] + j]);
+      }
+    }
+    EXPECT_LT (iDiff, (int64_t)iWidth * iHeight * 2) << "iFrame = " << iFrame;
+  }
+
+  // planes which do not match the requested layout are copied as before
+  sSrcPic.iStride[0] = iWidth;
+  sSrcPic.iStride[1] = sSrcPic.iStride[2] = iWidth >> 1;
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  rv = encoder_->GetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_FALSE (sZeroCopy.bLastInPlace);
+
+  free (pBuf);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_ZERO_COPY_INPUT_ANALYSIS) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 8;
+  // the same source encoded in place and copied, without the analysis which compares with the previous picture
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  SZeroCopyInputParam sZeroCopy;
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 30;
+    sParam.bEnableSceneChangeDetect = false;
+    sParam.bEnableBackgroundDetection = false;
+    sParam.bEnableAdaptiveQuant = false;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+    memset (&sZeroCopy, 0, sizeof (sZeroCopy));
+    sZeroCopy.bEnable = (i == 0);
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  int rv = encoder_->GetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+  // two sets of caller planes used in turn, each scribbled over as soon as EncodeFrame() returns
+  const int kiLumaSize = sZeroCopy.iStride[0] * kiHeight;
+  const int kiChromaSize = sZeroCopy.iStride[1] * (kiHeight >> 1);
+  const int kiPlanesSize = ((kiLumaSize + 15) & ~15) + (((kiChromaSize + 15) & ~15) << 1);
+  unsigned char* pBuf = static_cast<unsigned char*> (malloc ((kiPlanesSize << 1) + 16));
+  ASSERT_TRUE (pBuf != NULL);
+  unsigned char* pAligned = (unsigned char*) (((intptr_t)pBuf + 15) & ~ (intptr_t)15);
+
+  SSourcePicture sSrcPic;
+  memset (&sSrcPic, 0, sizeof (sSrcPic));
+  sSrcPic.iColorFormat = videoFormatI420;
+  sSrcPic.iPicWidth = kiWidth;
+  sSrcPic.iPicHeight = kiHeight;
+  for (int i = 0; i < 3; i++)
+    sSrcPic.iStride[i] = sZeroCopy.iStride[i];
+
+  std::vector<unsigned char> vStream[2];
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    sSrcPic.pData[0] = pAligned + (iFrame & 1) * kiPlanesSize;
+    sSrcPic.pData[1] = sSrcPic.pData[0] + ((kiLumaSize + 15) & ~15);
+    sSrcPic.pData[2] = sSrcPic.pData[1] + ((kiChromaSize + 15) & ~15);
+    for (int i = 0; i < kiHeight; i++) {
+      for (int j = 0; j < kiWidth; j++) {
+        const int kiU = j - 3 * iFrame + 64, kiV = i - iFrame + 64;
+        sSrcPic.pData[0][i * sSrcPic.iStride[0] + j] = (unsigned char) (((kiU * 7) ^ (kiV * 5)) + kiU + kiV);
+      }
+    }
+    memset (sSrcPic.pData[1], 128 + iFrame, kiChromaSize);
+    memset (sSrcPic.pData[2], 128 - iFrame, kiChromaSize);
+    sSrcPic.uiTimeStamp = iFrame * 33;
+
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&sSrcPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      for (int iLayer = 0; iLayer < info.iLayerNum; iLayer++) {
+        const SLayerBSInfo& kLayer = info.sLayerInfo[iLayer];
+        int iLayerSize = 0;
+        for (int iNal = 0; iNal < kLayer.iNalCount; iNal++)
+          iLayerSize += kLayer.pNalLengthInByte[iNal];
+        vStream[i].insert (vStream[i].end(), kLayer.pBsBuf, kLayer.pBsBuf + iLayerSize);
+      }
+    }
+    rv = encoder_->GetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_TRUE (sZeroCopy.bLastInPlace) << "iFrame = " << iFrame;
+    memset (sSrcPic.pData[0], iFrame * 37, kiPlanesSize);
+  }
+  EXPECT_TRUE (vStream[0] == vStream[1]);
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+  free (pBuf);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_ZERO_COPY_INPUT_SKIP) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 30;
+
+  // a bitrate far too low for the source, the rate control skips pictures read in place
+  SEncParamExt sParam;
+  prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.iMaxBitrate = sParam.sSpatialLayers[0].iSpatialBitrate
+                          = sParam.sSpatialLayers[0].iMaxSpatialBitrate = 20000;
+  sParam.bEnableFrameSkip = true;
+  int rv = encoder_->InitializeExt (&sParam);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  SZeroCopyInputParam sZeroCopy;
+  memset (&sZeroCopy, 0, sizeof (sZeroCopy));
+  sZeroCopy.bEnable = true;
+  rv = encoder_->SetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  rv = encoder_->GetOption (ENCODER_OPTION_ZERO_COPY_INPUT, &sZeroCopy);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  const int kiLumaSize = sZeroCopy.iStride[0] * kiHeight;
+  const int kiChromaSize = sZeroCopy.iStride[1] * (kiHeight >> 1);
+  const int kiPlanesSize = ((kiLumaSize + 15) & ~15) + (((kiChromaSize + 15) & ~15) << 1);
+  unsigned char* pData[3] = { NULL };
+  int iSkipped = 0;
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    // planes of their own for each picture, released as soon as EncodeFrame() returns
+    unsigned char* pBuf = static_cast<unsigned char*> (malloc (kiPlanesSize + 16));
+    ASSERT_TRUE (pBuf != NULL);
+    SSourcePicture sSrcPic;
+    memset (&sSrcPic, 0, sizeof (sSrcPic));
+    sSrcPic.iColorFormat = videoFormatI420;
+    sSrcPic.iPicWidth = kiWidth;
+    sSrcPic.iPicHeight = kiHeight;
+    for (int i = 0; i < 3; i++)
+      sSrcPic.iStride[i] = sZeroCopy.iStride[i];
+    sSrcPic.pData[0] = (unsigned char*) (((intptr_t)pBuf + 15) & ~ (intptr_t)15);
+    sSrcPic.pData[1] = sSrcPic.pData[0] + ((kiLumaSize + 15) & ~15);
+    sSrcPic.pData[2] = sSrcPic.pData[1] + ((kiChromaSize + 15) & ~15);
+    for (int i = 0; i < kiPlanesSize; i++)
+      sSrcPic.pData[0][i] = (unsigned char) rand();
+    sSrcPic.uiTimeStamp = iFrame * 33;
+
+    rv = encoder_->EncodeFrame (&sSrcPic, &info);
+    memset (pBuf, 0, kiPlanesSize + 16);
+    free (pBuf);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    if (info.eFrameType == videoFrameTypeSkip) {
+      ++ iSkipped;
+      continue;
+    }
+
+    int iLen = 0;
+    encToDecData (info, iLen);
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+  }
+  EXPECT_GT (iSkipped, 0);
+  EXPECT_LT (iSkipped, kiFrameNum);
+}
+
+static void FillPackedSource (SSourcePicture* pSrcPic, unsigned char* pBuf, int iFormat, int iWidth, int iHeight,
+                              int iFrame) {
+  memset (pSrcPic, 0, sizeof (SSourcePicture));
+  pSrcPic->iColorFormat = iFormat;
+  pSrcPic->iPicWidth = iWidth;
+  pSrcPic->iPicHeight = iHeight;
+  pSrcPic->uiTimeStamp = iFrame * 33;
+  pSrcPic->pData[0] = pBuf;
+  // chroma is constant over each pair of rows, so that every format describes the same I420 picture
+  for (int i = 0; i < iHeight; i++) {
+    for (int j = 0; j < iWidth; j++) {
+      const unsigned char uiY = (unsigned char) (i * 3 + j + iFrame * 5);
+      const unsigned char uiU = (unsigned char) (64 + (i >> 1) + iFrame);
+      const unsigned char uiV = (unsigned char) (192 - (j >> 1) - iFrame);
+      switch (iFormat) {
+      case videoFormatI420:
+        pBuf[i * iWidth + j] = uiY;
+        pBuf[iWidth * iHeight + (i >> 1) * (iWidth >> 1) + (j >> 1)] = uiU;
+        pBuf[iWidth * iHeight * 5 / 4 + (i >> 1) * (iWidth >> 1) + (j >> 1)] = uiV;
+        break;
+      case videoFormatNV12:
+      case videoFormatNV21:
+        pBuf[i * iWidth + j] = uiY;
+        pBuf[iWidth * iHeight + (i >> 1) * iWidth + (j & ~1) + (iFormat == videoFormatNV12 ? 0 : 1)] = uiU;
+        pBuf[iWidth * iHeight + (i >> 1) * iWidth + (j & ~1) + (iFormat == videoFormatNV12 ? 1 : 0)] = uiV;
+        break;
+      case videoFormatYUY2:
+        pBuf[i * iWidth * 2 + j * 2] = uiY;
+        pBuf[i * iWidth * 2 + (j & ~1) * 2 + 1] = uiU;
+        pBuf[i * iWidth * 2 + (j & ~1) * 2 + 3] = uiV;
+        break;
+      }
+    }
+  }
+  switch (iFormat) {
+  case videoFormatI420:
+    pSrcPic->iStride[0] = iWidth;
+    pSrcPic->iStride[1] = pSrcPic->iStride[2] = iWidth >> 1;
+    pSrcPic->pData[1] = pBuf + iWidth * iHeight;
+    pSrcPic->pData[2] = pBuf + iWidth * iHeight * 5 / 4;
+    break;
+  case videoFormatNV12:
+  case videoFormatNV21:
+    pSrcPic->iStride[0] = pSrcPic->iStride[1] = iWidth;
+    pSrcPic->pData[1] = pBuf + iWidth * iHeight;
+    break;
+  case videoFormatYUY2:
+    pSrcPic->iStride[0] = iWidth * 2;
+    break;
+  }
+}
+
+TEST_F (EncodeDecodeTestAPI, EncodeNonI420Input) {
+  int iWidth       = 176;
+  int iHeight      = 144;
+  float fFrameRate = 30.0f;
+  const int kiFrameNum = 5;
+  const int kiFormats[4] = {videoFormatI420, videoFormatNV12, videoFormatNV21, videoFormatYUY2};
+  std::vector<unsigned char> vRefBs[kiFrameNum];
+
+  SEncParamExt sParam;
+  prepareParamDefault (1, 1, iWidth, iHeight, fFrameRate, &sParam);
+  unsigned char* pBuf = new unsigned char[iWidth * iHeight * 4];
+  SSourcePicture sSrcPic;
+  int rv;
+
+  // semi-planar and packed yuv input give the very same bitstream as the I420 one
+  for (int k = 0; k < 4; k++) {
+    rv = encoder_->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+      FillPackedSource (&sSrcPic, pBuf, kiFormats[k], iWidth, iHeight, iFrame);
+      rv = encoder_->EncodeFrame (&sSrcPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFormat = " << kiFormats[k];
+      int iLen = 0;
+      encToDecData (info, iLen);
+      if (k == 0) {
+        vRefBs[iFrame].assign (info.sLayerInfo[0].pBsBuf, info.sLayerInfo[0].pBsBuf + iLen);
+      } else {
+        ASSERT_EQ ((int)vRefBs[iFrame].size(), iLen) << "iFormat = " << kiFormats[k] << " iFrame = " << iFrame;
+        EXPECT_EQ (0, memcmp (&vRefBs[iFrame][0], info.sLayerInfo[0].pBsBuf, iLen))
+            << "iFormat = " << kiFormats[k] << " iFrame = " << iFrame;
+      }
+    }
+    encoder_->Uninitialize();
+  }
+
+  // 32 bits rgb, a mid gray gives the BT.601 limited range luma
+  rv = encoder_->InitializeExt (&sParam);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  memset (pBuf, 128, iWidth * iHeight * 4);
+  memset (&sSrcPic, 0, sizeof (sSrcPic));
+  sSrcPic.iColorFormat = videoFormatBGRA;
+  sSrcPic.iPicWidth = iWidth;
+  sSrcPic.iPicHeight = iHeight;
+  sSrcPic.iStride[0] = iWidth * 4;
+  sSrcPic.pData[0] = pBuf;
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  int iLen = 0;
+  unsigned char* pData[3] = { NULL };
+  encToDecData (info, iLen);
+  memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+  rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+  EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  ASSERT_EQ (dstBufInfo_.iBufferStatus, 1);
+  EXPECT_NEAR (pData[0][ (iHeight >> 1) * dstBufInfo_.UsrData.sSystemBuffer.iStride[0] + (iWidth >> 1)], 126, 2);
+  EXPECT_NEAR (pData[1][ (iHeight >> 2) * dstBufInfo_.UsrData.sSystemBuffer.iStride[1] + (iWidth >> 2)], 128, 2);
+
+  // formats without a conversion are still refused
+  sSrcPic.iColorFormat = videoFormatUYVY;
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  EXPECT_TRUE (rv == cmInitParaError) << "rv = " << rv;
+
+  // a missing plane fails the encode rather than coding the previous picture again
+  sSrcPic.iColorFormat = videoFormatBGRA;
+  sSrcPic.pData[0] = NULL;
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  EXPECT_TRUE (rv == cmInitParaError) << "rv = " << rv;
+  FillPackedSource (&sSrcPic, pBuf, videoFormatNV12, iWidth, iHeight, 0);
+  sSrcPic.pData[1] = NULL;
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  EXPECT_TRUE (rv == cmInitParaError) << "rv = " << rv;
+  FillPackedSource (&sSrcPic, pBuf, videoFormatNV12, iWidth, iHeight, 0);
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+  // rows shorter than the picture are refused as for I420 input
+  FillPackedSource (&sSrcPic, pBuf, videoFormatYUY2, iWidth, iHeight, 0);
+  sSrcPic.iStride[0] = iWidth;
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  EXPECT_TRUE (rv == cmInitParaError) << "rv = " << rv;
+  FillPackedSource (&sSrcPic, pBuf, videoFormatNV21, iWidth, iHeight, 0);
+  sSrcPic.iStride[1] = iWidth >> 1;
+  rv = encoder_->EncodeFrame (&sSrcPic, &info);
+  EXPECT_TRUE (rv == cmInitParaError) << "rv = " << rv;
+
+  delete[] pBuf;
+}
+
+struct SSliceOutputCollector {
+  std::vector<unsigned char> vBs;
+  std::vector<int> vSliceIdx;
+  long long uiTimeStamp;
+  bool bConsistent;
+};
+
+static void CollectSliceOutput (void* pContext, const SSliceOutputInfo* pInfo) {
+  SSliceOutputCollector* pCollector = static_cast<SSliceOutputCollector*> (pContext);
+  int iLen = 0;
+  for (int i = 0; i < pInfo->iNalCount; i++)
+    iLen += pInfo->pNalLengthInByte[i];
+  pCollector->vBs.insert (pCollector->vBs.end(), pInfo->pBsBuf, pInfo->pBsBuf + iLen);
+  pCollector->vSliceIdx.push_back (pInfo->iSliceIdx);
+  if (pInfo->uiTimeStamp != pCollector->uiTimeStamp || pInfo->iSpatialId != 0)
+    pCollector->bConsistent = false;
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_SLICE_OUTPUT_CALLBACK) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  // {slice mode, slice num, thread num}
+  const int kiCases[5][3] = {
+    {SM_SINGLE_SLICE, 1, 1},
+    {SM_FIXEDSLCNUM_SLICE, 4, 1},
+    {SM_FIXEDSLCNUM_SLICE, 4, 3},
+    {SM_SIZELIMITED_SLICE, 0, 1},
+    {SM_SIZELIMITED_SLICE, 0, 2},
+  };
+
+  for (int iCase = 0; iCase < 5; iCase++) {
+    SEncParamExt sParam;
+    encoder_->GetDefaultParams (&sParam);
+    prepareParamDefault (1, kiCases[iCase][1], kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iMultipleThreadIdc = kiCases[iCase][2];
+    sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = (SliceModeEnum)kiCases[iCase][0];
+    if (SM_SIZELIMITED_SLICE == kiCases[iCase][0]) {
+      sParam.sSpatialLayers[0].sSliceArgument.uiSliceSizeConstraint = 1000;
+      sParam.uiMaxNalSize = 1000;
+    }
+    int rv = encoder_->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iCase = " << iCase;
+    ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+    SSliceOutputCollector sCollector;
+    SSliceOutputCallbackParam sSliceOutput;
+    sSliceOutput.pCallback = CollectSliceOutput;
+    sSliceOutput.pContext = &sCollector;
+    rv = encoder_->SetOption (ENCODER_OPTION_SLICE_OUTPUT_CALLBACK, &sSliceOutput);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    memset (&sSliceOutput, 0, sizeof (sSliceOutput));
+    rv = encoder_->GetOption (ENCODER_OPTION_SLICE_OUTPUT_CALLBACK, &sSliceOutput);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_TRUE (sSliceOutput.pCallback == CollectSliceOutput && sSliceOutput.pContext == &sCollector);
+
+    for (int iFrame = 0; iFrame < 4; iFrame++) {
+      for (int i = 0; i < kiWidth * kiHeight * 3 / 2; i++)
+        buf_.data()[i] = (unsigned char) ((i % kiWidth) * 3 + (i / kiWidth) * 5 + iFrame * 7 + rand() % 32);
+      EncPic.uiTimeStamp = iFrame * 33;
+      sCollector.vBs.clear();
+      sCollector.vSliceIdx.clear();
+      sCollector.uiTimeStamp = EncPic.uiTimeStamp;
+      sCollector.bConsistent = true;
+
+      rv = encoder_->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iCase = " << iCase << " iFrame = " << iFrame;
+      int iLen = 0;
+      encToDecData (info, iLen);
+
+      // the slices handed out one by one make up the whole frame, in slice order
+      EXPECT_TRUE (sCollector.bConsistent) << "iCase = " << iCase << " iFrame = " << iFrame;
+      ASSERT_EQ ((int)sCollector.vBs.size(), iLen) << "iCase = " << iCase << " iFrame = " << iFrame;
+      EXPECT_EQ (0, memcmp (&sCollector.vBs[0], info.sLayerInfo[0].pBsBuf, iLen));
+      int iExpectedIdx = 0;
+      for (size_t i = 0; i < sCollector.vSliceIdx.size(); i++) {
+        if (sCollector.vSliceIdx[i] < 0) {
+          EXPECT_EQ (0, iExpectedIdx) << "parameter sets come before the first slice";
+          continue;
+        }
+        EXPECT_EQ (iExpectedIdx, sCollector.vSliceIdx[i]) << "iCase = " << iCase << " iFrame = " << iFrame;
+        iExpectedIdx = sCollector.vSliceIdx[i] + 1;
+      }
+      if (SM_FIXEDSLCNUM_SLICE == kiCases[iCase][0]) {
+        EXPECT_EQ (kiCases[iCase][1], iExpectedIdx);
+      } else if (SM_SIZELIMITED_SLICE == kiCases[iCase][0]) {
+        EXPECT_GT (iExpectedIdx, 1);
+      }
+    }
+
+    memset (&sSliceOutput, 0, sizeof (sSliceOutput));
+    rv = encoder_->SetOption (ENCODER_OPTION_SLICE_OUTPUT_CALLBACK, &sSliceOutput);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    encoder_->Uninitialize();
+  }
+}
+
+static unsigned int SumMbTypes (const SProfilingCounters& kCounters) {
+  unsigned int uiSum = 0;
+  for (int i = 0; i < PROFILING_MB_TYPE_NUM; i++)
+    uiSum += kCounters.uiMbTypeCount[i];
+  return uiSum;
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_PROFILING) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const unsigned int kuiMbNum = (kiWidth >> 4) * (kiHeight >> 4);
+  const int kiFrameNum = 4;
+  // {slice num, thread num}
+  const int kiCases[2][2] = {
+    {1, 1},
+    {4, 3},
+  };
+
+  for (int iCase = 0; iCase < 2; iCase++) {
+    SEncParamExt sParam;
+    encoder_->GetDefaultParams (&sParam);
+    prepareParamDefault (1, kiCases[iCase][0], kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iMultipleThreadIdc = kiCases[iCase][1];
+    int rv = encoder_->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iCase = " << iCase;
+    ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+    SEncoderProfiling sProfiling;
+    memset (&sProfiling, 0, sizeof (sProfiling));
+    rv = encoder_->GetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_FALSE (sProfiling.bEnable);
+    EXPECT_EQ (0u, sProfiling.uiFrameCount);
+
+    sProfiling.bEnable = true;
+    sProfiling.bReset = true;
+    rv = encoder_->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+    for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+      for (int i = 0; i < kiWidth * kiHeight * 3 / 2; i++)
+        buf_.data()[i] = (unsigned char) ((i % kiWidth) * 3 + (i / kiWidth) * 5 + iFrame * 7 + rand() % 32);
+      EncPic.uiTimeStamp = iFrame * 33;
+      rv = encoder_->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iCase = " << iCase << " iFrame = " << iFrame;
+
+      memset (&sProfiling, 0, sizeof (sProfiling));
+      rv = encoder_->GetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      EXPECT_TRUE (sProfiling.bEnable);
+      EXPECT_EQ ((unsigned int) (iFrame + 1), sProfiling.uiFrameCount);
+      // every MB of the frame is counted once, whichever slice thread coded it
+      EXPECT_EQ (kuiMbNum, SumMbTypes (sProfiling.sLastFrame)) << "iCase = " << iCase << " iFrame = " << iFrame;
+      EXPECT_EQ (kuiMbNum * (iFrame + 1), SumMbTypes (sProfiling.sTotal)) << "iCase = " << iCase << " iFrame = " << iFrame;
+    }
+
+    const SProfilingCounters& kTotal = sProfiling.sTotal;
+    EXPECT_GT (kTotal.iStageTimeUs[PROFILING_STAGE_MODE_DECISION], 0);
+    EXPECT_GT (kTotal.iStageTimeUs[PROFILING_STAGE_ENTROPY_CODING], 0);
+    EXPECT_GT (kTotal.iSadCount, 0);
+    EXPECT_GT (kTotal.iSubpelRefineCount, 0);
+    EXPECT_GT (kTotal.uiMbTypeCount[PROFILING_MB_INTER16x16] + kTotal.uiMbTypeCount[PROFILING_MB_SKIP], 0u);
+    for (int i = 0; i < PROFILING_STAGE_NUM; i++) {
+      EXPECT_GE (kTotal.iStageTimeUs[i], sProfiling.sLastFrame.iStageTimeUs[i]);
+    }
+
+    // reset while staying enabled
+    sProfiling.bEnable = true;
+    sProfiling.bReset = true;
+    rv = encoder_->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    memset (&sProfiling, 0xff, sizeof (sProfiling));
+    rv = encoder_->GetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_EQ (0u, sProfiling.uiFrameCount);
+    EXPECT_EQ (0, sProfiling.sTotal.iSadCount);
+    EXPECT_EQ (0u, SumMbTypes (sProfiling.sTotal));
+
+    // disabled profiling stops counting
+    sProfiling.bEnable = false;
+    sProfiling.bReset = false;
+    rv = encoder_->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EncPic.uiTimeStamp = kiFrameNum * 33;
+    rv = encoder_->EncodeFrame (&EncPic, &info);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    rv = encoder_->GetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_FALSE (sProfiling.bEnable);
+    EXPECT_EQ (0u, sProfiling.uiFrameCount);
+    EXPECT_EQ (0u, SumMbTypes (sProfiling.sTotal));
+
+    encoder_->Uninitialize();
+  }
+}
+
+// I420 picture of a texture moving by (iDx, iDy) pixels per frame
+static void FillMovingTexture (unsigned char* pBuf, int iWidth, int iHeight, int iFrame, int iDx, int iDy) {
+  for (int i = 0; i < iHeight; i++) {
+    for (int j = 0; j < iWidth; j++) {
+      const int kiU = j - iDx * iFrame + 64, kiV = i - iDy * iFrame + 64;
+      pBuf[i * iWidth + j] = (unsigned char) (((kiU * 7) ^ (kiV * 5)) + kiU + kiV);
+    }
+  }
+  memset (pBuf + iWidth * iHeight, 128, iWidth * iHeight / 2);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_MOTION_HINT) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiMbWidth  = kiWidth >> 4;
+  const int kiMbHeight = kiHeight >> 4;
+  const int kiFrameNum = 6;
+  const int kiDx = 3, kiDy = 1; // motion of the content in pixels per frame
+  std::vector<SMbMotionHint> vHints (kiMbWidth * kiMbHeight);
+  for (size_t i = 0; i < vHints.size(); i++) {
+    SMbMotionHint& sHint = vHints[i];
+    sHint.iMv16x16[0] = -kiDx * 4;
+    sHint.iMv16x16[1] = -kiDy * 4;
+    for (int j = 0; j < 4; j++) {
+      sHint.iMv8x8[j][0] = sHint.iMv16x16[0];
+      sHint.iMv8x8[j][1] = sHint.iMv16x16[1];
+    }
+    sHint.iRefIdx = 0;
+    sHint.uiPartition = MOTION_HINT_16x16;
+  }
+
+  long long iSadCount[2] = {0, 0};
+  for (int iRun = 0; iRun < 2; iRun++) {
+    SEncParamExt sParam;
+    encoder_->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    int rv = encoder_->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+    SEncoderProfiling sProfiling;
+    memset (&sProfiling, 0, sizeof (sProfiling));
+    sProfiling.bEnable = true;
+    rv = encoder_->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+    unsigned char* pData[3] = { NULL };
+    for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+      FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, kiDx, kiDy);
+      EncPic.uiTimeStamp = iFrame * 33;
+
+      SMotionHintParam sHintParam;
+      memset (&sHintParam, 0, sizeof (sHintParam));
+      if (iRun == 1 && iFrame > 0) {
+        sHintParam.pHints = &vHints[0];
+        sHintParam.iMbWidth = kiMbWidth;
+        sHintParam.iMbHeight = kiMbHeight;
+        sHintParam.bEarlyTermination = true;
+      }
+      rv = encoder_->SetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+      rv = encoder_->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iRun = " << iRun << " iFrame = " << iFrame;
+      // the hints only apply to the picture which follows them
+      memset (&sHintParam, 0xff, sizeof (sHintParam));
+      rv = encoder_->GetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      EXPECT_TRUE (sHintParam.pHints == NULL && sHintParam.iMbWidth == 0);
+
+      int iLen = 0;
+      encToDecData (info, iLen);
+      memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+      rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+      EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iRun = " << iRun << " iFrame = " << iFrame;
+      ASSERT_EQ (dstBufInfo_.iBufferStatus, 1) << "iRun = " << iRun << " iFrame = " << iFrame;
+      int64_t iDiff = 0;
+      for (int i = 0; i < kiHeight; i++) {
+        for (int j = 0; j < kiWidth; j++) {
+          iDiff += abs (pData[0][i * dstBufInfo_.UsrData.sSystemBuffer.iStride[0] + j] - buf_.data()[i * kiWidth + j]);
+        }
+      }
+      EXPECT_LT (iDiff, (int64_t)kiWidth * kiHeight * 4) << "iRun = " << iRun << " iFrame = " << iFrame;
+    }
+
+    rv = encoder_->GetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    iSadCount[iRun] = sProfiling.sTotal.iSadCount;
+
+    // a map of another resolution is scaled, a map without size is refused
+    SMotionHintParam sHintParam;
+    memset (&sHintParam, 0, sizeof (sHintParam));
+    sHintParam.pHints = &vHints[0];
+    sHintParam.iMbWidth = kiMbWidth >> 1;
+    sHintParam.iMbHeight = kiMbHeight >> 1;
+    sHintParam.bEarlyTermination = true;
+    rv = encoder_->SetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EncPic.uiTimeStamp = kiFrameNum * 33;
+    rv = encoder_->EncodeFrame (&EncPic, &info);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    sHintParam.iMbWidth = 0;
+    rv = encoder_->SetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+    EXPECT_TRUE (rv != cmResultSuccess);
+
+    encoder_->Uninitialize();
+  }
+  // the partition search is replaced by the hinted 16x16
+  EXPECT_GT (iSadCount[0], 0);
+  EXPECT_LT (iSadCount[1], iSadCount[0]);
+}
+
+// releases the encoders created by a test, also when an ASSERT returns early
+struct SEncoderGuard {
+  ISVCEncoder** pEncoders;
+  int iNum;
+  ~SEncoderGuard() {
+    for (int i = 0; i < iNum; i++) {
+      if (pEncoders[i]) {
+        pEncoders[i]->Uninitialize();
+        WelsDestroySVCEncoder (pEncoders[i]);
+      }
+    }
+  }
+};
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_MOTION_ANALYSIS) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 6;
+  const int kiQpGapMax = 6; // MOTION_HINT_QP_GAP_MAX of the encoder
+  // renditions of the same source, the first one shares its motion with the others
+  // {QP, use the motion of the first rendition}
+  const int kiRenditions[4][2] = {
+    {26, 0},
+    {30, 1},
+    {30, 0},
+    {44, 1},
+  };
+  ISVCEncoder* pEncoders[4] = { encoder_, NULL, NULL, NULL };
+  SEncoderGuard sGuard = { pEncoders + 1, 3 };
+  for (int i = 1; i < 4; i++) {
+    ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[i]));
+  }
+
+  for (int i = 0; i < 4; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = kiRenditions[i][0];
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+
+    SEncoderProfiling sProfiling;
+    memset (&sProfiling, 0, sizeof (sProfiling));
+    sProfiling.bEnable = true;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+    // every rendition reports its decisions, to check them against those of the first one
+    SMotionAnalysis sAnalysis;
+    memset (&sAnalysis, 0, sizeof (sAnalysis));
+    sAnalysis.bEnable = true;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sAnalysis);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  SMotionAnalysis sAnalysis;
+  int rv;
+  int iTrustedMbs = 0;
+  int iSearchedMbs = 0;
+
+  unsigned char* pData[3] = { NULL };
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 2, 1);
+    // the left quarter moves the other way in every second band of 8 lines, for partitions below 16x16
+    for (int i = 8; i < kiHeight; i += 16) {
+      for (int k = i; k < i + 8; k++) {
+        for (int j = 0; j < kiWidth / 4; j++) {
+          const int kiU = j + 2 * iFrame + 64, kiV = k - iFrame + 64;
+          buf_.data()[k * kiWidth + j] = (unsigned char) (((kiU * 7) ^ (kiV * 5)) + kiU + kiV);
+        }
+      }
+    }
+    EncPic.uiTimeStamp = iFrame * 33;
+    rv = encoder_->EncodeFrame (&EncPic, &info);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+
+    memset (&sAnalysis, 0, sizeof (sAnalysis));
+    rv = encoder_->GetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sAnalysis);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    ASSERT_TRUE (sAnalysis.pHints != NULL);
+    EXPECT_TRUE (sAnalysis.bEnable);
+    EXPECT_EQ (kiWidth >> 4, sAnalysis.iMbWidth);
+    EXPECT_EQ (kiHeight >> 4, sAnalysis.iMbHeight);
+    EXPECT_EQ (info.eFrameType, sAnalysis.eFrameType);
+    EXPECT_EQ (EncPic.uiTimeStamp, sAnalysis.uiTimeStamp);
+    if (iFrame > 0) {
+      // most of the picture follows the motion of the texture
+      int iMatched = 0;
+      for (int i = 0; i < sAnalysis.iMbWidth * sAnalysis.iMbHeight; i++) {
+        const SMbMotionHint& kHint = sAnalysis.pHints[i];
+        EXPECT_EQ (kiRenditions[0][0], kHint.uiQp);
+        if (MOTION_HINT_INTRA != kHint.uiPartition && kHint.iMv16x16[0] == -8 && kHint.iMv16x16[1] == -4)
+          ++ iMatched;
+      }
+      EXPECT_GT (iMatched, sAnalysis.iMbWidth * sAnalysis.iMbHeight / 2) << "iFrame = " << iFrame;
+    }
+
+    // the other renditions take the motion and the frame type of the first one
+    SMotionHintParam sHintParam;
+    memset (&sHintParam, 0, sizeof (sHintParam));
+    sHintParam.pHints = sAnalysis.pHints;
+    sHintParam.iMbWidth = sAnalysis.iMbWidth;
+    sHintParam.iMbHeight = sAnalysis.iMbHeight;
+    sHintParam.bEarlyTermination = true;
+    for (int i = 1; i < 4; i++) {
+      if (kiRenditions[i][1]) {
+        rv = pEncoders[i]->SetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+        ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      }
+      if (videoFrameTypeIDR == sAnalysis.eFrameType)
+        pEncoders[i]->ForceIntraFrame (true);
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      EXPECT_EQ (sAnalysis.eFrameType, info.eFrameType) << "i = " << i << " iFrame = " << iFrame;
+
+      SMotionAnalysis sFollower;
+      memset (&sFollower, 0, sizeof (sFollower));
+      rv = pEncoders[i]->GetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sFollower);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      ASSERT_TRUE (sFollower.pHints != NULL);
+      ASSERT_EQ (sAnalysis.iMbWidth * sAnalysis.iMbHeight, sFollower.iMbWidth * sFollower.iMbHeight);
+      for (int j = 0; j < sAnalysis.iMbWidth * sAnalysis.iMbHeight; j++) {
+        const SMbMotionHint& kShared = sAnalysis.pHints[j];
+        const SMbMotionHint& kOwn = sFollower.pHints[j];
+        EXPECT_EQ (kiRenditions[i][0], kOwn.uiQp) << "i = " << i << " iFrame = " << iFrame << " MB " << j;
+        if (!kiRenditions[i][1] || kShared.uiPartition > MOTION_HINT_8x8)
+          continue;
+        // within the gap the shared partition replaces the partition search, no other one below 16x16 can come out
+        if (abs (kOwn.uiQp - kShared.uiQp) <= kiQpGapMax) {
+          EXPECT_TRUE (kOwn.uiPartition < MOTION_HINT_16x8 || kOwn.uiPartition > MOTION_HINT_8x8
+                       || kOwn.uiPartition == kShared.uiPartition)
+              << "i = " << i << " iFrame = " << iFrame << " MB " << j << " partition " << (int)kOwn.uiPartition
+              << " shared " << (int)kShared.uiPartition;
+          ++ iTrustedMbs;
+        } else if (kOwn.uiPartition >= MOTION_HINT_16x8 && kOwn.uiPartition <= MOTION_HINT_8x8
+                   && kOwn.uiPartition != kShared.uiPartition) {
+          // beyond the gap the rendition runs its own partition search
+          ++ iSearchedMbs;
+        }
+      }
+
+      if (1 == i) {
+        int iLen = 0;
+        encToDecData (info, iLen);
+        memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+        rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+        EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+        EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+      }
+    }
+  }
+
+  long long iSadCount[4];
+  for (int i = 0; i < 4; i++) {
+    SEncoderProfiling sProfiling;
+    rv = pEncoders[i]->GetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    iSadCount[i] = sProfiling.sTotal.iSadCount;
+  }
+  // the rendition close to the first one skips most of its own search
+  EXPECT_LT (iSadCount[1], iSadCount[2]);
+  EXPECT_GT (iSadCount[3], 0);
+  EXPECT_GT (iTrustedMbs, 0);
+  EXPECT_GT (iSearchedMbs, 0);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_MOTION_ANALYSIS_PREPROCESS) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 20;
+  const int kiSceneCut = 17; // the encoder takes no scene change as IDR within the first 16 frames
+  // the first encoder shares its preprocessing results with the second one, the third one runs its own analysis
+  ISVCEncoder* pEncoders[3] = { encoder_, NULL, NULL };
+  SEncoderGuard sGuard = { pEncoders + 1, 2 };
+  for (int i = 1; i < 3; i++) {
+    ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[i]));
+  }
+
+  for (int i = 0; i < 3; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_BITRATE_MODE;
+    sParam.sSpatialLayers[0].iSpatialBitrate = sParam.iTargetBitrate = (0 == i) ? 1200000 : 400000;
+    sParam.sSpatialLayers[0].iMaxSpatialBitrate = sParam.iMaxBitrate = UNSPECIFIED_BIT_RATE;
+    sParam.bEnableAdaptiveQuant = true;
+    sParam.bEnableBackgroundDetection = true;
+    sParam.bEnableSceneChangeDetect = true;
+    sParam.bEnableFrameSkip = false;
+    sParam.bEnableDenoise = false;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+
+    SEncoderProfiling sProfiling;
+    memset (&sProfiling, 0, sizeof (sProfiling));
+    sProfiling.bEnable = true;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+    SMotionAnalysis sAnalysis;
+    memset (&sAnalysis, 0, sizeof (sAnalysis));
+    sAnalysis.bEnable = (0 == i);
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sAnalysis);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  int rv;
+  int iSceneChanges = 0;
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    if (iFrame < kiSceneCut)
+      FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 2, 1);
+    else
+      FillMovingTexture (buf_.data(), kiWidth, kiHeight, 7 * iFrame + 100, -3, 5);
+    EncPic.uiTimeStamp = iFrame * 33;
+    rv = encoder_->EncodeFrame (&EncPic, &info);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+
+    SMotionAnalysis sAnalysis;
+    memset (&sAnalysis, 0, sizeof (sAnalysis));
+    rv = encoder_->GetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sAnalysis);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    ASSERT_TRUE (sAnalysis.pPreprocess != NULL) << "iFrame = " << iFrame;
+    EXPECT_GT (sAnalysis.iPreprocessSize, 0);
+
+    // the results only, without motion hints
+    SMotionHintParam sHintParam;
+    memset (&sHintParam, 0, sizeof (sHintParam));
+    sHintParam.pPreprocess = sAnalysis.pPreprocess;
+    sHintParam.iPreprocessSize = sAnalysis.iPreprocessSize;
+    rv = pEncoders[1]->SetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    memset (&sHintParam, 0, sizeof (sHintParam));
+    rv = pEncoders[1]->GetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_TRUE (sHintParam.pPreprocess != NULL && sHintParam.iPreprocessSize == sAnalysis.iPreprocessSize);
+
+    std::vector<unsigned char> vBs[2];
+    for (int i = 1; i < 3; i++) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      int iLen = 0;
+      encToDecData (info, iLen);
+      vBs[i - 1].assign (info.sLayerInfo[0].pBsBuf, info.sLayerInfo[0].pBsBuf + iLen);
+      if (1 == i && iFrame > 0 && videoFrameTypeIDR == info.eFrameType)
+        ++ iSceneChanges;
+    }
+    // the shared results are those the second encoder would have computed
+    EXPECT_TRUE (vBs[0] == vBs[1]) << "iFrame = " << iFrame;
+    if (0 == iFrame) {
+      // nothing to share at the first picture which has no reference yet
+      for (int i = 0; i < 3; i++) {
+        SEncoderProfiling sProfiling;
+        memset (&sProfiling, 0, sizeof (sProfiling));
+        sProfiling.bEnable = sProfiling.bReset = true;
+        rv = pEncoders[i]->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+        ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      }
+    }
+
+    // the results only apply to the picture which follows them
+    memset (&sHintParam, 0xff, sizeof (sHintParam));
+    rv = pEncoders[1]->GetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_TRUE (sHintParam.pPreprocess == NULL && sHintParam.iPreprocessSize == 0);
+  }
+  EXPECT_EQ (1, iSceneChanges);
+
+  SEncoderProfiling sProfiling[3];
+  for (int i = 0; i < 3; i++) {
+    rv = pEncoders[i]->GetOption (ENCODER_OPTION_PROFILING, &sProfiling[i]);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  const int kiShared[] = { PROFILING_VP_SCENE_CHANGE_DETECTION, PROFILING_VP_VAA_STATISTICS,
+                           PROFILING_VP_BACKGROUND_DETECTION
+                         };
+  for (int j = 0; j < (int) (sizeof (kiShared) / sizeof (kiShared[0])); j++) {
+    EXPECT_GT (sProfiling[2].sTotal.iVpTimeUs[kiShared[j]], 0) << j;
+    EXPECT_EQ (0, sProfiling[1].sTotal.iVpTimeUs[kiShared[j]]) << j;
+  }
+
+  // a truncated blob is refused
+  SMotionAnalysis sAnalysis;
+  memset (&sAnalysis, 0, sizeof (sAnalysis));
+  rv = encoder_->GetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sAnalysis);
+  ASSERT_TRUE (rv == cmResultSuccess && sAnalysis.pPreprocess != NULL) << "rv = " << rv;
+  SMotionHintParam sHintParam;
+  memset (&sHintParam, 0, sizeof (sHintParam));
+  sHintParam.pPreprocess = sAnalysis.pPreprocess;
+  sHintParam.iPreprocessSize = sAnalysis.iPreprocessSize - 1;
+  rv = pEncoders[1]->SetOption (ENCODER_OPTION_MOTION_HINT, &sHintParam);
+  EXPECT_TRUE (rv != cmResultSuccess);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_HIERARCHICAL_ME) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 4;
+  const int kiDx = 22, kiDy = -10; // fast motion, out of the reach of the predictors at the first P picture
+  // the same source encoded with and without hierarchical ME
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 30;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+
+    SMotionAnalysis sAnalysis;
+    memset (&sAnalysis, 0, sizeof (sAnalysis));
+    sAnalysis.bEnable = true;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sAnalysis);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  bool bHierarchicalMe = true;
+  int rv = encoder_->SetOption (ENCODER_OPTION_HIERARCHICAL_ME, &bHierarchicalMe);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  bHierarchicalMe = false;
+  rv = encoder_->GetOption (ENCODER_OPTION_HIERARCHICAL_ME, &bHierarchicalMe);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_TRUE (bHierarchicalMe);
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  unsigned char* pData[3] = { NULL };
+  int iMatched[2] = { 0, 0 };
+  int iPSize[2] = { 0, 0 };
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, kiDx, kiDy);
+    EncPic.uiTimeStamp = iFrame * 33;
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      if (iFrame > 0)
+        iPSize[i] += info.iFrameSizeInBytes;
+
+      SMotionAnalysis sAnalysis;
+      rv = pEncoders[i]->GetOption (ENCODER_OPTION_MOTION_ANALYSIS, &sAnalysis);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      ASSERT_TRUE (sAnalysis.pHints != NULL);
+      for (int j = 0; iFrame > 0 && j < sAnalysis.iMbWidth * sAnalysis.iMbHeight; j++) {
+        const SMbMotionHint& kHint = sAnalysis.pHints[j];
+        if (MOTION_HINT_INTRA != kHint.uiPartition && kHint.iMv16x16[0] == -4 * kiDx
+            && kHint.iMv16x16[1] == -4 * kiDy)
+          ++ iMatched[i];
+      }
+    }
+
+    int iLen = 0;
+    encToDecData (info, iLen);
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+  }
+  // the pyramid finds the motion the plain search misses, which pays off in the P pictures
+  EXPECT_GT (iMatched[0], (kiFrameNum - 1) * (kiWidth >> 4) * (kiHeight >> 4) / 2);
+  EXPECT_GT (iMatched[0], iMatched[1]);
+  EXPECT_LT (iPSize[0], iPSize[1]);
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+}
+
+static void FillHalfPelMotion (unsigned char* pBuf, int iWidth, int iHeight, int iFrame) {
+  // moves by 1.5 pixel right and 0.5 pixel down per frame, the half-pel shifts by averaging two positions
+  const int kiHalfX = 3 * iFrame, kiHalfY = iFrame;
+  for (int i = 0; i < iHeight; i++) {
+    for (int j = 0; j < iWidth; j++) {
+      int iSum = 0;
+      for (int k = 0; k < 4; k++) {
+        const int kiU = j - ((kiHalfX + (k & 1)) >> 1) + 64, kiV = i - ((kiHalfY + (k >> 1)) >> 1) + 64;
+        iSum += (kiU * kiU + kiV * 3 + ((kiU >> 3) ^ (kiV >> 2)) * 16) & 0xff;
+      }
+      pBuf[i * iWidth + j] = (unsigned char) ((iSum + 2) >> 2);
+    }
+  }
+  memset (pBuf + iWidth * iHeight, 128, iWidth * iHeight / 2);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_HALFPEL_CACHE) {
+  const int kiWidth  = 320;
+  const int kiHeight = 180; // not a multiple of 16, the bottom row of macroblocks refers to the padding
+  const int kiFrameNum = 6;
+  // the same source encoded with and without the half-pel cache
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 26;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+  }
+  bool bHalfPelCache = true;
+  int rv = encoder_->SetOption (ENCODER_OPTION_HALFPEL_CACHE, &bHalfPelCache);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  bHalfPelCache = false;
+  rv = encoder_->GetOption (ENCODER_OPTION_HALFPEL_CACHE, &bHalfPelCache);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_TRUE (bHalfPelCache);
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    FillHalfPelMotion (buf_.data(), kiWidth, kiHeight, iFrame);
+    EncPic.uiTimeStamp = iFrame * 33;
+    std::string sBitstream[2];
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      int iLen = 0;
+      encToDecData (info, iLen);
+      sBitstream[i].assign (reinterpret_cast<const char*> (info.sLayerInfo[0].pBsBuf), iLen);
+    }
+    // the cache only changes where the half-pel samples are read from
+    EXPECT_TRUE (sBitstream[0] == sBitstream[1]) << "iFrame = " << iFrame;
+
+    unsigned char* pData[3] = { NULL };
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, (int) sBitstream[0].size(), pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+  }
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_OVERLAPPED_DEBLOCKING) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 8;
+  // 4 slice threads deblocking while the slices are coded, against the same slicing coded on a single thread
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 30;
+    sParam.iMultipleThreadIdc = (i == 0) ? 4 : 1;
+    sParam.iLoopFilterDisableIdc = 0; // filtered across the slice boundaries as well
+    sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_FIXEDSLCNUM_SLICE;
+    sParam.sSpatialLayers[0].sSliceArgument.uiSliceNum = 4;
+    sParam.bUseLoadBalancing = false; // keep the slicing fixed
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+  }
+  bool bOverlappedDeblocking = true;
+  int rv = encoder_->SetOption (ENCODER_OPTION_OVERLAPPED_DEBLOCKING, &bOverlappedDeblocking);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  bOverlappedDeblocking = false;
+  rv = encoder_->GetOption (ENCODER_OPTION_OVERLAPPED_DEBLOCKING, &bOverlappedDeblocking);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_TRUE (bOverlappedDeblocking);
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 3, 1);
+    EncPic.uiTimeStamp = iFrame * 33;
+    std::string sBitstream[2];
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      int iLen = 0;
+      encToDecData (info, iLen);
+      sBitstream[i].assign (reinterpret_cast<const char*> (info.sLayerInfo[0].pBsBuf), iLen);
+    }
+    // a reconstruction differing anywhere would change the prediction of the following frames
+    EXPECT_TRUE (sBitstream[0] == sBitstream[1]) << "iFrame = " << iFrame;
+
+    unsigned char* pData[3] = { NULL };
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, (int) sBitstream[0].size(), pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+  }
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+}
+
+static void FillDraggedWindow (unsigned char* pBuf, int iWidth, int iHeight, int iLeft, int iTop) {
+  // a textured window of 128x96 on a flat desktop
+  memset (pBuf, 200, iWidth * iHeight);
+  for (int i = 0; i < 96 && iTop + i < iHeight; i++) {
+    for (int j = 0; j < 128 && iLeft + j < iWidth; j++) {
+      pBuf[ (iTop + i) * iWidth + iLeft + j] = (unsigned char) (((i * 7) ^ (j * 13)) + ((i * j) >> 3));
+    }
+  }
+  memset (pBuf + iWidth * iHeight, 128, iWidth * iHeight / 2);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_SCREEN_BLOCK_HASH) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 4;
+  // the window is dragged far and not along the macroblock grid
+  const int kiLeft[kiFrameNum] = { 8, 61, 139, 170 };
+  const int kiTop[kiFrameNum]  = { 4, 41, 13, 90 };
+  // the same source encoded with and without the block hash
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iUsageType = SCREEN_CONTENT_REAL_TIME;
+    sParam.bIsLosslessLink = true;
+    sParam.bEnableLongTermReference = true; // the references are then indexed on their source pictures
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 30;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+
+    SEncoderProfiling sProfiling;
+    memset (&sProfiling, 0, sizeof (sProfiling));
+    sProfiling.bEnable = true;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  bool bScreenBlockHash = true;
+  int rv = encoder_->SetOption (ENCODER_OPTION_SCREEN_BLOCK_HASH, &bScreenBlockHash);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  bScreenBlockHash = false;
+  rv = encoder_->GetOption (ENCODER_OPTION_SCREEN_BLOCK_HASH, &bScreenBlockHash);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_TRUE (bScreenBlockHash);
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  int iPSize[2] = { 0, 0 };
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    FillDraggedWindow (buf_.data(), kiWidth, kiHeight, kiLeft[iFrame], kiTop[iFrame]);
+    EncPic.uiTimeStamp = iFrame * 33;
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      if (iFrame > 0)
+        iPSize[i] += info.iFrameSizeInBytes;
+    }
+
+    int iLen = 0;
+    unsigned char* pData[3] = { NULL };
+    encToDecData (info, iLen);
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+  }
+  // the moved window is found by one look-up per block instead of a search
+  SEncoderProfiling sProfiling[2];
+  for (int i = 0; i < 2; i++) {
+    rv = pEncoders[i]->GetOption (ENCODER_OPTION_PROFILING, &sProfiling[i]);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  EXPECT_LT (sProfiling[0].sTotal.iSadCount, sProfiling[1].sTotal.iSadCount);
+  EXPECT_LE (iPSize[0], iPSize[1]);
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+}
+
+static void FillStaticScene (unsigned char* pBuf, int iWidth, int iHeight, int iFrame) {
+  // a smooth still background crossed by a small textured object, as seen by a surveillance camera
+  const int kiLeft = 32 + iFrame * 12, kiTop = 48 + iFrame * 5;
+  for (int i = 0; i < iHeight; i++) {
+    for (int j = 0; j < iWidth; j++) {
+      pBuf[i * iWidth + j] = (unsigned char) (64 + (j >> 2) + (i >> 3));
+    }
+  }
+  for (int i = 0; i < 40; i++) {
+    for (int j = 0; j < 40; j++) {
+      pBuf[ (kiTop + i) * iWidth + kiLeft + j] = (unsigned char) (((i * 11) ^ (j * 5)) & 0xff);
+    }
+  }
+  memset (pBuf + iWidth * iHeight, 128, iWidth * iHeight / 2);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_STATIC_SKIP_PREFILTER) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 4;
+  // the same source encoded with and without the prefilter
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 26;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+
+    SEncoderProfiling sProfiling;
+    memset (&sProfiling, 0, sizeof (sProfiling));
+    sProfiling.bEnable = true;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  bool bStaticSkipPrefilter = true;
+  int rv = encoder_->SetOption (ENCODER_OPTION_STATIC_SKIP_PREFILTER, &bStaticSkipPrefilter);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  bStaticSkipPrefilter = false;
+  rv = encoder_->GetOption (ENCODER_OPTION_STATIC_SKIP_PREFILTER, &bStaticSkipPrefilter);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_TRUE (bStaticSkipPrefilter);
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  int iPSize[2] = { 0, 0 };
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    FillStaticScene (buf_.data(), kiWidth, kiHeight, iFrame);
+    EncPic.uiTimeStamp = iFrame * 33;
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      if (iFrame > 0)
+        iPSize[i] += info.iFrameSizeInBytes;
+    }
+
+    int iLen = 0;
+    unsigned char* pData[3] = { NULL };
+    encToDecData (info, iLen);
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+  }
+  // the background is coded as skip without going through the mode decision
+  SEncoderProfiling sProfiling[2];
+  for (int i = 0; i < 2; i++) {
+    rv = pEncoders[i]->GetOption (ENCODER_OPTION_PROFILING, &sProfiling[i]);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  const int kiPMbNum = (kiFrameNum - 1) * (kiWidth >> 4) * (kiHeight >> 4);
+  EXPECT_GT (sProfiling[0].sTotal.iPrefilteredSkipCount, kiPMbNum / 2);
+  EXPECT_EQ (sProfiling[1].sTotal.iPrefilteredSkipCount, 0);
+  EXPECT_GE (sProfiling[0].sTotal.uiMbTypeCount[PROFILING_MB_SKIP], sProfiling[1].sTotal.uiMbTypeCount[PROFILING_MB_SKIP]);
+  EXPECT_LE (iPSize[0], iPSize[1]);
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_EFFORT_MAP) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiMbWidth  = kiWidth >> 4;
+  const int kiMbHeight = kiHeight >> 4;
+  const int kiFrameNum = 4;
+  // the upper rows are static UI forced to skip, the rest spends the low effort
+  std::vector<unsigned char> vEffort (kiMbWidth * kiMbHeight, EFFORT_LOW);
+  for (int i = 0; i < 4 * kiMbWidth; i++)
+    vEffort[i] = EFFORT_SKIP;
+
+  // the same source encoded with and without the effort map
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 26;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+
+    SEncoderProfiling sProfiling;
+    memset (&sProfiling, 0, sizeof (sProfiling));
+    sProfiling.bEnable = true;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  // an unknown effort is refused
+  SEffortMapParam sMapParam;
+  memset (&sMapParam, 0, sizeof (sMapParam));
+  std::vector<unsigned char> vInvalid (kiMbWidth * kiMbHeight, EFFORT_SKIP + 1);
+  sMapParam.pEffort   = &vInvalid[0];
+  sMapParam.iMbWidth  = kiMbWidth;
+  sMapParam.iMbHeight = kiMbHeight;
+  int rv = encoder_->SetOption (ENCODER_OPTION_EFFORT_MAP, &sMapParam);
+  EXPECT_FALSE (rv == cmResultSuccess);
+
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    FillStaticScene (buf_.data(), kiWidth, kiHeight, iFrame);
+    EncPic.uiTimeStamp = iFrame * 33;
+
+    sMapParam.pEffort   = &vEffort[0];
+    sMapParam.iMbWidth  = kiMbWidth;
+    sMapParam.iMbHeight = kiMbHeight;
+    rv = encoder_->SetOption (ENCODER_OPTION_EFFORT_MAP, &sMapParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    memset (&sMapParam, 0, sizeof (sMapParam));
+    rv = encoder_->GetOption (ENCODER_OPTION_EFFORT_MAP, &sMapParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    ASSERT_TRUE (sMapParam.pEffort != NULL);
+    EXPECT_EQ (sMapParam.iMbWidth, kiMbWidth);
+    EXPECT_EQ (0, memcmp (sMapParam.pEffort, &vEffort[0], vEffort.size()));
+
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+    }
+
+    int iLen = 0;
+    unsigned char* pData[3] = { NULL };
+    encToDecData (info, iLen);
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+
+    // the map applies to one picture only
+    rv = encoder_->GetOption (ENCODER_OPTION_EFFORT_MAP, &sMapParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_TRUE (sMapParam.pEffort == NULL);
+  }
+  SEncoderProfiling sProfiling[2];
+  for (int i = 0; i < 2; i++) {
+    rv = pEncoders[i]->GetOption (ENCODER_OPTION_PROFILING, &sProfiling[i]);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  // neither intra 4x4 nor inter partitions below 16x16, and a smaller search
+  EXPECT_EQ (sProfiling[0].sTotal.uiMbTypeCount[PROFILING_MB_INTRA4x4], 0u);
+  EXPECT_EQ (sProfiling[0].sTotal.uiMbTypeCount[PROFILING_MB_INTER16x8], 0u);
+  EXPECT_EQ (sProfiling[0].sTotal.uiMbTypeCount[PROFILING_MB_INTER8x16], 0u);
+  EXPECT_EQ (sProfiling[0].sTotal.uiMbTypeCount[PROFILING_MB_INTER8x8], 0u);
+  EXPECT_GE (sProfiling[0].sTotal.uiMbTypeCount[PROFILING_MB_SKIP], (unsigned int) ((kiFrameNum - 1) * 4 * kiMbWidth));
+  EXPECT_LT (sProfiling[0].sTotal.iSadCount, sProfiling[1].sTotal.iSadCount);
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_FRAME_TIME_BUDGET) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = COMPLEXITY_LEVEL_NUM + 2;
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+  sParam.iRCMode = RC_OFF_MODE;
+  sParam.sSpatialLayers[0].iDLayerQp = 26;
+  int rv = encoder_->InitializeExt (&sParam);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+
+  SEncoderProfiling sProfiling;
+  memset (&sProfiling, 0, sizeof (sProfiling));
+  sProfiling.bEnable = true;
+  rv = encoder_->SetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  int iBudgetUs = -1;
+  rv = encoder_->SetOption (ENCODER_OPTION_FRAME_TIME_BUDGET, &iBudgetUs);
+  EXPECT_FALSE (rv == cmResultSuccess);
+  // no encoder meets one microsecond, the complexity is lowered by one level per frame
+  iBudgetUs = 1;
+  rv = encoder_->SetOption (ENCODER_OPTION_FRAME_TIME_BUDGET, &iBudgetUs);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  iBudgetUs = 0;
+  rv = encoder_->GetOption (ENCODER_OPTION_FRAME_TIME_BUDGET, &iBudgetUs);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (iBudgetUs, 1);
+
+  for (int iFrame = 0; iFrame < kiFrameNum + 1; iFrame++) {
+    if (iFrame == kiFrameNum) {
+      // a budget met easily takes the encoder back to the full complexity
+      iBudgetUs = 10 * 1000 * 1000;
+      rv = encoder_->SetOption (ENCODER_OPTION_FRAME_TIME_BUDGET, &iBudgetUs);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    }
+    FillStaticScene (buf_.data(), kiWidth, kiHeight, iFrame);
+    EncPic.uiTimeStamp = iFrame * 33;
+    rv = encoder_->EncodeFrame (&EncPic, &info);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+
+    int iLen = 0;
+    unsigned char* pData[3] = { NULL };
+    encToDecData (info, iLen);
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+
+    int iLevel = -1;
+    rv = encoder_->GetOption (ENCODER_OPTION_GET_COMPLEXITY_LEVEL, &iLevel);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    int iExpectedLevel = (iFrame < COMPLEXITY_LEVEL_NUM - 1) ? iFrame : COMPLEXITY_LEVEL_NUM - 1;
+    if (iFrame == kiFrameNum)
+      iExpectedLevel = COMPLEXITY_LEVEL_FULL;
+    EXPECT_EQ (iLevel, iExpectedLevel) << "iFrame = " << iFrame;
+
+    if (iFrame == kiFrameNum - 1) {
+      // the lowest level tries neither intra 4x4 nor inter partitions below 16x16
+      rv = encoder_->GetOption (ENCODER_OPTION_PROFILING, &sProfiling);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      EXPECT_EQ (sProfiling.sLastFrame.uiMbTypeCount[PROFILING_MB_INTRA4x4], 0u);
+      EXPECT_EQ (sProfiling.sLastFrame.uiMbTypeCount[PROFILING_MB_INTER16x8], 0u);
+      EXPECT_EQ (sProfiling.sLastFrame.uiMbTypeCount[PROFILING_MB_INTER8x16], 0u);
+      EXPECT_EQ (sProfiling.sLastFrame.uiMbTypeCount[PROFILING_MB_INTER8x8], 0u);
+    }
+  }
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_PREALLOCATE_BUFFERS) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 6;
+  const int kiThreadNum[] = { 1, 4 };
+  for (int t = 0; t < (int) (sizeof (kiThreadNum) / sizeof (kiThreadNum[0])); t++) {
+    SEncParamExt sParam;
+    encoder_->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 12;
+    sParam.iMultipleThreadIdc = kiThreadNum[t];
+    // small slices, more than the slice and NAL buffers grown on demand start with
+    sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_SIZELIMITED_SLICE;
+    sParam.sSpatialLayers[0].sSliceArgument.uiSliceSizeConstraint = 700;
+    int rv = encoder_->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " t = " << t;
+    ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+    int iPreallocSliceNum = -2;
+    rv = encoder_->SetOption (ENCODER_OPTION_PREALLOCATE_BUFFERS, &iPreallocSliceNum);
+    EXPECT_FALSE (rv == cmResultSuccess);
+
+    SEncoderBufferStatistics sStatistics;
+    unsigned int uiAllocCount = 0;
+    unsigned int uiReallocCount = 0;
+    for (int iFrame = 0; iFrame < 2 * kiFrameNum; iFrame++) {
+      if (iFrame == kiFrameNum) {
+        memset (&sStatistics, 0, sizeof (sStatistics));
+        rv = encoder_->GetOption (ENCODER_OPTION_GET_BUFFER_STATISTICS, &sStatistics);
+        ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+        EXPECT_GT (sStatistics.uiBufferReallocCount, 0u) << "t = " << t;
+        EXPECT_GT (sStatistics.uiEncodingAllocCount, 0u) << "t = " << t;
+
+        // the worst case of the level, the encoder is reset to size the buffers
+        iPreallocSliceNum = -1;
+        rv = encoder_->SetOption (ENCODER_OPTION_PREALLOCATE_BUFFERS, &iPreallocSliceNum);
+        ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+        iPreallocSliceNum = 0;
+        rv = encoder_->GetOption (ENCODER_OPTION_PREALLOCATE_BUFFERS, &iPreallocSliceNum);
+        ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+        EXPECT_EQ (iPreallocSliceNum, -1);
+        uiAllocCount = sStatistics.uiEncodingAllocCount;
+        uiReallocCount = sStatistics.uiBufferReallocCount;
+      }
+      FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 3, 1);
+      EncPic.uiTimeStamp = iFrame * 33;
+      rv = encoder_->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+
+      int iLen = 0;
+      unsigned char* pData[3] = { NULL };
+      encToDecData (info, iLen);
+      memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+      rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+      EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+      EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+
+      memset (&sStatistics, 0, sizeof (sStatistics));
+      rv = encoder_->GetOption (ENCODER_OPTION_GET_BUFFER_STATISTICS, &sStatistics);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      if (iFrame >= kiFrameNum) {
+        // nothing allocated nor grown from the first frame on
+        EXPECT_EQ (sStatistics.uiEncodingAllocCount, uiAllocCount) << "iFrame = " << iFrame << " t = " << t;
+        EXPECT_EQ (sStatistics.uiBufferReallocCount, uiReallocCount) << "iFrame = " << iFrame << " t = " << t;
+      }
+    }
+    encoder_->Uninitialize();
+  }
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_MEMORY_ARENA) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 6;
+  // the same source encoded with the memory carved from an arena and taken from the heap
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  SMemoryArenaParam sArena;
+  memset (&sArena, 0, sizeof (sArena));
+  sArena.uiArenaSize = 512 * 1024; // less than the encoder takes, the rest is from the heap
+  sArena.bPrefault = true;
+  int rv = encoder_->SetOption (ENCODER_OPTION_MEMORY_ARENA, &sArena);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 26;
+    rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+  }
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  SMemoryUsage sUsage;
+  memset (&sUsage, 0, sizeof (sUsage));
+  rv = encoder_->GetOption (ENCODER_OPTION_GET_MEMORY_USAGE, &sUsage);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (sUsage.uiArenaSize, sArena.uiArenaSize);
+  EXPECT_GT (sUsage.uiArenaUsedBytes, sArena.uiArenaSize / 2);
+  EXPECT_GT (sUsage.uiArenaOverflowCount, 0u);
+  ASSERT_GT (sUsage.iTagNum, 0);
+  unsigned int uiTagBytes = 0;
+  bool bTagFound = false;
+  for (int i = 0; i < sUsage.iTagNum; i++) {
+    uiTagBytes += sUsage.sTagUsage[i].uiUsedBytes;
+    EXPECT_GE (sUsage.sTagUsage[i].uiPeakBytes, sUsage.sTagUsage[i].uiUsedBytes);
+    if (sUsage.sTagUsage[i].pTag != NULL && 0 == strcmp (sUsage.sTagUsage[i].pTag, "pDqLayer"))
+      bTagFound = true;
+  }
+  EXPECT_TRUE (bTagFound);
+  EXPECT_GT (uiTagBytes, 0u);
+  EXPECT_LE (uiTagBytes, sUsage.uiUsedBytes);
+
+  SMemoryUsage sHeapUsage;
+  rv = pEncoders[1]->GetOption (ENCODER_OPTION_GET_MEMORY_USAGE, &sHeapUsage);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (sHeapUsage.uiArenaSize, 0u);
+  EXPECT_EQ (sHeapUsage.iTagNum, 0);
+
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    if (iFrame == kiFrameNum / 2) {
+      // an arena holding the whole encoder, the encoder is reset to carve its memory again
+      sArena.uiArenaSize = 64 * 1024 * 1024;
+      sArena.bHugePages = true;
+      rv = encoder_->SetOption (ENCODER_OPTION_MEMORY_ARENA, &sArena);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      SMemoryArenaParam sArenaGot;
+      rv = encoder_->GetOption (ENCODER_OPTION_MEMORY_ARENA, &sArenaGot);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      EXPECT_EQ (sArenaGot.uiArenaSize, sArena.uiArenaSize);
+      EXPECT_TRUE (sArenaGot.bHugePages);
+      pEncoders[1]->ForceIntraFrame (true);
+    }
+    FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 3, 1);
+    EncPic.uiTimeStamp = iFrame * 33;
+    std::string sBitstream[2];
+    for (int i = 1; i >= 0; i--) {
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      int iLen = 0;
+      encToDecData (info, iLen);
+      sBitstream[i].assign (reinterpret_cast<const char*> (info.sLayerInfo[0].pBsBuf), iLen);
+    }
+    EXPECT_TRUE (sBitstream[0] == sBitstream[1]) << "iFrame = " << iFrame;
+
+    unsigned char* pData[3] = { NULL };
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, (int) sBitstream[0].size(), pData, &dstBufInfo_);
+    EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iFrame = " << iFrame;
+  }
+  rv = encoder_->GetOption (ENCODER_OPTION_GET_MEMORY_USAGE, &sUsage);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (sUsage.uiArenaOverflowCount, 0u);
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+  // kept over Initialize until changed
+  memset (&sArena, 0, sizeof (sArena));
+  rv = encoder_->SetOption (ENCODER_OPTION_MEMORY_ARENA, &sArena);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_LOW_FOOTPRINT) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiFrameNum = 8;
+  // the same source encoded with the low footprint on and off
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  bool bLowFootprint = true;
+  int rv = encoder_->SetOption (ENCODER_OPTION_LOW_FOOTPRINT, &bLowFootprint);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+  for (int iTemporalLayerNum = 1; iTemporalLayerNum <= 3; iTemporalLayerNum += 2) {
+    for (int i = 0; i < 2; i++) {
+      SEncParamExt sParam;
+      pEncoders[i]->GetDefaultParams (&sParam);
+      prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+      sParam.iTemporalLayerNum = iTemporalLayerNum;
+      sParam.iEntropyCodingModeFlag = 1;
+      sParam.bEnableAdaptiveQuant = true;
+      sParam.bEnableBackgroundDetection = true;
+      sParam.bEnableSceneChangeDetect = true;
+      pEncoders[i]->Uninitialize();
+      rv = pEncoders[i]->InitializeExt (&sParam);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+    }
+    bool bLowFootprintGot = false;
+    rv = encoder_->GetOption (ENCODER_OPTION_LOW_FOOTPRINT, &bLowFootprintGot);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_TRUE (bLowFootprintGot);
+
+    SMemoryUsage sUsage[2];
+    for (int i = 0; i < 2; i++) {
+      rv = pEncoders[i]->GetOption (ENCODER_OPTION_GET_MEMORY_USAGE, &sUsage[i]);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+      EXPECT_GT (sUsage[i].uiSharedBytes, 0u);
+    }
+    EXPECT_EQ (sUsage[0].uiSharedBytes, sUsage[1].uiSharedBytes);
+    if (iTemporalLayerNum == 1) {
+      EXPECT_LT (sUsage[0].uiUsedBytes, sUsage[1].uiUsedBytes);
+    }
+
+    for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+      FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 3, 1);
+      if (iFrame == kiFrameNum / 2)
+        memset (buf_.data(), iFrame * 16, kiWidth * kiHeight); // scene change
+      EncPic.uiTimeStamp = (iTemporalLayerNum * kiFrameNum + iFrame) * 33;
+      std::string sBitstream[2];
+      for (int i = 1; i >= 0; i--) {
+        rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+        ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+        int iLen = 0;
+        encToDecData (info, iLen);
+        sBitstream[i].assign (reinterpret_cast<const char*> (info.sLayerInfo[0].pBsBuf), iLen);
+      }
+      EXPECT_TRUE (sBitstream[0] == sBitstream[1]) << "iTemporalLayerNum = " << iTemporalLayerNum << " iFrame = " << iFrame;
+
+      unsigned char* pData[3] = { NULL };
+      memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+      rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, (int) sBitstream[0].size(), pData, &dstBufInfo_);
+      EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iFrame = " << iFrame;
+    }
+  }
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+  bLowFootprint = false;
+  rv = encoder_->SetOption (ENCODER_OPTION_LOW_FOOTPRINT, &bLowFootprint);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_RECONFIG_POOL) {
+  const int kiMaxWidth  = 320;
+  const int kiMaxHeight = 192;
+  const int kiSwitchNum = 6;
+  const int kiFrameNum = 3;
+  const int kiSizes[3][2] = { { 320, 192 }, { 160, 96 }, { 240, 144 } };
+  // the same source encoded with the resources kept over the resets and taken again
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+
+  SReconfigPoolParam sPool;
+  sPool.iMaxPicWidth  = kiMaxWidth;
+  sPool.iMaxPicHeight = kiMaxHeight;
+  int rv = encoder_->SetOption (ENCODER_OPTION_RECONFIG_POOL, &sPool);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  ASSERT_TRUE (InitialEncDec (kiMaxWidth, kiMaxHeight));
+
+  for (int iSwitch = 0; iSwitch <= kiSwitchNum; iSwitch++) {
+    const int kiWidth  = kiSizes[iSwitch % 3][0];
+    const int kiHeight = kiSizes[iSwitch % 3][1];
+    for (int i = 0; i < 2; i++) {
+      SEncParamExt sParam;
+      pEncoders[i]->GetDefaultParams (&sParam);
+      prepareParamDefault (1, 1 + (iSwitch & 1), kiWidth, kiHeight, 30.0f, &sParam);
+      sParam.iMultipleThreadIdc = 1;
+      sParam.iRCMode = RC_OFF_MODE;
+      sParam.sSpatialLayers[0].iDLayerQp = 26;
+      if (iSwitch == 0)
+        rv = pEncoders[i]->InitializeExt (&sParam);
+      else
+        rv = pEncoders[i]->SetOption (ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, &sParam);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iSwitch = " << iSwitch;
+    }
+    EncPic.iPicWidth  = kiWidth;
+    EncPic.iPicHeight = kiHeight;
+    EncPic.iStride[0] = kiWidth;
+    EncPic.iStride[1] = EncPic.iStride[2] = kiWidth >> 1;
+    EncPic.pData[1]   = EncPic.pData[0] + kiWidth * kiHeight;
+    EncPic.pData[2]   = EncPic.pData[1] + (kiWidth * kiHeight >> 2);
+
+    for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+      FillMovingTexture (buf_.data(), kiWidth, kiHeight, iSwitch * kiFrameNum + iFrame, 3, 1);
+      EncPic.uiTimeStamp = (iSwitch * kiFrameNum + iFrame) * 33;
+      std::string sBitstream[2];
+      for (int i = 1; i >= 0; i--) {
+        rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+        ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iSwitch = " << iSwitch;
+        int iLen = 0;
+        encToDecData (info, iLen);
+        sBitstream[i].assign (reinterpret_cast<const char*> (info.sLayerInfo[0].pBsBuf), iLen);
+      }
+      EXPECT_TRUE (sBitstream[0] == sBitstream[1]) << "iSwitch = " << iSwitch << " iFrame = " << iFrame;
+
+      unsigned char* pData[3] = { NULL };
+      memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+      rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, (int) sBitstream[0].size(), pData, &dstBufInfo_);
+      EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iSwitch = " << iSwitch << " iFrame = " << iFrame;
+      EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iSwitch = " << iSwitch << " iFrame = " << iFrame;
+    }
+  }
+
+  SReconfigPoolParam sPoolGot;
+  rv = encoder_->GetOption (ENCODER_OPTION_RECONFIG_POOL, &sPoolGot);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (sPoolGot.iMaxPicWidth, kiMaxWidth);
+  EXPECT_EQ (sPoolGot.iMaxPicHeight, kiMaxHeight);
+  // the arena sized for the largest picture holds every configuration
+  SMemoryUsage sUsage;
+  rv = encoder_->GetOption (ENCODER_OPTION_GET_MEMORY_USAGE, &sUsage);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_GT (sUsage.uiArenaSize, 0u);
+  EXPECT_EQ (sUsage.uiArenaOverflowCount, 0u);
+  for (int i = 0; i < 2; i++) {
+    SEncoderReconfigStatistics sStatistics;
+    rv = pEncoders[i]->GetOption (ENCODER_OPTION_GET_RECONFIG_STATISTICS, &sStatistics);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_EQ (sStatistics.uiReconfigCount, (unsigned int) kiSwitchNum) << "i = " << i;
+    EXPECT_GE (sStatistics.uiMaxReconfigUs, sStatistics.uiLastReconfigUs) << "i = " << i;
+  }
+
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+  memset (&sPool, 0, sizeof (sPool));
+  rv = encoder_->SetOption (ENCODER_OPTION_RECONFIG_POOL, &sPool);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+}
+
+static void AppendDecodedPicture (const SBufferInfo& kBufInfo, unsigned char* pData[3], std::string& sPicture) {
+  const SSysMEMBuffer& kBuffer = kBufInfo.UsrData.sSystemBuffer;
+  for (int iPlane = 0; iPlane < 3; iPlane++) {
+    const int kiShift = (iPlane > 0) ? 1 : 0;
+    const int kiStride = kBuffer.iStride[kiShift];
+    for (int i = 0; i < (kBuffer.iHeight >> kiShift); i++)
+      sPicture.append (reinterpret_cast<const char*> (pData[iPlane] + i * kiStride), kBuffer.iWidth >> kiShift);
+  }
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_INTRA_REFRESH) {
+  const int kiWidth  = 320;
+  const int kiHeight = 192;
+  const int kiIntraPeriod = 8;
+  const int kiRefreshFrames = 4;
+  const int kiFrameNum = 20;
+  // the two encoders see different pictures ahead of the first sweep and the same ones from it on
+  ISVCEncoder* pEncoders[2] = { encoder_, NULL };
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoders[1]));
+  ISVCDecoder* pJoiningDecoder = NULL;
+  ASSERT_EQ (0, WelsCreateDecoder (&pJoiningDecoder));
+  SDecodingParam sDecParam;
+  memset (&sDecParam, 0, sizeof (SDecodingParam));
+  sDecParam.uiTargetDqLayer = UCHAR_MAX;
+  sDecParam.eEcActiveIdc = ERROR_CON_DISABLE;
+  sDecParam.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
+  ASSERT_EQ (0, pJoiningDecoder->Initialize (&sDecParam));
+
+  for (int i = 0; i < 2; i++) {
+    SEncParamExt sParam;
+    pEncoders[i]->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iMultipleThreadIdc = 1;
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 26;
+    sParam.uiIntraPeriod = kiIntraPeriod;
+    sParam.iNumRefFrame = 1;
+    sParam.bEnableSceneChangeDetect = false;
+    int rv = pEncoders[i]->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i;
+    int iRefreshFrames = kiRefreshFrames;
+    rv = pEncoders[i]->SetOption (ENCODER_OPTION_INTRA_REFRESH, &iRefreshFrames);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  }
+  int iRefreshFrames = 0;
+  int rv = encoder_->GetOption (ENCODER_OPTION_INTRA_REFRESH, &iRefreshFrames);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (iRefreshFrames, kiRefreshFrames);
+  iRefreshFrames = -1;
+  EXPECT_NE (cmResultSuccess, encoder_->SetOption (ENCODER_OPTION_INTRA_REFRESH, &iRefreshFrames));
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+    EncPic.uiTimeStamp = iFrame * 33;
+    std::string sPicture[2];
+    // the joining decoder takes the pictures of the other encoder ahead of the sweep
+    for (int i = (iFrame < kiIntraPeriod) ? 1 : 0; i >= 0; i--) {
+      if (i == 1)
+        FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame + 100, 2, 5);
+      else
+        FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 1, -3);
+      rv = pEncoders[i]->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " i = " << i << " iFrame = " << iFrame;
+      if (i == 0) {
+        EXPECT_EQ (info.eFrameType, (iFrame == 0) ? videoFrameTypeIDR : videoFrameTypeP) << "iFrame = " << iFrame;
+        // the sweep starts where the IDR would be, announced by a recovery point SEI
+        bool bRecoveryPoint = false;
+        for (int iLayer = 0; iLayer < info.iLayerNum; iLayer++) {
+          const SLayerBSInfo& kLayer = info.sLayerInfo[iLayer];
+          if (NON_VIDEO_CODING_LAYER == kLayer.uiLayerType && 6 == (kLayer.pBsBuf[4] & 0x1f)) {
+            EXPECT_EQ (kLayer.pBsBuf[5], 6);
+            bRecoveryPoint = true;
+          }
+        }
+        EXPECT_EQ (bRecoveryPoint, iFrame > 0 && 0 == iFrame % kiIntraPeriod) << "iFrame = " << iFrame;
+      }
+
+      int iLen = 0;
+      unsigned char* pData[3] = { NULL };
+      encToDecData (info, iLen);
+      for (int iDec = 0; iDec < 2; iDec++) {
+        ISVCDecoder* pDecoder = (iDec == 0) ? decoder_ : pJoiningDecoder;
+        if ((iDec == 0 && i == 1) || (iDec == 1 && i == 0 && iFrame < kiIntraPeriod))
+          continue;
+        memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+        rv = pDecoder->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+        EXPECT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iDec = " << iDec << " iFrame = " << iFrame;
+        EXPECT_EQ (dstBufInfo_.iBufferStatus, 1) << "iDec = " << iDec << " iFrame = " << iFrame;
+        if (dstBufInfo_.iBufferStatus == 1)
+          AppendDecodedPicture (dstBufInfo_, pData, sPicture[iDec]);
+      }
+    }
+    // exact once the band passed the bottom, whatever was decoded ahead of the sweep
+    if (iFrame >= kiIntraPeriod + kiRefreshFrames - 1) {
+      EXPECT_TRUE (sPicture[0] == sPicture[1]) << "iFrame = " << iFrame;
+    }
+  }
+
+  unsigned int uiIntraRefreshNum = 0;
+  rv = encoder_->GetOption (ENCODER_OPTION_GET_INTRA_REFRESH_NUM, &uiIntraRefreshNum);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (uiIntraRefreshNum, (unsigned int) ((kiFrameNum - 1) / kiIntraPeriod));
+  SEncoderStatistics sStatistics;
+  rv = encoder_->GetOption (ENCODER_OPTION_GET_STATISTICS, &sStatistics);
+  ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+  EXPECT_EQ (sStatistics.uiIDRSentNum, 1u);
+
+  pJoiningDecoder->Uninitialize();
+  WelsDestroyDecoder (pJoiningDecoder);
+  pEncoders[1]->Uninitialize();
+  WelsDestroySVCEncoder (pEncoders[1]);
+}
+
+static float DecodedPlanePsnr (const unsigned char* pSrc, int iSrcStride, const unsigned char* pDec, int iDecStride,
+                               int iWidth, int iHeight) {
+  long long iSse = 0;
+  for (int i = 0; i < iHeight; i++) {
+    for (int j = 0; j < iWidth; j++) {
+      const int kiDiff = pSrc[i * iSrcStride + j] - pDec[i * iDecStride + j];
+      iSse += kiDiff * kiDiff;
+    }
+  }
+  if (iSse == 0)
+    return 99.99f;
+  return (float) (10.0 * log10 (65025.0 * iWidth * iHeight / iSse));
+}
+
+TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_QUALITY_METRICS) {
+  // not a multiple of the macroblock size, the cropped edge is measured as well
+  const int kiWidth  = 312;
+  const int kiHeight = 180;
+  const int kiFrameNum = 8;
+  // 0: single slice, 1: overlapped deblocking of fixed slices, 2: loop filter off, 3: metrics off
+  const int kiCaseNum = 4;
+  ASSERT_TRUE (InitialEncDec (kiWidth, kiHeight));
+
+  for (int iCase = 0; iCase < kiCaseNum; iCase++) {
+    SEncParamExt sParam;
+    encoder_->GetDefaultParams (&sParam);
+    prepareParamDefault (1, 1, kiWidth, kiHeight, 30.0f, &sParam);
+    sParam.iTemporalLayerNum = 2; // the non-reference pictures are deblocked for the metrics
+    sParam.iRCMode = RC_OFF_MODE;
+    sParam.sSpatialLayers[0].iDLayerQp = 30;
+    sParam.iMultipleThreadIdc = 1;
+    if (iCase == 1) {
+      sParam.iMultipleThreadIdc = 2;
+      sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_FIXEDSLCNUM_SLICE;
+      sParam.sSpatialLayers[0].sSliceArgument.uiSliceNum = 4;
+    } else if (iCase == 2) {
+      sParam.iLoopFilterDisableIdc = 1;
+    }
+    encoder_->Uninitialize();
+    int rv = encoder_->InitializeExt (&sParam);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iCase = " << iCase;
+    bool bOverlappedDeblocking = (iCase == 1);
+    rv = encoder_->SetOption (ENCODER_OPTION_OVERLAPPED_DEBLOCKING, &bOverlappedDeblocking);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    bool bQualityMetrics = (iCase != 3);
+    rv = encoder_->SetOption (ENCODER_OPTION_QUALITY_METRICS, &bQualityMetrics);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    bool bQualityMetricsGot = !bQualityMetrics;
+    rv = encoder_->GetOption (ENCODER_OPTION_QUALITY_METRICS, &bQualityMetricsGot);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_EQ (bQualityMetricsGot, bQualityMetrics);
+
+    float fSumPsnrY = 0.0f;
+    for (int iFrame = 0; iFrame < kiFrameNum; iFrame++) {
+      FillMovingTexture (buf_.data(), kiWidth, kiHeight, iFrame, 3, 1);
+      EncPic.uiTimeStamp = (iCase * kiFrameNum + iFrame) * 33;
+      rv = encoder_->EncodeFrame (&EncPic, &info);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iCase = " << iCase << " iFrame = " << iFrame;
+      SFrameQualityMetrics sMetrics;
+      memset (&sMetrics, 0xff, sizeof (sMetrics));
+      rv = encoder_->GetOption (ENCODER_OPTION_GET_QUALITY_METRICS, &sMetrics);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+      EXPECT_EQ (sMetrics.uiTimeStamp, info.uiTimeStamp);
+      ASSERT_EQ (sMetrics.iSpatialLayerNum, 1);
+      const SLayerQualityMetrics* pLayerMetrics = &sMetrics.sLayerMetrics[0];
+
+      int iLen = 0;
+      unsigned char* pData[3] = { NULL };
+      encToDecData (info, iLen);
+      memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+      rv = decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_);
+      ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv << " iCase = " << iCase << " iFrame = " << iFrame;
+      ASSERT_EQ (dstBufInfo_.iBufferStatus, 1) << "iCase = " << iCase << " iFrame = " << iFrame;
+      EXPECT_EQ (pLayerMetrics->bMeasured, bQualityMetrics) << "iCase = " << iCase << " iFrame = " << iFrame;
+      if (!bQualityMetrics) {
+        EXPECT_EQ (pLayerMetrics->fPsnrY, 0.0f);
+        EXPECT_EQ (pLayerMetrics->fSsim, 0.0f);
+        continue;
+      }
+      // the reconstruction measured is the picture the decoder outputs
+      const SSysMEMBuffer& kBuffer = dstBufInfo_.UsrData.sSystemBuffer;
+      ASSERT_EQ (kBuffer.iWidth, kiWidth);
+      ASSERT_EQ (kBuffer.iHeight, kiHeight);
+      const float kfPsnr[3] = { pLayerMetrics->fPsnrY, pLayerMetrics->fPsnrU, pLayerMetrics->fPsnrV };
+      for (int iPlane = 0; iPlane < 3; iPlane++) {
+        const int kiShift = (iPlane > 0) ? 1 : 0;
+        const float kfExpected = DecodedPlanePsnr (EncPic.pData[iPlane], EncPic.iStride[iPlane], pData[iPlane],
+                                 kBuffer.iStride[kiShift], kiWidth >> kiShift, kiHeight >> kiShift);
+        EXPECT_NEAR (kfPsnr[iPlane], kfExpected, 0.01f) << "iCase = " << iCase << " iFrame = " << iFrame << " iPlane = " <<
+            iPlane;
+        EXPECT_GT (kfPsnr[iPlane], 20.0f);
+      }
+      EXPECT_GT (pLayerMetrics->fSsim, 0.5f) << "iCase = " << iCase << " iFrame = " << iFrame;
+      EXPECT_LE (pLayerMetrics->fSsim, 1.0f) << "iCase = " << iCase << " iFrame = " << iFrame;
+      fSumPsnrY += pLayerMetrics->fPsnrY;
+    }
+
+    SFrameQualityMetrics sMetrics;
+    rv = encoder_->GetOption (ENCODER_OPTION_GET_QUALITY_METRICS, &sMetrics);
+    ASSERT_TRUE (rv == cmResultSuccess) << "rv = " << rv;
+    EXPECT_EQ (sMetrics.uiMeasuredFrameCount[0], bQualityMetrics ? (unsigned int) kiFrameNum : 0u) << "iCase = " << iCase;
+    EXPECT_EQ (sMetrics.sLayerAverage[0].bMeasured, bQualityMetrics) << "iCase = " << iCase;
+    if (bQualityMetrics) {
+      EXPECT_NEAR (sMetrics.sLayerAverage[0].fPsnrY, fSumPsnrY / kiFrameNum, 0.01f) << "iCase = " << iCase;
+    }
+  }
+}
@@ -104,3 +104,220 @@ TEST (CThreadPoolTest, CThreadPoolTestMulti) {
   EXPECT_FALSE (CWelsThreadPool::IsReferenced());
 }
 
+
+class CCountingTask : public IWelsTask {
+ public:
+  CCountingTask (WelsCommon::IWelsTaskSink* pSink, WelsCommon::CWelsLock* pLock, int32_t* pRunning,
+                 int32_t* pMaxRunning) : IWelsTask (pSink) {
+    m_pLock = pLock;
+    m_pRunning = pRunning;
+    m_pMaxRunning = pMaxRunning;
+  }
+
+  virtual int32_t Execute() {
+    m_pLock->Lock();
+    (*m_pRunning) ++;
+    if (*m_pRunning > *m_pMaxRunning)
+      *m_pMaxRunning = *m_pRunning;
+    m_pLock->Unlock();
+
+    WelsSleep (2);
+
+    m_pLock->Lock();
+    (*m_pRunning) --;
+    m_pLock->Unlock();
+    return cmResultSuccess;
+  }
+
+ private:
+  WelsCommon::CWelsLock* m_pLock;
+  int32_t* m_pRunning;
+  int32_t* m_pMaxRunning;
+};
+
+TEST (CThreadPoolTest, CThreadPoolTestGroupLimit) {
+  CThreadPoolTest cThreadPoolTest;
+  WelsCommon::CWelsLock cLock;
+  int32_t iRunning = 0, iMaxRunning = 0;
+  SWelsTaskGroup sGroup;
+  sGroup.iPriority = WELS_TASK_PRIORITY_HIGH;
+  sGroup.iMaxRunningNum = 2;
+  sGroup.iRunningNum = 0;
+
+  EXPECT_EQ (0, CWelsThreadPool::SetThreadNum (6));
+  CWelsThreadPool* pThreadPool = (CWelsThreadPool::AddReference());
+  ASSERT_TRUE (pThreadPool != NULL);
+
+  CCountingTask* aTasks[TEST_TASK_NUM];
+  int32_t i;
+  for (i = 0; i < TEST_TASK_NUM; i++) {
+    aTasks[i] = new CCountingTask (&cThreadPoolTest, &cLock, &iRunning, &iMaxRunning);
+    aTasks[i]->SetGroup (&sGroup);
+  }
+  for (i = 0; i < TEST_TASK_NUM; i++) {
+    pThreadPool->QueueTask (aTasks[i]);
+  }
+  while (cThreadPoolTest.GetTaskCount() < TEST_TASK_NUM) {
+    WelsSleep (1);
+  }
+
+  EXPECT_LE (iMaxRunning, 2);
+  EXPECT_EQ (0, sGroup.iRunningNum);
+
+  for (i = 0; i < TEST_TASK_NUM; i++) {
+    delete aTasks[i];
+  }
+  pThreadPool->RemoveInstance();
+  EXPECT_FALSE (CWelsThreadPool::IsReferenced());
+}
+
+TEST (CThreadPoolTest, CThreadPoolTestFixedThreadNum) {
+  EXPECT_EQ (0, CWelsThreadPool::SetThreadNum (2));
+  CWelsThreadPool* pThreadPool = (CWelsThreadPool::AddReference());
+  ASSERT_TRUE (pThreadPool != NULL);
+  EXPECT_EQ (2, pThreadPool->GetThreadNum());
+
+  // a pool in use can grow but not shrink
+  EXPECT_EQ (0, CWelsThreadPool::SetFixedThreadNum (5));
+  EXPECT_EQ (5, pThreadPool->GetThreadNum());
+  EXPECT_TRUE (0 != CWelsThreadPool::SetFixedThreadNum (3));
+  EXPECT_EQ (5, pThreadPool->GetThreadNum());
+  EXPECT_TRUE (CWelsThreadPool::IsThreadNumFixed());
+
+  pThreadPool->RemoveInstance();
+
+  // clients can not override a fixed size
+  EXPECT_TRUE (0 != CWelsThreadPool::SetThreadNum (2));
+  pThreadPool = (CWelsThreadPool::AddReference());
+  EXPECT_EQ (5, pThreadPool->GetThreadNum());
+  pThreadPool->RemoveInstance();
+
+  EXPECT_EQ (0, CWelsThreadPool::SetFixedThreadNum (0));
+  EXPECT_FALSE (CWelsThreadPool::IsThreadNumFixed());
+  EXPECT_EQ (0, CWelsThreadPool::SetThreadNum (4));
+  EXPECT_FALSE (CWelsThreadPool::IsReferenced());
+}
+
+class COrderTask : public IWelsTask {
+ public:
+  COrderTask (WelsCommon::IWelsTaskSink* pSink, WelsCommon::CWelsLock* pLock, int32_t* pOrder, int32_t* pOrderNum,
+              int32_t iId) : IWelsTask (pSink) {
+    m_pLock = pLock;
+    m_pOrder = pOrder;
+    m_pOrderNum = pOrderNum;
+    m_iId = iId;
+  }
+
+  virtual int32_t Execute() {
+    WelsCommon::CWelsAutoLock cAutoLock (*m_pLock);
+    m_pOrder[ (*m_pOrderNum) ++] = m_iId;
+    return cmResultSuccess;
+  }
+
+ private:
+  WelsCommon::CWelsLock* m_pLock;
+  int32_t* m_pOrder;
+  int32_t* m_pOrderNum;
+  int32_t m_iId;
+};
+
+// holds the only thread of the pool until released, the tasks queued meanwhile wait for dispatch
+class CBlockingTask : public IWelsTask {
+ public:
+  CBlockingTask (WelsCommon::IWelsTaskSink* pSink) : IWelsTask (pSink) {
+    m_bReleased = false;
+  }
+
+  virtual int32_t Execute() {
+    while (!IsReleased()) {
+      WelsSleep (1);
+    }
+    return cmResultSuccess;
+  }
+
+  void Release() {
+    WelsCommon::CWelsAutoLock cAutoLock (m_cLock);
+    m_bReleased = true;
+  }
+
+ private:
+  bool IsReleased() {
+    WelsCommon::CWelsAutoLock cAutoLock (m_cLock);
+    return m_bReleased;
+  }
+
+  WelsCommon::CWelsLock m_cLock;
+  bool m_bReleased;
+};
+
+// queues kiTaskNum tasks of the given priorities behind a blocking task on a one-thread pool and returns
+// the priorities in the order the tasks ran
+static void DispatchInOrder (const int32_t* kpPriority, const int32_t kiTaskNum, int32_t* pOrder) {
+  CThreadPoolTest cThreadPoolTest;
+  WelsCommon::CWelsLock cLock;
+  SWelsTaskGroup sGroup[WELS_TASK_PRIORITY_NUM];
+  int32_t iOrderNum = 0;
+  int32_t i;
+  for (i = 0; i < WELS_TASK_PRIORITY_NUM; i++) {
+    sGroup[i].iPriority = i;
+    sGroup[i].iMaxRunningNum = 0;
+    sGroup[i].iRunningNum = 0;
+  }
+
+  ASSERT_EQ (0, CWelsThreadPool::SetThreadNum (1));
+  CWelsThreadPool* pThreadPool = (CWelsThreadPool::AddReference());
+  ASSERT_TRUE (pThreadPool != NULL);
+
+  CBlockingTask cBlockingTask (&cThreadPoolTest);
+  pThreadPool->QueueTask (&cBlockingTask);
+
+  COrderTask* aTasks[TEST_TASK_NUM];
+  for (i = 0; i < kiTaskNum; i++) {
+    aTasks[i] = new COrderTask (&cThreadPoolTest, &cLock, pOrder, &iOrderNum, kpPriority[i]);
+    aTasks[i]->SetGroup (&sGroup[kpPriority[i]]);
+    pThreadPool->QueueTask (aTasks[i]);
+  }
+  cBlockingTask.Release();
+  while (cThreadPoolTest.GetTaskCount() < kiTaskNum + 1) {
+    WelsSleep (1);
+  }
+
+  for (i = 0; i < kiTaskNum; i++) {
+    delete aTasks[i];
+  }
+  pThreadPool->RemoveInstance();
+  EXPECT_EQ (0, CWelsThreadPool::SetThreadNum (CWelsThreadPool::DEFAULT_THREAD_NUM));
+}
+
+TEST (CThreadPoolTest, CThreadPoolTestPriorityOrder) {
+  const int32_t kiPriority[9] = {
+    WELS_TASK_PRIORITY_LOW, WELS_TASK_PRIORITY_NORMAL, WELS_TASK_PRIORITY_HIGH,
+    WELS_TASK_PRIORITY_LOW, WELS_TASK_PRIORITY_NORMAL, WELS_TASK_PRIORITY_HIGH,
+    WELS_TASK_PRIORITY_LOW, WELS_TASK_PRIORITY_NORMAL, WELS_TASK_PRIORITY_HIGH
+  };
+  int32_t iOrder[9];
+  DispatchInOrder (kiPriority, 9, iOrder);
+
+  for (int32_t i = 0; i < 9; i++) {
+    EXPECT_EQ (i / 3, iOrder[i]) << "dispatch " << i;
+  }
+}
+
+TEST (CThreadPoolTest, CThreadPoolTestPriorityAging) {
+  // a low class task queued before a run of high class tasks is served once it was passed over
+  // PRIORITY_AGING_NUM times instead of after all of them
+  const int32_t kiTaskNum = CWelsThreadPool::PRIORITY_AGING_NUM * 2 + 1;
+  int32_t iPriority[TEST_TASK_NUM];
+  int32_t iOrder[TEST_TASK_NUM];
+  ASSERT_LE (kiTaskNum, TEST_TASK_NUM);
+  iPriority[0] = WELS_TASK_PRIORITY_LOW;
+  for (int32_t i = 1; i < kiTaskNum; i++) {
+    iPriority[i] = WELS_TASK_PRIORITY_HIGH;
+  }
+  DispatchInOrder (iPriority, kiTaskNum, iOrder);
+
+  for (int32_t i = 0; i < kiTaskNum; i++) {
+    EXPECT_EQ (i == CWelsThreadPool::PRIORITY_AGING_NUM ? WELS_TASK_PRIORITY_LOW : WELS_TASK_PRIORITY_HIGH, iOrder[i])
+        << "dispatch " << i;
+  }
+}
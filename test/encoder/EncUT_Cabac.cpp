@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "set_mb_syn_cabac.h"
+
+using namespace WelsEnc;
+
+#define CABAC_TEST_CTX_NUM 8
+#define CABAC_TEST_BUF_SIZE (64 * 1024)
+
+namespace {
+
+// the arithmetic encoder as specified in H.264 9.3.4.2, bit by bit with outstanding bits
+class CCabacEncoderRef {
+ public:
+  CCabacEncoderRef() : m_uiLow (0), m_uiRange (510), m_iOutstanding (0), m_bFirstBit (true) {
+    for (int32_t i = 0; i < CABAC_TEST_CTX_NUM; i++)
+      m_sStateCtx[i].Set (0, 0);
+  }
+  void Decision (int32_t iCtx, uint32_t uiBin) {
+    SStateCtx* pState = &m_sStateCtx[iCtx];
+    const int32_t kiState = pState->State();
+    const uint32_t kuiRangeLps = g_kuiCabacRangeLps[kiState][ (m_uiRange >> 6) & 3];
+    m_uiRange -= kuiRangeLps;
+    if (uiBin != pState->Mps()) {
+      m_uiLow += m_uiRange;
+      m_uiRange = kuiRangeLps;
+      pState->Set (g_kuiStateTransTable[kiState][0], pState->Mps() ^ (kiState == 0));
+    } else {
+      pState->Set (g_kuiStateTransTable[kiState][1], pState->Mps());
+    }
+    Renorm();
+  }
+  void Bypass (uint32_t uiBin) {
+    m_uiLow <<= 1;
+    if (uiBin)
+      m_uiLow += m_uiRange;
+    if (m_uiLow >= 1024) {
+      PutBit (1);
+      m_uiLow -= 1024;
+    } else if (m_uiLow < 512) {
+      PutBit (0);
+    } else {
+      m_uiLow -= 512;
+      m_iOutstanding++;
+    }
+  }
+  void Terminate (uint32_t uiBin) {
+    m_uiRange -= 2;
+    if (uiBin) {
+      m_uiLow += m_uiRange;
+      m_uiRange = 2;
+      Renorm();
+      PutBit ((m_uiLow >> 9) & 1);
+      WriteBit ((m_uiLow >> 8) & 1);
+      WriteBit (1); // the rbsp stop bit, as the encoder flush sets it
+    } else {
+      Renorm();
+    }
+  }
+  // byte aligned with zero bits
+  std::vector<uint8_t> Bytes() const {
+    std::vector<uint8_t> vBytes ((m_vBits.size() + 7) >> 3, 0);
+    for (size_t i = 0; i < m_vBits.size(); i++)
+      vBytes[i >> 3] |= m_vBits[i] << (7 - (i & 7));
+    return vBytes;
+  }
+  SStateCtx m_sStateCtx[CABAC_TEST_CTX_NUM];
+
+ private:
+  void Renorm() {
+    while (m_uiRange < 256) {
+      if (m_uiLow < 256) {
+        PutBit (0);
+      } else if (m_uiLow >= 512) {
+        m_uiLow -= 512;
+        PutBit (1);
+      } else {
+        m_uiLow -= 256;
+        m_iOutstanding++;
+      }
+      m_uiRange <<= 1;
+      m_uiLow <<= 1;
+    }
+  }
+  void PutBit (uint8_t uiBit) {
+    if (m_bFirstBit)
+      m_bFirstBit = false;
+    else
+      WriteBit (uiBit);
+    for (; m_iOutstanding > 0; m_iOutstanding--)
+      WriteBit (1 - uiBit);
+  }
+  void WriteBit (uint8_t uiBit) {
+    m_vBits.push_back (uiBit);
+  }
+
+  uint32_t m_uiLow;
+  uint32_t m_uiRange;
+  int32_t m_iOutstanding;
+  bool m_bFirstBit;
+  std::vector<uint8_t> m_vBits;
+};
+
+void InitCabacTest (SCabacCtx* pCbCtx, uint8_t* pBuf) {
+  memset (pCbCtx, 0, sizeof (*pCbCtx));
+  WelsCabacEncodeInit (pCbCtx, pBuf, pBuf + CABAC_TEST_BUF_SIZE);
+  for (int32_t i = 0; i < CABAC_TEST_CTX_NUM; i++)
+    pCbCtx->m_sStateCtx[i].Set (0, 0);
+}
+
+// a bin with the given probability of being 1, in percent
+uint32_t RandomBin (int32_t iOnePercent) {
+  return (rand() % 100) < iOnePercent;
+}
+
+} // anon ns.
+
+// random decisions, bypass bins, exp-golomb suffixes with or without a sign and terminates, including long runs of 1 bypass bins
+// which make the carry run through many 0xff bytes
+TEST (CabacTest, EncodeMatchesReference) {
+  std::vector<uint8_t> vBuf (CABAC_TEST_BUF_SIZE);
+  for (int32_t iRound = 0; iRound < 200; iRound++) {
+    SCabacCtx sCbCtx;
+    CCabacEncoderRef cRef;
+    InitCabacTest (&sCbCtx, &vBuf[0]);
+
+    const int32_t kiOnePercent = rand() % 101;
+    const int32_t kiOpNum = 1 + rand() % 4000;
+    for (int32_t iOp = 0; iOp < kiOpNum; iOp++) {
+      const int32_t kiDice = rand() % 100;
+      if (kiDice < 60) {
+        const int32_t kiCtx = rand() % CABAC_TEST_CTX_NUM;
+        const uint32_t kuiBin = RandomBin (kiOnePercent);
+        WelsCabacEncodeDecision (&sCbCtx, kiCtx, kuiBin);
+        cRef.Decision (kiCtx, kuiBin);
+      } else if (kiDice < 75) {
+        const uint32_t kuiBin = RandomBin (kiOnePercent);
+        WelsCabacEncodeBypassOne (&sCbCtx, kuiBin);
+        cRef.Bypass (kuiBin);
+      } else if (kiDice < 85) {
+        const int32_t kiBinNum = 1 + rand() % 16;
+        const uint32_t kuiBins = (kiDice & 1) ? ((1u << kiBinNum) - 1) : (rand() & ((1u << kiBinNum) - 1));
+        WelsCabacEncodeBypassBins (&sCbCtx, kiBinNum, kuiBins);
+        for (int32_t i = kiBinNum - 1; i >= 0; i--)
+          cRef.Bypass ((kuiBins >> i) & 1);
+      } else if (kiDice < 95) {
+        const int32_t kiExpBits = rand() % 4;
+        const uint32_t kuiVal = (kiDice & 1) ? (rand() % 16) : (rand() % 70000);
+        const uint32_t kuiSign = rand() & 1;
+        const bool kbWithSign = (kiDice & 2) != 0;
+        if (kbWithSign)
+          WelsCabacEncodeUeBypassSign (&sCbCtx, kiExpBits, kuiVal, kuiSign);
+        else
+          WelsCabacEncodeUeBypass (&sCbCtx, kiExpBits, kuiVal);
+        int32_t k = kiExpBits;
+        uint32_t uiSuf = kuiVal;
+        for (; uiSuf >= (1u << k); k++) {
+          cRef.Bypass (1);
+          uiSuf -= 1u << k;
+        }
+        cRef.Bypass (0);
+        while (k--)
+          cRef.Bypass ((uiSuf >> k) & 1);
+        if (kbWithSign)
+          cRef.Bypass (kuiSign);
+      } else {
+        WelsCabacEncodeTerminate (&sCbCtx, 0);
+        cRef.Terminate (0);
+      }
+    }
+    WelsCabacEncodeFlush (&sCbCtx);
+    cRef.Terminate (1);
+
+    const std::vector<uint8_t> kvRef = cRef.Bytes();
+    const int32_t kiLen = (int32_t) (WelsCabacEncodeGetPtr (&sCbCtx) - &vBuf[0]);
+    ASSERT_EQ ((int32_t) kvRef.size(), kiLen) << "round " << iRound;
+    ASSERT_EQ (0, memcmp (&kvRef[0], &vBuf[0], kiLen)) << "round " << iRound;
+  }
+}
+
+TEST (CabacTest, BypassBinsMatchBypassOne) {
+  std::vector<uint8_t> vBufOne (CABAC_TEST_BUF_SIZE);
+  std::vector<uint8_t> vBufBins (CABAC_TEST_BUF_SIZE);
+  for (int32_t iRound = 0; iRound < 50; iRound++) {
+    SCabacCtx sCbCtxOne, sCbCtxBins;
+    InitCabacTest (&sCbCtxOne, &vBufOne[0]);
+    InitCabacTest (&sCbCtxBins, &vBufBins[0]);
+    for (int32_t iOp = 0; iOp < 1000; iOp++) {
+      const int32_t kiCtx = rand() % CABAC_TEST_CTX_NUM;
+      const uint32_t kuiBin = RandomBin (30);
+      WelsCabacEncodeDecision (&sCbCtxOne, kiCtx, kuiBin);
+      WelsCabacEncodeDecision (&sCbCtxBins, kiCtx, kuiBin);
+
+      const int32_t kiBinNum = 1 + rand() % 16;
+      const uint32_t kuiBins = rand() & ((1u << kiBinNum) - 1);
+      WelsCabacEncodeBypassBins (&sCbCtxBins, kiBinNum, kuiBins);
+      for (int32_t i = kiBinNum - 1; i >= 0; i--)
+        WelsCabacEncodeBypassOne (&sCbCtxOne, (kuiBins >> i) & 1);
+    }
+    WelsCabacEncodeFlush (&sCbCtxOne);
+    WelsCabacEncodeFlush (&sCbCtxBins);
+    const int32_t kiLen = (int32_t) (WelsCabacEncodeGetPtr (&sCbCtxOne) - &vBufOne[0]);
+    ASSERT_EQ (kiLen, (int32_t) (WelsCabacEncodeGetPtr (&sCbCtxBins) - &vBufBins[0]));
+    EXPECT_EQ (0, memcmp (&vBufOne[0], &vBufBins[0], kiLen));
+  }
+}
+
+// the estimated cost follows the context states like the engine does and stays close to the coded size
+TEST (CabacTest, EstimateMatchesCodedSize) {
+  std::vector<uint8_t> vBuf (CABAC_TEST_BUF_SIZE);
+  const int32_t kiOnePercent[] = { 2, 10, 30, 50, 80 };
+  for (int32_t i = 0; i < (int32_t) (sizeof (kiOnePercent) / sizeof (kiOnePercent[0])); i++) {
+    SCabacCtx sCbCtx;
+    SStateCtx sStateCtx[CABAC_TEST_CTX_NUM];
+    InitCabacTest (&sCbCtx, &vBuf[0]);
+    memcpy (sStateCtx, sCbCtx.m_sStateCtx, sizeof (sStateCtx));
+
+    uint64_t uiCost = 0;
+    for (int32_t iOp = 0; iOp < 20000; iOp++) {
+      const int32_t kiCtx = rand() % CABAC_TEST_CTX_NUM;
+      const uint32_t kuiBin = RandomBin (kiOnePercent[i]);
+      const uint32_t kuiCost = WelsCabacEstimateDecision (&sStateCtx[kiCtx], kuiBin);
+      ASSERT_EQ (kuiCost, WelsCabacEstimateDecisionUpdate (&sStateCtx[kiCtx], kuiBin));
+      uiCost += kuiCost;
+      WelsCabacEncodeDecision (&sCbCtx, kiCtx, kuiBin);
+
+      const uint32_t kuiVal = rand() % 40;
+      uiCost += WelsCabacEstimateUeBypass (0, kuiVal);
+      WelsCabacEncodeUeBypass (&sCbCtx, 0, kuiVal);
+      ASSERT_EQ (sStateCtx[kiCtx].m_uiStateMps, sCbCtx.m_sStateCtx[kiCtx].m_uiStateMps);
+    }
+    WelsCabacEncodeFlush (&sCbCtx);
+    const int64_t kiCodedBits = (WelsCabacEncodeGetPtr (&sCbCtx) - &vBuf[0]) * 8;
+    const int64_t kiEstimatedBits = (int64_t) (uiCost >> 8);
+    EXPECT_LT (llabs (kiCodedBits - kiEstimatedBits), kiCodedBits / 100 + 16) << "one percent " << kiOnePercent[i];
+  }
+}
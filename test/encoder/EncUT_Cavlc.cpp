@@ -1,6 +1,9 @@
 #include "cpu.h"
 #include "macros.h"
 #include "set_mb_syn_cavlc.h"
+#include "svc_enc_golomb.h"
+#include "vlc_encoder.h"
+#include "measure_time.h"
 #include <gtest/gtest.h>
 #include <cmath>
 #include <cstddef>
@@ -70,6 +73,232 @@ void TestCavlcParamCal (PCavlcParamCalFunc func) {
   }
 }
 
+// every code word through BsWriteBits, the writer the block writer replaces
+int32_t WriteBlockResidualCavlc_ref (int16_t* pCoffLevel, int32_t iEndIdx, int32_t iResidualProperty, int8_t iNC,
+                                     SBitStringAux* pBs) {
+  int16_t iLevel[16];
+  uint8_t uiRun[16];
+  int32_t iTotalCoeffs = 0, iTrailingOnes = 0;
+  uint32_t uiSign = 0;
+  const int32_t iTotalZeros = CavlcParamCal_ref (pCoffLevel, uiRun, iLevel, &iTotalCoeffs, iEndIdx);
+
+  for (int32_t i = 0; i < WELS_MIN (iTotalCoeffs, 3) && WELS_ABS (iLevel[i]) == 1; i++) {
+    iTrailingOnes ++;
+    uiSign = (uiSign << 1) | (iLevel[i] < 0);
+  }
+  const uint8_t* kpCoeffToken = g_kuiVlcCoeffToken[g_kuiEncNcMapTable[iNC]][iTotalCoeffs][iTrailingOnes];
+  if (iTotalCoeffs == 0) {
+    BsWriteBits (pBs, kpCoeffToken[1], kpCoeffToken[0]);
+    return ENC_RETURN_SUCCESS;
+  }
+  BsWriteBits (pBs, kpCoeffToken[1], kpCoeffToken[0]);
+  BsWriteBits (pBs, iTrailingOnes, uiSign);
+
+  int32_t iSuffixLength = (iTotalCoeffs > 10 && iTrailingOnes < 3) ? 1 : 0;
+  for (int32_t i = iTrailingOnes; i < iTotalCoeffs; i++) {
+    const int32_t kiVal = iLevel[i];
+    int32_t iLevelCode = (kiVal > 0) ? ((kiVal - 1) << 1) : ((-kiVal << 1) - 1);
+    iLevelCode -= ((i == iTrailingOnes) && (iTrailingOnes < 3)) << 1;
+    int32_t iLevelPrefix = iLevelCode >> iSuffixLength;
+    int32_t iLevelSuffixSize = iSuffixLength;
+    int32_t iLevelSuffix = iLevelCode - (iLevelPrefix << iSuffixLength);
+    if (iLevelPrefix >= 14 && iLevelPrefix < 30 && iSuffixLength == 0) {
+      iLevelPrefix = 14;
+      iLevelSuffix = iLevelCode - iLevelPrefix;
+      iLevelSuffixSize = 4;
+    } else if (iLevelPrefix >= 15) {
+      iLevelPrefix = 15;
+      iLevelSuffix = iLevelCode - (iLevelPrefix << iSuffixLength);
+      if (iLevelSuffix >> 11)
+        return ENC_RETURN_VLCOVERFLOWFOUND;
+      if (iSuffixLength == 0)
+        iLevelSuffix -= 15;
+      iLevelSuffixSize = 12;
+    }
+    BsWriteBits (pBs, iLevelPrefix + 1 + iLevelSuffixSize, (1 << iLevelSuffixSize) | iLevelSuffix);
+
+    iSuffixLength += !iSuffixLength;
+    const int32_t kiThreshold = 3 << (iSuffixLength - 1);
+    iSuffixLength += ((kiVal > kiThreshold) || (kiVal < -kiThreshold)) && (iSuffixLength < 6);
+  }
+
+  if (iTotalCoeffs < iEndIdx + 1) {
+    const uint8_t* kpTotalZeros = (CHROMA_DC != iResidualProperty) ? g_kuiVlcTotalZeros[iTotalCoeffs][iTotalZeros]
+                                  : g_kuiVlcTotalZerosChromaDc[iTotalCoeffs][iTotalZeros];
+    BsWriteBits (pBs, kpTotalZeros[1], kpTotalZeros[0]);
+  }
+  int32_t iZerosLeft = iTotalZeros;
+  for (int32_t i = 0; i + 1 < iTotalCoeffs && iZerosLeft > 0; i++) {
+    const uint8_t* kpRunBefore = g_kuiVlcRunBefore[WELS_MIN (iZerosLeft, 7)][uiRun[i]];
+    BsWriteBits (pBs, kpRunBefore[1], kpRunBefore[0]);
+    iZerosLeft -= uiRun[i];
+  }
+  return ENC_RETURN_SUCCESS;
+}
+
+// the block writer as it was with a 32-bit register, one branch and a 4-byte store per full register
+#define CAVLC_BS32_INIT(pBs) \
+  uint8_t* pBufPtr = pBs->pCurBuf; \
+  uint32_t uiCurBits = pBs->uiCurBits; \
+  int32_t iLeftBits = pBs->iLeftBits;
+
+#define CAVLC_BS32_UNINIT(pBs) \
+  pBs->pCurBuf = pBufPtr; \
+  pBs->uiCurBits = uiCurBits; \
+  pBs->iLeftBits = iLeftBits;
+
+#define CAVLC_BS32_WRITE(n, v) { \
+  if ((n) < iLeftBits) { \
+    uiCurBits = (uiCurBits << (n)) | (v); \
+    iLeftBits -= (n); \
+  } else { \
+    (n) -= iLeftBits; \
+    uiCurBits = (uiCurBits << iLeftBits) | ((v) >> (n)); \
+    WRITE_BE_32 (pBufPtr, uiCurBits); \
+    pBufPtr += 4; \
+    uiCurBits = (v) & ((1 << (n)) - 1); \
+    iLeftBits = 32 - (n); \
+  } \
+}
+
+int32_t WriteBlockResidualCavlc32_ref (int16_t* pCoffLevel, int32_t iEndIdx, int32_t iResidualProperty, int8_t iNC,
+                                       SBitStringAux* pBs) {
+  ENFORCE_STACK_ALIGN_1D (int16_t, iLevel, 16, 16)
+  ENFORCE_STACK_ALIGN_1D (uint8_t, uiRun, 16, 16)
+  int32_t iTotalCoeffs = 0, iTrailingOnes = 0, iTotalZeros, iZerosLeft;
+  uint32_t uiSign = 0;
+  int32_t iLevelCode, iLevelPrefix, iLevelSuffix, uiSuffixLength, iLevelSuffixSize;
+  int32_t iValue, iThreshold, n, i;
+
+  CAVLC_BS32_INIT (pBs);
+  iTotalZeros = CavlcParamCal_c (pCoffLevel, uiRun, iLevel, &iTotalCoeffs, iEndIdx);
+  for (i = 0; i < WELS_MIN (iTotalCoeffs, 3) && WELS_ABS (iLevel[i]) == 1; i++) {
+    iTrailingOnes ++;
+    uiSign = (uiSign << 1) | (iLevel[i] < 0);
+  }
+  const uint8_t* kpCoeffToken = g_kuiVlcCoeffToken[g_kuiEncNcMapTable[iNC]][iTotalCoeffs][iTrailingOnes];
+  iValue = kpCoeffToken[0];
+  n = kpCoeffToken[1];
+  if (iTotalCoeffs == 0) {
+    CAVLC_BS32_WRITE (n, iValue);
+    CAVLC_BS32_UNINIT (pBs);
+    return ENC_RETURN_SUCCESS;
+  }
+  n += iTrailingOnes;
+  iValue = (iValue << iTrailingOnes) + uiSign;
+  CAVLC_BS32_WRITE (n, iValue);
+
+  uiSuffixLength = (iTotalCoeffs > 10 && iTrailingOnes < 3) ? 1 : 0;
+  for (i = iTrailingOnes; i < iTotalCoeffs; i++) {
+    int32_t iVal = iLevel[i];
+    iLevelCode = (iVal - 1) * (1 << 1);
+    uiSign = (iLevelCode >> 31);
+    iLevelCode = (iLevelCode ^ uiSign) + (uiSign << 1);
+    iLevelCode -= ((i == iTrailingOnes) && (iTrailingOnes < 3)) << 1;
+    iLevelPrefix = iLevelCode >> uiSuffixLength;
+    iLevelSuffixSize = uiSuffixLength;
+    iLevelSuffix = iLevelCode - (iLevelPrefix << uiSuffixLength);
+    if (iLevelPrefix >= 14 && iLevelPrefix < 30 && uiSuffixLength == 0) {
+      iLevelPrefix = 14;
+      iLevelSuffix = iLevelCode - iLevelPrefix;
+      iLevelSuffixSize = 4;
+    } else if (iLevelPrefix >= 15) {
+      iLevelPrefix = 15;
+      iLevelSuffix = iLevelCode - (iLevelPrefix << uiSuffixLength);
+      if (iLevelSuffix >> 11)
+        return ENC_RETURN_VLCOVERFLOWFOUND;
+      if (uiSuffixLength == 0)
+        iLevelSuffix -= 15;
+      iLevelSuffixSize = 12;
+    }
+    n = iLevelPrefix + 1 + iLevelSuffixSize;
+    iValue = ((1 << iLevelSuffixSize) | iLevelSuffix);
+    CAVLC_BS32_WRITE (n, iValue);
+
+    uiSuffixLength += !uiSuffixLength;
+    iThreshold = 3 << (uiSuffixLength - 1);
+    uiSuffixLength += ((iVal > iThreshold) || (iVal < -iThreshold)) && (uiSuffixLength < 6);
+  }
+
+  if (iTotalCoeffs < iEndIdx + 1) {
+    const uint8_t* kpTotalZeros = (CHROMA_DC != iResidualProperty) ? g_kuiVlcTotalZeros[iTotalCoeffs][iTotalZeros]
+                                  : g_kuiVlcTotalZerosChromaDc[iTotalCoeffs][iTotalZeros];
+    n = kpTotalZeros[1];
+    iValue = kpTotalZeros[0];
+    CAVLC_BS32_WRITE (n, iValue);
+  }
+  iZerosLeft = iTotalZeros;
+  for (i = 0; i + 1 < iTotalCoeffs && iZerosLeft > 0; ++ i) {
+    const uint8_t kuiRun = uiRun[i];
+    n = g_kuiVlcRunBefore[WELS_MIN (iZerosLeft, 7)][kuiRun][1];
+    iValue = g_kuiVlcRunBefore[WELS_MIN (iZerosLeft, 7)][kuiRun][0];
+    CAVLC_BS32_WRITE (n, iValue);
+    iZerosLeft -= kuiRun;
+  }
+  CAVLC_BS32_UNINIT (pBs);
+  return ENC_RETURN_SUCCESS;
+}
+
+// small levels as after quantisation at moderate QPs, with an occasional large one
+void FillCavlcBlock (int16_t* pCoeffLevel, const int32_t kiEndIdx, const int32_t kiNonZeroPercent) {
+  for (int32_t i = 0; i < 16; i++) {
+    const int32_t r = std::rand();
+    if (i > kiEndIdx || (r % 100) >= kiNonZeroPercent)
+      pCoeffLevel[i] = 0;
+    else if ((r >> 8) % 16 == 0)
+      pCoeffLevel[i] = ((r >> 12) % 600) - 300;
+    else
+      pCoeffLevel[i] = ((r >> 12) & 1) ? 1 + (r >> 13) % 3 : -1 - (r >> 13) % 3;
+  }
+}
+
+#define CAVLC_TEST_BLOCK_NUM 4096
+#define CAVLC_TEST_WRITER_NUM 3 // the block writer, the BsWriteBits one and the former 32-bit block writer
+
+// writes the same blocks with every writer, in batches that leave the bit position unaligned in between
+void TestWriteBlockResidualCavlc (const int32_t kiNonZeroPercent, const int32_t kiRepetitions, int64_t* pTime,
+                                  int32_t* pBits) {
+  ENFORCE_STACK_ALIGN_2D (int16_t, iCoeffLevel, CAVLC_TEST_BLOCK_NUM, 16, 16);
+  static uint8_t uiBuf[CAVLC_TEST_WRITER_NUM][CAVLC_TEST_BLOCK_NUM * 64];
+  const int32_t kiEndIdx[] = { 15, 14, 3 };
+  const int32_t kiProperty[] = { LUMA_4x4, LUMA_AC, CHROMA_DC };
+  int8_t iNC[CAVLC_TEST_BLOCK_NUM];
+  SWelsFuncPtrList sFuncList;
+  SBitStringAux sBs[CAVLC_TEST_WRITER_NUM];
+
+  sFuncList.pfCavlcParamCal = CavlcParamCal_c;
+  for (int32_t i = 0; i < CAVLC_TEST_BLOCK_NUM; i++) {
+    FillCavlcBlock (iCoeffLevel[i], kiEndIdx[i % 3], kiNonZeroPercent);
+    iNC[i] = (i % 3 == 2) ? CHROMA_DC_NC_OFFSET : std::rand() % 17;
+  }
+
+  for (int32_t iWriter = 0; iWriter < CAVLC_TEST_WRITER_NUM; iWriter++) {
+    const int64_t kiStart = WelsTime();
+    for (int32_t r = 0; r < kiRepetitions; r++) {
+      InitBits (&sBs[iWriter], uiBuf[iWriter], sizeof (uiBuf[iWriter]));
+      BsWriteBits (&sBs[iWriter], 3, 5);
+      for (int32_t i = 0; i < CAVLC_TEST_BLOCK_NUM; i++) {
+        int32_t iRet;
+        if (iWriter == 0)
+          iRet = WriteBlockResidualCavlc (&sFuncList, iCoeffLevel[i], kiEndIdx[i % 3], 1, kiProperty[i % 3], iNC[i],
+                                          &sBs[0]);
+        else if (iWriter == 1)
+          iRet = WriteBlockResidualCavlc_ref (iCoeffLevel[i], kiEndIdx[i % 3], kiProperty[i % 3], iNC[i], &sBs[1]);
+        else
+          iRet = WriteBlockResidualCavlc32_ref (iCoeffLevel[i], kiEndIdx[i % 3], kiProperty[i % 3], iNC[i], &sBs[2]);
+        ASSERT_EQ (ENC_RETURN_SUCCESS, iRet);
+      }
+      BsRbspTrailingBits (&sBs[iWriter]);
+    }
+    pTime[iWriter] = WelsTime() - kiStart;
+  }
+  for (int32_t iWriter = 1; iWriter < CAVLC_TEST_WRITER_NUM; iWriter++) {
+    ASSERT_EQ (BsGetBitsPos (&sBs[iWriter]), BsGetBitsPos (&sBs[0])) << "iWriter = " << iWriter;
+    EXPECT_EQ (0, memcmp (uiBuf[0], uiBuf[iWriter], BsGetBitsPos (&sBs[0]) >> 3)) << "iWriter = " << iWriter;
+  }
+  *pBits = BsGetBitsPos (&sBs[0]);
+}
+
 } // anon ns.
 
 TEST (CavlcTest, CavlcParamCal_c) {
@@ -88,3 +317,27 @@ TEST (CavlcTest, CavlcParamCal_sse42) {
     TestCavlcParamCal (CavlcParamCal_sse42);
 }
 #endif
+
+TEST (CavlcTest, WriteBlockResidualCavlc) {
+  const int32_t kiNonZeroPercent[] = { 0, 10, 40, 100 };
+  for (std::size_t i = 0; i < sizeof kiNonZeroPercent / sizeof *kiNonZeroPercent; i++) {
+    int64_t iTime[CAVLC_TEST_WRITER_NUM];
+    int32_t iBits = 0;
+    TestWriteBlockResidualCavlc (kiNonZeroPercent[i], 1, iTime, &iBits);
+  }
+}
+
+// Baseline entropy throughput of the block writer against the former 32-bit one and the BsWriteBits based one
+TEST (CavlcTest, WriteBlockResidualCavlcThroughput) {
+  const int32_t kiRepetitions = 40;
+  const int32_t kiNonZeroPercent[] = { 10, 30, 60 };
+  for (std::size_t i = 0; i < sizeof kiNonZeroPercent / sizeof *kiNonZeroPercent; i++) {
+    int64_t iTime[CAVLC_TEST_WRITER_NUM];
+    int32_t iBits = 0;
+    TestWriteBlockResidualCavlc (kiNonZeroPercent[i], kiRepetitions, iTime, &iBits);
+    const double kdMbits = (double)iBits * kiRepetitions / 1000000.0;
+    printf ("%d%% non-zero, WriteBlockResidualCavlc: %.1f Mbit/s, former 32-bit writer: %.1f Mbit/s, "
+            "BsWriteBits: %.1f Mbit/s\n", kiNonZeroPercent[i], kdMbits * 1000000.0 / WELS_MAX (iTime[0], 1),
+            kdMbits * 1000000.0 / WELS_MAX (iTime[2], 1), kdMbits * 1000000.0 / WELS_MAX (iTime[1], 1));
+  }
+}
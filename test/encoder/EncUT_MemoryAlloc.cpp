@@ -54,3 +54,61 @@ TEST (MemoryAlignTest, WelsMallocAndFreeOnceFunctionVerify) {
     }
   }
 }
+//Tests of WelsMallocAndFree End
+//Tests of the arena mode Begin
+TEST (MemoryAlignTest, ArenaMallocAndFree) {
+  const uint32_t kuiArenaSize = 64 * 1024;
+  const uint32_t kuiZero = 0;
+  CMemoryAlign cTestMa (64, kuiArenaSize, MEMORY_ARENA_PREFAULT);
+  ASSERT_EQ (kuiArenaSize, cTestMa.WelsGetArenaSize());
+
+  uint8_t* pData[64];
+  uint32_t uiSize[64];
+  for (int i = 0; i < 64; i++) {
+    const uint32_t kuiSize = uiSize[i] = 1 + rand() % 600;
+    pData[i] = static_cast<uint8_t*> (cTestMa.WelsMallocz (kuiSize, (i & 1) ? "pOdd" : "pEven"));
+    ASSERT_TRUE (pData[i] != NULL);
+    ASSERT_TRUE ((((uintptr_t)pData[i]) & 63) == 0);
+    for (uint32_t j = 0; j < kuiSize; j++)
+      ASSERT_EQ (0, pData[i][j]);
+    memset (pData[i], 0xff, kuiSize);
+  }
+  EXPECT_EQ (kuiZero, cTestMa.WelsGetArenaOverflowCount());
+  ASSERT_EQ (2, cTestMa.WelsGetMemoryTagNum());
+  EXPECT_STREQ ("pEven", cTestMa.WelsGetMemoryTagStat (0)->pTag);
+  EXPECT_EQ (32u, cTestMa.WelsGetMemoryTagStat (1)->uiAllocCount);
+
+  // a freed block is taken again by a request of its size, without carving the arena further
+  const uint32_t kuiArenaUsed = cTestMa.WelsGetArenaUsedBytes();
+  cTestMa.WelsFree (pData[10], "pEven");
+  uint8_t* pReused = static_cast<uint8_t*> (cTestMa.WelsMalloc (uiSize[10], "pReused"));
+  EXPECT_EQ (pData[10], pReused);
+  EXPECT_EQ (kuiArenaUsed, cTestMa.WelsGetArenaUsedBytes());
+  pData[10] = pReused;
+
+  // larger than the arena, from the heap
+  uint8_t* pLarge = static_cast<uint8_t*> (cTestMa.WelsMalloc (kuiArenaSize, "pLarge"));
+  ASSERT_TRUE (pLarge != NULL);
+  ASSERT_TRUE ((((uintptr_t)pLarge) & 63) == 0);
+  EXPECT_EQ (1u, cTestMa.WelsGetArenaOverflowCount());
+  EXPECT_EQ (kuiArenaSize, cTestMa.WelsGetMemoryTagStat (3)->uiUsedBytes);
+  cTestMa.WelsFree (pLarge, "pLarge");
+  EXPECT_EQ (kuiZero, cTestMa.WelsGetMemoryTagStat (3)->uiUsedBytes);
+  EXPECT_EQ (kuiArenaSize, cTestMa.WelsGetMemoryTagStat (3)->uiPeakBytes);
+  EXPECT_FALSE (cTestMa.WelsArenaRewind());
+
+  for (int i = 0; i < 64; i++)
+    cTestMa.WelsFree (pData[i], "pData");
+  EXPECT_EQ (kuiZero, cTestMa.WelsGetMemoryUsage());
+  for (int i = 0; i < cTestMa.WelsGetMemoryTagNum(); i++)
+    EXPECT_EQ (kuiZero, cTestMa.WelsGetMemoryTagStat (i)->uiUsedBytes);
+
+  // all the blocks given back, the arena is carved from its start again
+  EXPECT_TRUE (cTestMa.WelsArenaRewind());
+  EXPECT_EQ (kuiZero, cTestMa.WelsGetArenaUsedBytes());
+  uint8_t* pFirst = static_cast<uint8_t*> (cTestMa.WelsMalloc (kuiArenaSize / 2, "pFirst"));
+  EXPECT_EQ (1u, cTestMa.WelsGetArenaOverflowCount());
+  EXPECT_GT (cTestMa.WelsGetArenaUsedBytes(), kuiArenaSize / 2);
+  cTestMa.WelsFree (pFirst, "pFirst");
+}
+//Tests of the arena mode End
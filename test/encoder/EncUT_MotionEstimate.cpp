@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <vector>
 #include "gtest/gtest.h"
 #include "utils/DataGenerator.h"
 #include "md.h"
@@ -563,3 +564,133 @@ TEST_F (FeatureMotionEstimateTest, TestFeatureSearch) {
   }
 }
 
+
+TEST (BlockHashIndexTest, TestPerformBlockHashIndex) {
+  const int32_t kiWidth = 64;
+  const int32_t kiHeight = 64;
+  CMemoryAlign cMa (16);
+  uint8_t* pRefData = (uint8_t*)cMa.WelsMalloc (kiWidth * kiHeight * sizeof (uint8_t), "pRefData");
+  ASSERT_TRUE (NULL != pRefData);
+  // constant along the anti-diagonals, so that each block equals the one below on its left but not the one on its left
+  uint8_t uiDiagonal[128];
+  for (int32_t i = 0; i < 128; i++)
+    uiDiagonal[i] = rand() % 256;
+  for (int32_t i = 0; i < kiHeight; i++)
+    for (int32_t j = 0; j < kiWidth; j++)
+      pRefData[i * kiWidth + j] = uiDiagonal[i + j];
+
+  SPicture sRef;
+  memset (&sRef, 0, sizeof (sRef));
+  sRef.pData[0] = pRefData;
+  sRef.iLineSize[0] = kiWidth;
+  sRef.iFrameAverageQp = rand() % 52;
+  SWelsFuncPtrList sFuncList;
+  WelsInitMeFunc (&sFuncList, WelsCPUFeatureDetect (NULL), true);
+  SScreenBlockHashIndex* pHashIndex = NULL;
+  ASSERT_TRUE (ENC_RETURN_SUCCESS == RequestScreenBlockHashIndex (&cMa, kiWidth, kiHeight, &pHashIndex));
+  PerformBlockHashIndex (&sFuncList, &sRef, pHashIndex, NULL);
+  ASSERT_TRUE (pHashIndex->bIndexed);
+
+  // every position is chained, except those equal to the position on their left
+  const int32_t kiPositionNum = pHashIndex->iWidth * pHashIndex->iHeight;
+  std::vector<bool> bChained (kiPositionNum, false);
+  for (int32_t iBucket = 0; iBucket < (1 << pHashIndex->iBucketBits); iBucket++) {
+    for (int32_t iPos = pHashIndex->pBucketHead[iBucket]; iPos >= 0; iPos = pHashIndex->pNextPosition[iPos])
+      bChained[iPos] = true;
+  }
+  for (int32_t y = 0; y < pHashIndex->iHeight; y++) {
+    for (int32_t x = 0; x < pHashIndex->iWidth; x++) {
+      bool bEqualToLeft = (x > 0);
+      for (int32_t i = 0; i < BLOCK_HASH_SIZE && bEqualToLeft; i++) {
+        const uint8_t* kpRow = pRefData + (y + i) * kiWidth + x;
+        bEqualToLeft = (0 == memcmp (kpRow, kpRow - 1, BLOCK_HASH_SIZE));
+      }
+      if (!bEqualToLeft) {
+        EXPECT_TRUE (bChained[y * pHashIndex->iWidth + x]) << "x = " << x << " y = " << y;
+      }
+    }
+  }
+  ReleaseScreenBlockHashIndex (&cMa, &pHashIndex);
+  cMa.WelsFree (pRefData, "pRefData");
+}
+
+// a few rectangles of the picture changed, as the screen between two frames
+static void ChangeBlockHashTestPicture (uint8_t* pData, const int32_t kiWidth, const int32_t kiHeight) {
+  for (int32_t n = 0; n < 4; n++) {
+    const int32_t kiLeft = rand() % kiWidth;
+    const int32_t kiTop = rand() % kiHeight;
+    const int32_t kiRectWidth = 1 + rand() % 12;
+    const int32_t kiRectHeight = 1 + rand() % 12;
+    const int32_t kiRight = WELS_MIN (kiLeft + kiRectWidth, kiWidth);
+    const int32_t kiBottom = WELS_MIN (kiTop + kiRectHeight, kiHeight);
+    for (int32_t i = kiTop; i < kiBottom; i++)
+      for (int32_t j = kiLeft; j < kiRight; j++)
+        pData[i * kiWidth + j] = rand() % 256;
+  }
+}
+
+TEST (BlockHashIndexTest, TestIncrementalBlockHashIndex) {
+  const int32_t kiWidth = 67;
+  const int32_t kiHeight = 45;
+  CMemoryAlign cMa (16);
+  uint8_t* pRefData = (uint8_t*)cMa.WelsMalloc (kiWidth * kiHeight * sizeof (uint8_t), "pRefData");
+  ASSERT_TRUE (NULL != pRefData);
+  // two levels only, so that equal blocks are frequent
+  for (int32_t i = 0; i < kiWidth * kiHeight; i++)
+    pRefData[i] = (rand() % 4) ? 16 : 235;
+
+  SPicture sRef;
+  memset (&sRef, 0, sizeof (sRef));
+  sRef.pData[0] = pRefData;
+  sRef.iLineSize[0] = kiWidth;
+  sRef.iFrameAverageQp = rand() % 52;
+  SWelsFuncPtrList sFuncList;
+  WelsInitMeFunc (&sFuncList, WelsCPUFeatureDetect (NULL), true);
+  SScreenBlockHashIndex* pPrevIndex = NULL;
+  SScreenBlockHashIndex* pCurIndex = NULL;
+  SScreenBlockHashIndex* pFullIndex = NULL;
+  ASSERT_TRUE (ENC_RETURN_SUCCESS == RequestScreenBlockHashIndex (&cMa, kiWidth, kiHeight, &pPrevIndex));
+  ASSERT_TRUE (ENC_RETURN_SUCCESS == RequestScreenBlockHashIndex (&cMa, kiWidth, kiHeight, &pCurIndex));
+  ASSERT_TRUE (ENC_RETURN_SUCCESS == RequestScreenBlockHashIndex (&cMa, kiWidth, kiHeight, &pFullIndex));
+  PerformBlockHashIndex (&sFuncList, &sRef, pPrevIndex, NULL);
+
+  const int32_t kiPositionNum = pFullIndex->iWidth * pFullIndex->iHeight;
+  const int32_t kiBucketNum = 1 << pFullIndex->iBucketBits;
+  for (int32_t iFrame = 0; iFrame < 8; iFrame++) {
+    ChangeBlockHashTestPicture (pRefData, kiWidth, kiHeight);
+    // from another index, then from the index itself as a reference buffer being reused
+    PerformBlockHashIndex (&sFuncList, &sRef, pCurIndex, pPrevIndex);
+    PerformBlockHashIndex (&sFuncList, &sRef, pPrevIndex, pPrevIndex);
+    PerformBlockHashIndex (&sFuncList, &sRef, pFullIndex, NULL);
+    ASSERT_EQ (0, memcmp (pCurIndex->pHash, pFullIndex->pHash, kiPositionNum * sizeof (uint64_t)));
+    ASSERT_EQ (0, memcmp (pCurIndex->pNextPosition, pFullIndex->pNextPosition, kiPositionNum * sizeof (int32_t)));
+    ASSERT_EQ (0, memcmp (pCurIndex->pBucketHead, pFullIndex->pBucketHead, kiBucketNum * sizeof (int32_t)));
+    ASSERT_EQ (0, memcmp (pPrevIndex->pHash, pFullIndex->pHash, kiPositionNum * sizeof (uint64_t)));
+    ASSERT_EQ (0, memcmp (pPrevIndex->pNextPosition, pFullIndex->pNextPosition, kiPositionNum * sizeof (int32_t)));
+    ASSERT_EQ (0, memcmp (pPrevIndex->pBucketHead, pFullIndex->pBucketHead, kiBucketNum * sizeof (int32_t)));
+    EXPECT_GT (pPrevIndex->uiIndexSeq, pFullIndex->uiIndexSeq);
+  }
+  ReleaseScreenBlockHashIndex (&cMa, &pPrevIndex);
+  ReleaseScreenBlockHashIndex (&cMa, &pCurIndex);
+  ReleaseScreenBlockHashIndex (&cMa, &pFullIndex);
+  cMa.WelsFree (pRefData, "pRefData");
+}
+
+#ifdef X86_ASM
+TEST (BlockHashIndexTest, TestBlockHash8x8_sse42) {
+  if ((WelsCPUFeatureDetect (NULL) & WELS_CPU_SSE42) == 0)
+    return;
+  const int32_t kiStride = 77;
+  const int32_t kiNum = 64;
+  uint8_t uiSrc[BLOCK_HASH_SIZE * kiStride];
+  for (int32_t i = 0; i < BLOCK_HASH_SIZE * kiStride; i++)
+    uiSrc[i] = rand() % 256;
+  uint64_t uiHashC[kiNum], uiHashAsm[kiNum];
+  for (int32_t iNum = 1; iNum <= kiNum; iNum += 9) {
+    memset (uiHashAsm, 0, sizeof (uiHashAsm));
+    BlockHash8x8_c (uiSrc, kiStride, iNum, uiHashC);
+    BlockHash8x8_sse42 (uiSrc, kiStride, iNum, uiHashAsm);
+    ASSERT_EQ (0, memcmp (uiHashC, uiHashAsm, iNum * sizeof (uint64_t))) << "iNum = " << iNum;
+  }
+}
+#endif
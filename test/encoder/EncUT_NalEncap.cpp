@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "nal_encap.h"
+#include "encoder_context.h"
+
+using namespace WelsEnc;
+
+#define NAL_ENCAP_TEST_PAYLOAD_MAX 4096
+
+// byte by byte emulation prevention, as the NAL writer did before the zero-free spans were copied as a whole
+static int32_t EncodeNalPayloadRef (const uint8_t* kpSrc, const int32_t kiSrcLen, uint8_t* pDst) {
+  uint8_t* pDstPointer = pDst;
+  int32_t iZeroCount = 0;
+  for (int32_t i = 0; i < kiSrcLen; i++) {
+    if (iZeroCount == 2 && kpSrc[i] <= 3) {
+      *pDstPointer++ = 3;
+      iZeroCount = 0;
+    }
+    iZeroCount = (kpSrc[i] == 0) ? (iZeroCount + 1) : 0;
+    *pDstPointer++ = kpSrc[i];
+  }
+  return (int32_t) (pDstPointer - pDst);
+}
+
+// iZeroPercent of the payload is 0x00 and as much again is 0x01..0x03, the rest is random
+static void FillNalPayload (uint8_t* pBuf, const int32_t kiLen, const int32_t kiZeroPercent) {
+  for (int32_t i = 0; i < kiLen; i++) {
+    const int32_t kiDice = rand() % 100;
+    if (kiDice < kiZeroPercent)
+      pBuf[i] = 0;
+    else if (kiDice < (kiZeroPercent << 1))
+      pBuf[i] = 1 + rand() % 3;
+    else
+      pBuf[i] = rand() % 256;
+  }
+}
+
+static void TestEncodeNal (const int32_t kiPayloadLen, const int32_t kiZeroPercent, const EWelsNalUnitType keType) {
+  uint8_t uiPayload[NAL_ENCAP_TEST_PAYLOAD_MAX];
+  uint8_t uiDst[NAL_ENCAP_TEST_PAYLOAD_MAX * 2];
+  uint8_t uiRef[NAL_ENCAP_TEST_PAYLOAD_MAX * 2];
+  SWelsNalRaw sRawNal;
+  SNalUnitHeaderExt sNalHeaderExt;
+
+  memset (&sRawNal, 0, sizeof (sRawNal));
+  memset (&sNalHeaderExt, 0, sizeof (sNalHeaderExt));
+  FillNalPayload (uiPayload, kiPayloadLen, kiZeroPercent);
+  sRawNal.pRawData = uiPayload;
+  sRawNal.iPayloadSize = kiPayloadLen;
+  sRawNal.sNalExt.sNalUnitHeader.eNalUnitType = keType;
+  sRawNal.sNalExt.sNalUnitHeader.uiNalRefIdc = NRI_PRI_HIGHEST;
+
+  int32_t iDstLen = 0;
+  ASSERT_EQ (ENC_RETURN_SUCCESS, WelsEncodeNal (&sRawNal, &sNalHeaderExt, sizeof (uiDst), uiDst, &iDstLen));
+
+  const int32_t kiHeaderLen = NAL_HEADER_SIZE + 1 + ((keType == NAL_UNIT_PREFIX) ? 3 : 0);
+  const int32_t kiRefLen = EncodeNalPayloadRef (uiPayload, kiPayloadLen, uiRef);
+  ASSERT_EQ (kiHeaderLen + kiRefLen, iDstLen) << "iPayloadLen = " << kiPayloadLen;
+  EXPECT_EQ (0, memcmp (uiDst + kiHeaderLen, uiRef, kiRefLen)) << "iPayloadLen = " << kiPayloadLen;
+}
+
+TEST (NalEncapTest, WelsEncodeNalEmulationPrevention) {
+  const int32_t kiZeroPercent[] = { 0, 2, 10, 30, 50, 100 };
+  for (int32_t iPercent = 0; iPercent < (int32_t) (sizeof (kiZeroPercent) / sizeof (kiZeroPercent[0])); iPercent++) {
+    // every short length, so the scan ends at each offset of a vector
+    for (int32_t iLen = 0; iLen < 40; iLen++)
+      TestEncodeNal (iLen, kiZeroPercent[iPercent], NAL_UNIT_CODED_SLICE);
+    for (int32_t i = 0; i < 20; i++)
+      TestEncodeNal (rand() % NAL_ENCAP_TEST_PAYLOAD_MAX, kiZeroPercent[iPercent], NAL_UNIT_CODED_SLICE);
+  }
+  TestEncodeNal (NAL_ENCAP_TEST_PAYLOAD_MAX, 10, NAL_UNIT_PREFIX);
+}
+
+TEST (NalEncapTest, WelsEncodeNalStartCodePatterns) {
+  // escapes at the start, at the end and across word boundaries of the payload
+  static const uint8_t kuiPatterns[][12] = {
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 0, 0, 1, 0, 0, 2, 0, 0, 3, 0, 0, 4 },
+    { 9, 9, 9, 9, 9, 9, 0, 0, 3, 9, 0, 0 },
+    { 9, 9, 9, 9, 9, 9, 9, 0, 0, 1, 9, 9 },
+    { 0, 0, 0, 3, 0, 0, 0, 3, 0, 0, 0, 3 },
+  };
+  uint8_t uiDst[64];
+  uint8_t uiRef[64];
+  for (int32_t i = 0; i < (int32_t) (sizeof (kuiPatterns) / sizeof (kuiPatterns[0])); i++) {
+    SWelsNalRaw sRawNal;
+    memset (&sRawNal, 0, sizeof (sRawNal));
+    sRawNal.pRawData = const_cast<uint8_t*> (kuiPatterns[i]);
+    sRawNal.iPayloadSize = sizeof (kuiPatterns[i]);
+    sRawNal.sNalExt.sNalUnitHeader.eNalUnitType = NAL_UNIT_CODED_SLICE;
+
+    int32_t iDstLen = 0;
+    ASSERT_EQ (ENC_RETURN_SUCCESS, WelsEncodeNal (&sRawNal, NULL, sizeof (uiDst), uiDst, &iDstLen));
+    const int32_t kiRefLen = EncodeNalPayloadRef (kuiPatterns[i], sizeof (kuiPatterns[i]), uiRef);
+    ASSERT_EQ (NAL_HEADER_SIZE + 1 + kiRefLen, iDstLen) << "pattern " << i;
+    EXPECT_EQ (0, memcmp (uiDst + NAL_HEADER_SIZE + 1, uiRef, kiRefLen)) << "pattern " << i;
+  }
+}
@@ -125,6 +125,118 @@ GENERATE_Intra8x8_UT (WelsIntra8x8Combined3Sad_AArch64_neon, WelsSampleSadIntra8
 GENERATE_Intra4x4_UT (WelsIntra4x4Combined3Satd_AArch64_neon, 1, WELS_CPU_NEON)
 #endif
 
+//reference for the all-mode kernels: predictor plus block cost per mode, in list order
+template<typename T>
+static int32_t IntraAllModesRef (PGetIntraPredFunc* pfGetPred, PSampleSadSatdCostFunc pfCost, int32_t iSize,
+                                 uint8_t* pDec, int32_t iDecStride, uint8_t* pEnc, int32_t iEncStride, const T* kpMode, int32_t iCount,
+                                 const int32_t* kpModeCost, uint8_t* pDst, int32_t* pBestMode) {
+  int32_t iBestCost = INT_MAX;
+  for (int32_t i = 0; i < iCount; i++) {
+    pfGetPred[kpMode[i]] (pDst, pDec, iDecStride);
+    int32_t iCost = pfCost (pDst, iSize, pEnc, iEncStride) + kpModeCost[kpMode[i]];
+    if (iCost < iBestCost) {
+      iBestCost = iCost;
+      *pBestMode = kpMode[i];
+    }
+  }
+  pfGetPred[*pBestMode] (pDst, pDec, iDecStride);
+  return iBestCost;
+}
+
+//random samples, alternating full range and a narrow range that makes the flat modes tie; shuffled mode list
+template<typename T>
+static int32_t IntraAllModesInput (int32_t k, uint8_t* pDec, uint8_t* pEnc, int32_t iLen, T* pMode,
+                                   int32_t* pModeCost, int32_t iModeNum) {
+  const int32_t iRange = (k & 1) ? 256 : 4;
+  for (int32_t i = 0; i < iLen; i++) {
+    pDec[i] = rand() % iRange;
+    pEnc[i] = rand() % iRange;
+  }
+  for (int32_t i = 0; i < iModeNum; i++) {
+    pMode[i] = i;
+    pModeCost[i] = rand() % 64;
+  }
+  for (int32_t i = iModeNum - 1; i > 0; i--) {
+    int32_t j = rand() % (i + 1);
+    T t = pMode[i];
+    pMode[i] = pMode[j];
+    pMode[j] = t;
+  }
+  return 1 + rand() % iModeNum;
+}
+
+#define GENERATE_IntraAllModes_UT(func, pred, cost, iSize, iModeNum, type) \
+TEST (IntraSadSatdFuncTest, func) { \
+  const int32_t iLineSize = 32; \
+  SWelsFuncPtrList sFuncList; \
+  WelsInitIntraPredFuncs (&sFuncList, 0); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pDec, iLineSize << 5, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pEnc, iLineSize << 5, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pDstRef, 256, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pDst, 256, 16); \
+  type iMode[iModeNum]; \
+  int32_t iModeCost[iModeNum]; \
+  for (int32_t k = 0; k < 100; k++) { \
+    int32_t iCount = IntraAllModesInput (k, pDec, pEnc, iLineSize << 5, iMode, iModeCost, iModeNum); \
+    int32_t iBestModeRef = -1, iBestMode = -1; \
+    int32_t iCostRef = IntraAllModesRef (sFuncList.pred, cost, iSize, pDec + 128, iLineSize, pEnc, iLineSize, \
+                                         iMode, iCount, iModeCost, pDstRef, &iBestModeRef); \
+    int32_t iCostNew = func (pDec + 128, iLineSize, pEnc, iLineSize, sFuncList.pred, cost, iMode, iCount, iModeCost, \
+                             pDst, &iBestMode); \
+    ASSERT_EQ (iCostRef, iCostNew); \
+    ASSERT_EQ (iBestModeRef, iBestMode); \
+    ASSERT_EQ (0, memcmp (pDstRef, pDst, iSize * iSize)); \
+  } \
+}
+
+GENERATE_IntraAllModes_UT (WelsSampleSatdIntra4x4AllModes_c, pfGetLumaI4x4Pred, WelsSampleSatd4x4_c, 4, I4_PRED_A,
+                           uint8_t)
+GENERATE_IntraAllModes_UT (WelsSampleSatdIntra16x16AllModes_c, pfGetLumaI16x16Pred, WelsSampleSatd16x16_c, 16,
+                           I16_PRED_DC_A, int8_t)
+GENERATE_IntraAllModes_UT (WelsSampleSadIntra16x16AllModes_c, pfGetLumaI16x16Pred, WelsSampleSad16x16_c, 16,
+                           I16_PRED_DC_A, int8_t)
+
+#define GENERATE_IntraChromaAllModes_UT(func, cost) \
+TEST (IntraSadSatdFuncTest, func) { \
+  const int32_t iLineSize = 32; \
+  SWelsFuncPtrList sFuncList; \
+  WelsInitIntraPredFuncs (&sFuncList, 0); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pDecCb, iLineSize << 5, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pEncCb, iLineSize << 5, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pDecCr, iLineSize << 5, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pEncCr, iLineSize << 5, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pDstRef, 128, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, pDst, 128, 16); \
+  int8_t iMode[C_PRED_A]; \
+  int32_t iModeCost[C_PRED_A], iCrModeCost[C_PRED_A]; \
+  for (int32_t k = 0; k < 100; k++) { \
+    int32_t iCount = IntraAllModesInput (k, pDecCb, pEncCb, iLineSize << 5, iMode, iModeCost, C_PRED_A); \
+    IntraAllModesInput (k, pDecCr, pEncCr, iLineSize << 5, iMode, iCrModeCost, C_PRED_A); \
+    int32_t iCostRef = INT_MAX, iBestModeRef = -1, iBestMode = -1; \
+    for (int32_t i = 0; i < iCount; i++) { \
+      int32_t iModeRef = 0; \
+      int32_t iCost = IntraAllModesRef (sFuncList.pfGetChromaPred, cost, 8, pDecCb + 128, iLineSize, pEncCb, iLineSize, \
+                                        &iMode[i], 1, iModeCost, pDstRef, &iModeRef) + \
+                      IntraAllModesRef (sFuncList.pfGetChromaPred, cost, 8, pDecCr + 128, iLineSize, pEncCr, iLineSize, \
+                                        &iMode[i], 1, iModeCost, pDstRef + 64, &iModeRef) - iModeCost[iModeRef]; \
+      if (iCost < iCostRef) { \
+        iCostRef = iCost; \
+        iBestModeRef = iModeRef; \
+      } \
+    } \
+    sFuncList.pfGetChromaPred[iBestModeRef] (pDstRef, pDecCb + 128, iLineSize); \
+    sFuncList.pfGetChromaPred[iBestModeRef] (pDstRef + 64, pDecCr + 128, iLineSize); \
+    int32_t iCostNew = func (pDecCb + 128, iLineSize, pEncCb, iLineSize, sFuncList.pfGetChromaPred, cost, iMode, \
+                             iCount, iModeCost, pDst, &iBestMode, pDecCr + 128, pEncCr); \
+    ASSERT_EQ (iCostRef, iCostNew); \
+    ASSERT_EQ (iBestModeRef, iBestMode); \
+    ASSERT_EQ (0, memcmp (pDstRef, pDst, 128)); \
+  } \
+}
+
+GENERATE_IntraChromaAllModes_UT (WelsSampleSatdIntra8x8AllModes_c, WelsSampleSatd8x8_c)
+GENERATE_IntraChromaAllModes_UT (WelsSampleSadIntra8x8AllModes_c, WelsSampleSad8x8_c)
+
 #define ASSERT_MEMORY_FAIL2X(A, B)     \
   if (NULL == B) {                     \
     pMemAlign->WelsFree(A, "Sad_SrcA");\
@@ -526,6 +638,76 @@ TEST_F (SadSatdCFuncTest, WelsSampleSadFour4x8_c) {
   EXPECT_EQ (m_pSad[0] + m_pSad[1] + m_pSad[2] + m_pSad[3], iSumSad);
 }
 
+#define GENERATE_SadMulti_UT(func, ref, iWidth, iHeight) \
+TEST_F (SadSatdCFuncTest, func) { \
+  for (int i = 0; i < (m_iStrideA << 5); i++) \
+    m_pPixSrcA[i] = rand() % 256; \
+  for (int i = 0; i < (m_iStrideB << 5); i++) \
+    m_pPixSrcB[i] = rand() % 256; \
+  uint8_t* pRef[SAD_MULTI_MAX_CANDIDATE]; \
+  uint16_t uiBaseCost[SAD_MULTI_MAX_CANDIDATE]; \
+  int32_t iCost[SAD_MULTI_MAX_CANDIDATE]; \
+  for (int i = 0; i < SAD_MULTI_MAX_CANDIDATE; i++) { \
+    pRef[i] = m_pPixSrcB + (rand() % (33 - iHeight)) * m_iStrideB + rand() % (m_iStrideB - iWidth + 1); \
+    uiBaseCost[i] = rand() % 1024; \
+  } \
+  for (int iNum = 1; iNum <= SAD_MULTI_MAX_CANDIDATE; iNum++) { \
+    func (m_pPixSrcA, m_iStrideA, pRef, m_iStrideB, uiBaseCost, iNum, iCost); \
+    for (int i = 0; i < iNum; i++) \
+      ASSERT_EQ (ref (m_pPixSrcA, m_iStrideA, pRef[i], m_iStrideB) + uiBaseCost[i], iCost[i]) << "iNum = " << iNum; \
+  } \
+}
+
+GENERATE_SadMulti_UT (WelsSampleSadMulti16x16_c, WelsSampleSad16x16_c, 16, 16)
+GENERATE_SadMulti_UT (WelsSampleSadMulti16x8_c, WelsSampleSad16x8_c, 16, 8)
+GENERATE_SadMulti_UT (WelsSampleSadMulti8x16_c, WelsSampleSad8x16_c, 8, 16)
+GENERATE_SadMulti_UT (WelsSampleSadMulti8x8_c, WelsSampleSad8x8_c, 8, 8)
+GENERATE_SadMulti_UT (WelsSampleSadMulti4x4_c, WelsSampleSad4x4_c, 4, 4)
+GENERATE_SadMulti_UT (WelsSampleSadMulti8x4_c, WelsSampleSad8x4_c, 8, 4)
+GENERATE_SadMulti_UT (WelsSampleSadMulti4x8_c, WelsSampleSad4x8_c, 4, 8)
+
+TEST_F (SadSatdCFuncTest, WelsSampleSad8x8Row_c) {
+  for (int i = 0; i < (m_iStrideA << 5); i++)
+    m_pPixSrcA[i] = rand() % 256;
+  for (int i = 0; i < (m_iStrideB << 5); i++)
+    m_pPixSrcB[i] = rand() % 256;
+  int32_t iSad[PIXEL_STRIDE >> 3];
+  for (int iNum = 1; iNum <= (PIXEL_STRIDE >> 3); iNum++) {
+    WelsSampleSad8x8Row_c (m_pPixSrcA, m_iStrideA, m_pPixSrcB, m_iStrideB, iNum, iSad);
+    for (int i = 0; i < iNum; i++)
+      ASSERT_EQ (WelsSampleSad8x8_c (m_pPixSrcA + (i << 3), m_iStrideA, m_pPixSrcB + (i << 3), m_iStrideB), iSad[i])
+          << "iNum = " << iNum;
+  }
+}
+
+TEST_F (SadSatdCFuncTest, WelsSampleSsimStats8x8_c) {
+  for (int i = 0; i < (m_iStrideA << 3); i++)
+    m_pPixSrcA[i] = rand() % 256;
+  for (int i = 0; i < (m_iStrideB << 3); i++)
+    m_pPixSrcB[i] = rand() % 256;
+  uint8_t* pPixA = m_pPixSrcA;
+  uint8_t* pPixB = m_pPixSrcB;
+
+  int32_t iSumA = 0, iSumB = 0, iSumSq = 0, iSumAB = 0, iSse = 0;
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 8; j++) {
+      iSumA  += pPixA[j];
+      iSumB  += pPixB[j];
+      iSumSq += pPixA[j] * pPixA[j] + pPixB[j] * pPixB[j];
+      iSumAB += pPixA[j] * pPixB[j];
+      iSse   += (pPixA[j] - pPixB[j]) * (pPixA[j] - pPixB[j]);
+    }
+    pPixA += m_iStrideA;
+    pPixB += m_iStrideB;
+  }
+  WelsSampleSsimStats8x8_c (m_pPixSrcA, m_iStrideA, m_pPixSrcB, m_iStrideB, m_pSad);
+  EXPECT_EQ (m_pSad[0], iSumA);
+  EXPECT_EQ (m_pSad[1], iSumB);
+  EXPECT_EQ (m_pSad[2], iSumSq);
+  EXPECT_EQ (m_pSad[3], iSumAB);
+  EXPECT_EQ (m_pSad[2] - 2 * m_pSad[3], iSse);
+}
+
 class SadSatdAssemblyFuncTest : public testing::Test {
  public:
   virtual void SetUp() {
@@ -686,6 +868,127 @@ GENERATE_Sad16x8_UT (WelsSampleSatd16x8_mmi, WelsSampleSatd16x8_c, WELS_CPU_MMI)
 GENERATE_Sad16x16_UT (WelsSampleSatd16x16_mmi, WelsSampleSatd16x16_c, WELS_CPU_MMI)
 #endif
 
+#define GENERATE_SadMultiAsm_UT(func, ref, iWidth, iHeight, CPUFLAGS) \
+TEST_F (SadSatdAssemblyFuncTest, func) { \
+  if (0 == (m_uiCpuFeatureFlag & CPUFLAGS)) \
+    return; \
+  for (int i = 0; i < (m_iStrideA << 5); i++) \
+    m_pPixSrcA[i] = rand() % 256; \
+  for (int i = 0; i < (m_iStrideB << 5); i++) \
+    m_pPixSrcB[i] = rand() % 256; \
+  uint8_t* pRef[SAD_MULTI_MAX_CANDIDATE]; \
+  uint16_t uiBaseCost[SAD_MULTI_MAX_CANDIDATE]; \
+  int32_t iCost[SAD_MULTI_MAX_CANDIDATE]; \
+  int32_t iCostRef[SAD_MULTI_MAX_CANDIDATE]; \
+  for (int i = 0; i < SAD_MULTI_MAX_CANDIDATE; i++) { \
+    pRef[i] = m_pPixSrcB + (rand() % (33 - iHeight)) * m_iStrideB + rand() % (m_iStrideB - iWidth + 1); \
+    uiBaseCost[i] = rand() % 1024; \
+  } \
+  for (int iNum = 1; iNum <= SAD_MULTI_MAX_CANDIDATE; iNum++) { \
+    ref (m_pPixSrcA, m_iStrideA, pRef, m_iStrideB, uiBaseCost, iNum, iCostRef); \
+    func (m_pPixSrcA, m_iStrideA, pRef, m_iStrideB, uiBaseCost, iNum, iCost); \
+    for (int i = 0; i < iNum; i++) \
+      ASSERT_EQ (iCostRef[i], iCost[i]) << "iNum = " << iNum; \
+  } \
+}
+
+#ifdef X86_ASM
+GENERATE_SadMultiAsm_UT (WelsSampleSadMulti4x4_sse2, WelsSampleSadMulti4x4_c, 4, 4, WELS_CPU_SSE2)
+GENERATE_SadMultiAsm_UT (WelsSampleSadMulti8x8_sse2, WelsSampleSadMulti8x8_c, 8, 8, WELS_CPU_SSE2)
+GENERATE_SadMultiAsm_UT (WelsSampleSadMulti8x16_sse2, WelsSampleSadMulti8x16_c, 8, 16, WELS_CPU_SSE2)
+GENERATE_SadMultiAsm_UT (WelsSampleSadMulti16x8_sse2, WelsSampleSadMulti16x8_c, 16, 8, WELS_CPU_SSE2)
+GENERATE_SadMultiAsm_UT (WelsSampleSadMulti16x16_sse2, WelsSampleSadMulti16x16_c, 16, 16, WELS_CPU_SSE2)
+#ifdef HAVE_AVX2
+GENERATE_SadMultiAsm_UT (WelsSampleSadMulti16x8_avx2, WelsSampleSadMulti16x8_c, 16, 8, WELS_CPU_AVX2)
+GENERATE_SadMultiAsm_UT (WelsSampleSadMulti16x16_avx2, WelsSampleSadMulti16x16_c, 16, 16, WELS_CPU_AVX2)
+#endif
+
+TEST_F (SadSatdAssemblyFuncTest, WelsSampleSad8x8Row_sse2) {
+  if (0 == (m_uiCpuFeatureFlag & WELS_CPU_SSE2))
+    return;
+  // unaligned rows, different strides and up to the 40 luma blocks of a 320 wide picture
+  const int32_t kiMaxNum = 40;
+  const int32_t kiStrideA = (kiMaxNum << 3) + 24;
+  const int32_t kiStrideB = (kiMaxNum << 3) + 40;
+  uint8_t uiPixA[kiStrideA * 8 + 8], uiPixB[kiStrideB * 8 + 8];
+  for (int i = 0; i < kiStrideA * 8 + 8; i++)
+    uiPixA[i] = rand() % 256;
+  for (int i = 0; i < kiStrideB * 8 + 8; i++)
+    uiPixB[i] = rand() % 256;
+  uint8_t* pA = uiPixA + rand() % 8;
+  uint8_t* pB = uiPixB + rand() % 8;
+  int32_t iSad[kiMaxNum], iSadRef[kiMaxNum];
+  for (int iNum = 1; iNum <= kiMaxNum; iNum++) {
+    WelsSampleSad8x8Row_c (pA, kiStrideA, pB, kiStrideB, iNum, iSadRef);
+    WelsSampleSad8x8Row_sse2 (pA, kiStrideA, pB, kiStrideB, iNum, iSad);
+    for (int i = 0; i < iNum; i++)
+      ASSERT_EQ (iSadRef[i], iSad[i]) << "iNum = " << iNum;
+  }
+}
+#endif
+
+#define GENERATE_SatdQuarFourAsm_UT(func, ref, iWidth, iHeight, CPUFLAGS) \
+TEST_F (SadSatdAssemblyFuncTest, func) { \
+  if (0 == (m_uiCpuFeatureFlag & CPUFLAGS)) \
+    return; \
+  for (int i = 0; i < (m_iStrideA << 5); i++) \
+    m_pPixSrcA[i] = rand() % 256; \
+  for (int i = 0; i < (m_iStrideB << 5); i++) \
+    m_pPixSrcB[i] = rand() % 256; \
+  uint8_t uiAvg[16 * 16]; \
+  uint8_t* pSrcA[4]; \
+  uint8_t* pSrcB[4]; \
+  const int32_t kiStrideB[4] = {m_iStrideB, m_iStrideB, iWidth, iWidth}; \
+  int32_t iSatd[4]; \
+  for (int i = 0; i < 4; i++) { \
+    pSrcA[i] = m_pPixSrcB + (rand() % (33 - iHeight)) * m_iStrideB + rand() % (m_iStrideB - iWidth + 1); \
+    pSrcB[i] = m_pPixSrcB + rand() % ((m_iStrideB << 5) - (kiStrideB[i] * (iHeight - 1) + iWidth) + 1); \
+  } \
+  func (m_pPixSrcA, m_iStrideA, pSrcA, m_iStrideB, pSrcB, kiStrideB, iSatd); \
+  for (int i = 0; i < 4; i++) { \
+    for (int y = 0; y < iHeight; y++) \
+      for (int x = 0; x < iWidth; x++) \
+        uiAvg[y * 16 + x] = (pSrcA[i][y * m_iStrideB + x] + pSrcB[i][y * kiStrideB[i] + x] + 1) >> 1; \
+    EXPECT_EQ (ref (m_pPixSrcA, m_iStrideA, uiAvg, 16), iSatd[i]) << "candidate " << i; \
+  } \
+}
+
+#ifdef X86_ASM
+GENERATE_SatdQuarFourAsm_UT (WelsSampleSatdQuarFour16x16_sse41, WelsSampleSatd16x16_c, 16, 16, WELS_CPU_SSE41)
+GENERATE_SatdQuarFourAsm_UT (WelsSampleSatdQuarFour16x8_sse41, WelsSampleSatd16x8_c, 16, 8, WELS_CPU_SSE41)
+GENERATE_SatdQuarFourAsm_UT (WelsSampleSatdQuarFour8x16_sse41, WelsSampleSatd8x16_c, 8, 16, WELS_CPU_SSE41)
+GENERATE_SatdQuarFourAsm_UT (WelsSampleSatdQuarFour8x8_sse41, WelsSampleSatd8x8_c, 8, 8, WELS_CPU_SSE41)
+#endif
+
+#define GENERATE_SsimStatsAsm_UT(func, CPUFLAGS) \
+TEST_F (SadSatdAssemblyFuncTest, func) { \
+  if (0 == (m_uiCpuFeatureFlag & CPUFLAGS)) \
+    return; \
+  int32_t iStatsRef[4]; \
+  for (int k = 0; k < 3; k++) { \
+    for (int i = 0; i < (m_iStrideA << 3); i++) \
+      m_pPixSrcA[i] = k == 0 ? rand() % 256 : (k == 1 ? 255 : 0); \
+    for (int i = 0; i < (m_iStrideB << 3); i++) \
+      m_pPixSrcB[i] = k == 0 ? rand() % 256 : 255; \
+    WelsSampleSsimStats8x8_c (m_pPixSrcA, m_iStrideA, m_pPixSrcB, m_iStrideB, iStatsRef); \
+    func (m_pPixSrcA, m_iStrideA, m_pPixSrcB, m_iStrideB, m_pSad); \
+    for (int i = 0; i < 4; i++) \
+      ASSERT_EQ (iStatsRef[i], m_pSad[i]) << "k = " << k; \
+  } \
+}
+
+#ifdef X86_ASM
+GENERATE_SsimStatsAsm_UT (WelsSampleSsimStats8x8_sse2, WELS_CPU_SSE2)
+#endif
+
+#ifdef HAVE_NEON
+GENERATE_SsimStatsAsm_UT (WelsSampleSsimStats8x8_neon, WELS_CPU_NEON)
+#endif
+
+#ifdef HAVE_NEON_AARCH64
+GENERATE_SsimStatsAsm_UT (WelsSampleSsimStats8x8_AArch64_neon, WELS_CPU_NEON)
+#endif
+
 #define GENERATE_SadFour_UT(func, CPUFLAGS, width, height) \
 TEST_F (SadSatdAssemblyFuncTest, func) { \
   if (0 == (m_uiCpuFeatureFlag & CPUFLAGS)) \
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include "cpu.h"
+#include "cpu_core.h"
+#include "util.h"
+#include "macros.h"
+#include "IWelsVP.h"
+#include "colorspaceconvert.h"
+
+using namespace WelsVP;
+
+#define CSC_TEST_WIDTH   62
+#define CSC_TEST_HEIGHT  30
+#define CSC_TEST_STRIDE  80
+
+static uint8_t RgbToY_ref (int32_t r, int32_t g, int32_t b) {
+  return (uint8_t) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+static void Rgb32ToI420_ref (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                             const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                             const int32_t kiHeight, const int32_t kiR, const int32_t kiG, const int32_t kiB) {
+  for (int32_t j = 0; j < kiHeight; j++) {
+    for (int32_t i = 0; i < kiWidth; i++) {
+      uint8_t* p = pSrc + j * kiSrcStride + i * 4;
+      pDstY[j * kiDstStrideY + i] = RgbToY_ref (p[kiR], p[kiG], p[kiB]);
+    }
+  }
+  for (int32_t j = 0; j < (kiHeight >> 1); j++) {
+    for (int32_t i = 0; i < (kiWidth >> 1); i++) {
+      int32_t iSum[3] = {0, 0, 0};
+      for (int32_t y = 0; y < 2; y++) {
+        for (int32_t x = 0; x < 2; x++) {
+          uint8_t* p = pSrc + (2 * j + y) * kiSrcStride + (2 * i + x) * 4;
+          iSum[0] += p[kiR];
+          iSum[1] += p[kiG];
+          iSum[2] += p[kiB];
+        }
+      }
+      const int32_t r = (iSum[0] + 2) >> 2, g = (iSum[1] + 2) >> 2, b = (iSum[2] + 2) >> 2;
+      pDstU[j * kiDstStrideUV + i] = (uint8_t) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+      pDstV[j * kiDstStrideUV + i] = (uint8_t) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+  }
+}
+
+static void Bgra32ToI420_ref (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                              const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                              const int32_t kiHeight) {
+  Rgb32ToI420_ref (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, pSrc, kiSrcStride, kiWidth, kiHeight, 2, 1, 0);
+}
+
+static void Rgba32ToI420_ref (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                              const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                              const int32_t kiHeight) {
+  Rgb32ToI420_ref (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, pSrc, kiSrcStride, kiWidth, kiHeight, 0, 1, 2);
+}
+
+static void Yuy2ToI420_ref (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, const int32_t kiDstStrideY,
+                            const int32_t kiDstStrideUV, uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiWidth,
+                            const int32_t kiHeight) {
+  for (int32_t j = 0; j < kiHeight; j++) {
+    for (int32_t i = 0; i < kiWidth; i++)
+      pDstY[j * kiDstStrideY + i] = pSrc[j * kiSrcStride + i * 2];
+  }
+  for (int32_t j = 0; j < (kiHeight >> 1); j++) {
+    for (int32_t i = 0; i < (kiWidth >> 1); i++) {
+      uint8_t* p0 = pSrc + 2 * j * kiSrcStride + i * 4;
+      uint8_t* p1 = p0 + kiSrcStride;
+      pDstU[j * kiDstStrideUV + i] = (p0[1] + p1[1] + 1) >> 1;
+      pDstV[j * kiDstStrideUV + i] = (p0[3] + p1[3] + 1) >> 1;
+    }
+  }
+}
+
+#define GENERATE_PackedToI420_UT(func, ref_func, bpp, ASM, CPUFLAGS) \
+TEST (ColorspaceConvertTest, func) { \
+  if (ASM) { \
+    int32_t iCpuCores = 0; \
+    uint32_t uiCpuFeatureFlag = WelsCPUFeatureDetect (&iCpuCores); \
+    if (0 == (uiCpuFeatureFlag & CPUFLAGS)) \
+      return; \
+  } \
+  const int32_t kiSrcStride = CSC_TEST_STRIDE * bpp; \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, src, CSC_TEST_HEIGHT * CSC_TEST_STRIDE * bpp, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, dst_c, CSC_TEST_HEIGHT * CSC_TEST_STRIDE * 2, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, dst_a, CSC_TEST_HEIGHT * CSC_TEST_STRIDE * 2, 16); \
+  for (int32_t j = 0; j < CSC_TEST_HEIGHT * kiSrcStride; j++) \
+    src[j] = rand() % 256; \
+  for (int32_t j = 0; j < CSC_TEST_HEIGHT * CSC_TEST_STRIDE * 2; j++) \
+    dst_c[j] = dst_a[j] = rand() % 256; \
+  uint8_t* pUc = dst_c + CSC_TEST_HEIGHT * CSC_TEST_STRIDE; \
+  uint8_t* pVc = pUc + (CSC_TEST_HEIGHT >> 1) * (CSC_TEST_STRIDE >> 1); \
+  uint8_t* pUa = dst_a + CSC_TEST_HEIGHT * CSC_TEST_STRIDE; \
+  uint8_t* pVa = pUa + (CSC_TEST_HEIGHT >> 1) * (CSC_TEST_STRIDE >> 1); \
+  ref_func (dst_c, pUc, pVc, CSC_TEST_STRIDE, CSC_TEST_STRIDE >> 1, src, kiSrcStride, CSC_TEST_WIDTH, CSC_TEST_HEIGHT); \
+  func (dst_a, pUa, pVa, CSC_TEST_STRIDE, CSC_TEST_STRIDE >> 1, src, kiSrcStride, CSC_TEST_WIDTH, CSC_TEST_HEIGHT); \
+  for (int32_t j = 0; j < CSC_TEST_HEIGHT * CSC_TEST_STRIDE * 2; j++) { \
+    ASSERT_EQ (dst_c[j], dst_a[j]); \
+  } \
+}
+
+GENERATE_PackedToI420_UT (Yuy2ToI420_c, Yuy2ToI420_ref, 2, 0, 0)
+GENERATE_PackedToI420_UT (Bgra32ToI420_c, Bgra32ToI420_ref, 4, 0, 0)
+GENERATE_PackedToI420_UT (Rgba32ToI420_c, Rgba32ToI420_ref, 4, 0, 0)
+
+// CSC_TEST_WIDTH leaves columns to the c kernels after those of the simd ones
+#define GENERATE_DeinterleaveChroma_UT(func, ASM, CPUFLAGS) \
+TEST (ColorspaceConvertTest, func) { \
+  if (ASM) { \
+    int32_t iCpuCores = 0; \
+    uint32_t uiCpuFeatureFlag = WelsCPUFeatureDetect (&iCpuCores); \
+    if (0 == (uiCpuFeatureFlag & CPUFLAGS)) \
+      return; \
+  } \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, src, CSC_TEST_HEIGHT * CSC_TEST_STRIDE, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, dst_c, CSC_TEST_HEIGHT * CSC_TEST_STRIDE, 16); \
+  ENFORCE_STACK_ALIGN_1D (uint8_t, dst_a, CSC_TEST_HEIGHT * CSC_TEST_STRIDE, 16); \
+  for (int32_t j = 0; j < CSC_TEST_HEIGHT * CSC_TEST_STRIDE; j++) { \
+    src[j] = rand() % 256; \
+    dst_c[j] = dst_a[j] = rand() % 256; \
+  } \
+  const int32_t kiDstStride = CSC_TEST_STRIDE >> 1; \
+  const int32_t kiPlaneSize = (CSC_TEST_HEIGHT >> 1) * kiDstStride; \
+  DeinterleaveChroma_c (dst_c, dst_c + kiPlaneSize, kiDstStride, src, CSC_TEST_STRIDE, CSC_TEST_WIDTH >> 1, \
+                        CSC_TEST_HEIGHT >> 1); \
+  func (dst_a, dst_a + kiPlaneSize, kiDstStride, src, CSC_TEST_STRIDE, CSC_TEST_WIDTH >> 1, CSC_TEST_HEIGHT >> 1); \
+  for (int32_t j = 0; j < CSC_TEST_HEIGHT * CSC_TEST_STRIDE; j++) { \
+    ASSERT_EQ (dst_c[j], dst_a[j]); \
+  } \
+}
+
+#if defined(X86_ASM)
+GENERATE_DeinterleaveChroma_UT (DeinterleaveChroma_sse2, 1, WELS_CPU_SSE2)
+GENERATE_PackedToI420_UT (Yuy2ToI420_sse2, Yuy2ToI420_ref, 2, 1, WELS_CPU_SSE2)
+GENERATE_PackedToI420_UT (Bgra32ToI420_sse2, Bgra32ToI420_ref, 4, 1, WELS_CPU_SSE2)
+GENERATE_PackedToI420_UT (Rgba32ToI420_sse2, Rgba32ToI420_ref, 4, 1, WELS_CPU_SSE2)
+#endif
+
+#if defined(HAVE_NEON)
+GENERATE_DeinterleaveChroma_UT (DeinterleaveChroma_neon, 1, WELS_CPU_NEON)
+GENERATE_PackedToI420_UT (Yuy2ToI420_neon, Yuy2ToI420_ref, 2, 1, WELS_CPU_NEON)
+GENERATE_PackedToI420_UT (Bgra32ToI420_neon, Bgra32ToI420_ref, 4, 1, WELS_CPU_NEON)
+GENERATE_PackedToI420_UT (Rgba32ToI420_neon, Rgba32ToI420_ref, 4, 1, WELS_CPU_NEON)
+#endif
+
+#if defined(HAVE_NEON_AARCH64)
+GENERATE_DeinterleaveChroma_UT (DeinterleaveChroma_AArch64_neon, 1, WELS_CPU_NEON)
+GENERATE_PackedToI420_UT (Yuy2ToI420_AArch64_neon, Yuy2ToI420_ref, 2, 1, WELS_CPU_NEON)
+GENERATE_PackedToI420_UT (Bgra32ToI420_AArch64_neon, Bgra32ToI420_ref, 4, 1, WELS_CPU_NEON)
+GENERATE_PackedToI420_UT (Rgba32ToI420_AArch64_neon, Rgba32ToI420_ref, 4, 1, WELS_CPU_NEON)
+#endif
+
+TEST (ColorspaceConvertTest, RgbRange) {
+  EXPECT_EQ (RgbToY_ref (0, 0, 0), 16);
+  EXPECT_EQ (RgbToY_ref (255, 255, 255), 235);
+  uint8_t uiWhite[16], uiY[4], uiU, uiV;
+  memset (uiWhite, 255, sizeof (uiWhite));
+  Bgra32ToI420_c (uiY, &uiU, &uiV, 2, 1, uiWhite, 8, 2, 2);
+  EXPECT_EQ (uiY[0], 235);
+  EXPECT_EQ (uiU, 128);
+  EXPECT_EQ (uiV, 128);
+}
+
+TEST (ColorspaceConvertTest, SemiPlanarThroughStrategy) {
+  const int32_t kiChromaStride = CSC_TEST_STRIDE >> 1;
+  uint8_t* pSrc = new uint8_t[CSC_TEST_HEIGHT * CSC_TEST_STRIDE * 3 / 2];
+  uint8_t* pDst = new uint8_t[CSC_TEST_HEIGHT * CSC_TEST_STRIDE * 3 / 2];
+  for (int32_t j = 0; j < CSC_TEST_HEIGHT * CSC_TEST_STRIDE * 3 / 2; j++)
+    pSrc[j] = rand() % 256;
+
+  SPixMap sSrc, sDst;
+  memset (&sSrc, 0, sizeof (sSrc));
+  memset (&sDst, 0, sizeof (sDst));
+  sSrc.pPixel[0] = pSrc;
+  sSrc.pPixel[1] = pSrc + CSC_TEST_HEIGHT * CSC_TEST_STRIDE;
+  sSrc.iStride[0] = sSrc.iStride[1] = CSC_TEST_STRIDE;
+  sSrc.sRect.iRectWidth = CSC_TEST_WIDTH;
+  sSrc.sRect.iRectHeight = CSC_TEST_HEIGHT;
+  sDst.pPixel[0] = pDst;
+  sDst.pPixel[1] = pDst + CSC_TEST_HEIGHT * CSC_TEST_STRIDE;
+  sDst.pPixel[2] = (uint8_t*)sDst.pPixel[1] + (CSC_TEST_HEIGHT >> 1) * kiChromaStride;
+  sDst.iStride[0] = CSC_TEST_STRIDE;
+  sDst.iStride[1] = sDst.iStride[2] = kiChromaStride;
+  sDst.sRect = sSrc.sRect;
+  sDst.eFormat = VIDEO_FORMAT_I420;
+
+  CColorspaceConvert cConvert (0);
+  const EVideoFormat keFormats[2] = {VIDEO_FORMAT_NV12, VIDEO_FORMAT_NV21};
+  for (int32_t k = 0; k < 2; k++) {
+    sSrc.eFormat = keFormats[k];
+    ASSERT_EQ (cConvert.Process (0, &sSrc, &sDst), RET_SUCCESS);
+    uint8_t* pU = (uint8_t*)sDst.pPixel[k == 0 ? 1 : 2];
+    uint8_t* pV = (uint8_t*)sDst.pPixel[k == 0 ? 2 : 1];
+    for (int32_t j = 0; j < CSC_TEST_HEIGHT; j++) {
+      for (int32_t i = 0; i < CSC_TEST_WIDTH; i++)
+        ASSERT_EQ (pDst[j * CSC_TEST_STRIDE + i], pSrc[j * CSC_TEST_STRIDE + i]);
+    }
+    for (int32_t j = 0; j < (CSC_TEST_HEIGHT >> 1); j++) {
+      uint8_t* pUV = (uint8_t*)sSrc.pPixel[1] + j * CSC_TEST_STRIDE;
+      for (int32_t i = 0; i < (CSC_TEST_WIDTH >> 1); i++) {
+        ASSERT_EQ (pU[j * kiChromaStride + i], pUV[2 * i]);
+        ASSERT_EQ (pV[j * kiChromaStride + i], pUV[2 * i + 1]);
+      }
+    }
+  }
+
+  sSrc.eFormat = VIDEO_FORMAT_UYVY;
+  EXPECT_EQ (cConvert.Process (0, &sSrc, &sDst), RET_NOTSUPPORTED);
+
+  delete[] pSrc;
+  delete[] pDst;
+}